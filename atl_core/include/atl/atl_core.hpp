@@ -5,7 +5,9 @@
 #include "atl/estimation/estimation.hpp"
 #include "atl/mission/mission.hpp"
 #include "atl/planning/planning.hpp"
+#include "atl/quadrotor/control_executor.hpp"
 #include "atl/quadrotor/quadrotor.hpp"
+#include "atl/quadrotor/state_store.hpp"
 #include "atl/sensor/sensor.hpp"
 #include "atl/utils/utils.hpp"
 #include "atl/vision/vision.hpp"
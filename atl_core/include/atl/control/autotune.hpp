@@ -0,0 +1,231 @@
+#ifndef ATL_CONTROL_AUTOTUNE_HPP
+#define ATL_CONTROL_AUTOTUNE_HPP
+
+#include <libgen.h>
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "atl/control/landing_controller.hpp"
+#include "atl/control/position_controller.hpp"
+#include "atl/control/tracking_controller.hpp"
+#include "atl/models/quadrotor.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+#define AUTOTUNE_NB_GAINS 9
+
+/**
+ * Closed loop scenario the controller gains are tuned on
+ *
+ * - `step`: position controller or tracking controller moves from hovering
+ *   at `start` to `start + step`
+ * - `hover`: same as `step` with zero step, meant to be used with `wind`
+ * - `track`: tracking controller follows a target starting at
+ *   `target_pos` relative to `start` and moving at `target_vel`
+ * - `land`: landing controller descends onto the same moving target
+ *
+ * Every scenario applies the constant `wind` force plus a sinusoidal gust
+ * of amplitude `gust` and period `gust_period` to the model. The model
+ * mass is matched to the hover throttle of the controller.
+ */
+struct TuningScenario {
+  std::string name;
+  std::string type;
+  double duration = 10.0;
+  double weight = 1.0;
+
+  Vec3 start{0.0, 0.0, 3.0};
+  Vec3 step{0.0, 0.0, 0.0};
+  Vec3 target_pos{0.0, 0.0, 0.0};
+  Vec3 target_vel{0.0, 0.0, 0.0};
+
+  Vec3 wind{0.0, 0.0, 0.0};
+  Vec3 gust{0.0, 0.0, 0.0};
+  double gust_period = 2.0;
+};
+
+/**
+ * Closed loop performance of one scenario
+ *
+ * - `ise`: integral of the squared position error
+ * - `overshoot`: largest travel past the setpoint relative to the step
+ *   size for a step, the peak error over the second half of the scenario
+ *   for hover and tracking, and the horizontal error at touch down for
+ *   landing
+ * - `effort`: integral of the squared roll, pitch and throttle deviation
+ *   from hover
+ */
+struct TuningMetrics {
+  bool failed = false;
+  double ise = 0.0;
+  double overshoot = 0.0;
+  double effort = 0.0;
+  double cost = 0.0;
+};
+
+/**
+ * Controller auto-tuner
+ *
+ * Tunes the PID gains of the position, tracking or landing controller
+ * offline by running the real controller class in closed loop against
+ * `QuadrotorModel` over a batch of scenarios. The cost of a set of gains
+ * is the weighted sum over scenarios of
+ *
+ *     w_ise * ise + w_overshoot * overshoot + w_effort * effort
+ *
+ * or `failure_cost` if the quadrotor crashes, diverges or does not land.
+ * The gains `(k_p, k_i, k_d)` of the three axes are optimized within
+ * `lower` and `upper` with differential evolution (DE/rand/1/bin), the
+ * hand tuned gains are part of the initial population so the result is
+ * never worse than them. Each generation is evaluated on all cores, every
+ * candidate draws its random numbers before the evaluation so the result
+ * does not depend on the number of threads.
+ */
+class AutoTuner {
+public:
+  bool configured = false;
+
+  // controller
+  std::string controller;
+  std::string controller_file;
+  std::vector<std::string> axes;
+  PositionController position_controller;
+  TrackingController tracking_controller;
+  LandingController landing_controller;
+
+  // scenarios and cost
+  std::vector<TuningScenario> scenarios;
+  double dt = 0.002;
+  double w_ise = 1.0;
+  double w_overshoot = 1.0;
+  double w_effort = 0.1;
+  double failure_cost = 1e6;
+
+  // optimizer
+  int population = 24;
+  int max_generations = 40;
+  double mutation = 0.7;
+  double crossover = 0.9;
+  int seed = 1;
+  int nb_threads = 0;
+  VecX lower = VecX::Zero(AUTOTUNE_NB_GAINS);
+  VecX upper = VecX::Ones(AUTOTUNE_NB_GAINS);
+
+  // results
+  VecX initial_gains;
+  VecX best_gains;
+  double initial_cost = 0.0;
+  double best_cost = 0.0;
+  std::vector<double> history;
+  int nb_evaluations = 0;
+  double elapsed = 0.0;
+
+  AutoTuner() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Failed to load controller config file
+   *    - -3: Invalid scenarios, bounds or optimizer settings
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Gains of the configured controller as
+   * `(k_p(0..2), k_i(0..2), k_d(0..2))`
+   *
+   * @return Gains
+   */
+  VecX controllerGains();
+
+  /**
+   * Set the gains of the configured controller
+   *
+   * @param gains Gains as returned by `controllerGains()`
+   * @param pid Controller PID
+   */
+  static void setGains(const VecX &gains, MultiPID<3> &pid);
+
+  /**
+   * Simulate one scenario
+   *
+   * @param scenario Scenario
+   * @param gains Gains as returned by `controllerGains()`
+   * @return Metrics
+   */
+  TuningMetrics simulate(const TuningScenario &scenario, const VecX &gains);
+
+  /**
+   * Evaluate gains over all scenarios
+   *
+   * @param gains Gains as returned by `controllerGains()`
+   * @param metrics Metrics of every scenario
+   * @return Total cost
+   */
+  double evaluate(const VecX &gains, std::vector<TuningMetrics> &metrics);
+
+  /**
+   * Evaluate gains over all scenarios
+   *
+   * @param gains Gains as returned by `controllerGains()`
+   * @return Total cost
+   */
+  double evaluate(const VecX &gains);
+
+  /**
+   * Evaluate candidates in parallel
+   *
+   * @param candidates Candidate gains
+   * @param costs Costs of the candidates
+   */
+  void evaluateBatch(const std::vector<VecX> &candidates,
+                     std::vector<double> &costs);
+
+  /**
+   * Optimize gains, the result is kept in `best_gains` and `best_cost`
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   */
+  int optimize();
+
+  /**
+   * Save controller config with the tuned gains, every other key of the
+   * controller config file is kept
+   *
+   * @param output_file Path to output YAML file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load controller config file
+   *    - -2: Failed to write output file
+   */
+  int saveConfig(const std::string &output_file);
+
+  /**
+   * Save tuning report with the gains, cost history and per scenario
+   * metrics before and after tuning
+   *
+   * @param report_file Path to report file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to write report file
+   */
+  int saveReport(const std::string &report_file);
+};
+
+} // namespace atl
+#endif
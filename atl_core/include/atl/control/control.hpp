@@ -1,12 +1,18 @@
 #ifndef ATL_CONTROL_CONTROL_HPP
 #define ATL_CONTROL_CONTROL_HPP
 
+#include "atl/control/autotune.hpp"
+#include "atl/control/flatness.hpp"
+#include "atl/control/geometric_controller.hpp"
 #include "atl/control/landing_controller.hpp"
+#include "atl/control/landing_mpc.hpp"
+#include "atl/control/multi_pid.hpp"
 #include "atl/control/pid.hpp"
 #include "atl/control/position_controller.hpp"
 #include "atl/control/tracking_controller.hpp"
 #include "atl/control/trajectory.hpp"
 #include "atl/control/trajectory_index.hpp"
+#include "atl/control/trajectory_library.hpp"
 #include "atl/control/velocity_controller.hpp"
 #include "atl/control/waypoint_controller.hpp"
 
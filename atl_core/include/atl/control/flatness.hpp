@@ -0,0 +1,158 @@
+#ifndef ATL_CONTROL_FLATNESS_HPP
+#define ATL_CONTROL_FLATNESS_HPP
+
+#include <math.h>
+
+#include <functional>
+#include <vector>
+
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Flat output of a quadrotor and its derivatives, world frame (NWU)
+ */
+struct FlatOutput {
+  Vec3 pos{0.0, 0.0, 0.0};
+  Vec3 vel{0.0, 0.0, 0.0};
+  Vec3 acc{0.0, 0.0, 0.0};
+  Vec3 jerk{0.0, 0.0, 0.0};
+  double yaw = 0.0;
+  double yaw_rate = 0.0;
+};
+
+/**
+ * Quadrotor state and inputs that realize a flat output
+ *
+ * - `thrust`: mass normalized collective thrust in m/s^2, `g` at hover
+ * - `orientation`: body to world frame
+ * - `rpy`: euler 3-2-1 angles of `orientation`
+ * - `omega`: body rates in rad/s
+ */
+struct FlatState {
+  Vec3 pos{0.0, 0.0, 0.0};
+  Vec3 vel{0.0, 0.0, 0.0};
+  Vec3 acc{0.0, 0.0, 0.0};
+  Quaternion orientation{1.0, 0.0, 0.0, 0.0};
+  Vec3 rpy{0.0, 0.0, 0.0};
+  double thrust = 0.0;
+  Vec3 omega{0.0, 0.0, 0.0};
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/**
+ * Differential flatness map of a quadrotor
+ *
+ * Maps position, yaw and their derivatives to thrust, orientation and body
+ * rates (Mellinger and Kumar, "Minimum snap trajectory generation and
+ * control for quadrotors", 2011). The body z-axis is aligned with
+ * `acc + g * e3`, the body x-axis with the yaw heading projected onto the
+ * plane normal to it. Body rates follow from the jerk and the yaw rate.
+ * The yaw rate is mapped exactly rather than with the small tilt
+ * approximation `r = yaw_rate * z_B(2)` of the paper.
+ *
+ * @param flat Flat output
+ * @param g Gravitational constant
+ * @param state State and inputs
+ * @return
+ *    - 0: Success
+ *    - -1: Free fall or thrust along the yaw heading, orientation
+ *      undefined
+ */
+int flatness_map(const FlatOutput &flat, const double g, FlatState &state);
+
+/**
+ * Flatness feed-forward plan
+ *
+ * Precomputes the flatness map of a trajectory on a uniform time grid so
+ * `evaluate()` costs an index computation and one interpolation between
+ * neighbouring states, independent of the length of the trajectory.
+ */
+class FlatnessPlan {
+public:
+  bool loaded = false;
+  double dt = 0.0;
+  double g = 9.81;
+  std::vector<FlatState, Eigen::aligned_allocator<FlatState>> states;
+
+  FlatnessPlan() {}
+
+  /**
+   * Plan from flat outputs sampled every `dt` seconds
+   *
+   * @param flat_outputs Flat outputs
+   * @param dt Time between samples in seconds
+   * @param g Gravitational constant
+   * @return
+   *    - 0: Success
+   *    - -1: Invalid samples or time step
+   *    - -2: Orientation undefined along the trajectory
+   */
+  int plan(const std::vector<FlatOutput> &flat_outputs,
+           const double dt,
+           const double g = 9.81);
+
+  /**
+   * Plan from a continuous trajectory sampled every `dt` seconds
+   *
+   * @param trajectory Flat output as a function of time
+   * @param duration Duration of trajectory in seconds
+   * @param dt Time between samples in seconds
+   * @param g Gravitational constant
+   * @return
+   *    - 0: Success
+   *    - -1: Invalid duration or time step
+   *    - -2: Orientation undefined along the trajectory
+   */
+  int plan(const std::function<FlatOutput(const double)> &trajectory,
+           const double duration,
+           const double dt,
+           const double g = 9.81);
+
+  /**
+   * Plan from positions and velocities sampled every `dt` seconds, the
+   * acceleration and jerk are finite differences of the velocity
+   *
+   * @param pos Positions
+   * @param vel Velocities
+   * @param yaw Yaw angles, or empty for zero yaw
+   * @param dt Time between samples in seconds
+   * @param g Gravitational constant
+   * @return
+   *    - 0: Success
+   *    - -1: Invalid samples or time step
+   *    - -2: Orientation undefined along the trajectory
+   */
+  int plan(const std::vector<Vec3> &pos,
+           const std::vector<Vec3> &vel,
+           const std::vector<double> &yaw,
+           const double dt,
+           const double g = 9.81);
+
+  /**
+   * Duration of plan in seconds
+   */
+  double duration() const;
+
+  /**
+   * Evaluate plan, times outside of the plan are held at the first or last
+   * state
+   *
+   * @param t Time since start of plan in seconds
+   * @param state State and inputs
+   * @return
+   *    - 0: Success
+   *    - -1: Not loaded
+   */
+  int evaluate(const double t, FlatState &state) const;
+
+  /**
+   * Clear plan
+   */
+  void reset();
+};
+
+} // namespace atl
+#endif
@@ -0,0 +1,140 @@
+#ifndef ATL_CONTROL_GEOMETRIC_CONTROLLER_HPP
+#define ATL_CONTROL_GEOMETRIC_CONTROLLER_HPP
+
+#include <float.h>
+#include <math.h>
+
+#include "atl/data/data.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Geometric controller on SE(3)
+ *
+ * Position and attitude controller of Lee, Leok and McClamroch, "Geometric
+ * tracking control of a quadrotor UAV on SE(3)" (2010). The attitude error
+ * is computed on SO(3) from rotation matrices instead of Euler angles, so it
+ * has no singularity at large tilt and no yaw wrap around.
+ *
+ * The position loop turns a position, velocity and acceleration setpoint
+ * into a desired thrust vector in the world frame (NWU)
+ *
+ *     F = -k_x * e_x - k_v * e_v + m * g * e3 + m * a_d
+ *
+ * whose direction and the yaw setpoint define the desired orientation
+ * `R_d`. The collective thrust is `F` projected on the current body z-axis.
+ * The desired body rates `omega_d` are the finite difference of `R_d`
+ * between updates, without them the attitude loop lags behind a rotating
+ * thrust vector, for example on a circle. The attitude loop turns `R_d` and
+ * `omega_d` into body moments
+ *
+ *     e_R = 0.5 * vee(R_d^T * R - R^T * R_d)
+ *     e_w = w - R^T * R_d * w_d
+ *     M = -k_R * e_R - k_w * e_w + w x J * w - J * (w x R^T * R_d * w_d)
+ *
+ * Gains are per axis. Everything is fixed size, an update does not allocate.
+ */
+class GeometricController {
+public:
+  bool configured = false;
+
+  // gains
+  Vec3 k_x{4.0, 4.0, 4.0};
+  Vec3 k_v{3.0, 3.0, 3.0};
+  Vec3 k_R{8.0, 8.0, 3.0};
+  Vec3 k_omega{1.5, 1.5, 1.0};
+
+  // vehicle
+  double mass = 1.0;
+  double g = 9.81;
+  Mat3 J = Mat3::Identity();
+  double hover_throttle = 0.5;
+  double max_tilt = deg2rad(45.0);
+  double max_thrust = FLT_MAX;
+
+  // errors and outputs
+  Vec3 e_x{0.0, 0.0, 0.0};
+  Vec3 e_v{0.0, 0.0, 0.0};
+  Vec3 e_R{0.0, 0.0, 0.0};
+  Vec3 e_omega{0.0, 0.0, 0.0};
+  Mat3 R_d = Mat3::Identity();
+  Vec3 omega_d{0.0, 0.0, 0.0};
+  bool R_d_valid = false;
+  double thrust = 0.0;
+  Vec3 moment{0.0, 0.0, 0.0};
+  Vec4 outputs{0.0, 0.0, 0.0, 0.0};
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  GeometricController() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Invalid vehicle parameters
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Update position loop
+   *
+   * Sets `R_d`, `omega_d`, `thrust` and `outputs`.
+   *
+   * @param pos_d Position setpoint in world frame
+   * @param vel_d Velocity setpoint in world frame
+   * @param acc_d Acceleration feed-forward in world frame
+   * @param yaw_d Yaw setpoint in radians
+   * @param pos Position in world frame
+   * @param vel Velocity in world frame
+   * @param R Orientation, body to world frame
+   * @param dt Time difference in seconds
+   *
+   * @return
+   *    Attitude command as a vector of size 4:
+   *    (roll, pitch, yaw, throttle)
+   */
+  Vec4 update(const Vec3 &pos_d,
+              const Vec3 &vel_d,
+              const Vec3 &acc_d,
+              const double yaw_d,
+              const Vec3 &pos,
+              const Vec3 &vel,
+              const Mat3 &R,
+              const double dt);
+
+  /**
+   * Update attitude loop
+   *
+   * @param R_d Desired orientation, body to world frame
+   * @param omega_d Desired body rates in rad/s
+   * @param R Orientation, body to world frame
+   * @param omega Body rates in rad/s
+   *
+   * @return Body moments in Nm
+   */
+  Vec3 updateAttitude(const Mat3 &R_d,
+                      const Vec3 &omega_d,
+                      const Mat3 &R,
+                      const Vec3 &omega);
+
+  /**
+   * Reset controller errors and outputs
+   */
+  void reset();
+};
+
+/**
+ * Vee map, inverse of `skew()`
+ *
+ * @param S Skew symmetric matrix
+ * @return Vector `x` such that `skew(x) == S`
+ */
+Vec3 vee(const Mat3 &S);
+
+} // namespace atl
+#endif
@@ -8,7 +8,7 @@
 
 #include <yaml-cpp/yaml.h>
 
-#include "atl/control/pid.hpp"
+#include "atl/control/multi_pid.hpp"
 #include "atl/control/trajectory.hpp"
 #include "atl/control/trajectory_index.hpp"
 #include "atl/data/data.hpp"
@@ -22,9 +22,7 @@ public:
   std::string mode;
 
   double dt = 0.0;
-  PID x_controller;
-  PID y_controller;
-  PID vz_controller;
+  MultiPID<3> pid; // x, y, vz
 
   double roll_limit[2] = {0.0, 0.0};
   double pitch_limit[2] = {0.0, 0.0};
@@ -0,0 +1,158 @@
+#ifndef ATL_CONTROL_LANDING_MPC_HPP
+#define ATL_CONTROL_LANDING_MPC_HPP
+
+#include <iomanip>
+#include <string>
+
+#include "atl/control/pid.hpp"
+#include "atl/data/data.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+#define LANDING_MPC_HORIZON 20
+
+/**
+ * Model predictive landing controller
+ *
+ * Plans the horizontal approach onto the landing target over a fixed
+ * horizon. Along each horizontal axis the target relative position `e` and
+ * velocity `de` from the tracker are propagated with the horizontal
+ * dynamics of `Quad2DModel`, with the thrust holding the vertical
+ * acceleration at zero. The quadrotor acceleration `a` then follows from
+ * its attitude (`a_x = g tan(pitch)`, `a_y = -g tan(roll)` in NWU) and the
+ * target keeps its estimated velocity:
+ *
+ *     e(k + 1) = e(k) + dt de(k) - 0.5 dt^2 a(k)
+ *     de(k + 1) = de(k) - dt a(k)
+ *
+ * This is a simplification of the quadrotor model, not the full
+ * `QuadrotorModel`. It assumes the attitude is reached within a step, the
+ * thrust compensates the tilt, the two axes are decoupled and there is no
+ * drag or wind. It is a fair model for small roll and pitch and slow
+ * descent. Large angles, fast attitude changes or strong wind are outside
+ * of it and are left to the feedback of re-planning every update.
+ *
+ * The states are eliminated to give a condensed QP in the accelerations
+ * only, with box constraints from the roll and pitch limits. Both axes
+ * share the same Hessian, so it and the unconstrained gain are computed
+ * once in `configure()`. The unconstrained solution is used when it is
+ * feasible, otherwise the QP is solved with accelerated projected gradient
+ * warm started from the previous solution shifted by one step. Vertical
+ * descent keeps the velocity PID of the `LandingController`.
+ */
+class LandingMPC {
+public:
+  static const int N = LANDING_MPC_HORIZON;
+  typedef Eigen::Matrix<double, N, 1> VecN;
+  typedef Eigen::Matrix<double, N, N> MatN;
+  typedef Eigen::Matrix<double, N, 2> MatN2;
+  typedef Eigen::Matrix<double, 2 * N, 2> Mat2N2;
+  typedef Eigen::Matrix<double, 2 * N, N> Mat2NN;
+
+  bool configured = false;
+
+  double dt = 0.0;
+  double horizon_dt = 0.1;
+  double g = 9.81;
+
+  // weights
+  double q_position = 10.0;
+  double q_velocity = 1.0;
+  double q_terminal = 10.0;
+  double r_input = 0.1;
+
+  // solver
+  int max_iter = 200;
+  double tolerance = 1e-6;
+
+  // condensed QP, min 0.5 U' H U + (F s0)' U
+  Mat2N2 Phi = Mat2N2::Zero();
+  Mat2NN Gamma = Mat2NN::Zero();
+  MatN H = MatN::Zero();
+  MatN2 F = MatN2::Zero();
+  MatN2 K = MatN2::Zero();
+  double step_size = 0.0;
+
+  // warm start
+  VecN u_x = VecN::Zero();
+  VecN u_y = VecN::Zero();
+  double shift_dt = 0.0;
+
+  // limits and descent
+  double roll_limit[2] = {0.0, 0.0};
+  double pitch_limit[2] = {0.0, 0.0};
+  PID vz_controller;
+  double hover_throttle = 0.0;
+  double descent_velocity = -0.3;
+
+  // statistics of the last solve
+  double solve_time = 0.0;
+  int nb_iter = 0;
+
+  Vec4 outputs{0.0, 0.0, 0.0, 0.0};
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  LandingMPC() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Invalid horizon or weights
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Build condensed QP from the horizon, weights and model
+   */
+  void buildQP();
+
+  /**
+   * Solve box constrained QP for one axis
+   *
+   * @param s0 Initial relative state (position, velocity)
+   * @param lb Lower acceleration bound
+   * @param ub Upper acceleration bound
+   * @param u Accelerations, holds the warm start on input
+   * @return Number of projected gradient iterations, 0 if the
+   * unconstrained solution was feasible
+   */
+  int solve(const Vec2 &s0, const double lb, const double ub, VecN &u);
+
+  /**
+   * Update controller
+   *
+   * @param pos_errors_B Target position relative to quadrotor
+   * @param vel_errors_B Target velocity relative to quadrotor
+   * @param velocity_W Quadrotor velocity in world frame
+   * @param yaw_setpoint Yaw setpoint
+   * @param dt Time difference in seconds
+   *
+   * @return
+   *    Attitude command as a vector of size 4:
+   *    (roll, pitch, yaw, throttle)
+   */
+  Vec4 update(const Vec3 &pos_errors_B,
+              const Vec3 &vel_errors_B,
+              const Vec3 &velocity_W,
+              const double yaw_setpoint,
+              const double dt);
+
+  /**
+   * Reset controller and warm start
+   */
+  void reset();
+
+  /**
+   * Print controller outputs
+   */
+  void printOutputs();
+};
+
+} // namespace atl
+#endif
@@ -0,0 +1,296 @@
+#ifndef ATL_CONTROL_MULTI_PID_HPP
+#define ATL_CONTROL_MULTI_PID_HPP
+
+#include <float.h>
+#include <math.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Gain schedule
+ *
+ * PID gains tabulated against a scheduling variable (for example the
+ * altitude), one row per breakpoint and one column per axis. Gains between
+ * breakpoints are interpolated linearly and held beyond the first and last
+ * breakpoint.
+ */
+struct GainSchedule {
+  bool loaded = false;
+
+  std::vector<double> breakpoints;
+  MatX k_p;
+  MatX k_i;
+  MatX k_d;
+
+  GainSchedule() {}
+
+  /**
+   * Configure
+   *
+   * The schedule is optional, nothing is loaded if `<prefix>.breakpoints`
+   * is not in the config file.
+   *
+   * @param config_file Path to config file
+   * @param prefix Key of the schedule in the config file
+   * @param nb_axes Number of axes
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Invalid schedule
+   */
+  int configure(const std::string &config_file,
+                const std::string &prefix,
+                const int nb_axes);
+
+  /**
+   * Look up breakpoint interval
+   *
+   * @param x Scheduling variable
+   * @param row Row of the breakpoint at or below `x`
+   * @param alpha Interpolation weight of the row after `row`
+   */
+  void lookup(const double x, int &row, double &alpha) const;
+};
+
+/**
+ * Multi-axis PID controller
+ *
+ * Runs `N` independent PID loops in one call with every gain and state
+ * kept in fixed-size Eigen arrays, so the axes are updated with packed
+ * coefficient-wise operations (`N = 4` maps onto whole SIMD registers)
+ * instead of one scalar `PID` per axis. With the defaults it computes the
+ * same outputs as `PID`, on top of that it supports:
+ *
+ * - Setpoint weighting: the proportional and derivative terms act on
+ *   `b * setpoint - actual` and `c * setpoint - actual`.
+ * - Derivative filter: first order low pass with time constant `tau_d`.
+ * - Anti-windup: conditional integration, the integral is frozen on an
+ *   axis while its output is beyond `output_min` / `output_max` and the
+ *   error would drive it further into saturation. The outputs themselves
+ *   are not clamped, that is left to the caller.
+ * - Gain schedule: gains interpolated from a `GainSchedule` with
+ *   `scheduleGains()`.
+ */
+template <int N>
+class MultiPID {
+public:
+  typedef Eigen::Array<double, N, 1> ArrayN;
+
+  // gains
+  ArrayN k_p = ArrayN::Zero();
+  ArrayN k_i = ArrayN::Zero();
+  ArrayN k_d = ArrayN::Zero();
+
+  // setpoint weights of the proportional and derivative terms
+  ArrayN b = ArrayN::Ones();
+  ArrayN c = ArrayN::Ones();
+
+  // derivative filter time constant in seconds, 0 disables the filter
+  ArrayN tau_d = ArrayN::Zero();
+
+  // saturation limits of the outputs downstream, only used for anti-windup
+  // so the caller still applies its own limits
+  ArrayN output_min = ArrayN::Constant(-FLT_MAX);
+  ArrayN output_max = ArrayN::Constant(FLT_MAX);
+
+  GainSchedule schedule;
+
+  // state
+  ArrayN error_prev = ArrayN::Zero();
+  ArrayN error_sum = ArrayN::Zero();
+  ArrayN derivative = ArrayN::Zero();
+
+  ArrayN error_p = ArrayN::Zero();
+  ArrayN error_i = ArrayN::Zero();
+  ArrayN error_d = ArrayN::Zero();
+  ArrayN outputs = ArrayN::Zero();
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  MultiPID() {}
+
+  /**
+   * Configure
+   *
+   * Loads `k_p`, `k_i`, `k_d` and the optional `tau_d`, `b` and `c` of
+   * every axis from `<axis>.<param>`, and the optional gain schedule from
+   * `gain_schedule`.
+   *
+   * @param config_file Path to config file
+   * @param axes Config key of every axis
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Invalid gain schedule
+   */
+  int configure(const std::string &config_file,
+                const std::vector<std::string> &axes) {
+    // pre-check
+    if ((int) axes.size() != N) {
+      LOG_ERROR("Expected %d PID axes but got %d!", N, (int) axes.size());
+      return -1;
+    }
+
+    // load config
+    ConfigParser parser;
+    for (int i = 0; i < N; i++) {
+      parser.addParam(axes[i] + ".k_p", &this->k_p(i));
+      parser.addParam(axes[i] + ".k_i", &this->k_i(i));
+      parser.addParam(axes[i] + ".k_d", &this->k_d(i));
+      parser.addParam(axes[i] + ".tau_d", &this->tau_d(i), true);
+      parser.addParam(axes[i] + ".b", &this->b(i), true);
+      parser.addParam(axes[i] + ".c", &this->c(i), true);
+    }
+    if (parser.load(config_file) != 0) {
+      return -1;
+    }
+
+    // load gain schedule
+    if (this->schedule.configure(config_file, "gain_schedule", N) != 0) {
+      return -2;
+    }
+
+    return 0;
+  }
+
+  /**
+   * Set gains from gain schedule, does nothing if no schedule is loaded
+   *
+   * @param x Scheduling variable
+   */
+  void scheduleGains(const double x) {
+    if (this->schedule.loaded == false) {
+      return;
+    }
+
+    int row;
+    double alpha;
+    this->schedule.lookup(x, row, alpha);
+
+    const int next = std::min(row + 1, (int) this->schedule.k_p.rows() - 1);
+    for (int i = 0; i < N; i++) {
+      const MatX &k_p = this->schedule.k_p;
+      const MatX &k_i = this->schedule.k_i;
+      const MatX &k_d = this->schedule.k_d;
+      this->k_p(i) = (1.0 - alpha) * k_p(row, i) + alpha * k_p(next, i);
+      this->k_i(i) = (1.0 - alpha) * k_i(row, i) + alpha * k_i(next, i);
+      this->k_d(i) = (1.0 - alpha) * k_d(row, i) + alpha * k_d(next, i);
+    }
+  }
+
+  /**
+   * Update controller
+   *
+   * @param setpoints Setpoints
+   * @param actual Actual
+   * @param dt Difference in time, the previous outputs are returned if it
+   *           is not positive
+   *
+   * @return Controller outputs
+   */
+  ArrayN update(const ArrayN &setpoints,
+                const ArrayN &actual,
+                const double dt) {
+    if (dt <= 0.0) {
+      return this->outputs;
+    }
+
+    const ArrayN errors = setpoints - actual;
+    const ArrayN errors_d = this->c * setpoints - actual;
+    this->updateDerivative(errors_d, dt);
+
+    // conditional integration
+    const ArrayN sum = this->error_sum + errors * dt;
+    const ArrayN u = this->k_p * (this->b * setpoints - actual) +
+                     this->k_i * sum + this->k_d * this->derivative;
+    const auto windup = (u > this->output_max && errors > 0.0) ||
+                        (u < this->output_min && errors < 0.0);
+    this->error_sum = windup.select(this->error_sum, sum);
+
+    this->error_p = this->k_p * (this->b * setpoints - actual);
+    return this->calculateOutputs();
+  }
+
+  /**
+   * Update controller
+   *
+   * @param errors Errors
+   * @param dt Difference in time
+   *
+   * @return Controller outputs
+   */
+  ArrayN update(const ArrayN &errors, const double dt) {
+    return this->update(errors, ArrayN::Zero(), dt);
+  }
+
+  /**
+   * Update controller with an integral measured by the caller instead of
+   * accumulated, for example the position error of a velocity loop
+   *
+   * @param errors Errors
+   * @param error_sums Error integrals
+   * @param dt Difference in time
+   *
+   * @return Controller outputs
+   */
+  ArrayN updateIntegral(const ArrayN &errors,
+                        const ArrayN &error_sums,
+                        const double dt) {
+    if (dt <= 0.0) {
+      return this->outputs;
+    }
+
+    this->updateDerivative(errors, dt);
+    this->error_sum = error_sums;
+    this->error_p = this->k_p * errors;
+    return this->calculateOutputs();
+  }
+
+  /**
+   * Reset controller
+   */
+  void reset() {
+    this->error_prev.setZero();
+    this->error_sum.setZero();
+    this->derivative.setZero();
+
+    this->error_p.setZero();
+    this->error_i.setZero();
+    this->error_d.setZero();
+    this->outputs.setZero();
+  }
+
+  /**
+   * Update filtered derivative
+   *
+   * @param errors_d Errors of the derivative term
+   * @param dt Difference in time
+   */
+  void updateDerivative(const ArrayN &errors_d, const double dt) {
+    const ArrayN rate = (errors_d - this->error_prev) / dt;
+    const ArrayN alpha = dt / (this->tau_d + dt);
+    this->derivative += alpha * (rate - this->derivative);
+    this->error_prev = errors_d;
+  }
+
+  /**
+   * Calculate outputs from the proportional term, integral and derivative
+   *
+   * @return Controller outputs
+   */
+  ArrayN calculateOutputs() {
+    this->error_i = this->k_i * this->error_sum;
+    this->error_d = this->k_d * this->derivative;
+    this->outputs = this->error_p + this->error_i + this->error_d;
+    return this->outputs;
+  }
+};
+
+} // namespace atl
+#endif
@@ -32,7 +32,8 @@ public:
    *
    * @param setpoint Setpoint
    * @param actual Actual
-   * @param dt Difference in time
+   * @param dt Difference in time, the previous output is returned if it is
+   *           not positive
    *
    * @return Controller command
    */
@@ -5,7 +5,7 @@
 
 #include <yaml-cpp/yaml.h>
 
-#include "atl/control/pid.hpp"
+#include "atl/control/multi_pid.hpp"
 #include "atl/data/data.hpp"
 #include "atl/utils/utils.hpp"
 
@@ -19,9 +19,7 @@ public:
   bool configured = false;
 
   double dt = 0.0;
-  PID x_controller;
-  PID y_controller;
-  PID z_controller;
+  MultiPID<3> pid; // x, y, z
 
   double roll_limit[2] = {0.0, 0.0};
   double pitch_limit[2] = {0.0, 0.0};
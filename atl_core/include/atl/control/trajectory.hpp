@@ -1,13 +1,14 @@
 #ifndef ATL_CONTROL_TRAJECTORY_HPP
 #define ATL_CONTROL_TRAJECTORY_HPP
 
-#include <deque>
 #include <iomanip>
 #include <libgen.h>
 #include <string>
+#include <vector>
 
 #include <yaml-cpp/yaml.h>
 
+#include "atl/control/flatness.hpp"
 #include "atl/utils/utils.hpp"
 
 namespace atl {
@@ -16,18 +17,40 @@ namespace atl {
 #define ETCOLS "Trajectory [%s] invalid number of cols!"
 #define ETLOAD "Failed to load trajectory!"
 
+/**
+ * Trajectory
+ *
+ * The waypoints are stored as one contiguous array per field, loaded once
+ * and never popped. `cursor` is the first waypoint of the segment being
+ * tracked, it only moves forward. `update()` advances it past every
+ * segment the robot has passed, however many, then looks `search_window`
+ * segments further ahead for a closer one. Each segment is passed at most
+ * once, so an update costs O(1) amortized and never allocates or frees
+ * memory.
+ */
 class Trajectory {
 public:
   bool loaded = false;
   int index = -1;
 
-  std::deque<Vec2> pos;
-  std::deque<Vec2> vel;
-  std::deque<Vec2> inputs;
-  std::deque<Vec2> rel_pos;
-  std::deque<Vec2> rel_vel;
+  std::vector<Vec2, Eigen::aligned_allocator<Vec2>> pos;
+  std::vector<Vec2, Eigen::aligned_allocator<Vec2>> vel;
+  std::vector<Vec2, Eigen::aligned_allocator<Vec2>> inputs;
+  std::vector<Vec2, Eigen::aligned_allocator<Vec2>> rel_pos;
+  std::vector<Vec2, Eigen::aligned_allocator<Vec2>> rel_vel;
   Vec3 p0{0.0, 0.0, 0.0};
 
+  // segment tracking
+  int cursor = 0;
+  int search_window = 10;
+
+  // flatness feed-forward, rows are `dt` seconds apart and `wp_time` is the
+  // time along the trajectory of the last waypoint, `plan` is built by
+  // `planFeedForward()` after a load
+  double dt = 0.1;
+  double wp_time = 0.0;
+  FlatnessPlan plan;
+
   Trajectory() {}
 
   /**
@@ -37,12 +60,47 @@ public:
    * @param filepath Trajectory filepath
    * @param pos Robot position in inertial frame
    *
-   * @return 0 for success, -1 for failure
+   * @return
+   *    - 0: Success
+   *    - -1: File not found
+   *    - -2: Invalid trajectory
    */
   int load(const int index, const std::string &filepath, const Vec3 &pos);
 
   /**
-   * Update trajectory
+   * Load trajectory from data
+   *
+   * @param index Trajectory index
+   * @param traj_data Trajectory data, at least two rows, one per waypoint
+   * with the columns of a trajectory file
+   * @param pos Robot position in inertial frame
+   *
+   * @return
+   *    - 0: Success
+   *    - -2: Invalid trajectory
+   */
+  int load(const int index, const MatX &traj_data, const Vec3 &pos);
+
+  /**
+   * Load trajectory from row-major records, e.g. of a `TrajectoryLibrary`
+   *
+   * @param index Trajectory index
+   * @param records Trajectory records, 10 floats per waypoint
+   * @param nb_rows Number of waypoints
+   * @param pos Robot position in inertial frame
+   *
+   * @return
+   *    - 0: Success
+   *    - -2: Invalid trajectory
+   */
+  int load(const int index,
+           const float *records,
+           const int nb_rows,
+           const Vec3 &pos);
+
+  /**
+   * Update trajectory, the waypoint is held at the first or last waypoint
+   * when the robot is before the start or past the end of the trajectory
    *
    * @param pos Robot position in inertial frame
    * @param wp_pos Waypoint position in inertial frame
@@ -53,6 +111,53 @@ public:
    */
   int update(const Vec3 &pos, Vec2 &wp_pos, Vec2 &wp_vel, Vec2 &wp_inputs);
 
+  /**
+   * Sample trajectory at time, interpolating between waypoints. Times
+   * outside of the trajectory are held at the first or last waypoint
+   *
+   * @param t Time since start of trajectory in seconds
+   * @param wp_pos Waypoint position
+   * @param wp_vel Waypoint velocity
+   * @param wp_inputs Waypoint inputs
+   *
+   * @return 0 for success, -1 for failure
+   */
+  int sample(const double t, Vec2 &wp_pos, Vec2 &wp_vel, Vec2 &wp_inputs) const;
+
+  /**
+   * Plan the flatness feed-forward of the loaded trajectory, O(n) and
+   * allocates, so call it after a load and not per control tick
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Not loaded
+   *    - -2: Failed to plan feed-forward
+   */
+  int planFeedForward();
+
+  /**
+   * Flatness feed-forward at the last waypoint of `update()`, constant time
+   *
+   * @param state State and inputs
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Feed-forward not planned
+   */
+  int feedForward(FlatState &state) const;
+
+  /**
+   * Project onto segment
+   *
+   * @param i Segment, from waypoint `i` to `i + 1`
+   * @param q_pos Query position
+   * @param closest Closest point on the line through the segment
+   *
+   * @return Position of `closest` along the segment, 0 at its start and 1
+   * at its end, 1 for a segment of zero length
+   */
+  double project(const int i, const Vec2 &q_pos, Vec2 &closest) const;
+
   /**
    * Reset trajectory
    */
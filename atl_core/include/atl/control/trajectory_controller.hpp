@@ -8,14 +8,22 @@
 
 #include <yaml-cpp/yaml.h>
 
-#include "atl/control/pid.hpp"
+#include "atl/control/multi_pid.hpp"
 #include "atl/control/trajectory.hpp"
 #include "atl/control/trajectory_index.hpp"
 #include "atl/data/data.hpp"
+#include "atl/planning/min_snap.hpp"
 #include "atl/utils/utils.hpp"
 
 namespace atl {
 
+/**
+ * Feed-forward of `TrajectoryController`, "inputs" interpolates the thrust
+ * and pitch inputs of the trajectory file, "flatness" evaluates the
+ * flatness plan of the trajectory
+ */
+enum FeedForward { FEED_FORWARD_INPUTS, FEED_FORWARD_FLATNESS };
+
 class TrajectoryController {
 public:
   bool configured = false;
@@ -24,23 +32,7 @@ public:
   double dt = 0.0;
   double blackbox_dt = 0.0;
 
-  double vx_error_prev = 0.0;
-  double vy_error_prev = 0.0;
-  double vz_error_prev = 0.0;
-
-  double vx_error_sum = 0.0;
-
-  double vx_k_p = 0.0;
-  double vx_k_i = 0.0;
-  double vx_k_d = 0.0;
-
-  double vy_k_p = 0.0;
-  double vy_k_i = 0.0;
-  double vy_k_d = 0.0;
-
-  double vz_k_p = 0.0;
-  double vz_k_i = 0.0;
-  double vz_k_d = 0.0;
+  MultiPID<3> pid; // vx, vy, vz
 
   double roll_limit[2] = {0.0, 0.0};
   double pitch_limit[2] = {0.0, 0.0};
@@ -50,20 +42,23 @@ public:
   Vec4 outputs{0.0, 0.0, 0.0, 0.0};
 
   TrajectoryIndex traj_index;
+  MinSnapGenerator generator;
   Vec3 trajectory_threshold{1.0, 1.0, 1.0};
   Trajectory trajectory;
 
+  // feed-forward, the flatness plan of a trajectory is planned when it is
+  // loaded and evaluated every update
+  enum FeedForward feed_forward = FEED_FORWARD_INPUTS;
+  double hover_throttle = 0.5;
+  FlatState wp_state;
+
   bool blackbox_enable = false;
-  double blackbox_rate = FLT_MAX;
-  std::ofstream blackbox;
+  double blackbox_rate = FLT_MAX; // seconds between records
+  FlightRecorder blackbox;
 
-  TrajectoryController() {}
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
-  ~TrajectoryController() {
-    if (this->blackbox_enable && this->blackbox) {
-      this->blackbox.close();
-    }
-  }
+  TrajectoryController() {}
 
   /**
    * Configure
@@ -76,16 +71,28 @@ public:
   /**
    * Load trajectory
    *
+   * With a trajectory generator configured the trajectory is generated
+   * online in the vertical plane towards the target, from the actual height
+   * and `v` to a rendezvous with the target. The target is predicted at its
+   * estimated velocity projected onto that plane. Otherwise it is looked up
+   * in the trajectory index by height and `v`. With flatness feed-forward
+   * the flatness plan of the trajectory is planned here, off the control
+   * path.
+   *
    * @param pos Robot position in inertial frame
    * @param target_pos_B Target position in body frame
-   * @param v Robot velocity in inertial frame
+   * @param target_vel_B Estimated target velocity in body frame
+   * @param v Robot velocity towards the target
    *
    * @return 0 for success, -1 for failure
    */
-  int loadTrajectory(const Vec3 &pos, const Vec3 &target_pos_B, const double v);
+  int loadTrajectory(const Vec3 &pos,
+                     const Vec3 &target_pos_B,
+                     const Vec3 &target_vel_B,
+                     const double v);
 
   /**
-   * Prepare blackbox
+   * Prepare blackbox flight log
    *
    * @param blackbox_file Path to save blackbox
    *
@@ -94,14 +101,8 @@ public:
   int prepBlackbox(const std::string &blackbox_file);
 
   /**
-   * Record trajectory index
-   *
-   * @return 0 for success, -1 for failure
-   */
-  int recordTrajectoryIndex();
-
-  /**
-   * Record landing data
+   * Record landing data and the trajectory index, at most once every
+   * `blackbox_rate` seconds
    *
    * @param pos Robot position
    * @param vel Robot velocity
@@ -114,7 +115,7 @@ public:
    * @param thrust Relative thrust (0, 1.0)
    * @param dt Time diffrence in seconds
    *
-   * @return 0 for success, -1 for failure
+   * @return 0 for success, -1 if the row was dropped
    */
   int record(const Vec3 &pos,
              const Vec3 &vel,
@@ -1,15 +1,19 @@
 #ifndef ATL_CONTROL_TRAJECTORY_INDEX_HPP
 #define ATL_CONTROL_TRAJECTORY_INDEX_HPP
 
+#include <algorithm>
 #include <deque>
 #include <iomanip>
 #include <libgen.h>
+#include <queue>
 #include <string>
+#include <vector>
 
 #include <yaml-cpp/yaml.h>
 
 #include "atl/control/pid.hpp"
 #include "atl/control/trajectory.hpp"
+#include "atl/control/trajectory_library.hpp"
 #include "atl/utils/utils.hpp"
 
 namespace atl {
@@ -19,6 +23,49 @@ namespace atl {
 #define ETIFAIL "Found no trajectory for z = %f, v = %f"
 #define TLOAD "Loaded trajectory @ z = %f, v = %f"
 
+/**
+ * Trajectory found in the index
+ *
+ * - `row`: Row in the index
+ * - `index`: Trajectory index, the trajectory file is `<index>.csv`
+ * - `z`, `v`: Start height and velocity of the trajectory
+ * - `distance`: Distance to the query, see `TrajectoryIndex`
+ */
+struct TrajectoryMatch {
+  int row = -1;
+  int index = -1;
+  double z = 0.0;
+  double v = 0.0;
+  double distance = 0.0;
+};
+
+/**
+ * Node of the k-d tree over the index, coordinates are normalized by the
+ * thresholds
+ */
+struct TrajectoryIndexNode {
+  double z = 0.0;
+  double v = 0.0;
+  int row = -1;
+};
+
+/**
+ * Trajectory index
+ *
+ * Trajectories are indexed by start height `z` and velocity `v`. The
+ * distance between `(z, v)` and a trajectory is the euclidean distance with
+ * the height difference scaled by `pos_thres` and the velocity difference
+ * by `vel_thres`
+ *
+ *     d = sqrt((dz / pos_thres)^2 + (dv / vel_thres)^2)
+ *
+ * A 2D k-d tree over the normalized `(z, v)` of every row is built at load
+ * time, so finding the nearest trajectory is O(log n) instead of a scan.
+ *
+ * The index is either a CSV index file, whose trajectories are parsed from
+ * `<index>.csv` files when found, or a memory-mapped `TrajectoryLibrary`,
+ * whose trajectories are read from memory without file I/O.
+ */
 class TrajectoryIndex {
 public:
   bool loaded = false;
@@ -27,6 +74,8 @@ public:
   MatX index_data{MatX::Zero(1, 1)};
   double pos_thres = 0.0;
   double vel_thres = 0.0;
+  std::vector<TrajectoryIndexNode> tree;
+  TrajectoryLibrary library;
 
   TrajectoryIndex() {}
 
@@ -41,14 +90,95 @@ public:
    *    - 0: Success
    *    - -1: Failed to find index file
    *    - -2: Failed to load index file
+   *    - -3: Invalid thresholds
    */
   int load(const std::string &index_file,
            const double pos_thres = 0.2,
            const double vel_thres = 0.2);
 
+  /**
+   * Load trajectory index and trajectories from a trajectory library
+   *
+   * @param library_file Trajectory library file
+   * @param pos_thres Position threshold (m)
+   * @param vel_thres Velocity threshold (m/s)
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to open library file
+   *    - -2: Invalid library file
+   *    - -3: Invalid thresholds
+   */
+  int loadLibrary(const std::string &library_file,
+                  const double pos_thres = 0.2,
+                  const double vel_thres = 0.2);
+
+  /**
+   * Build k-d tree over `index_data`, called by `load()`
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Invalid index data or thresholds
+   */
+  int build();
+
+  /**
+   * Find nearest trajectory within the thresholds, that is with
+   * `|dz| < pos_thres` and `|dv| < vel_thres`
+   *
+   * @param z Start height
+   * @param v Start velocity
+   * @param match Nearest trajectory
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Trajectory index not loaded yet
+   *    - -2: Found no trajectory
+   */
+  int nearest(const double z, const double v, TrajectoryMatch &match) const;
+
+  /**
+   * Find the k nearest trajectories regardless of the thresholds, e.g. to
+   * blend between them
+   *
+   * @param z Start height
+   * @param v Start velocity
+   * @param k Number of trajectories
+   * @param matches Nearest trajectories sorted by distance, fewer than `k`
+   * if the index has fewer rows
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Trajectory index not loaded yet
+   */
+  int nearest(const double z,
+              const double v,
+              const int k,
+              std::vector<TrajectoryMatch> &matches) const;
+
+  /**
+   * Find trajectory based on relative position and velocity
+   * to landing target, the nearest one within the thresholds is loaded
+   *
+   * @param pos Relative position
+   * @param vel Relative velocity
+   * @param traj Found trajectory
+   * @param match Found trajectory in the index
+   *
+   * @return
+   *    - 0: for success
+   *    - -1: Trajectory index not loaded yet
+   *    - -2: Found no trajectory
+   *    - -3: Failed to load trajectory
+   */
+  int find(const Vec3 &pos,
+           const double vel,
+           Trajectory &traj,
+           TrajectoryMatch &match);
+
   /**
    * Find trajectory based on relative position and velocity
-   * to landing target
+   * to landing target, the nearest one within the thresholds is loaded
    *
    * @param pos Relative position
    * @param vel Relative velocity
@@ -61,6 +191,26 @@ public:
    *    - -3: Failed to load trajectory
    */
   int find(const Vec3 &pos, const double vel, Trajectory &traj);
+
+  typedef std::priority_queue<std::pair<double, int>> Candidates;
+
+  /**
+   * Search the k-d tree nodes in `[lo, hi)` split along `axis`, keeping the
+   * `k` nearest in `candidates` as (squared distance, node)
+   */
+  void search(const size_t lo,
+              const size_t hi,
+              const int axis,
+              const double z,
+              const double v,
+              const size_t k,
+              const bool within_thres,
+              Candidates &candidates) const;
+
+  /**
+   * Trajectory match of k-d tree node
+   */
+  TrajectoryMatch toMatch(const int node, const double dist2) const;
 };
 
 } // namespace atl
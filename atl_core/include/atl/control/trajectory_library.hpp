@@ -0,0 +1,131 @@
+#ifndef ATL_CONTROL_TRAJECTORY_LIBRARY_HPP
+#define ATL_CONTROL_TRAJECTORY_LIBRARY_HPP
+
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+#define TRAJ_LIBRARY_MAGIC "ATLTRAJ\n"
+#define TRAJ_LIBRARY_VERSION 1
+#define TRAJ_LIBRARY_COLS 10
+
+/**
+ * Trajectory library header
+ */
+struct TrajectoryLibraryHeader {
+  char magic[8];
+  uint32_t version = TRAJ_LIBRARY_VERSION;
+  uint32_t nb_trajectories = 0;
+  uint32_t nb_cols = TRAJ_LIBRARY_COLS;
+  uint32_t reserved = 0;
+  uint64_t nb_rows = 0;
+};
+
+/**
+ * Trajectory library index entry
+ *
+ * - `index`: Trajectory index, `<index>.csv` in the CSV directory
+ * - `nb_rows`: Number of records of the trajectory
+ * - `offset`: First record of the trajectory
+ * - `z`, `v`: Start height and velocity of the trajectory
+ */
+struct TrajectoryLibraryEntry {
+  int32_t index = -1;
+  uint32_t nb_rows = 0;
+  uint64_t offset = 0;
+  double z = 0.0;
+  double v = 0.0;
+};
+
+/**
+ * Trajectory library
+ *
+ * Compiled form of a trajectory index and its trajectory CSV files, in one
+ * binary file:
+ *
+ *     TrajectoryLibraryHeader header
+ *     TrajectoryLibraryEntry entries[nb_trajectories]
+ *     float records[nb_rows][nb_cols]
+ *
+ * in native byte order. The columns of a record are the columns of a
+ * trajectory CSV file (x, vx, z, vz, az, theta, rel_x, rel_z, rel_vx,
+ * rel_vz). `open()` memory-maps the whole file and faults it in, so looking
+ * up a trajectory afterwards is pointer arithmetic without file I/O or
+ * parsing. Copies of a library share the mapping, it is unmapped with the
+ * last copy. Create a library with `trajectory_library_create()`.
+ */
+class TrajectoryLibrary {
+public:
+  bool loaded = false;
+  std::string file_path;
+
+  std::shared_ptr<const char> data;
+  size_t size = 0;
+  const TrajectoryLibraryHeader *header = nullptr;
+  const TrajectoryLibraryEntry *entries = nullptr;
+  const float *records = nullptr;
+
+  TrajectoryLibrary() {}
+
+  /**
+   * Open and memory-map trajectory library
+   *
+   * @param file_path Path to trajectory library
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to open or map file
+   *    - -2: Invalid trajectory library
+   */
+  int open(const std::string &file_path);
+
+  /**
+   * Unmap trajectory library, once no copy uses it anymore
+   */
+  void close();
+
+  /**
+   * @return Number of trajectories in library
+   */
+  int nbTrajectories() const;
+
+  /**
+   * Records of trajectory
+   *
+   * @param row Row in the index table
+   * @param nb_rows Number of records
+   * @return Pointer to the first record, or nullptr if not loaded or out of
+   * range
+   */
+  const float *trajectory(const int row, int &nb_rows) const;
+};
+
+/**
+ * Create trajectory library from a trajectory index and the trajectory CSV
+ * files `<index>.csv` next to it
+ *
+ * @param index_file Trajectory index file, columns (index, p0_z, v)
+ * @param library_file Output trajectory library
+ * @return
+ *    - 0: Success
+ *    - -1: Failed to load trajectory index
+ *    - -2: Failed to load trajectory
+ *    - -3: Failed to write trajectory library
+ */
+int trajectory_library_create(const std::string &index_file,
+                              const std::string &library_file);
+
+} // namespace atl
+#endif
@@ -5,7 +5,7 @@
 
 #include <yaml-cpp/yaml.h>
 
-#include "atl/control/pid.hpp"
+#include "atl/control/multi_pid.hpp"
 #include "atl/data/data.hpp"
 #include "atl/utils/utils.hpp"
 
@@ -19,9 +19,7 @@ public:
   bool configured = false;
 
   double dt = 0.0;
-  PID vx_controller;
-  PID vy_controller;
-  PID vz_controller;
+  MultiPID<3> pid; // vx, vy, vz
 
   double roll_limit[2] = {0.0, 0.0};
   double pitch_limit[2] = {0.0, 0.0};
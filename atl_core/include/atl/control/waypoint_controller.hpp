@@ -7,7 +7,7 @@
 
 #include <yaml-cpp/yaml.h>
 
-#include "atl/control/pid.hpp"
+#include "atl/control/multi_pid.hpp"
 #include "atl/data/data.hpp"
 #include "atl/mission/mission.hpp"
 #include "atl/utils/utils.hpp"
@@ -26,10 +26,7 @@ public:
 
   double dt = 0.0;
 
-  PID at_controller;
-  PID ct_controller;
-  PID z_controller;
-  PID yaw_controller;
+  MultiPID<3> pid; // along-track, cross-track, z
 
   double roll_limit[2] = {0.0, 0.0};
   double pitch_limit[2] = {0.0, 0.0};
@@ -39,9 +36,10 @@ public:
   Vec4 outputs{0.0, 0.0, 0.0, 0.0};
 
   bool blackbox_enable = true;
-  double blackbox_rate = 1.0;
+  double blackbox_rate = 1.0; // seconds between records
   double blackbox_dt = 0.0;
-  std::ofstream blackbox;
+  std::string blackbox_file = "/tmp/blackbox.dat";
+  FlightRecorder blackbox;
 
   WaypointController() {}
 
@@ -57,7 +55,7 @@ public:
   int configure(const std::string &config_file);
 
   /**
-   * Prepare black box file
+   * Prepare black box flight log
    *
    * @param blackbox_file Path to store black box file
    * @return
@@ -67,15 +65,15 @@ public:
   int prepBlackbox(const std::string &blackbox_file);
 
   /**
-   * Record position and waypoint
+   * Record position and waypoint, at most once every `blackbox_rate`
+   * seconds
    *
    * @param pos Position
    * @param waypoint Waypoint
-   * @param dt Difference in time (seconds)
    *
    * @return
    *    - 0: Success
-   *    - -1: Failure
+   *    - -1: Row dropped
    */
   int record(const Vec3 &pos, const Vec3 &waypoint);
 
@@ -1,19 +1,30 @@
 #ifndef ATL_DATA_LANDING_TARGET_HPP
 #define ATL_DATA_LANDING_TARGET_HPP
 
+#include <functional>
+
 #include "atl/utils/utils.hpp"
 
 namespace atl {
 
+/**
+ * Landing target
+ *
+ * `first_seen` and `last_seen` are read from `clock` in seconds, -1 if the
+ * target has not been seen. The clock defaults to `CLOCK_MONOTONIC`, the
+ * quadrotor sets it to its own so a simulated clock also drives the lost
+ * target timeout.
+ */
 struct LandingTarget {
   Vec3 position_B{0.0, 0.0, 0.0};
   Vec3 velocity_B{0.0, 0.0, 0.0};
   bool detected = false;
   bool losted = true;
-  struct timespec first_seen = {0, 0};
-  struct timespec last_seen = {0, 0};
+  double first_seen = -1.0;
+  double last_seen = -1.0;
 
   double lost_threshold = 1000.0;
+  std::function<double(void)> clock = time_monotonic;
 
   LandingTarget() {}
   bool isTargetLosted();
@@ -116,8 +116,43 @@ public:
   int measurementUpdate(const VecX &h, const MatX &H, const VecX &y);
 };
 
+/**
+ * Two wheel process model
+ *
+ * State vector: x, y, z, theta, v, vz, omega, a, az
+ *
+ * @param x State
+ * @param dt Time difference in seconds
+ * @param g Propagated state
+ */
+void two_wheel_process_model(const Eigen::Ref<const VecX> &x,
+                             const double dt,
+                             Eigen::Ref<VecX> g);
+
+/**
+ * Linearized two wheel process model
+ *
+ * @param x State
+ * @param dt Time difference in seconds
+ * @param G Jacobian of process model evaluated at `x`
+ */
+void two_wheel_process_jacobian(const Eigen::Ref<const VecX> &x,
+                                const double dt,
+                                Eigen::Ref<MatX> G);
+
 void two_wheel_process_model(EKFTracker &ekf, MatX &G, VecX &g, double dt);
 
+/**
+ * Two wheel measurement model
+ *
+ * Measurement vector: x, y, z, theta
+ *
+ * @param x State
+ * @param h Expected measurement
+ */
+void two_wheel_measurement_model(const Eigen::Ref<const VecX> &x,
+                                 Eigen::Ref<VecX> h);
+
 void two_wheel_measurement_model(EKFTracker &ekf, MatX &H, VecX &h);
 
 } // namespace atl
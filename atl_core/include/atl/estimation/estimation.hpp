@@ -2,7 +2,12 @@
 #define ATL_ESTIMATION_HPP
 
 #include "atl/estimation/ekf_tracker.hpp"
+#include "atl/estimation/inertial_filter.hpp"
+#include "atl/estimation/inertial_replay.hpp"
 #include "atl/estimation/kf.hpp"
 #include "atl/estimation/kf_tracker.hpp"
+#include "atl/estimation/rts_smoother.hpp"
+#include "atl/estimation/tracker_bank.hpp"
+#include "atl/estimation/ukf_tracker.hpp"
 
 #endif
@@ -0,0 +1,191 @@
+#ifndef ATL_ESTIMATION_INERTIAL_FILTER_HPP
+#define ATL_ESTIMATION_INERTIAL_FILTER_HPP
+
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+#define INS_NB_ERROR_STATES 15
+
+/**
+ * Timestamped IMU sample
+ */
+struct IMUSample {
+  double t = 0.0;
+  Vec3 accel{0.0, 0.0, 0.0}; // body frame specific force [m/s^2]
+  Vec3 gyro{0.0, 0.0, 0.0};  // body frame angular velocity [rad/s]
+
+  IMUSample() {}
+  IMUSample(const double t, const Vec3 &accel, const Vec3 &gyro)
+      : t{t}, accel{accel}, gyro{gyro} {}
+};
+
+/**
+ * Error-state inertial navigation filter
+ *
+ * The nominal state (position, velocity, orientation and IMU biases in the
+ * NWU world frame) is integrated at IMU rate, while a 15 element error state
+ * (position, velocity, attitude, accelerometer bias, gyroscope bias) and its
+ * covariance are corrected whenever a GPS position, velocity or attitude
+ * measurement arrives. After each correction the error state is injected
+ * into the nominal state and reset to zero.
+ *
+ * Every input carries its own timestamp, the filter never reads a clock. A
+ * correction newer than the last IMU sample first propagates the state up
+ * to the measurement time by holding the last IMU sample, a correction
+ * older than `max_latency` seconds is rejected.
+ */
+class InertialFilter {
+public:
+  // clang-format off
+  typedef Eigen::Matrix<double, INS_NB_ERROR_STATES, 1> ErrorVec;
+  typedef Eigen::Matrix<double, INS_NB_ERROR_STATES, INS_NB_ERROR_STATES> ErrorMat;
+  typedef Eigen::Matrix<double, 3, INS_NB_ERROR_STATES> MeasurementMat;
+  typedef Eigen::Matrix<double, INS_NB_ERROR_STATES, 3> GainMat;
+  // clang-format on
+
+  bool configured = false;
+  bool initialized = false;
+  std::string config_file;
+
+  // noise densities
+  double accel_noise = 0.1;       // [m/s^2 / sqrt(Hz)]
+  double gyro_noise = 0.01;       // [rad/s / sqrt(Hz)]
+  double accel_bias_noise = 1e-3; // [m/s^3 / sqrt(Hz)]
+  double gyro_bias_noise = 1e-4;  // [rad/s^2 / sqrt(Hz)]
+
+  // measurement noise, standard deviation per axis
+  Vec3 position_noise{1.0, 1.0, 2.0};    // [m]
+  Vec3 velocity_noise{0.1, 0.1, 0.1};    // [m/s]
+  Vec3 attitude_noise{0.01, 0.01, 0.05}; // [rad]
+
+  // initial error state standard deviation
+  double init_position_std = 1.0;
+  double init_velocity_std = 1.0;
+  double init_attitude_std = 0.1;
+  double init_accel_bias_std = 0.1;
+  double init_gyro_bias_std = 0.01;
+
+  // timing
+  double max_dt = 0.1;      // IMU gaps larger than this are not integrated
+  double max_latency = 0.2; // corrections older than this are rejected
+
+  Vec3 gravity{0.0, 0.0, -9.81};
+
+  // nominal state
+  double t = 0.0;
+  Vec3 position{0.0, 0.0, 0.0};
+  Vec3 velocity{0.0, 0.0, 0.0};
+  Quaternion orientation{1.0, 0.0, 0.0, 0.0};
+  Vec3 accel_bias{0.0, 0.0, 0.0};
+  Vec3 gyro_bias{0.0, 0.0, 0.0};
+
+  // error state covariance
+  ErrorMat P = ErrorMat::Identity();
+
+  // last IMU sample
+  bool imu_received = false;
+  IMUSample imu_last;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  InertialFilter() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return 0 for success, -1 for failure
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Initialize
+   *
+   * @param t Time in seconds
+   * @param position Position in world frame
+   * @param velocity Velocity in world frame
+   * @param orientation Orientation of body in world frame
+   * @return 0 for success, -1 for failure
+   */
+  int initialize(const double t,
+                 const Vec3 &position,
+                 const Vec3 &velocity,
+                 const Quaternion &orientation);
+
+  /**
+   * Integrate nominal state and error covariance over a time step
+   *
+   * @param imu IMU sample, held constant over the time step
+   * @param dt Time step in seconds
+   */
+  void integrate(const IMUSample &imu, const double dt);
+
+  /**
+   * Propagate nominal state and error covariance with IMU sample
+   *
+   * @param imu IMU sample
+   * @return
+   *    - 0: Success
+   *    - -1: Not initialized
+   *    - -2: Sample is older than current state, ignored
+   *    - -3: Gap since last sample exceeds `max_dt`, not integrated
+   */
+  int propagate(const IMUSample &imu);
+
+  /**
+   * Correct with GPS position
+   *
+   * @param t Time of measurement in seconds
+   * @param position Measured position in world frame
+   * @return
+   *    - 0: Success
+   *    - -1: Not initialized
+   *    - -2: Measurement too old
+   */
+  int correctPosition(const double t, const Vec3 &position);
+
+  /**
+   * Correct with velocity
+   *
+   * @param t Time of measurement in seconds
+   * @param velocity Measured velocity in world frame
+   * @return
+   *    - 0: Success
+   *    - -1: Not initialized
+   *    - -2: Measurement too old
+   */
+  int correctVelocity(const double t, const Vec3 &velocity);
+
+  /**
+   * Correct with attitude
+   *
+   * @param t Time of measurement in seconds
+   * @param orientation Measured orientation of body in world frame
+   * @return
+   *    - 0: Success
+   *    - -1: Not initialized
+   *    - -2: Measurement too old
+   */
+  int correctAttitude(const double t, const Quaternion &orientation);
+
+  /**
+   * Bring filter up to the time of a correction
+   *
+   * @param t Time of measurement in seconds
+   * @return 0 for success, -1 if not initialized, -2 if too old
+   */
+  int catchUp(const double t);
+
+  /**
+   * Kalman update of the error state and injection into nominal state
+   *
+   * @param H Measurement matrix
+   * @param r Measurement residual
+   * @param noise Measurement noise standard deviation per axis
+   */
+  void correct(const MeasurementMat &H, const Vec3 &r, const Vec3 &noise);
+};
+
+} // namespace atl
+#endif
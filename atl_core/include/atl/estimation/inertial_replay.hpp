@@ -0,0 +1,76 @@
+#ifndef ATL_ESTIMATION_INERTIAL_REPLAY_HPP
+#define ATL_ESTIMATION_INERTIAL_REPLAY_HPP
+
+#include <time.h>
+
+#include "atl/estimation/inertial_filter.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Replay recorded sensor streams through an `InertialFilter`
+ *
+ * Each stream is a matrix with one timestamped measurement per row:
+ *
+ * - `imu`: t, ax, ay, az, wx, wy, wz (body frame, m/s^2 and rad/s)
+ * - `gps`: t, x, y, z (local NWU position relative to home)
+ * - `velocity`: t, vx, vy, vz (NWU)
+ * - `attitude`: t, qw, qx, qy, qz (body to NWU)
+ *
+ * The streams are merged by timestamp, with IMU samples first on ties, so a
+ * replay is fully deterministic. By default the replay runs as fast as
+ * possible, set `speed` to pace it relative to real time instead.
+ */
+class InertialReplay {
+public:
+  MatX imu;
+  MatX gps;
+  MatX velocity;
+  MatX attitude;
+
+  // replay speed relative to real time, 0 runs as fast as possible
+  double speed = 0.0;
+
+  // estimates recorded after every IMU sample, one row per sample:
+  // t, x, y, z, vx, vy, vz, qw, qx, qy, qz, bax, bay, baz, bgx, bgy, bgz
+  MatX estimates;
+  int nb_rejected = 0;
+
+  InertialReplay() {}
+
+  /**
+   * Load sensor streams from a directory containing `imu.csv` and
+   * optionally `gps.csv`, `velocity.csv` and `attitude.csv`, each with a
+   * header row
+   *
+   * @param data_dir Path to data directory
+   * @return 0 for success, -1 for failure
+   */
+  int load(const std::string &data_dir);
+
+  /**
+   * Replay sensor streams through filter
+   *
+   * If the filter is not initialized yet, it is initialized from the first
+   * GPS and attitude measurements, and earlier IMU samples are skipped.
+   *
+   * @param filter Configured inertial filter
+   * @return
+   *    - 0: Success
+   *    - -1: Filter not configured
+   *    - -2: No IMU data
+   */
+  int run(InertialFilter &filter);
+
+  /**
+   * Save recorded estimates as csv
+   *
+   * @param output_path Output file path
+   * @return 0 for success, -1 for failure
+   */
+  int save(const std::string &output_path);
+};
+
+} // namespace atl
+#endif
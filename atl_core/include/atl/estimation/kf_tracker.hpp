@@ -2,6 +2,7 @@
 #define ATL_ESTIMATION_KF_TRACKER_HPP
 
 #include "atl/utils/utils.hpp"
+#include "atl/vision/apriltag/data.hpp"
 
 namespace atl {
 
@@ -60,6 +61,24 @@ public:
   double sanity_dist;
   std::string config_file;
 
+  // innovation gating
+  double gate_threshold;
+  int max_rejected;
+  int nb_rejected;
+  double nis;
+
+  // measurement noise scaling by detection confidence
+  bool noise_scaling;
+  double ref_range;
+  double ref_decision_margin;
+  double ref_area;
+  double min_noise_scale;
+  double max_noise_scale;
+
+  // adaptive noise estimation
+  bool adaptive_noise;
+  double adaptive_alpha;
+
   VecX mu;
 
   MatX B;
@@ -81,7 +100,58 @@ public:
   int checkDimensions();
   int reset(VecX mu);
   int sanityCheck(Vec3 prev_pos, Vec3 curr_pos);
-  int estimate(MatX A, VecX y);
+
+  /**
+   * Measurement noise scale given detection confidence, the noise grows
+   * with the square of the tag range and shrinks with the decision margin
+   * and pixel area of the tag. Fields of the tag that are 0 are ignored.
+   *
+   * @param tag Tag detection
+   * @return Measurement noise scale
+   */
+  double noiseScale(const TagPose &tag);
+
+  /**
+   * Prediction only, used while there is no measurement. The innovation
+   * gate, the count of rejected measurements and the noise are left as is.
+   *
+   * @param A Transition matrix
+   * @return
+   *    - 0: Success
+   *    - -1: Not initialized
+   *    - -2: Invalid dimensions
+   */
+  int predict(MatX A);
+
+  /**
+   * Estimate
+   *
+   * The measurement is rejected if its normalized innovation squared
+   * exceeds `gate_threshold`, the estimate is then the prediction. If the
+   * measurement matrix C is all zero there is no measurement and the filter
+   * only predicts, see `predict()`.
+   *
+   * @param A Transition matrix
+   * @param y Measurement
+   * @param noise_scale Measurement noise scale
+   * @return
+   *    - 0: Success
+   *    - -1: Not initialized
+   *    - -2: Invalid dimensions
+   *    - -3: Measurement rejected
+   *    - -4: More than `max_rejected` consecutive measurements rejected
+   */
+  int estimate(MatX A, VecX y, const double noise_scale = 1.0);
+
+  /**
+   * Estimate with measurement noise scaled by detection confidence, a tag
+   * that was not detected only predicts
+   *
+   * @param A Transition matrix
+   * @param tag Tag detection
+   * @return See `estimate()`
+   */
+  int estimate(MatX A, const TagPose &tag);
 };
 
 } // namespace atl
@@ -0,0 +1,126 @@
+#ifndef ATL_ESTIMATION_RTS_SMOOTHER_HPP
+#define ATL_ESTIMATION_RTS_SMOOTHER_HPP
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "atl/estimation/kf.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Rauch-Tung-Striebel smoother
+ *
+ * Records the forward pass of a linear `KF` over a flight (the transition
+ * matrix, predicted and filtered estimates and covariances of every step)
+ * and smooths it with a single backward pass. Every quantity is stored in
+ * one contiguous array, step after step, so recording a step does not
+ * allocate once `reserve()` has been called.
+ */
+class RTSSmoother {
+public:
+  int nb_states = 0;
+  int nb_steps = 0;
+
+  // forward pass
+  std::vector<double> A;
+  std::vector<double> mu_p;
+  std::vector<double> S_p;
+  std::vector<double> mu;
+  std::vector<double> S;
+
+  // smoothed estimates
+  std::vector<double> mu_s;
+  std::vector<double> S_s;
+
+  RTSSmoother() {}
+
+  /**
+   * Reserve memory for forward pass
+   *
+   * @param nb_states Number of states
+   * @param nb_steps Expected number of steps
+   */
+  void reserve(const int nb_states, const int nb_steps);
+
+  /**
+   * Clear forward pass and smoothed estimates
+   */
+  void clear();
+
+  /**
+   * Record forward pass step, call after every `KF::estimate()`
+   *
+   * @param kf Kalman filter
+   * @param A Transition matrix used by the last `KF::estimate()`
+   * @return
+   *    - 0: Success
+   *    - -1: Kalman filter not initialized
+   *    - -2: Number of states changed
+   */
+  int record(const KF &kf, const MatX &A);
+
+  /**
+   * Smooth whole forward pass
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Nothing recorded
+   *    - -2: Predicted covariance not positive definite
+   */
+  int smooth();
+
+  /**
+   * Fixed-lag smoothing, the estimate of every step only uses measurements
+   * up to `lag` steps ahead of it, as an online smoother with that delay
+   * would. Only the smoothed means are computed, `S_s` is left empty.
+   *
+   * @param lag Number of steps to look ahead
+   * @return
+   *    - 0: Success
+   *    - -1: Nothing recorded
+   *    - -2: Predicted covariance not positive definite
+   */
+  int smoothFixedLag(const int lag);
+
+  /**
+   * @param k Step
+   * @return Filtered estimate
+   */
+  VecX filteredState(const int k) const;
+
+  /**
+   * @param k Step
+   * @return Smoothed estimate
+   */
+  VecX smoothedState(const int k) const;
+
+  /**
+   * @param k Step
+   * @return Smoothed covariance
+   */
+  MatX smoothedCovariance(const int k) const;
+};
+
+/**
+ * Run forward pass and smooth multiple flights in parallel
+ *
+ * Flights are handed out to `nb_threads` worker threads one at a time, so
+ * flights of different lengths balance out across the workers.
+ *
+ * @param flights Smoothers, one per flight
+ * @param nb_threads Number of worker threads
+ * @param forward Function recording the forward pass of a flight given its
+ *                index, may be empty if the forward passes are recorded
+ * @return Number of flights that failed, 0 on success
+ */
+int smooth_flights(
+    std::vector<RTSSmoother> &flights,
+    const int nb_threads,
+    const std::function<int(const int, RTSSmoother &)> &forward = nullptr);
+
+} // namespace atl
+#endif
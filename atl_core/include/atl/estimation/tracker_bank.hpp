@@ -0,0 +1,160 @@
+#ifndef ATL_ESTIMATION_TRACKER_BANK_HPP
+#define ATL_ESTIMATION_TRACKER_BANK_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "atl/utils/utils.hpp"
+#include "atl/vision/apriltag/data.hpp"
+
+namespace atl {
+
+/**
+ * Bank of independent constant acceleration Kalman filters, one per tracked
+ * landing target.
+ *
+ * Each track follows the same model as `KFTracker` configured with
+ * `MATRIX_A_CONSTANT_ACCELERATION_XYZ`, but with a diagonal motion noise the
+ * x, y and z axes are decoupled, so the covariance of a track is three 3x3
+ * blocks (position, velocity, acceleration) instead of a dense 9x9 matrix.
+ *
+ * Tracks are stored in a structure-of-arrays layout: every state and
+ * covariance entry is a contiguous array indexed by track, and live tracks
+ * always occupy `[0, nb_tracks)`. Prediction is therefore a handful of
+ * straight loops over the tracks that the compiler can vectorize, and no
+ * memory is allocated after `configure()`.
+ */
+class TrackerBank {
+public:
+  bool configured = false;
+  std::string config_file;
+
+  int max_tracks = 64;
+  double gate_threshold = 11.345; // chi-squared, 3 DoF, 99%
+  double track_timeout = 1.0;     // seconds without measurement
+  Vec3 motion_noise{1.0, 1.0, 1.0};      // position, velocity, acceleration
+  Vec3 measurement_noise{1.0, 1.0, 1.0}; // x, y, z
+
+  int nb_tracks = 0;
+  int next_track_id = 0;
+
+  // track book-keeping
+  std::vector<int> track_id;
+  std::vector<int> tag_id;
+  std::vector<int> nb_updates;
+  std::vector<double> last_updated;
+
+  // track states, one array per axis (x, y, z)
+  std::vector<double> pos[3];
+  std::vector<double> vel[3];
+  std::vector<double> acc[3];
+
+  // track covariances, upper triangle of the 3x3 block per axis
+  std::vector<double> S_pp[3];
+  std::vector<double> S_pv[3];
+  std::vector<double> S_pa[3];
+  std::vector<double> S_vv[3];
+  std::vector<double> S_va[3];
+  std::vector<double> S_aa[3];
+
+  TrackerBank() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return 0 for success, -1 for failure
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Remove all tracks
+   */
+  void clear();
+
+  /**
+   * Find track by tag id
+   *
+   * @param tag_id Tag id
+   * @return Track index, or -1 if no track has the tag id
+   */
+  int findTag(const int tag_id) const;
+
+  /**
+   * Spawn a new track at measured position
+   *
+   * @param tag Detected tag
+   * @param t Time of detection in seconds
+   * @return Track index, or -1 if the bank is full
+   */
+  int spawnTrack(const TagPose &tag, const double t);
+
+  /**
+   * Retire track, the last track is moved into its slot
+   *
+   * @param index Track index
+   */
+  void retireTrack(const int index);
+
+  /**
+   * Batched prediction update of all tracks
+   *
+   * @param dt Time difference in seconds
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   */
+  int predict(const double dt);
+
+  /**
+   * Squared Mahalanobis distance between measurement and predicted track
+   * position
+   *
+   * @param index Track index
+   * @param z Measured position
+   * @return Squared Mahalanobis distance
+   */
+  double mahalanobis(const int index, const Vec3 &z) const;
+
+  /**
+   * Measurement update of a single track
+   *
+   * @param index Track index
+   * @param z Measured position
+   * @param t Time of measurement in seconds
+   */
+  void updateTrack(const int index, const Vec3 &z, const double t);
+
+  /**
+   * Associate detections with tracks and update them
+   *
+   * Detections sharing a tag id (>= 0) are merged into one at their mean
+   * position, which is associated with the track of the same id.
+   * Detections without a tag id are associated with the remaining
+   * tracks by nearest gated Mahalanobis distance. Unassociated detections
+   * spawn new tracks and tracks not updated for `track_timeout` seconds are
+   * retired.
+   *
+   * @param tags Detected tags
+   * @param t Time of detections in seconds
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   */
+  int update(const std::vector<TagPose> &tags, const double t);
+
+  /**
+   * @param index Track index
+   * @return Track position estimate
+   */
+  Vec3 getPosition(const int index) const;
+
+  /**
+   * @param index Track index
+   * @return Track velocity estimate
+   */
+  Vec3 getVelocity(const int index) const;
+};
+
+} // namespace atl
+#endif
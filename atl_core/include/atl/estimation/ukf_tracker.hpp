@@ -0,0 +1,138 @@
+#ifndef ATL_ESTIMATION_UKF_TRACKER_HPP
+#define ATL_ESTIMATION_UKF_TRACKER_HPP
+
+#include "atl/estimation/ekf_tracker.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+#define UKF_NB_STATES 9
+#define UKF_NB_MEASUREMENTS 4
+#define UKF_NB_SIGMAS (2 * UKF_NB_STATES + 1)
+
+#define EUKFNBSTATES "UKFTracker supports %d states but config has %d!"
+#define EUKFRSIZE "Motion noise R should be a %dx%d matrix!"
+#define EUKFQSIZE "Measurement noise Q should be a %dx%d matrix!"
+#define EUKFSIGMAS "Failed to compute sigma points, covariance not PD!"
+#ifndef ECHECKCONFIG
+#define ECHECKCONFIG "Consider checking your dimensions in config: [%s]!"
+#endif
+
+/**
+ * Unscented Kalman Filter tracker
+ *
+ * Uses the same process and measurement model functions as `EKFTracker`
+ * (by default `two_wheel_process_model()` and
+ * `two_wheel_measurement_model()`), but propagates sigma points through them
+ * instead of linearizing around the current estimate. All storage is fixed
+ * size, so no memory is allocated while estimating.
+ */
+class UKFTracker {
+public:
+  // clang-format off
+  typedef Eigen::Matrix<double, UKF_NB_STATES, 1> StateVec;
+  typedef Eigen::Matrix<double, UKF_NB_STATES, UKF_NB_STATES> StateMat;
+  typedef Eigen::Matrix<double, UKF_NB_MEASUREMENTS, 1> MeasurementVec;
+  typedef Eigen::Matrix<double, UKF_NB_MEASUREMENTS, UKF_NB_MEASUREMENTS> MeasurementMat;
+  typedef Eigen::Matrix<double, UKF_NB_STATES, UKF_NB_MEASUREMENTS> GainMat;
+  typedef Eigen::Matrix<double, UKF_NB_STATES, UKF_NB_SIGMAS> StateSigmas;
+  typedef Eigen::Matrix<double, UKF_NB_MEASUREMENTS, UKF_NB_SIGMAS> MeasurementSigmas;
+  typedef Eigen::Matrix<double, UKF_NB_SIGMAS, 1> Weights;
+
+  typedef void (*ProcessModel)(const Eigen::Ref<const VecX> &x, const double dt, Eigen::Ref<VecX> g);
+  typedef void (*MeasurementModel)(const Eigen::Ref<const VecX> &x, Eigen::Ref<VecX> h);
+  // clang-format on
+
+  bool configured = false;
+  bool initialized = false;
+
+  int nb_states = 0;
+  std::string config_file;
+
+  // sigma point spread and weighting
+  double alpha = 1.0;
+  double beta = 2.0;
+  double kappa = 0.0;
+  double lambda = 0.0;
+  Weights W_m = Weights::Zero();
+  Weights W_c = Weights::Zero();
+
+  // state and measurement elements that are angles, -1 for none
+  int state_angle_index = 3;
+  int measurement_angle_index = 3;
+
+  ProcessModel process_model = two_wheel_process_model;
+  MeasurementModel measurement_model = two_wheel_measurement_model;
+
+  StateVec mu = StateVec::Zero();
+
+  StateMat R = StateMat::Zero();
+  MeasurementMat Q = MeasurementMat::Zero();
+
+  StateMat S = StateMat::Zero();
+  GainMat K = GainMat::Zero();
+
+  StateVec mu_p = StateVec::Zero();
+  StateMat S_p = StateMat::Zero();
+
+  StateSigmas X = StateSigmas::Zero();
+  StateSigmas X_p = StateSigmas::Zero();
+  MeasurementSigmas Y = MeasurementSigmas::Zero();
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  UKFTracker() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return 0 for success, -1 for failure
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Initialize
+   *
+   * @param mu Initial estimate
+   * @return 0 for success, -1 for failure
+   */
+  int initialize(const VecX &mu);
+
+  /**
+   * Reset estimator with new estimates
+   *
+   * @param mu Estimate
+   * @return 0 for success, -1 for failure
+   */
+  int reset(const VecX &mu);
+
+  /**
+   * Prediction update
+   *
+   * @param dt Time difference in seconds
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Not initialized
+   *    - -2: Failed to compute sigma points
+   */
+  int predictionUpdate(const double dt);
+
+  /**
+   * Measurement update
+   *
+   * The predicted sigma points from `predictionUpdate()` are reused, so a
+   * prediction update must precede every measurement update.
+   *
+   * @param y Measurement
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Not initialized
+   */
+  int measurementUpdate(const VecX &y);
+};
+
+} // namespace atl
+#endif
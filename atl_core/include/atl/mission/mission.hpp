@@ -4,6 +4,8 @@
 #include <vector>
 
 #include "atl/mission/waypoint.hpp"
+#include "atl/planning/path_spline.hpp"
+#include "atl/planning/velocity_profile.hpp"
 #include "atl/utils/utils.hpp"
 
 namespace atl {
@@ -22,6 +24,13 @@ namespace atl {
 
 /**
  * Mission
+ *
+ * Follows the local waypoints either segment by segment along straight
+ * lines, or with `smooth_path` along a continuous curvature `PathSpline`
+ * through all of them. On the spline the waypoint is `look_ahead_dist` of
+ * arc length ahead of the closest point, which is searched within
+ * `path_window` of the previous one, and the desired velocity comes from a
+ * `VelocityProfile` along the spline capped at `desired_velocity`.
  */
 class Mission {
 public:
@@ -37,6 +46,8 @@ public:
   double threshold_waypoint_reached = 0.2;
   double desired_velocity = 0.5;
   double look_ahead_dist = 0.5;
+  bool smooth_path = false;
+  double path_window = 5.0;
 
   std::vector<Vec3> gps_waypoints;
   std::vector<Vec3> local_waypoints;
@@ -44,6 +55,10 @@ public:
   Vec3 wp_start = Vec3::Zero();
   Vec3 wp_end = Vec3::Zero();
 
+  PathSpline path;
+  VelocityProfile profile;
+  double path_s = -1.0; // arc length of the closest point, -1 if unknown
+
   Mission() {}
 
   /**
@@ -90,6 +105,22 @@ public:
    */
   Vec3 closestPoint(const Vec3 &position);
 
+  /**
+   * Calculate closest point on the smoothed path and keep its arc length
+   *
+   * @param position Actual position of robot
+   * @return Closest point
+   */
+  Vec3 pathClosestPoint(const Vec3 &position);
+
+  /**
+   * Desired velocity
+   *
+   * @return Speed of the velocity profile at the waypoint on the smoothed
+   * path, otherwise `desired_velocity`
+   */
+  double desiredVelocity() const;
+
   /**
    * Calcuate which side the point is compared to waypoint track
    *
@@ -125,7 +156,8 @@ public:
    *
    * This function assumes we are operating in the NWU frame, where a 0
    * heading
-   * starts from the x-axis and goes counter-clock-wise.
+   * starts from the x-axis and goes counter-clock-wise. On the smoothed path
+   * it is the heading of the path tangent at the closest point.
    *
    * @return Waypoint yaw
    */
@@ -4,6 +4,7 @@
 #include <float.h>
 #include <iostream>
 
+#include "atl/control/geometric_controller.hpp"
 #include "atl/control/pid.hpp"
 #include "atl/data/transform.hpp"
 #include "atl/utils/utils.hpp"
@@ -30,7 +31,7 @@ public:
               double dt);
 };
 
-class PositionController {
+class ModelPositionController {
 public:
   double dt;
   Vec4 outputs;
@@ -39,7 +40,7 @@ public:
   PID y_controller;
   PID z_controller;
 
-  PositionController()
+  ModelPositionController()
       : dt(0.0), outputs(), x_controller(0.5, 0.0, 0.035),
         y_controller(0.5, 0.0, 0.035), z_controller(0.5, 0.0, 0.018) {}
 
@@ -52,6 +53,7 @@ public:
   Vec3 angular_velocity;
   Vec3 position;
   Vec3 linear_velocity;
+  Vec3 ext_force; // external force in world frame, e.g. wind
 
   double Ix;
   double Iy;
@@ -68,13 +70,18 @@ public:
 
   Vec4 attitude_setpoints;
   Vec3 position_setpoints;
+  Vec3 velocity_setpoints;
+  Vec3 acceleration_setpoints;
+  double yaw_setpoint;
 
   AttitudeController attitude_controller;
-  PositionController position_controller;
+  ModelPositionController position_controller;
+  GeometricController geometric_controller;
 
   QuadrotorModel()
       : attitude(0, 0, 0), angular_velocity(0, 0, 0), position(0, 0, 0),
-        linear_velocity(0, 0, 0), Ix(0.0963), // inertial x
+        linear_velocity(0, 0, 0), ext_force(0, 0, 0),
+        Ix(0.0963),                           // inertial x
         Iy(0.0963),                           // inertial y
         Iz(0.1927),                           // inertial z
         kr(0.1),                              // rotation drag constant
@@ -84,11 +91,14 @@ public:
         m(1.0),                               // mass of quad
         g(10.0),                              // gravitational constant
         attitude_setpoints(0, 0, 0, 0), position_setpoints(0, 0, 0),
-        attitude_controller(), position_controller() {}
+        velocity_setpoints(0, 0, 0), acceleration_setpoints(0, 0, 0),
+        yaw_setpoint(0.0), attitude_controller(), position_controller(),
+        geometric_controller() {}
 
   QuadrotorModel(const VecX &pose)
       : attitude(pose(3), pose(4), pose(5)), angular_velocity(0, 0, 0),
         position(pose(0), pose(1), pose(2)), linear_velocity(0, 0, 0),
+        ext_force(0, 0, 0),
         Ix(0.0963), // inertial x
         Iy(0.0963), // inertial y
         Iz(0.1927), // inertial z
@@ -99,11 +109,15 @@ public:
         m(1.0),     // mass of quad
         g(10.0),    // gravitational constant
         attitude_setpoints(0, 0, 0, 0.5), position_setpoints(0, 0, 0),
-        attitude_controller(), position_controller() {}
+        velocity_setpoints(0, 0, 0), acceleration_setpoints(0, 0, 0),
+        yaw_setpoint(0.0), attitude_controller(), position_controller(),
+        geometric_controller() {}
 
   int update(const VecX &motor_inputs, double dt);
   Vec4 attitudeControllerControl(double dt);
   Vec4 positionControllerControl(double dt);
+  Vec4 geometricControllerControl(double dt);
+  Vec4 geometricAttitudeControl(const Mat3 &R_d, double thrust);
   void setAttitude(double roll, double pitch, double yaw, double z);
   void setPosition(double x, double y, double z);
   void setVelocity(double vx, double vy, double vz);
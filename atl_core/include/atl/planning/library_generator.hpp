@@ -0,0 +1,133 @@
+#ifndef ATL_PLANNING_LIBRARY_GENERATOR_HPP
+#define ATL_PLANNING_LIBRARY_GENERATOR_HPP
+
+#include <stdio.h>
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atl/planning/optimizer.hpp"
+#include "atl/planning/trajectory.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Batch generator of the landing trajectory library
+ *
+ * Optimizes a landing trajectory (see `trajectory_landing_setup()`) for
+ * every start height and target velocity on a grid and writes them as a
+ * trajectory index (`index.csv`) and one `<index>.csv` file each, the
+ * layout `TrajectoryIndex` loads and `trajectory_library_create()`
+ * converts.
+ *
+ * The grid rows (heights) are split into chunks of `chunk_size`
+ * velocities that a pool of threads, each with its own `POpt`, pull until
+ * none are left. Within a chunk every trajectory is warm started from its
+ * neighbour at the previous velocity, shifted by the velocity difference,
+ * as cells of a row have the same number of steps.
+ *
+ * The index of a cell is its position on the grid, so it does not depend
+ * on the order the threads finish in. Each trajectory file is written to a
+ * temporary file and renamed, then its line appended to the index and
+ * flushed. Generating into a directory that already has an index skips the
+ * trajectories it lists, so an interrupted run resumes where it stopped.
+ */
+class LibraryGenerator {
+public:
+  bool configured = false;
+
+  // grid
+  double z_min = 1.0;
+  double z_max = 10.0;
+  double z_step = 1.0;
+  double v_min = 0.0;
+  double v_max = 10.0;
+  double v_step = 1.0;
+
+  // problem
+  double dt = 0.08;
+  double vz = -1.0;
+
+  // execution
+  int nb_threads = 0; // 0: hardware concurrency
+  int chunk_size = 4;
+
+  // progress, a byte per cell so threads can set their own
+  std::vector<char> done;
+  std::mutex index_mutex;
+  std::ofstream index_file;
+  std::atomic<int> nb_solved{0};
+  std::atomic<int> nb_failed{0};
+  int nb_skipped = 0;
+  double elapsed = 0.0;
+
+  LibraryGenerator() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Invalid grid
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * @return Number of start heights on the grid
+   */
+  int nbHeights() const;
+
+  /**
+   * @return Number of target velocities on the grid
+   */
+  int nbVelocities() const;
+
+  /**
+   * @return Start height of grid row `i`
+   */
+  double height(const int i) const;
+
+  /**
+   * @return Target velocity of grid column `j`
+   */
+  double velocity(const int j) const;
+
+  /**
+   * Load the trajectories an earlier run finished
+   *
+   * Keeps the index lines that parse and whose trajectory file exists,
+   * marks them done and rewrites the index without the rest (for example a
+   * line cut short by an interruption).
+   *
+   * @param output_dir Output directory
+   * @return Number of finished trajectories
+   */
+  int resume(const std::string &output_dir);
+
+  /**
+   * Generate the trajectories that are not done yet
+   *
+   * @param output_dir Output directory, must exist
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   *    - -2: Failed to open index file
+   *    - -3: Some trajectories failed to optimize or save
+   */
+  int generate(const std::string &output_dir);
+
+  /**
+   * @return Trajectories generated per second of the last run
+   */
+  double throughput() const;
+};
+
+} // namespace atl
+#endif
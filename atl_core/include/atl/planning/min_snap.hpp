@@ -0,0 +1,231 @@
+#ifndef ATL_PLANNING_MIN_SNAP_HPP
+#define ATL_PLANNING_MIN_SNAP_HPP
+
+#include <float.h>
+#include <math.h>
+
+#include <string>
+
+#include "atl/control/trajectory.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Polynomial boundary value problem
+ *
+ * Polynomial `p(tau) = sum c_i tau^i` of `N` coefficients on normalized time
+ * `tau = t / T` in [0, 1], with its first `N / 2` derivatives fixed at both
+ * ends. It is the polynomial that minimizes the integral of its squared
+ * `N / 2`-th derivative (Euler-Lagrange), `N = 6` is minimum jerk and
+ * `N = 8` minimum snap. On normalized time the boundary condition matrix and
+ * the cost Hessian do not depend on the duration, so both are computed once
+ * at construction and a solve is one fixed-size matrix-vector product.
+ */
+template <int N>
+struct PolyBVP {
+  typedef Eigen::Matrix<double, N, 1> Coeffs;
+  typedef Eigen::Matrix<double, N, N> Hessian;
+  static const int R = N / 2;
+
+  Hessian A_inv; // normalized boundary conditions to coefficients
+  Hessian Q;     // integral of the squared R-th derivative over [0, 1]
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  PolyBVP() {
+    // boundary conditions, R derivatives at tau = 0 then at tau = 1
+    Hessian A = Hessian::Zero();
+    for (int k = 0; k < R; k++) {
+      A(k, k) = PolyBVP::falling(k, k);
+      for (int i = k; i < N; i++) {
+        A(R + k, i) = PolyBVP::falling(i, k);
+      }
+    }
+    this->A_inv = A.inverse();
+
+    // cost hessian
+    this->Q.setZero();
+    for (int i = R; i < N; i++) {
+      for (int j = R; j < N; j++) {
+        const double d = PolyBVP::falling(i, R) * PolyBVP::falling(j, R);
+        this->Q(i, j) = d / (i + j - 2 * R + 1);
+      }
+    }
+  }
+
+  /**
+   * i! / (i - k)!, the factor of the k-th derivative of tau^i
+   */
+  static double falling(const int i, const int k) {
+    double d = 1.0;
+    for (int n = i - k + 1; n <= i; n++) {
+      d *= n;
+    }
+    return d;
+  }
+
+  /**
+   * Solve for the coefficients
+   *
+   * @param start Position and its first `R - 1` time derivatives at t = 0
+   * @param end Position and its first `R - 1` time derivatives at t = T
+   * @param T Duration in seconds
+   * @return Coefficients on normalized time
+   */
+  Coeffs solve(const double *start, const double *end, const double T) const {
+    Coeffs b;
+    double scale = 1.0;
+    for (int k = 0; k < R; k++) {
+      b(k) = start[k] * scale;
+      b(R + k) = end[k] * scale;
+      scale *= T;
+    }
+    return this->A_inv * b;
+  }
+
+  /**
+   * Integral of the squared R-th time derivative over [0, T]
+   */
+  double cost(const Coeffs &c, const double T) const {
+    return c.dot(this->Q * c) / pow(T, 2 * R - 1);
+  }
+};
+
+/**
+ * Evaluate the k-th time derivative of a polynomial on normalized time
+ *
+ * @param c Coefficients, trailing zeros for a lower degree
+ * @param T Duration in seconds
+ * @param t Time in seconds
+ * @param k Derivative
+ * @return k-th derivative at t
+ */
+double poly_evaluate(const Eigen::Matrix<double, 8, 1> &c,
+                     const double T,
+                     const double t,
+                     const int k);
+
+/**
+ * Online minimum snap / minimum jerk landing trajectory generator
+ *
+ * Plans in the vertical landing plane, `x` along the horizontal direction
+ * towards the target and `z` up, like the trajectory library. The target is
+ * predicted at constant velocity and the trajectory meets it at the end, with
+ * the target velocity plus `touchdown_vz` and zero acceleration (and jerk
+ * for minimum snap). Each axis is one polynomial segment from the actual
+ * start state, see `PolyBVP`.
+ *
+ * The duration is searched over the multiples of `dt` between
+ * `duration_min` and `duration_max`, so the trajectory has whole rows, and
+ * the feasible one with the lowest `cost + time_weight * T` is kept. A
+ * duration is feasible when, at `nb_checks` points along it, the mass
+ * normalized thrust is within `[thrust_min, thrust_max]`, the tilt within
+ * `tilt_max`, the descent rate within `vz_min` and the height at or above
+ * the target.
+ */
+class MinSnapGenerator {
+public:
+  bool configured = false;
+
+  // objective
+  int order = 4; // minimized derivative, 3: jerk, 4: snap
+  double time_weight = 1.0;
+  double duration_min = 0.5;
+  double duration_max = 10.0;
+  double dt = 0.1;
+
+  // limits
+  double thrust_min = 2.0;
+  double thrust_max = 20.0;
+  double tilt_max = deg2rad(45.0);
+  double vz_min = -2.0;
+  double touchdown_vz = 0.0;
+  int nb_checks = 20;
+
+  // trajectory inputs
+  double hover_throttle = 0.5;
+  double g = 9.81;
+
+  PolyBVP<6> jerk_bvp;
+  PolyBVP<8> snap_bvp;
+
+  // solution
+  double duration = 0.0;
+  double cost = 0.0;
+  int nb_evaluated = 0;
+  Eigen::Matrix<double, 8, 1> coeffs_x = Eigen::Matrix<double, 8, 1>::Zero();
+  Eigen::Matrix<double, 8, 1> coeffs_z = Eigen::Matrix<double, 8, 1>::Zero();
+  Vec2 target_pos{0.0, 0.0};
+  Vec2 target_vel{0.0, 0.0};
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  MinSnapGenerator() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Invalid settings
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Solve for the trajectory from a start state to the target
+   *
+   * @param pos Start position (x, z)
+   * @param vel Start velocity (vx, vz)
+   * @param acc Start acceleration (ax, az)
+   * @param target_pos Target position (x, z)
+   * @param target_vel Target velocity (vx, vz)
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   *    - -2: No feasible duration
+   */
+  int solve(const Vec2 &pos,
+            const Vec2 &vel,
+            const Vec2 &acc,
+            const Vec2 &target_pos,
+            const Vec2 &target_vel);
+
+  /**
+   * Evaluate solution
+   *
+   * @param t Time in seconds, clamped to the duration
+   * @param pos Position (x, z)
+   * @param vel Velocity (vx, vz)
+   * @param acc Acceleration (ax, az)
+   */
+  void evaluate(const double t, Vec2 &pos, Vec2 &vel, Vec2 &acc) const;
+
+  /**
+   * Solve and sample the solution every `dt` seconds into a trajectory with
+   * the columns of a trajectory file, the trajectory index is -1
+   *
+   * @param pos Start position (x, z)
+   * @param vel Start velocity (vx, vz)
+   * @param target_pos Target position (x, z)
+   * @param target_vel Target velocity (vx, vz)
+   * @param p0 Robot position in inertial frame
+   * @param traj Generated trajectory
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   *    - -2: No feasible duration
+   *    - -3: Failed to load trajectory
+   */
+  int generate(const Vec2 &pos,
+               const Vec2 &vel,
+               const Vec2 &target_pos,
+               const Vec2 &target_vel,
+               const Vec3 &p0,
+               Trajectory &traj);
+};
+
+} // namespace atl
+#endif
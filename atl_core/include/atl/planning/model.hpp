@@ -34,7 +34,76 @@ public:
 
   Simulator();
   int configure(Vec4 x_init, Vec4 x_final, double m);
-  int simulate(double dt, double tend, MatX U, MatX &X);
+  int simulate(double dt, double tend, const MatX &U, MatX &X);
+};
+
+/**
+ * Batched simulator
+ *
+ * Propagates `N` control sequences through the `Quad2DModel` dynamics at
+ * once, for sampling based planners that need thousands of rollouts. The
+ * rollouts are a structure of arrays, one array of `N` per state and
+ * result. They are propagated in blocks of `BATCH_SIM_BLOCK` through every
+ * step, so a block's states stay in registers or L1 between steps and the
+ * sines and cosines of a block overlap. Those are branch free polynomials
+ * that vectorize with the baseline instruction set, the `sin()` and `cos()`
+ * of Eigen arrays are much slower without SSE4.1.
+ *
+ * The arrays are single precision, the results of each rollout are the
+ * same as `Simulator::simulate()` of its control sequence to single
+ * precision.
+ */
+#define BATCH_SIM_BLOCK 32
+
+class BatchSimulator {
+public:
+  bool configured = false;
+
+  Vec4 x_init{0.0, 0.0, 0.0, 0.0};
+  Vec4 x_final{0.0, 0.0, 0.0, 0.0};
+  double g = 9.81;
+
+  // final state of every rollout
+  Eigen::ArrayXf x;
+  Eigen::ArrayXf vx;
+  Eigen::ArrayXf z;
+  Eigen::ArrayXf vz;
+
+  // results of every rollout
+  Eigen::ArrayXf d_az;
+  Eigen::ArrayXf d_theta;
+  Eigen::ArrayXf az_sum;
+  Eigen::ArrayXf dist_error;
+  Eigen::ArrayXf vel_error;
+  Eigen::ArrayXf z_min; // lowest height along the rollout
+
+  BatchSimulator() {}
+
+  /**
+   * Configure
+   *
+   * @param x_init Initial state (x, vx, z, vz)
+   * @param x_final Final state (x, vx, z, vz) the errors are against
+   * @return 0 for success
+   */
+  int configure(const Vec4 &x_init, const Vec4 &x_final);
+
+  /**
+   * Simulate rollouts
+   *
+   * @param dt Time step
+   * @param tend Simulation time, `round(tend / dt)` steps
+   * @param AZ Thrust inputs, one row per rollout and one column per step
+   * @param THETA Pitch inputs, one row per rollout and one column per step
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   *    - -2: Inputs do not match the number of steps
+   */
+  int simulate(const double dt,
+               const double tend,
+               const Eigen::MatrixXf &AZ,
+               const Eigen::MatrixXf &THETA);
 };
 
 } // namespace atl
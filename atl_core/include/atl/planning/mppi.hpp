@@ -0,0 +1,191 @@
+#ifndef ATL_PLANNING_MPPI_HPP
+#define ATL_PLANNING_MPPI_HPP
+
+#include <float.h>
+#include <math.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atl/planning/model.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Samples of one MPPI worker thread, each thread owns its simulator, random
+ * number generator and rows of inputs so rollouts need no locking
+ */
+struct MPPIBatch {
+  BatchSimulator sim;
+  std::mt19937 rng;
+  Eigen::MatrixXf AZ;    // one row per sample and one column per step
+  Eigen::MatrixXf THETA; // one row per sample and one column per step
+  Eigen::ArrayXf cost;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/**
+ * Model predictive path integral (MPPI) landing planner
+ *
+ * Plans the mass normalized thrust `az` and pitch `theta` of the
+ * `Quad2DModel` in the vertical landing plane, `x` along the horizontal
+ * direction towards the target and `z` up. Every update perturbs the nominal
+ * input sequence with gaussian noise, rolls all samples out with a
+ * `BatchSimulator` and replaces the nominal with the average of the samples
+ * weighted by `exp(-(cost - cost_min) / lambda)`.
+ *
+ * The horizon ends at the interception, where the target is predicted at
+ * constant velocity and met with its velocity plus `touchdown_vz`. It
+ * starts at the time to descend to the target at `descent_rate` and shrinks
+ * as time passes, the nominal is shifted by the elapsed whole steps and used
+ * as the mean of the next samples. The horizon does not shrink below
+ * `min_steps`, the shifted nominal is padded with hover instead.
+ *
+ * The cost of a rollout is
+ *
+ *     w_pos * dist_error + w_vel * vel_error
+ *       + w_daz * d_az + w_dtheta * d_theta
+ *       + w_ground * max(0, target_z - z_min)^2
+ *
+ * Rollouts are split over `nb_threads` threads, so the sample budget can be
+ * sized to the control rate of the on-board computer. The caller rolls out
+ * the first batch, the others are handed to a pool of worker threads that is
+ * started by `configure()` and stopped by the destructor, so no thread is
+ * started per update.
+ */
+class MPPIPlanner {
+public:
+  bool configured = false;
+
+  // horizon
+  double dt = 0.1;
+  int max_steps = 60;
+  int min_steps = 5;
+  double descent_rate = 1.0;
+  double touchdown_vz = 0.0;
+
+  // sampling
+  int nb_samples = 512;
+  int nb_threads = 1; // <= 0: hardware concurrency
+  int seed = 0;
+  double lambda = 1.0;
+  double sigma_az = 1.0;
+  double sigma_theta = deg2rad(5.0);
+
+  // limits
+  double thrust_min = 2.0;
+  double thrust_max = 20.0;
+  double tilt_max = deg2rad(45.0);
+  double g = 9.81;
+
+  // cost weights
+  double w_pos = 10.0;
+  double w_vel = 5.0;
+  double w_daz = 0.01;
+  double w_dtheta = 1.0;
+  double w_ground = 1000.0;
+
+  // nominal input sequence
+  Eigen::VectorXf nominal_az;
+  Eigen::VectorXf nominal_theta;
+  double time_shift = 0.0;
+
+  std::vector<MPPIBatch, Eigen::aligned_allocator<MPPIBatch>> batches;
+
+  // worker pool, worker i rolls out batch i + 1
+  std::vector<std::thread> workers;
+  std::mutex pool_mutex;
+  std::condition_variable pool_cv; // wakes the workers up on a new update
+  std::condition_variable done_cv; // wakes the caller up on the last batch
+  std::function<void(const int)> job;
+  uint64_t generation = 0;
+  int nb_pending = 0;
+  bool stopping = false;
+
+  // last update
+  double cost_min = 0.0;
+  double nb_effective = 0.0;
+  double elapsed = 0.0;
+
+  MPPIPlanner() {}
+  ~MPPIPlanner() { this->stopWorkers(); }
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Invalid settings
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Start one worker thread per batch after the first
+   */
+  void startWorkers();
+
+  /**
+   * Stop and join the worker threads
+   */
+  void stopWorkers();
+
+  /**
+   * Worker thread, runs `job` on its batch once per generation
+   *
+   * @param i Batch index
+   * @param generation Generation the worker was started at
+   */
+  void workerLoop(const int i, uint64_t generation);
+
+  /**
+   * Run `job` on every batch, the first on the calling thread and the
+   * others on the workers, and wait for all of them
+   *
+   * @param job Job to run with the batch index
+   */
+  void runBatches(const std::function<void(const int)> &job);
+
+  /**
+   * Drop the nominal input sequence, the next update starts a new landing
+   */
+  void reset();
+
+  /**
+   * Horizon of the nominal input sequence in steps
+   */
+  int horizon() const { return (int) this->nominal_az.size(); }
+
+  /**
+   * Update the nominal input sequence, once per control tick
+   *
+   * @param pos Position (x, z)
+   * @param vel Velocity (vx, vz)
+   * @param target_pos Target position (x, z)
+   * @param target_vel Target velocity (vx, vz)
+   * @param dt Time since the last update in seconds
+   * @param inputs Inputs to apply now, thrust `az` and pitch `theta`
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   *    - -2: Rollouts failed
+   */
+  int update(const Vec2 &pos,
+             const Vec2 &vel,
+             const Vec2 &target_pos,
+             const Vec2 &target_vel,
+             const double dt,
+             Vec2 &inputs);
+};
+
+} // namespace atl
+#endif
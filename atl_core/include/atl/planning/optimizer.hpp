@@ -3,25 +3,100 @@
 
 #include <math.h>
 
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 #include <nlopt.hpp>
 
+#include "atl/planning/trajectory.hpp"
 #include "atl/utils/utils.hpp"
 
 namespace atl {
 
-typedef struct {
-  double a;
-  double b;
-} constraint_data;
-
+/**
+ * Direct collocation trajectory optimizer
+ *
+ * Solves the collocation problem of `trajectory.hpp` with nlopt's SLSQP,
+ * with the analytic cost gradient, the defects as one vector equality
+ * constraint and the fixed first and last steps as bounds. Without an
+ * initial guess it warm starts from `desired`.
+ *
+ * `solve()` blocks, `start()` solves the same problem on a background thread
+ * so a new trajectory can be planned while flying the current one: poll
+ * `done()`, then collect it with `result()`, or abandon it with `stop()`.
+ */
 class POpt {
 public:
   nlopt::opt opt;
 
-  POpt();
-  int run();
+  // settings
+  int max_evaluations = 500;
+  double max_time = 0.0; // seconds, 0 for no limit
+  double xtol_rel = 1e-6;
+  double ftol_rel = 1e-8;
+  double constraint_tol = 1e-8;
+  double feasibility_tol = 1e-4; // largest defect of an accepted solution
+
+  // problem and solution
+  struct problem_data problem;
+  std::vector<double> solution;
+  double cost = 0.0;
+  double violation = 0.0;
+  int nb_evaluations = 0;
+
+  // background solve
+  std::thread thread;
+  std::atomic<bool> running{false};
+  std::atomic<bool> stop_requested{false};
+  int retval = 0;
+
+  POpt() {}
+  ~POpt() { this->stop(); }
+
+  /**
+   * Solve
+   *
+   * @param p Problem data
+   * @param x Initial guess, warm started from `desired` if empty or of the
+   * wrong size, and the solution
+   * @return
+   *    - 0: Success
+   *    - -1: Invalid problem
+   *    - -2: Failed to converge to a feasible solution
+   *    - -3: Stopped
+   */
+  int solve(const struct problem_data &p, std::vector<double> &x);
+
+  /**
+   * Start solving on a background thread
+   *
+   * @param p Problem data
+   * @param x Initial guess, see `solve()`
+   * @return
+   *    - 0: Success
+   *    - -1: Already running
+   */
+  int start(const struct problem_data &p,
+            const std::vector<double> &x = std::vector<double>());
+
+  /**
+   * @return True if the background solve has finished
+   */
+  bool done() const { return this->running == false; }
+
+  /**
+   * Wait for the background solve to finish
+   *
+   * @param x Solution
+   * @return Return value of `solve()`
+   */
+  int result(std::vector<double> &x);
+
+  /**
+   * Stop the background solve and wait for it to finish
+   */
+  void stop();
 };
 
 } // namespace atl
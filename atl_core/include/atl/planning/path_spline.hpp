@@ -0,0 +1,113 @@
+#ifndef ATL_PLANNING_PATH_SPLINE_HPP
+#define ATL_PLANNING_PATH_SPLINE_HPP
+
+#include <float.h>
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Continuous curvature path through waypoints
+ *
+ * Natural cubic spline through the waypoints, parameterized by the
+ * cumulative chord length `t`, so the position, tangent and curvature are
+ * continuous at the waypoints. Each axis is `p(t)` with second derivatives
+ * `M_i` at the knots from the usual tridiagonal system.
+ *
+ * Every segment is sampled `nb_samples` times into an arc length lookup
+ * table of `(s, t, p)`. Converting an arc length to a spline parameter is a
+ * binary search of the table and an interpolation, O(log n) in the number
+ * of samples. A closest point query near a previous arc length binary
+ * searches the table and then scans the chords within `window` of it,
+ * O(log n + window / ds) for a sample spacing `ds`. Without a previous arc
+ * length it scans every chord, O(n).
+ */
+class PathSpline {
+public:
+  bool loaded = false;
+  int nb_samples = 20; // per segment
+
+  // spline
+  std::vector<Vec3> waypoints;
+  std::vector<double> knots;
+  std::vector<Vec3> second_derivs;
+
+  // arc length lookup table
+  std::vector<double> lut_s;
+  std::vector<double> lut_t;
+  std::vector<Vec3> lut_p;
+  double length = 0.0;
+
+  PathSpline() {}
+
+  /**
+   * Fit the spline and build the arc length lookup table
+   *
+   * @param waypoints Waypoints
+   * @param nb_samples Samples per segment
+   * @return
+   *    - 0: Success
+   *    - -1: Less than 2 waypoints or samples per segment
+   *    - -2: Repeated waypoints
+   */
+  int load(const std::vector<Vec3> &waypoints, const int nb_samples = 20);
+
+  /**
+   * Evaluate the spline
+   *
+   * @param t Spline parameter, clamped to the knots
+   * @param k Derivative, 0 to 2
+   * @return k-th derivative of the position with respect to `t`
+   */
+  Vec3 evaluate(const double t, const int k = 0) const;
+
+  /**
+   * Spline parameter at an arc length
+   *
+   * @param s Arc length, clamped to the path
+   * @return Spline parameter
+   */
+  double param(const double s) const;
+
+  /**
+   * Position at an arc length
+   */
+  Vec3 point(const double s) const;
+
+  /**
+   * Unit tangent at an arc length
+   */
+  Vec3 tangent(const double s) const;
+
+  /**
+   * Curvature at an arc length
+   */
+  double curvature(const double s) const;
+
+  /**
+   * Waypoint segment at an arc length, from waypoint `i` to `i + 1`
+   */
+  int segment(const double s) const;
+
+  /**
+   * Closest point on the path
+   *
+   * @param position Position
+   * @param s_hint Previous arc length, negative to search the whole path
+   * @param window Arc length searched either side of `s_hint`
+   * @param closest Closest point
+   * @return Arc length of the closest point, -1 if not loaded
+   */
+  double closestPoint(const Vec3 &position,
+                      const double s_hint,
+                      const double window,
+                      Vec3 &closest) const;
+};
+
+} // namespace atl
+#endif
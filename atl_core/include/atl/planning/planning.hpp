@@ -1,7 +1,16 @@
 #ifndef ATL_PLANNING_HPP
 #define ATL_PLANNING_HPP
 
-#include "atl/planning/optimizer.hpp"
+#include "atl/planning/min_snap.hpp"
+#include "atl/planning/mppi.hpp"
+#include "atl/planning/path_spline.hpp"
 #include "atl/planning/utils.hpp"
+#include "atl/planning/velocity_profile.hpp"
+
+// built only when nlopt is found, see ATL_NLOPT in CMakeLists.txt
+#ifdef ATL_NLOPT
+#include "atl/planning/library_generator.hpp"
+#include "atl/planning/optimizer.hpp"
+#endif
 
 #endif
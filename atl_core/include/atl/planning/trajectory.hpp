@@ -41,6 +41,19 @@ struct problem_data {
 
   MatX desired;
   std::vector<double> cost_weights;
+
+  // dynamics
+  double dt;
+  double g;
+  double cdx;
+  double cdz;
+
+  // bounds on the free steps
+  double thrust_min;
+  double thrust_max;
+  double theta_max;
+  double z_min;
+  double vz_min;
 };
 
 Vec2 quadrotor_calculate_inputs(double mass, double thrust, double omega);
@@ -52,12 +65,149 @@ void trajectory_setup(struct problem_data *p,
                       int nb_steps,
                       std::vector<double> cost_weights);
 int trajectory_calculate_desired(struct problem_data *p);
+
+/**
+ * Setup a landing problem, from `z` above the target down onto it while it
+ * moves at `v` along x
+ *
+ * Mirrors `desired_system()` of `scripts/atl_planner.py`: the quadrotor
+ * starts at the origin level and at the target velocity, descends at `vz`
+ * on average and ends on the target hovering. The number of steps follows
+ * from the descent time.
+ *
+ * @param p Problem data
+ * @param z Starting height above the target
+ * @param v Target velocity along x
+ * @param dt Time step
+ * @param vz Average descent rate, negative
+ * @return
+ *    - 0: Success
+ *    - -1: Invalid arguments
+ */
+int trajectory_landing_setup(struct problem_data *p,
+                             double z,
+                             double v,
+                             double dt,
+                             double vz);
+
+/**
+ * Direct collocation
+ *
+ * The decision vector stacks `[x, vx, z, vz, az, theta]` of every step, in
+ * the layout of `desired` (`load_matrix()`), so it is `6 * nb_steps` long.
+ * The dynamics
+ *
+ *    f = [vx, az sin(theta) - cdx vx, vz, az cos(theta) - g - cdz vz]
+ *
+ * are enforced between consecutive steps with the trapezoidal defects
+ *
+ *    d_k = s_k+1 - s_k - dt / 2 (f_k + f_k+1) = 0
+ *
+ * four per step, `4 * (nb_steps - 1)` in total. Each defect only depends
+ * on the two steps it joins, so the constraint Jacobian is block banded
+ * with 20 non-zeros per step, see `trajectory_constraint_structure()`.
+ *
+ * The cost, weighted by `cost_weights` (missing weights are zero), is
+ *
+ *    w0 (x - x_des)^2 + w1 (z - z_des)^2 + w2 (az - g)^2 + w3 theta^2
+ *    + w4 (az_k+1 - az_k)^2 + w5 (theta_k+1 - theta_k)^2
+ *
+ * summed over the steps. The functions below have the signatures nlopt
+ * expects with `data` pointing to the `problem_data`, see `POpt`.
+ */
+int trajectory_nb_variables(const struct problem_data *p);
+int trajectory_nb_constraints(const struct problem_data *p);
+
+/**
+ * Cost and, if `grad` is not empty, its gradient
+ */
 double trajectory_cost_func(const std::vector<double> &x,
                             std::vector<double> &grad,
                             void *data);
+
+/**
+ * Sum of squared defects and, if `grad` is not empty, its gradient
+ *
+ * A single equality constraint for algorithms that do not take vector
+ * constraints. It is zero only when every defect is, but its gradient
+ * vanishes at the solution too, prefer `trajectory_constraints_func()`.
+ */
 double trajectory_constraint_func(const std::vector<double> &x,
                                   std::vector<double> &grad,
                                   void *data);
+
+/**
+ * Defects and, if `grad` is not null, their dense row-major `m x n`
+ * Jacobian filled from the sparse one (nlopt vector constraint)
+ */
+void trajectory_constraints_func(unsigned m,
+                                 double *result,
+                                 unsigned n,
+                                 const double *x,
+                                 double *grad,
+                                 void *data);
+
+/**
+ * Defects
+ *
+ * @param p Problem data
+ * @param x Decision vector
+ * @param d Defects, `trajectory_nb_constraints()` long
+ */
+void trajectory_defects(const struct problem_data *p,
+                        const double *x,
+                        double *d);
+
+/**
+ * Sparsity structure of the constraint Jacobian, the `(row, col)` of every
+ * non-zero in the order `trajectory_constraint_jacobian()` returns them
+ */
+void trajectory_constraint_structure(const struct problem_data *p,
+                                     std::vector<int> &rows,
+                                     std::vector<int> &cols);
+
+/**
+ * Non-zeros of the constraint Jacobian, in the order of
+ * `trajectory_constraint_structure()`
+ */
+void trajectory_constraint_jacobian(const struct problem_data *p,
+                                    const double *x,
+                                    std::vector<double> &values);
+
+/**
+ * Bounds, the first and last steps are fixed to the initial and final
+ * states and inputs
+ */
+void trajectory_bounds(const struct problem_data *p,
+                       std::vector<double> &lb,
+                       std::vector<double> &ub);
+
+/**
+ * Initial guess from `desired` (see `trajectory_calculate_desired()`),
+ * clamped to the bounds
+ */
+void trajectory_warm_start(const struct problem_data *p,
+                           std::vector<double> &x);
+
+/**
+ * Save solution as a trajectory file
+ *
+ * The columns of the trajectory library (`Trajectory::load()`): the thrust
+ * is normalized by `thrust_max` like the Python planner does, and the
+ * relative states are to a target that moves at `vel_final` and is met at
+ * the final step.
+ *
+ * @param file_path Output file path
+ * @param p Problem data
+ * @param x Solution
+ * @return
+ *    - 0: Success
+ *    - -1: Failed to open file
+ */
+int trajectory_save(const std::string &file_path,
+                    const struct problem_data *p,
+                    const std::vector<double> &x);
+
 int trajectory_record_optimization(std::string file_path,
                                    std::vector<double> x,
                                    int nb_rows);
@@ -0,0 +1,74 @@
+#ifndef ATL_PLANNING_VELOCITY_PROFILE_HPP
+#define ATL_PLANNING_VELOCITY_PROFILE_HPP
+
+#include <math.h>
+
+#include <vector>
+
+#include "atl/planning/path_spline.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Velocity profile along a path
+ *
+ * Speed on a uniform arc length grid of about `ds`, so the speed at an arc
+ * length is one index and one interpolation. The speed is capped by `v_max`
+ * and by `sqrt(a_lat_max / curvature)` at every grid point, then a forward
+ * pass accelerates from `v_start` and a backward pass brakes to `v_end`
+ * under `a_max`. That profile changes its acceleration abruptly where it
+ * reaches a cap and where the passes meet, so its speed is finally averaged
+ * over a moving window of `2 a_max / j_max` in time, which bounds the rate
+ * of change of the acceleration by `j_max` everywhere. The caps are lowered
+ * beforehand to the lowest cap within the distance the window covers, so
+ * the averaged speed stays under them, and the profile takes about the
+ * window longer than without the jerk limit.
+ */
+class VelocityProfile {
+public:
+  bool loaded = false;
+
+  // limits
+  double v_max = 0.5;
+  double a_max = 1.0;
+  double j_max = 2.0;
+  double a_lat_max = 1.0;
+  double v_start = 0.0;
+  double v_end = 0.0;
+
+  // profile, the grid spacing is `ds` rounded to divide the path length
+  double ds = 0.1;
+  double ds_actual = 0.0;
+  double length = 0.0;
+  std::vector<double> speeds;
+
+  VelocityProfile() {}
+
+  /**
+   * Generate the profile along a path
+   *
+   * @param path Path
+   * @return
+   *    - 0: Success
+   *    - -1: Path not loaded
+   *    - -2: Invalid limits
+   */
+  int generate(const PathSpline &path);
+
+  /**
+   * Speed at an arc length
+   *
+   * @param s Arc length, clamped to the path
+   * @return Speed
+   */
+  double speed(const double s) const;
+
+  /**
+   * Time to follow the whole profile
+   */
+  double duration() const;
+};
+
+} // namespace atl
+#endif
@@ -0,0 +1,311 @@
+#ifndef ATL_QUADROTOR_CONTROL_EXECUTOR_HPP
+#define ATL_QUADROTOR_CONTROL_EXECUTOR_HPP
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <atomic>
+#include <thread>
+
+#include "atl/quadrotor/quadrotor.hpp"
+#include "atl/quadrotor/state_store.hpp"
+#include "atl/utils/ring_buffer.hpp"
+#include "atl/utils/triple_buffer.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+#define EXECUTOR_HISTOGRAM_BINS 64
+#define EXECUTOR_COMMAND_CAPACITY 64
+
+/**
+ * Timing histogram with fixed width bins, the last bin collects everything
+ * beyond it. Counters are atomic so another thread may read them while the
+ * executor is running.
+ */
+struct TimingHistogram {
+  double bin_width = 10e-6;
+  std::atomic<uint64_t> counts[EXECUTOR_HISTOGRAM_BINS];
+  std::atomic<uint64_t> nb_samples{0};
+  std::atomic<uint64_t> max_ns{0};
+
+  TimingHistogram() { this->reset(); }
+
+  /**
+   * Reset counts
+   */
+  void reset();
+
+  /**
+   * Add sample
+   *
+   * @param t Time in seconds
+   */
+  void add(const double t);
+
+  /**
+   * Percentile
+   *
+   * @param p Percentile between 0 and 1
+   * @return Upper edge of the bin the percentile falls in, in seconds
+   */
+  double percentile(const double p) const;
+
+  /**
+   * @return Largest sample in seconds
+   */
+  double max() const;
+};
+
+/**
+ * Controller gains, the axes are x, y, z
+ */
+struct ControllerGains {
+  double k_p[3] = {0.0, 0.0, 0.0};
+  double k_i[3] = {0.0, 0.0, 0.0};
+  double k_d[3] = {0.0, 0.0, 0.0};
+  double roll_limit[2] = {0.0, 0.0};
+  double pitch_limit[2] = {0.0, 0.0};
+  double hover_throttle = 0.0;
+  double track_offset[3] = {0.0, 0.0, 0.0}; // tracking controller only
+};
+
+/**
+ * Control command types
+ */
+enum ControlCommandType {
+  COMMAND_SET_MODE,
+  COMMAND_SET_YAW,
+  COMMAND_SET_HOME_POINT,
+  COMMAND_SET_HOVER_POSITION,
+  COMMAND_SET_HOVER_HEIGHT,
+  COMMAND_SET_OFFBOARD_SETPOINT,
+  COMMAND_SET_POSITION_GAINS,
+  COMMAND_SET_TRACKING_GAINS,
+  COMMAND_RESET
+};
+
+/**
+ * Control command, plain data so it is queued by copy without allocating.
+ * `values` holds the arguments of the command in the order of the
+ * corresponding `ControlExecutor` setter, `gains` the controller gains.
+ */
+struct ControlCommand {
+  enum ControlCommandType type = COMMAND_RESET;
+  enum Mode mode = NOT_SET;
+  double values[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  ControllerGains gains;
+};
+
+/**
+ * Fixed-rate control executor
+ *
+ * Runs `Quadrotor::step()` on a dedicated thread at a fixed period. Every
+ * period starts at an absolute deadline on `CLOCK_MONOTONIC`, so the rate
+ * does not drift with the time the step takes. The thread can optionally be
+ * scheduled with `SCHED_FIFO` and pinned to a CPU.
+ *
+ * While running the executor owns the quadrotor. Other threads publish the
+ * latest pose, velocity, landing target and radio into `state`, post
+ * anything else that changes the quadrotor (mode, setpoints, gains) as a
+ * command with the setters below, and read back the attitude command of the
+ * last step from `att_cmd`. Commands go through a preallocated wait-free
+ * ring buffer, so posting never locks or allocates and neither does the
+ * step, but they must all be posted from one thread.
+ */
+class ControlExecutor {
+public:
+  bool configured = false;
+  std::atomic<bool> running{false};
+
+  double rate = 100.0;
+  bool realtime = false;
+  int priority = 80;
+  int cpu = -1;
+
+  Quadrotor *quadrotor = nullptr;
+  std::thread thread;
+
+  // inputs
+  StateStore state;
+  StateSnapshot snapshot;
+  RingBuffer<ControlCommand, EXECUTOR_COMMAND_CAPACITY> commands;
+  std::atomic<bool> paused{false};
+
+  // outputs
+  TripleBuffer<AttitudeCommand> att_cmd;
+  std::atomic<int> mode{NOT_SET};
+  std::atomic<int> step_retval{0};
+
+  // timing
+  TimingHistogram jitter;
+  TimingHistogram execution;
+  std::atomic<uint64_t> nb_steps{0};
+  std::atomic<uint64_t> nb_overruns{0};
+  std::atomic<uint64_t> nb_missed{0};
+
+  ControlExecutor() {}
+  ~ControlExecutor() { this->stop(); }
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to configuration file (YAML)
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Invalid rate
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Start executor thread
+   *
+   * Failing to set the real-time scheduling policy or CPU affinity (for
+   * example without the privileges to do so) is logged and the executor
+   * runs with the default scheduling instead.
+   *
+   * @param quadrotor Quadrotor to step
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   *    - -2: Quadrotor not configured
+   *    - -3: Already running
+   */
+  int start(Quadrotor &quadrotor);
+
+  /**
+   * Stop executor thread and wait for it to finish
+   */
+  void stop();
+
+  /**
+   * Post command to apply to the quadrotor before the next step, commands
+   * are applied in the order they were posted
+   *
+   * @param command Command
+   * @return
+   *    - 0: Success
+   *    - -1: Command queue full, the command is dropped
+   */
+  int post(const ControlCommand &command);
+
+  /**
+   * Set mode, the mode is checked the same way as `Quadrotor::setMode()`
+   * when posted so an invalid mode is reported to the caller
+   *
+   * @param mode Mode
+   * @return
+   *    - 0: Success
+   *    - -1: Quadrotor not configured
+   *    - -2: Invalid mode
+   *    - -3: Command queue full
+   */
+  int setMode(const enum Mode mode);
+
+  /**
+   * Set yaw
+   *
+   * @param yaw Yaw in radians
+   * @return 0 for success, -1 if the command queue is full
+   */
+  int setYaw(const double yaw);
+
+  /**
+   * Set home point
+   *
+   * @param latitude Latitude in decimal format
+   * @param longitude Longitude in decimal format
+   * @return 0 for success, -1 if the command queue is full
+   */
+  int setHomePoint(const double latitude, const double longitude);
+
+  /**
+   * Set hover position
+   *
+   * @param position Position
+   * @return 0 for success, -1 if the command queue is full
+   */
+  int setHoverPosition(const Vec3 &position);
+
+  /**
+   * Set hover height
+   *
+   * @param height Height
+   * @return 0 for success, -1 if the command queue is full
+   */
+  int setHoverHeight(const double height);
+
+  /**
+   * Set offboard setpoint
+   *
+   * @param position Position setpoint in world frame
+   * @param velocity Velocity setpoint in world frame
+   * @param acceleration Acceleration feed-forward in world frame
+   * @return 0 for success, -1 if the command queue is full
+   */
+  int setOffboardSetpoint(const Vec3 &position,
+                          const Vec3 &velocity,
+                          const Vec3 &acceleration);
+
+  /**
+   * Set position controller gains
+   *
+   * @param gains Gains
+   * @return 0 for success, -1 if the command queue is full
+   */
+  int setPositionGains(const ControllerGains &gains);
+
+  /**
+   * Set tracking controller gains
+   *
+   * @param gains Gains
+   * @return 0 for success, -1 if the command queue is full
+   */
+  int setTrackingGains(const ControllerGains &gains);
+
+  /**
+   * Reset quadrotor
+   *
+   * @return 0 for success, -1 if the command queue is full
+   */
+  int reset();
+
+  /**
+   * Apply command to the quadrotor, called by the executor thread
+   *
+   * @param command Command
+   * @return Return value of the quadrotor call the command maps to
+   */
+  int apply(const ControlCommand &command);
+
+  /**
+   * Step quadrotor once with the latest inputs, called by the executor
+   * thread every period. While paused only the inputs and commands are
+   * applied.
+   *
+   * @param dt Time difference in seconds
+   * @return Return value of `Quadrotor::step()`, 0 while paused
+   */
+  int step(const double dt);
+
+  /**
+   * Reset timing statistics
+   */
+  void resetStats();
+
+  /**
+   * Print timing statistics
+   */
+  void printStats();
+
+  /**
+   * Executor thread loop
+   */
+  void loop();
+};
+
+} // namespace atl
+#endif
@@ -0,0 +1,204 @@
+#ifndef ATL_QUADROTOR_LANDING_SIM_HPP
+#define ATL_QUADROTOR_LANDING_SIM_HPP
+
+#include <libgen.h>
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atl/estimation/kf_tracker.hpp"
+#include "atl/models/quadrotor.hpp"
+#include "atl/models/two_wheel.hpp"
+#include "atl/quadrotor/quadrotor.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+/**
+ * Components of a landing simulation step that are timed
+ */
+enum LandingSimComponent {
+  SIM_TARGET = 0,
+  SIM_DETECTOR = 1,
+  SIM_TRACKER = 2,
+  SIM_QUADROTOR = 3,
+  SIM_MODEL = 4,
+  SIM_NB_COMPONENTS = 5
+};
+
+/**
+ * Landing episode, its randomized conditions and outcome
+ *
+ * Outcomes:
+ * - `landed`: touched down within `success_radius` of the target
+ * - `missed`: touched down further away
+ * - `crashed`: hit the ground or diverged
+ * - `timeout`: still flying at the end of the episode
+ */
+struct LandingEpisode {
+  int index = 0;
+  unsigned int seed = 0;
+
+  // conditions
+  Vec3 quad_start{0.0, 0.0, 0.0};
+  Vec3 target_start{0.0, 0.0, 0.0};
+  double target_speed = 0.0;
+  double target_turn_rate = 0.0;
+  double detection_noise = 0.0;
+  double detection_dropout = 0.0;
+  Vec3 wind{0.0, 0.0, 0.0};
+
+  // outcome
+  std::string outcome = "timeout";
+  bool success = false;
+  double touchdown_error = 0.0;
+  double touchdown_time = 0.0;
+  enum Mode final_mode = NOT_SET;
+  int nb_detections = 0;
+
+  // time spent per component in seconds
+  int nb_steps = 0;
+  double timing[SIM_NB_COMPONENTS] = {0.0, 0.0, 0.0, 0.0, 0.0};
+};
+
+/**
+ * Monte Carlo closed loop landing simulation
+ *
+ * Every episode flies the real `Quadrotor` mode logic and controllers
+ * against `QuadrotorModel`, landing on a ground vehicle driven by
+ * `TwoWheelRobot2DModel`. A synthetic tag detector measures the target
+ * position relative to the quadrotor at `detection_rate` with gaussian
+ * noise and random dropouts, while the target is within the camera field
+ * of view. The measurements are filtered by a `KFTracker` with a constant
+ * acceleration model, whose estimate is the landing target of the
+ * quadrotor. The yaw is held at zero, so the body planar frame of the
+ * quadrotor is the world frame shifted to the quadrotor.
+ *
+ * The start offsets, target speed and turn rate, detection noise and
+ * dropout rate and wind are drawn uniformly from their ranges with a
+ * generator seeded by `seed + index`, so an episode is reproducible on its
+ * own and the results do not depend on the number of threads. The
+ * quadrotor runs on the simulated clock, an episode takes milliseconds.
+ */
+class LandingSim {
+public:
+  bool configured = false;
+
+  // components
+  std::string quadrotor_config;
+  std::string tracker_config;
+
+  // simulation
+  double dt = 0.01;
+  double duration = 60.0;
+  int nb_episodes = 100;
+  unsigned int seed = 1;
+  int nb_threads = 0;
+  double success_radius = 0.3;
+  double touchdown_height = 0.1;
+
+  // detector
+  double detection_rate = 30.0;
+  double camera_fov = deg2rad(90.0);
+  double detection_timeout = 0.5;
+
+  // randomization ranges (min, max)
+  Vec2 quad_offset{0.0, 0.5};
+  Vec2 target_offset{0.0, 1.0};
+  Vec2 target_speed{0.0, 0.5};
+  Vec2 target_turn_rate{-0.2, 0.2};
+  Vec2 detection_noise{0.01, 0.05};
+  Vec2 detection_dropout{0.0, 0.2};
+  Vec2 wind{0.0, 0.2};
+
+  // results
+  std::vector<LandingEpisode> episodes;
+  double elapsed = 0.0;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  LandingSim() {}
+
+  /**
+   * Configure
+   *
+   * @param config_file Path to config file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to load config file
+   *    - -2: Failed to configure quadrotor or tracker
+   *    - -3: Invalid simulation settings
+   */
+  int configure(const std::string &config_file);
+
+  /**
+   * Draw the conditions of an episode
+   *
+   * @param index Episode index
+   * @return Episode with its conditions set
+   */
+  LandingEpisode sample(const int index) const;
+
+  /**
+   * Simulate one episode
+   *
+   * @param episode Episode with its conditions set, the outcome is written
+   * back
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to configure quadrotor or tracker
+   */
+  int simulate(LandingEpisode &episode) const;
+
+  /**
+   * Run `nb_episodes` episodes in parallel, the results are kept in
+   * `episodes`
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   */
+  int run();
+
+  /**
+   * @return Fraction of episodes that landed on the target
+   */
+  double successRate() const;
+
+  /**
+   * Touchdown error percentile over the episodes that touched down
+   *
+   * @param p Percentile between 0 and 1
+   * @return Touchdown error in meters, or -1 if none touched down
+   */
+  double touchdownError(const double p) const;
+
+  /**
+   * Save report with the success rate, touchdown error distribution and
+   * per component timing
+   *
+   * @param report_file Path to report file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to write report file
+   */
+  int saveReport(const std::string &report_file) const;
+
+  /**
+   * Save one line per episode with its conditions and outcome
+   *
+   * @param output_file Path to output CSV file
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to write output file
+   */
+  int saveEpisodes(const std::string &output_file) const;
+};
+
+} // namespace atl
+#endif
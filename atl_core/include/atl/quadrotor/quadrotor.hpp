@@ -16,12 +16,15 @@ namespace atl {
 #define INFO_TMODE "[TRACKING_MODE]!"
 #define INFO_LMODE "[LANDING_MODE]!"
 #define INFO_WMODE "[WAYPOINT_MODE]!"
+#define INFO_OMODE "[OFFBOARD_MODE]!"
 #define EINVMODE "Invalid quadrotor mode!"
 #define FCONFQUAD "Failed to configure quadrotor!"
 #define FCONFPCTRL "Failed to configure position controller!"
 #define FCONFTCTRL "Failed to configure tracking controller!"
 #define FCONFLCTRL "Failed to configure landing controller!"
+#define FCONFLMPC "Failed to configure landing MPC!"
 #define FCONFWCTRL "Failed to configure waypoint controller!"
+#define FCONFGCTRL "Failed to configure geometric controller!"
 #define FCONFHMODE "Failed to configure hover mode!"
 #define FCONFDMODE "Failed to configure discover mode!"
 #define FCONFTMODE "Failed to configure tracking mode!"
@@ -45,9 +48,35 @@ enum Mode {
   DISCOVER_MODE = 2,
   TRACKING_MODE = 3,
   LANDING_MODE = 4,
-  WAYPOINT_MODE = 5
+  WAYPOINT_MODE = 5,
+  OFFBOARD_MODE = 6
 };
 
+/**
+ * Superstates of the mode state machine, they group modes that share
+ * transitions and are never the current mode themselves
+ */
+enum ModeGroup {
+  FLIGHT_MODES = 100, // every mode but disarm
+  TARGET_MODES = 101  // tracking and landing, left when the target is lost
+};
+
+/**
+ * Quadrotor
+ *
+ * Modes are the states of a table driven hierarchical state machine,
+ * `mode_machine`, set up by `configure()`. Every `step()` runs the
+ * controller of the current mode and then fires the first transition whose
+ * guard holds. `current_mode` mirrors the current state of the machine, use
+ * `setMode()` to change it.
+ *
+ * Timers in the guards, how long a mode has been active or since the
+ * target was last seen, read `clock`. It defaults to `CLOCK_MONOTONIC`, so
+ * the timers do not jump when the wall clock is set. Only simulations and
+ * tests replace it, with a simulated clock to run whole missions faster than
+ * real time. The guards and actions refer to this quadrotor, so it must not
+ * be copied after it is configured.
+ */
 class Quadrotor {
 public:
   bool configured = false;
@@ -56,7 +85,9 @@ public:
   PositionController position_controller;
   TrackingController tracking_controller;
   LandingController landing_controller;
+  LandingMPC landing_mpc;
   WaypointController waypoint_controller;
+  GeometricController geometric_controller;
   AttitudeCommand att_cmd;
 
   double recover_height = 0.0;
@@ -67,10 +98,11 @@ public:
   double min_discover_time = FLT_MAX;
   double min_tracking_time = FLT_MAX;
 
-  struct timespec discover_tic = {0, 0};
-  struct timespec tracking_tic = {0, 0};
-  struct timespec landing_tic = {0, 0};
-  struct timespec waypoint_tic = {0, 0};
+  std::function<double(void)> clock = time_monotonic;
+  StateMachine mode_machine;
+  double target_last_seen = -1.0;
+  double waypoint_tic = 0.0;
+  int waypoint_retval = 0;
   bool waypoint_countdown[4] = {false, false, false, false};
 
   bool home_set = false;
@@ -84,9 +116,16 @@ public:
   Pose pose;
   Vec3 velocity = Vec3::Zero();
   Vec3 hover_position = Vec3::Zero();
+  Vec3 offboard_position = Vec3::Zero();
+  Vec3 offboard_velocity = Vec3::Zero();
+  Vec3 offboard_acceleration = Vec3::Zero();
   LandingTarget landing_target;
   LandingTarget landing_target_prev;
 
+  bool landing_mpc_enabled = false;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
   Quadrotor() {}
 
   /**
@@ -98,6 +137,30 @@ public:
    */
   int configure(const std::string &config_path);
 
+  /**
+   * Set up mode state machine, its states, guards and actions
+   *
+   * @return
+   *    - 0: Success
+   *    - -1: Failed to set up state machine
+   */
+  int configureModes();
+
+  /**
+   * Check whether the landing target is detected and not lost
+   *
+   * @return True if target acquired
+   */
+  bool targetAcquired();
+
+  /**
+   * Check whether the landing target has not been seen for longer than
+   * `target_lost_threshold` according to `clock`
+   *
+   * @return True if target lost
+   */
+  bool targetLost();
+
   /**
    * Set home point
    *
@@ -110,12 +173,13 @@ public:
   int setHomePoint(const double latitude, const double longitude);
 
   /**
-   * Set mode
+   * Set mode, runs the exit and entry actions of the mode state machine
    *
    * @param mode Mode
    * @return
    *    - 0: Success
    *    - -1: Not configured
+   *    - -2: Invalid mode
    */
   int setMode(const enum Mode &mode);
 
@@ -199,6 +263,21 @@ public:
    */
   int setHoverPosition(const Vec3 &position);
 
+  /**
+   * Set offboard setpoint, the offboard mode tracks it with the geometric
+   * controller
+   *
+   * @param position Position setpoint in world frame
+   * @param velocity Velocity setpoint in world frame
+   * @param acceleration Acceleration feed-forward in world frame
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   */
+  int setOffboardSetpoint(const Vec3 &position,
+                          const Vec3 &velocity,
+                          const Vec3 &acceleration);
+
   /**
    *  Check whether all conditions have been met
    *
@@ -262,6 +341,16 @@ public:
    */
   int stepWaypointMode(const double dt);
 
+  /**
+   * Step offboard mode
+   *
+   * @param dt Time difference in seconds
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured
+   */
+  int stepOffboardMode(const double dt);
+
   /**
    * Rest quadrotor
    *
@@ -272,7 +361,7 @@ public:
   int reset();
 
   /**
-   * Step quadrotor
+   * Step quadrotor, runs the current mode and then the mode transitions
    *
    * @return
    *    - 0: Success
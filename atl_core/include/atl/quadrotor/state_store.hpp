@@ -0,0 +1,114 @@
+#ifndef ATL_QUADROTOR_STATE_STORE_HPP
+#define ATL_QUADROTOR_STATE_STORE_HPP
+
+#include "atl/data/data.hpp"
+#include "atl/utils/seqlock.hpp"
+#include "atl/utils/utils.hpp"
+
+namespace atl {
+
+#define RADIO_MAX_AXES 8
+
+/**
+ * Coefficients of a fixed-size vector or quaternion
+ *
+ * Eigen types are not trivially copyable, so the state store publishes
+ * their coefficients through its `Seqlock` channels. Converts implicitly
+ * from the Eigen type, quaternions are stored as `coeffs()` (x, y, z, w).
+ */
+template <int N>
+struct Coefficients {
+  double values[N];
+
+  Coefficients() : values{} {}
+
+  template <typename Derived>
+  Coefficients(const Eigen::MatrixBase<Derived> &vector) {
+    Eigen::Map<Eigen::Matrix<double, N, 1>>(this->values) = vector;
+  }
+
+  Coefficients(const Quaternion &q) : Coefficients(q.coeffs()) {}
+
+  Eigen::Matrix<double, N, 1> vector() const {
+    return Eigen::Map<const Eigen::Matrix<double, N, 1>>(this->values);
+  }
+};
+
+/**
+ * Landing target as seen by the control loop
+ */
+struct ControlTarget {
+  Vec3 position{0.0, 0.0, 0.0};
+  Vec3 velocity{0.0, 0.0, 0.0};
+  bool detected = false;
+};
+
+/**
+ * Radio sticks and switches
+ */
+struct RadioState {
+  double axes[RADIO_MAX_AXES] = {0.0};
+  int nb_axes = 0;
+};
+
+/**
+ * Coherent snapshot of the state store
+ *
+ * Besides the state it keeps the sequence number of every channel it was
+ * read from, so the next read can tell which parts of the state changed.
+ */
+struct StateSnapshot {
+  Pose pose;
+  Vec3 velocity{0.0, 0.0, 0.0};
+  ControlTarget target;
+  RadioState radio;
+
+  bool pose_updated = false;
+  bool velocity_updated = false;
+  bool target_updated = false;
+  bool radio_updated = false;
+
+  uint32_t sequences[7] = {0, 0, 0, 0, 0, 0, 0};
+};
+
+/**
+ * State store
+ *
+ * Typed channels for the pose, velocity, landing target and radio inputs
+ * of the control loop. Every channel is a `Seqlock` with a single
+ * producer, so the pose and target are split into one channel per field
+ * since different callbacks produce them. Producers publish wait-free and
+ * `read()` returns a snapshot in which no channel changed while it was
+ * copied.
+ */
+class StateStore {
+public:
+  // pose
+  Seqlock<Coefficients<3>> position{Vec3{0.0, 0.0, 0.0}};
+  Seqlock<Coefficients<4>> orientation{Quaternion{1.0, 0.0, 0.0, 0.0}};
+
+  // velocity
+  Seqlock<Coefficients<3>> velocity{Vec3{0.0, 0.0, 0.0}};
+
+  // landing target
+  Seqlock<Coefficients<3>> target_position{Vec3{0.0, 0.0, 0.0}};
+  Seqlock<Coefficients<3>> target_velocity{Vec3{0.0, 0.0, 0.0}};
+  Seqlock<bool> target_detected{false};
+
+  // radio
+  Seqlock<RadioState> radio;
+
+  StateStore() {}
+
+  /**
+   * Read coherent snapshot
+   *
+   * @param snapshot Snapshot, holds the previous snapshot of this consumer
+   *                 on input so the updated flags can be set
+   * @return Number of retries because a producer wrote during the read
+   */
+  int read(StateSnapshot &snapshot) const;
+};
+
+} // namespace atl
+#endif
@@ -180,7 +180,7 @@ public:
   float pitch_offset;
   float roll_offset;
 
-  clock_t last_updated;
+  struct timespec last_updated;
   float sample_rate;
   int8_t dplf_config;
 
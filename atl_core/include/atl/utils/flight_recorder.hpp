@@ -0,0 +1,176 @@
+#ifndef ATL_UTILS_FLIGHT_RECORDER_HPP
+#define ATL_UTILS_FLIGHT_RECORDER_HPP
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atl/utils/data.hpp"
+#include "atl/utils/log.hpp"
+#include "atl/utils/math.hpp"
+
+namespace atl {
+
+#define FLIGHT_LOG_MAGIC "ATLFDR\r\n"
+#define FLIGHT_LOG_VERSION 1
+
+/**
+ * Flight data recorder
+ *
+ * Records fixed-schema rows of doubles from the control loop into a binary
+ * flight log. `record()` copies the row into a preallocated single producer
+ * single consumer ring buffer and publishes it with one atomic store, it
+ * never allocates, locks or calls into the OS, so its worst-case cost is a
+ * copy of `fields.size()` doubles. When the ring buffer is full the row is
+ * dropped and counted in `nb_dropped` instead of waiting on the writer.
+ *
+ * A background writer thread drains the ring buffer every `flush_period`
+ * seconds into the log file. The file starts with a schema header:
+ *
+ *     char magic[8]         FLIGHT_LOG_MAGIC
+ *     uint32_t version      FLIGHT_LOG_VERSION
+ *     uint32_t nb_fields
+ *     nb_fields x {uint32_t length, char name[length]}
+ *
+ * followed by chunks of rows:
+ *
+ *     uint32_t nb_rows
+ *     double rows[nb_rows][nb_fields]
+ *
+ * in the host byte order, so a log is only loaded on a machine of the same
+ * endianness. Load it with `flight_log_load()` or convert it with
+ * `flight_log2csv()` and `flight_log2npy()`.
+ */
+class FlightRecorder {
+public:
+  std::atomic<bool> configured{false};
+  std::string file_path;
+  std::vector<std::string> fields;
+  size_t nb_fields = 0;
+
+  // ring buffer, capacity in rows rounded up to a power of two
+  size_t capacity = 0;
+  std::vector<double> ring;
+
+  // writer
+  size_t chunk_size = 256;
+  double flush_period = 0.05;
+  FILE *file = NULL;
+  std::thread writer;
+  std::atomic<bool> running{false};
+  std::mutex writer_mutex;
+  std::condition_variable writer_cv; // wakes the writer up on close()
+
+  // ring buffer positions, padded onto separate cache lines so the control
+  // thread and the writer do not contend on them
+  std::atomic<uint64_t> head{0};
+  char pad0[64 - sizeof(std::atomic<uint64_t>)];
+  std::atomic<uint64_t> tail{0};
+  char pad1[64 - sizeof(std::atomic<uint64_t>)];
+
+  // statistics
+  std::atomic<uint64_t> nb_dropped{0};
+  uint64_t nb_written = 0;
+
+  FlightRecorder() {}
+  ~FlightRecorder() { this->close(); }
+
+  /**
+   * Configure, opens the flight log, writes the schema header and starts
+   * the writer thread
+   *
+   * @param file_path Path to flight log
+   * @param fields Field names of a row
+   * @param capacity Ring buffer capacity in rows
+   * @return
+   *    - 0: Success
+   *    - -1: Invalid schema or capacity
+   *    - -2: Failed to open or write flight log
+   */
+  int configure(const std::string &file_path,
+                const std::vector<std::string> &fields,
+                const size_t capacity = 4096);
+
+  /**
+   * Record row, producer side, safe to call from the control thread
+   *
+   * @param values Row of `fields.size()` values
+   * @return
+   *    - 0: Success
+   *    - -1: Not configured or ring buffer full, row dropped
+   */
+  int record(const double *values);
+
+  /**
+   * Write pending rows to the flight log, consumer side, only called by the
+   * writer thread or once it stopped
+   *
+   * @return Number of rows written, -1 on a write error
+   */
+  int drain();
+
+  /**
+   * Stop writer thread, write pending rows and close flight log
+   */
+  void close();
+
+  /**
+   * Writer thread loop
+   */
+  void loop();
+};
+
+/**
+ * Load flight log
+ *
+ * A truncated last chunk, for example from a crash mid-flight, is loaded up
+ * to its last complete row.
+ *
+ * @param file_path Path to flight log
+ * @param fields Field names
+ * @param data Rows of the flight log
+ * @return
+ *    - 0: Success
+ *    - -1: Failed to open flight log
+ *    - -2: Invalid flight log
+ */
+int flight_log_load(const std::string &file_path,
+                    std::vector<std::string> &fields,
+                    MatX &data);
+
+/**
+ * Convert flight log to CSV with the field names as header
+ *
+ * @param log_path Path to flight log
+ * @param csv_path Path to CSV output
+ * @return
+ *    - 0: Success
+ *    - -1: Failed to load flight log
+ *    - -2: Failed to write CSV file
+ */
+int flight_log2csv(const std::string &log_path, const std::string &csv_path);
+
+/**
+ * Convert flight log to a NumPy `.npy` file holding a structured array
+ * with one named `float64` field per flight log field
+ *
+ * @param log_path Path to flight log
+ * @param npy_path Path to NumPy output
+ * @return
+ *    - 0: Success
+ *    - -1: Failed to load flight log
+ *    - -2: Failed to write NumPy file
+ */
+int flight_log2npy(const std::string &log_path, const std::string &npy_path);
+
+} // namespace atl
+#endif
@@ -102,7 +102,7 @@ void load_matrix(const std::vector<double> &x,
  * @param A Matrix
  * @param x Output vector of matrix values
  */
-void load_matrix(const MatX A, std::vector<double> &x);
+void load_matrix(const MatX &A, std::vector<double> &x);
 
 /**
  * Wrap angle in degrees to 180
@@ -206,6 +206,20 @@ Mat3 roty(const double angle);
  */
 Mat3 rotz(const double angle);
 
+/**
+ * Skew symmetric matrix
+ * @param x Input vector
+ * @return Skew symmetric matrix such that `skew(x) * y == x.cross(y)`
+ */
+Mat3 skew(const Vec3 &x);
+
+/**
+ * Convert rotation vector (axis scaled by angle) to quaternion
+ * @param rvec Input rotation vector
+ * @return Output quaternion
+ */
+Quaternion rvec2quat(const Vec3 &rvec);
+
 /**
  * Convert Euler 1-2-3 angles to quaternion
  * @param euler Input Euler angles
@@ -0,0 +1,85 @@
+#ifndef ATL_UTILS_RING_BUFFER_HPP
+#define ATL_UTILS_RING_BUFFER_HPP
+
+#include <stdint.h>
+
+#include <atomic>
+#include <type_traits>
+
+namespace atl {
+
+/**
+ * Ring buffer
+ *
+ * Preallocated first in first out queue of up to `N` values of type `T`
+ * between one producer thread and one consumer thread. Pushing and popping
+ * are wait-free, each side only stores its own position and loads the
+ * other's, and neither ever allocates. A push into a full buffer fails
+ * instead of waiting on the consumer. `N` must be a power of two and `T`
+ * trivially copyable.
+ */
+template <typename T, int N>
+class RingBuffer {
+public:
+  static_assert(N > 0 && (N & (N - 1)) == 0,
+                "RingBuffer capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "RingBuffer value must be trivially copyable");
+
+  T buffer[N];
+
+  // positions, padded onto separate cache lines so the producer and the
+  // consumer do not contend on them
+  std::atomic<uint32_t> head{0};
+  char pad0[64 - sizeof(std::atomic<uint32_t>)];
+  std::atomic<uint32_t> tail{0};
+  char pad1[64 - sizeof(std::atomic<uint32_t>)];
+
+  RingBuffer() {}
+
+  /**
+   * Push value, producer side
+   *
+   * @param value Value
+   * @return True if pushed, false if the buffer is full
+   */
+  bool push(const T &value) {
+    const uint32_t tail = this->tail.load(std::memory_order_relaxed);
+    if (tail - this->head.load(std::memory_order_acquire) == (uint32_t) N) {
+      return false;
+    }
+
+    this->buffer[tail & (N - 1)] = value;
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Pop oldest value, consumer side
+   *
+   * @param value Value
+   * @return True if popped, false if the buffer is empty
+   */
+  bool pop(T &value) {
+    const uint32_t head = this->head.load(std::memory_order_relaxed);
+    if (head == this->tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    value = this->buffer[head & (N - 1)];
+    this->head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @return Number of values in the buffer, exact only on either side while
+   * the other is idle
+   */
+  int size() const {
+    return (int) (this->tail.load(std::memory_order_acquire) -
+                  this->head.load(std::memory_order_acquire));
+  }
+};
+
+} // namespace atl
+#endif
@@ -0,0 +1,112 @@
+#ifndef ATL_UTILS_SEQLOCK_HPP
+#define ATL_UTILS_SEQLOCK_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <type_traits>
+
+namespace atl {
+
+/**
+ * Sequence lock
+ *
+ * Latest value of type `T` written by one producer thread and read by any
+ * number of consumer threads. Writing is wait-free, the sequence number is
+ * odd while a write is in progress and readers retry when it changed under
+ * them. The value is kept in atomic words so a reader racing a writer never
+ * reads a torn word, `T` must therefore be trivially copyable. Eigen types
+ * are not, publish their coefficients instead.
+ */
+template <typename T>
+class Seqlock {
+public:
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Seqlock value must be trivially copyable");
+  static const int NB_WORDS = (sizeof(T) + 7) / 8;
+
+  std::atomic<uint32_t> sequence{0};
+  std::atomic<uint64_t> words[NB_WORDS];
+
+  Seqlock(const T &value = T()) { this->store(value); }
+
+  /**
+   * Write value, producer side
+   *
+   * @param value Value
+   */
+  void write(const T &value) {
+    const uint32_t seq = this->sequence.load(std::memory_order_relaxed);
+    this->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->store(value);
+    this->sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  /**
+   * Begin read
+   *
+   * @return Sequence number, odd if a write is in progress
+   */
+  uint32_t readBegin() const {
+    return this->sequence.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Copy value, only valid if `readValid()` holds afterwards
+   *
+   * @param value Value
+   */
+  void readCopy(T &value) const {
+    uint64_t buf[NB_WORDS];
+    for (int i = 0; i < NB_WORDS; i++) {
+      buf[i] = this->words[i].load(std::memory_order_relaxed);
+    }
+    memcpy(&value, buf, sizeof(T));
+  }
+
+  /**
+   * Check read
+   *
+   * @param seq Sequence number returned by `readBegin()`
+   * @return True if no write happened since `readBegin()`
+   */
+  bool readValid(const uint32_t seq) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint32_t seq_end = this->sequence.load(std::memory_order_relaxed);
+    return (seq & 1) == 0 && seq == seq_end;
+  }
+
+  /**
+   * Read value, consumer side
+   *
+   * @param value Value
+   * @return Sequence number of the value read
+   */
+  uint32_t read(T &value) const {
+    uint32_t seq;
+    do {
+      seq = this->readBegin();
+      this->readCopy(value);
+    } while (this->readValid(seq) == false);
+
+    return seq;
+  }
+
+  /**
+   * Store value into words
+   *
+   * @param value Value
+   */
+  void store(const T &value) {
+    uint64_t buf[NB_WORDS] = {0};
+    memcpy(buf, &value, sizeof(T));
+    for (int i = 0; i < NB_WORDS; i++) {
+      this->words[i].store(buf[i], std::memory_order_relaxed);
+    }
+  }
+};
+
+} // namespace atl
+#endif
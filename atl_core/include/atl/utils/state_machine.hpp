@@ -0,0 +1,172 @@
+#ifndef ATL_UTILS_STATE_MACHINE_HPP
+#define ATL_UTILS_STATE_MACHINE_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "atl/utils/log.hpp"
+#include "atl/utils/time.hpp"
+
+namespace atl {
+
+/**
+ * State of a `StateMachine`
+ *
+ * - `parent`: Id of the parent state, or -1 for a top level state
+ * - `entry`: Called when the state is entered, may be empty
+ * - `exit`: Called when the state is exited, may be empty
+ */
+struct SMState {
+  int id = -1;
+  std::string name;
+  int parent = -1;
+  std::function<void(void)> entry;
+  std::function<void(void)> exit;
+};
+
+/**
+ * Transition of a `StateMachine`
+ *
+ * - `guard`: Transition fires when it returns true, an empty guard always
+ *   fires
+ * - `action`: Called between the exit and entry actions, may be empty
+ */
+struct SMTransition {
+  int from = -1;
+  int to = -1;
+  std::function<bool(void)> guard;
+  std::function<void(void)> action;
+};
+
+/**
+ * Table driven hierarchical state machine
+ *
+ * States form a tree through their parent. Being in a state means being in
+ * all of its ancestors too, so a transition out of a parent applies to
+ * every state below it. `update()` checks the transitions of the current
+ * state first, then those of its parent and so on, and fires the first one
+ * whose guard holds, in the order they were added.
+ *
+ * A transition exits the states from the current state up to, but not
+ * including, the closest common ancestor with the target, runs the
+ * transition action and enters the states from below the common ancestor
+ * down to the target. A transition to the current state exits and re-enters
+ * it.
+ *
+ * Time in state comes from `clock`, which defaults to `CLOCK_MONOTONIC`. Set
+ * it to a simulated clock to run the state machine faster than real time.
+ */
+class StateMachine {
+public:
+  std::vector<SMState> states;
+  std::vector<SMTransition> transitions;
+  std::function<double(void)> clock = time_monotonic;
+
+  int current = -1;
+  double entry_time = 0.0;
+
+  StateMachine() {}
+
+  /**
+   * Add state
+   *
+   * @param id State id, must not be negative
+   * @param name State name
+   * @param parent Parent state id, or -1 for a top level state
+   * @param entry Entry action
+   * @param exit Exit action
+   * @return
+   *    - 0: Success
+   *    - -1: Invalid or duplicate id
+   *    - -2: Parent not found
+   */
+  int addState(const int id,
+               const std::string &name,
+               const int parent = -1,
+               const std::function<void(void)> &entry = nullptr,
+               const std::function<void(void)> &exit = nullptr);
+
+  /**
+   * Add transition
+   *
+   * @param from Source state id
+   * @param to Target state id
+   * @param guard Guard
+   * @param action Transition action
+   * @return
+   *    - 0: Success
+   *    - -1: State not found
+   */
+  int addTransition(const int from,
+                    const int to,
+                    const std::function<bool(void)> &guard,
+                    const std::function<void(void)> &action = nullptr);
+
+  /**
+   * Enter state and its ancestors, without exiting the current state
+   *
+   * @param id State id
+   * @return
+   *    - 0: Success
+   *    - -1: State not found
+   */
+  int start(const int id);
+
+  /**
+   * Exit the current state and its ancestors
+   */
+  void stop();
+
+  /**
+   * Transition to state, regardless of guards
+   *
+   * @param id Target state id
+   * @param action Transition action
+   * @return
+   *    - 0: Success
+   *    - -1: State not found
+   */
+  int transition(const int id,
+                 const std::function<void(void)> &action = nullptr);
+
+  /**
+   * Check transitions of the current state and its ancestors, fire the first
+   * one whose guard holds
+   *
+   * @return
+   *    - 1: Transitioned
+   *    - 0: No guard holds
+   *    - -1: Not started
+   */
+  int update();
+
+  /**
+   * Check whether the current state is `id` or one of its descendants
+   *
+   * @param id State id
+   * @return True if in state
+   */
+  bool isIn(const int id) const;
+
+  /**
+   * @return Time since the current state was entered in seconds
+   */
+  double timeInState() const;
+
+  /**
+   * @return Name of the current state
+   */
+  std::string currentName() const;
+
+  /**
+   * Find state
+   *
+   * @param id State id
+   * @return Index of state in `states`, or -1 if not found
+   */
+  int find(const int id) const;
+};
+
+} // namespace atl
+#endif
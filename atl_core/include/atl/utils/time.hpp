@@ -10,6 +10,7 @@ void tic(struct timespec *tic);
 float toc(struct timespec *tic);
 float mtoc(struct timespec *tic);
 double time_now();
+double time_monotonic();
 
 } // namespace atl
 #endif
@@ -0,0 +1,67 @@
+#ifndef ATL_UTILS_TRIPLE_BUFFER_HPP
+#define ATL_UTILS_TRIPLE_BUFFER_HPP
+
+#include <atomic>
+
+namespace atl {
+
+/**
+ * Triple buffer
+ *
+ * Hands the latest value from one producer thread to one consumer thread
+ * without locks. The producer writes into the back buffer and swaps it with
+ * the middle buffer, the consumer swaps the middle buffer with the front
+ * buffer when it holds a newer value. Neither side ever waits on the other
+ * and the consumer always reads a complete value.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+  T buffers[3];
+  int back = 0;
+  std::atomic<int> middle{1};
+  int front = 2;
+
+  // bit set on the middle index when it holds a value the consumer has not
+  // seen yet
+  static const int FRESH = 4;
+  static const int INDEX = 3;
+
+  TripleBuffer() {}
+
+  /**
+   * Write value, producer side
+   *
+   * @param value Value
+   */
+  void write(const T &value) {
+    this->buffers[this->back] = value;
+    const int prev = this->middle.exchange(this->back | FRESH,
+                                           std::memory_order_acq_rel);
+    this->back = prev & INDEX;
+  }
+
+  /**
+   * Read latest value, consumer side
+   *
+   * @param value Latest value written, or the last value read if nothing
+   *              new was written since
+   * @return True if value is new since the last read
+   */
+  bool read(T &value) {
+    bool fresh = false;
+
+    if (this->middle.load(std::memory_order_relaxed) & FRESH) {
+      const int prev =
+          this->middle.exchange(this->front, std::memory_order_acq_rel);
+      this->front = prev & INDEX;
+      fresh = true;
+    }
+    value = this->buffers[this->front];
+
+    return fresh;
+  }
+};
+
+} // namespace atl
+#endif
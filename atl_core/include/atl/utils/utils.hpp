@@ -4,12 +4,17 @@
 #include "atl/utils/config.hpp"
 #include "atl/utils/data.hpp"
 #include "atl/utils/file.hpp"
+#include "atl/utils/flight_recorder.hpp"
 #include "atl/utils/gps.hpp"
 #include "atl/utils/log.hpp"
 #include "atl/utils/math.hpp"
 #include "atl/utils/opencv.hpp"
+#include "atl/utils/ring_buffer.hpp"
+#include "atl/utils/seqlock.hpp"
+#include "atl/utils/state_machine.hpp"
 #include "atl/utils/stats.hpp"
 #include "atl/utils/time.hpp"
+#include "atl/utils/triple_buffer.hpp"
 
 // MACROS
 #define UNUSED(expr)                                                           \
@@ -12,11 +12,17 @@ public:
   Vec3 position;
   Quaternion orientation;
 
+  // detection confidence, 0 if the detector does not provide it
+  double decision_margin;
+  double area;
+
   TagPose() {
     this->id = -1;
     this->detected = false;
     this->position << 0.0, 0.0, 0.0;
-    this->orientation = Quaternion();
+    this->orientation = Quaternion::Identity();
+    this->decision_margin = 0.0;
+    this->area = 0.0;
   };
 
   TagPose(int id, bool detected, Vec3 position, Quaternion orientation) {
@@ -24,6 +30,8 @@ public:
     this->detected = detected;
     this->position = position;
     this->orientation = orientation;
+    this->decision_margin = 0.0;
+    this->area = 0.0;
   }
 
   TagPose(int id, bool detected, Vec3 position, Mat3 rotmat) {
@@ -31,8 +39,15 @@ public:
     this->detected = detected;
     this->position = position;
     this->orientation = Quaternion(rotmat);
+    this->decision_margin = 0.0;
+    this->area = 0.0;
   }
 
+  /**
+   * @return Distance to tag
+   */
+  double range() const { return this->position.norm(); }
+
   void print() {
     std::cout << "tag ";
     std::cout << "id: " << this->id << "\t";
@@ -0,0 +1,488 @@
+#include "atl/control/autotune.hpp"
+
+namespace atl {
+
+int AutoTuner::configure(const std::string &config_file) {
+  ConfigParser parser;
+  std::vector<std::string> scenario_names;
+  std::vector<double> lower, upper;
+
+  // load config
+  parser.addParam("controller", &this->controller);
+  parser.addParam("controller_file", &this->controller_file);
+  parser.addParam("dt", &this->dt, true);
+  parser.addParam("cost.ise", &this->w_ise, true);
+  parser.addParam("cost.overshoot", &this->w_overshoot, true);
+  parser.addParam("cost.effort", &this->w_effort, true);
+  parser.addParam("cost.failure", &this->failure_cost, true);
+  parser.addParam("optimizer.population", &this->population, true);
+  parser.addParam("optimizer.generations", &this->max_generations, true);
+  parser.addParam("optimizer.mutation", &this->mutation, true);
+  parser.addParam("optimizer.crossover", &this->crossover, true);
+  parser.addParam("optimizer.seed", &this->seed, true);
+  parser.addParam("optimizer.threads", &this->nb_threads, true);
+  parser.addParam("bounds.lower", &lower);
+  parser.addParam("bounds.upper", &upper);
+  parser.addParam("scenarios", &scenario_names);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // load scenarios
+  this->scenarios.clear();
+  for (auto &name : scenario_names) {
+    TuningScenario scenario;
+    scenario.name = name;
+
+    ConfigParser sparser;
+    sparser.addParam(name + ".type", &scenario.type);
+    sparser.addParam(name + ".duration", &scenario.duration, true);
+    sparser.addParam(name + ".weight", &scenario.weight, true);
+    sparser.addParam(name + ".start", &scenario.start, true);
+    sparser.addParam(name + ".step", &scenario.step, true);
+    sparser.addParam(name + ".target_pos", &scenario.target_pos, true);
+    sparser.addParam(name + ".target_vel", &scenario.target_vel, true);
+    sparser.addParam(name + ".wind", &scenario.wind, true);
+    sparser.addParam(name + ".gust", &scenario.gust, true);
+    sparser.addParam(name + ".gust_period", &scenario.gust_period, true);
+    if (sparser.load(config_file) != 0) {
+      return -1;
+    }
+    this->scenarios.push_back(scenario);
+  }
+
+  // load controller, the path is relative to the config file
+  std::string config_dir = std::string(dirname((char *) config_file.c_str()));
+  paths_combine(config_dir, this->controller_file, this->controller_file);
+
+  int retval = -1;
+  std::vector<std::string> types;
+  if (this->controller == "position") {
+    retval = this->position_controller.configure(this->controller_file);
+    this->axes = {"pitch_controller", "roll_controller", "throttle_controller"};
+    types = {"step", "hover"};
+  } else if (this->controller == "tracking") {
+    retval = this->tracking_controller.configure(this->controller_file);
+    this->axes = {"pitch_controller", "roll_controller", "throttle_controller"};
+    types = {"step", "hover", "track"};
+  } else if (this->controller == "landing") {
+    retval = this->landing_controller.configure(this->controller_file);
+    this->axes = {"pitch_controller", "roll_controller", "vz_controller"};
+    types = {"land"};
+  } else {
+    LOG_ERROR("Invalid controller [%s]!", this->controller.c_str());
+    return -3;
+  }
+  if (retval != 0) {
+    LOG_ERROR("Failed to load [%s]!", this->controller_file.c_str());
+    return -2;
+  }
+
+  // check scenarios, bounds and optimizer
+  if (this->scenarios.size() == 0) {
+    LOG_ERROR("No tuning scenarios!");
+    return -3;
+  }
+  for (auto &scenario : this->scenarios) {
+    if (std::find(types.begin(), types.end(), scenario.type) == types.end()) {
+      LOG_ERROR("Scenario [%s] of type [%s] does not apply to the %s "
+                "controller!",
+                scenario.name.c_str(),
+                scenario.type.c_str(),
+                this->controller.c_str());
+      return -3;
+    } else if (scenario.duration <= 0.0 || scenario.gust_period <= 0.0) {
+      LOG_ERROR("Invalid duration of scenario [%s]!", scenario.name.c_str());
+      return -3;
+    }
+  }
+  if (lower.size() != AUTOTUNE_NB_GAINS || upper.size() != AUTOTUNE_NB_GAINS) {
+    LOG_ERROR("Gain bounds must have %d values!", AUTOTUNE_NB_GAINS);
+    return -3;
+  }
+  for (int i = 0; i < AUTOTUNE_NB_GAINS; i++) {
+    this->lower(i) = lower[i];
+    this->upper(i) = upper[i];
+    if (lower[i] < 0.0 || lower[i] > upper[i]) {
+      LOG_ERROR("Invalid gain bounds [%f, %f]!", lower[i], upper[i]);
+      return -3;
+    }
+  }
+  if (this->population < 4 || this->max_generations < 0 || this->dt <= 0.0) {
+    LOG_ERROR("Invalid optimizer settings!");
+    return -3;
+  }
+
+  this->initial_gains = this->controllerGains();
+  this->best_gains = this->initial_gains;
+  this->history.clear();
+  this->nb_evaluations = 0;
+  this->configured = true;
+
+  return 0;
+}
+
+VecX AutoTuner::controllerGains() {
+  const MultiPID<3> *pid = &this->position_controller.pid;
+  if (this->controller == "tracking") {
+    pid = &this->tracking_controller.pid;
+  } else if (this->controller == "landing") {
+    pid = &this->landing_controller.pid;
+  }
+
+  VecX gains(AUTOTUNE_NB_GAINS);
+  gains << pid->k_p.matrix(), pid->k_i.matrix(), pid->k_d.matrix();
+  return gains;
+}
+
+void AutoTuner::setGains(const VecX &gains, MultiPID<3> &pid) {
+  pid.k_p = gains.segment(0, 3).array();
+  pid.k_i = gains.segment(3, 3).array();
+  pid.k_d = gains.segment(6, 3).array();
+  pid.schedule.loaded = false;
+}
+
+TuningMetrics AutoTuner::simulate(const TuningScenario &scenario,
+                                  const VecX &gains) {
+  TuningMetrics metrics;
+
+  // controllers with the candidate gains
+  PositionController pc = this->position_controller;
+  TrackingController tc = this->tracking_controller;
+  LandingController lc = this->landing_controller;
+  setGains(gains, pc.pid);
+  setGains(gains, tc.pid);
+  setGains(gains, lc.pid);
+
+  double hover = pc.hover_throttle;
+  if (this->controller == "tracking") {
+    hover = tc.hover_throttle;
+  } else if (this->controller == "landing") {
+    hover = lc.hover_throttle;
+  }
+
+  // model hovering at start, four motors with a max thrust of 5 N each
+  VecX pose = VecX::Zero(6);
+  pose.head(3) = scenario.start;
+  QuadrotorModel quad(pose);
+  quad.m = 4.0 * 5.0 * hover / quad.g;
+  quad.attitude_setpoints << 0.0, 0.0, 0.0, hover;
+
+  const Vec3 setpoint = scenario.start + scenario.step;
+  const double step_size = scenario.step.norm();
+  const Vec3 target_start = scenario.start + scenario.target_pos;
+  bool landed = false;
+
+  for (double t = 0.0; t < scenario.duration; t += this->dt) {
+    // disturbance
+    const double phase = 2.0 * M_PI * t / scenario.gust_period;
+    quad.ext_force = scenario.wind + sin(phase) * scenario.gust;
+
+    // controller, yaw is held at zero so the body and world frame only
+    // differ by roll and pitch
+    const Vec3 target = target_start + t * scenario.target_vel;
+    Vec3 error;
+    Vec4 u;
+    if (this->controller == "position") {
+      Pose pose("",
+                quad.attitude(0),
+                quad.attitude(1),
+                quad.attitude(2),
+                quad.position(0),
+                quad.position(1),
+                quad.position(2));
+      u = pc.update(setpoint, pose, 0.0, this->dt);
+      error = setpoint - quad.position;
+
+    } else if (this->controller == "tracking") {
+      Vec3 errors_B = setpoint - quad.position;
+      if (scenario.type == "track") {
+        errors_B = target - quad.position;
+        errors_B(2) = scenario.start(2) - quad.position(2);
+      }
+      tc.update(errors_B, 0.0, this->dt);
+      u = tc.outputs;
+      error = errors_B + tc.track_offset;
+
+    } else {
+      const Vec3 pos_errors_B = target - quad.position;
+      u = lc.update(pos_errors_B, quad.linear_velocity, 0.0, this->dt);
+      error = Vec3{pos_errors_B(0), pos_errors_B(1), 0.0};
+    }
+    quad.attitude_setpoints = u;
+    quad.update(quad.attitudeControllerControl(this->dt), this->dt);
+
+    // touch down
+    if (scenario.type == "land" && quad.position(2) <= target(2) + 0.05) {
+      const Vec3 pos_errors = target - quad.position;
+      metrics.overshoot = pos_errors.head(2).norm();
+      landed = true;
+      break;
+    }
+
+    // crash or divergence
+    if (!quad.position.allFinite() || error.norm() > 50.0 ||
+        quad.position(2) < 0.0) {
+      metrics.failed = true;
+      break;
+    }
+
+    // metrics
+    metrics.ise += error.squaredNorm() * this->dt;
+    metrics.effort += (u(0) * u(0) + u(1) * u(1)) * this->dt;
+    metrics.effort += (u(3) - hover) * (u(3) - hover) * this->dt;
+    if (scenario.type == "step" && step_size > 0.0) {
+      const double past = -error.dot(scenario.step) / step_size;
+      metrics.overshoot = std::max(metrics.overshoot, past / step_size);
+    } else if (scenario.type != "land" && t > 0.5 * scenario.duration) {
+      metrics.overshoot = std::max(metrics.overshoot, error.norm());
+    }
+  }
+  if (scenario.type == "land" && landed == false) {
+    metrics.failed = true;
+  }
+
+  // cost
+  if (metrics.failed) {
+    metrics.cost = scenario.weight * this->failure_cost;
+  } else {
+    metrics.cost = this->w_ise * metrics.ise;
+    metrics.cost += this->w_overshoot * metrics.overshoot;
+    metrics.cost += this->w_effort * metrics.effort;
+    metrics.cost *= scenario.weight;
+  }
+
+  return metrics;
+}
+
+double AutoTuner::evaluate(const VecX &gains,
+                           std::vector<TuningMetrics> &metrics) {
+  double cost = 0.0;
+
+  metrics.clear();
+  for (auto &scenario : this->scenarios) {
+    metrics.push_back(this->simulate(scenario, gains));
+    cost += metrics.back().cost;
+  }
+
+  return cost;
+}
+
+double AutoTuner::evaluate(const VecX &gains) {
+  std::vector<TuningMetrics> metrics;
+  return this->evaluate(gains, metrics);
+}
+
+void AutoTuner::evaluateBatch(const std::vector<VecX> &candidates,
+                              std::vector<double> &costs) {
+  costs.resize(candidates.size());
+
+  // workers pull the next candidate until none are left
+  int nb_threads = this->nb_threads;
+  if (nb_threads <= 0) {
+    nb_threads = std::max(1, (int) std::thread::hardware_concurrency());
+  }
+  nb_threads = std::min(nb_threads, (int) candidates.size());
+
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    size_t i;
+    while ((i = next.fetch_add(1)) < candidates.size()) {
+      costs[i] = this->evaluate(candidates[i]);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < nb_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  this->nb_evaluations += (int) candidates.size();
+}
+
+int AutoTuner::optimize() {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  struct timespec t_start;
+  tic(&t_start);
+  std::mt19937 rng(this->seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::uniform_int_distribution<int> pick(0, this->population - 1);
+  std::uniform_int_distribution<int> pick_gain(0, AUTOTUNE_NB_GAINS - 1);
+
+  // initial population, seeded with the hand tuned gains
+  std::vector<VecX> pop(this->population);
+  std::vector<double> costs;
+  pop[0] = this->initial_gains.cwiseMax(this->lower).cwiseMin(this->upper);
+  for (int i = 1; i < this->population; i++) {
+    pop[i] = VecX(AUTOTUNE_NB_GAINS);
+    for (int j = 0; j < AUTOTUNE_NB_GAINS; j++) {
+      const double range = this->upper(j) - this->lower(j);
+      pop[i](j) = this->lower(j) + uniform(rng) * range;
+    }
+  }
+  this->evaluateBatch(pop, costs);
+  this->initial_cost = this->evaluate(this->initial_gains);
+
+  // keep the hand tuned gains if they are outside the bounds and better
+  int best = std::min_element(costs.begin(), costs.end()) - costs.begin();
+  this->best_gains = pop[best];
+  this->best_cost = costs[best];
+  if (this->initial_cost < this->best_cost) {
+    this->best_gains = this->initial_gains;
+    this->best_cost = this->initial_cost;
+  }
+  this->history = {this->best_cost};
+
+  // differential evolution
+  std::vector<VecX> trials(this->population);
+  std::vector<double> trial_costs;
+  for (int g = 0; g < this->max_generations; g++) {
+    // mutation and crossover
+    for (int i = 0; i < this->population; i++) {
+      int r1, r2, r3;
+      do {
+        r1 = pick(rng);
+      } while (r1 == i);
+      do {
+        r2 = pick(rng);
+      } while (r2 == i || r2 == r1);
+      do {
+        r3 = pick(rng);
+      } while (r3 == i || r3 == r1 || r3 == r2);
+
+      const int j_rand = pick_gain(rng);
+      trials[i] = pop[i];
+      for (int j = 0; j < AUTOTUNE_NB_GAINS; j++) {
+        if (uniform(rng) < this->crossover || j == j_rand) {
+          const double diff = pop[r2](j) - pop[r3](j);
+          const double x = pop[r1](j) + this->mutation * diff;
+          trials[i](j) = std::max(this->lower(j), std::min(x, this->upper(j)));
+        }
+      }
+    }
+
+    // selection
+    this->evaluateBatch(trials, trial_costs);
+    for (int i = 0; i < this->population; i++) {
+      if (trial_costs[i] <= costs[i]) {
+        pop[i] = trials[i];
+        costs[i] = trial_costs[i];
+      }
+      if (costs[i] < this->best_cost) {
+        this->best_gains = pop[i];
+        this->best_cost = costs[i];
+      }
+    }
+    this->history.push_back(this->best_cost);
+  }
+  this->elapsed = toc(&t_start);
+
+  return 0;
+}
+
+int AutoTuner::saveConfig(const std::string &output_file) {
+  // load controller config
+  YAML::Node config;
+  try {
+    config = YAML::LoadFile(this->controller_file);
+  } catch (YAML::Exception &ex) {
+    LOG_ERROR("Failed to load [%s]!", this->controller_file.c_str());
+    return -1;
+  }
+
+  // replace gains
+  const std::string gains[3] = {"k_p", "k_i", "k_d"};
+  for (int k = 0; k < 3; k++) {
+    for (int i = 0; i < 3; i++) {
+      char value[32];
+      snprintf(value, sizeof(value), "%.4g", this->best_gains(3 * k + i));
+      config[this->axes[i]][gains[k]] = std::string(value);
+    }
+  }
+
+  // write config
+  std::ofstream output(output_file);
+  if (!output) {
+    LOG_ERROR("Failed to open [%s]!", output_file.c_str());
+    return -2;
+  }
+  output << "# auto-tuned from " << this->controller_file << std::endl;
+  output << "# cost: " << this->initial_cost << " -> " << this->best_cost;
+  output << std::endl;
+  output << config << std::endl;
+
+  return output ? 0 : -2;
+}
+
+int AutoTuner::saveReport(const std::string &report_file) {
+  std::ofstream report(report_file);
+  if (!report) {
+    LOG_ERROR("Failed to open [%s]!", report_file.c_str());
+    return -1;
+  }
+
+  // summary
+  report << "controller: " << this->controller << std::endl;
+  report << "controller file: " << this->controller_file << std::endl;
+  report << "evaluations: " << this->nb_evaluations << std::endl;
+  report << "time [s]: " << this->elapsed << std::endl;
+  report << "cost: " << this->initial_cost << " -> " << this->best_cost;
+  report << std::endl << std::endl;
+
+  // gains
+  const std::string gains[3] = {"k_p", "k_i", "k_d"};
+  report << std::left << std::setw(28) << "gain";
+  report << std::setw(12) << "initial" << "tuned" << std::endl;
+  for (int k = 0; k < 3; k++) {
+    for (int i = 0; i < 3; i++) {
+      const int idx = 3 * k + i;
+      report << std::setw(28) << this->axes[i] + "." + gains[k];
+      report << std::setw(12) << this->initial_gains(idx);
+      report << this->best_gains(idx) << std::endl;
+    }
+  }
+  report << std::endl;
+
+  // scenario metrics
+  std::vector<TuningMetrics> before, after;
+  this->evaluate(this->initial_gains, before);
+  this->evaluate(this->best_gains, after);
+  report << std::setw(16) << "scenario" << std::setw(10) << "gains";
+  report << std::setw(12) << "ise" << std::setw(12) << "overshoot";
+  report << std::setw(12) << "effort" << "cost" << std::endl;
+  for (size_t i = 0; i < this->scenarios.size(); i++) {
+    const TuningMetrics *m[2] = {&before[i], &after[i]};
+    const std::string label[2] = {"initial", "tuned"};
+    for (int k = 0; k < 2; k++) {
+      report << std::setw(16) << this->scenarios[i].name;
+      report << std::setw(10) << label[k];
+      if (m[k]->failed) {
+        report << "failed" << std::endl;
+        continue;
+      }
+      report << std::setw(12) << m[k]->ise;
+      report << std::setw(12) << m[k]->overshoot;
+      report << std::setw(12) << m[k]->effort;
+      report << m[k]->cost << std::endl;
+    }
+  }
+  report << std::endl;
+
+  // cost history
+  report << "best cost per generation:" << std::endl;
+  for (size_t g = 0; g < this->history.size(); g++) {
+    report << g << "\t" << this->history[g] << std::endl;
+  }
+
+  return report ? 0 : -1;
+}
+
+} // namespace atl
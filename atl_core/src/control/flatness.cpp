@@ -0,0 +1,191 @@
+#include "atl/control/flatness.hpp"
+
+namespace atl {
+
+int flatness_map(const FlatOutput &flat, const double g, FlatState &state) {
+  // thrust vector, the body z-axis points along it
+  const Vec3 t{flat.acc(0), flat.acc(1), flat.acc(2) + g};
+  const double thrust = t.norm();
+  if (thrust < 1e-6) {
+    return -1;
+  }
+  const Vec3 z_B = t / thrust;
+
+  // body x-axis towards the yaw heading
+  const Vec3 x_C{cos(flat.yaw), sin(flat.yaw), 0.0};
+  const Vec3 y_C{-sin(flat.yaw), cos(flat.yaw), 0.0};
+  const Vec3 z_B_x_C = z_B.cross(x_C);
+  const double z_B_x_C_norm = z_B_x_C.norm();
+  if (z_B_x_C_norm < 1e-6) {
+    return -1;
+  }
+  const Vec3 y_B = z_B_x_C / z_B_x_C_norm;
+  const Vec3 x_B = y_B.cross(z_B);
+  Mat3 R;
+  R.col(0) = x_B;
+  R.col(1) = y_B;
+  R.col(2) = z_B;
+
+  // body rates, the component of the jerk normal to the thrust rotates the
+  // thrust vector, r follows from differentiating y_B
+  const Vec3 h_w = (flat.jerk - z_B.dot(flat.jerk) * z_B) / thrust;
+  const double p = -h_w.dot(y_B);
+  const double q = h_w.dot(x_B);
+  double r = p * x_C.dot(z_B) + flat.yaw_rate * y_C.dot(y_B);
+  r /= z_B_x_C_norm;
+
+  state.pos = flat.pos;
+  state.vel = flat.vel;
+  state.acc = flat.acc;
+  state.orientation = Quaternion{R};
+  state.rpy = quatToEuler321(state.orientation);
+  state.thrust = thrust;
+  state.omega << p, q, r;
+
+  return 0;
+}
+
+int FlatnessPlan::plan(const std::vector<FlatOutput> &flat_outputs,
+                       const double dt,
+                       const double g) {
+  // pre-check
+  this->reset();
+  if (flat_outputs.size() == 0 || dt <= 0.0) {
+    LOG_ERROR("Invalid flatness plan samples or time step!");
+    return -1;
+  }
+
+  // flatness map of every sample
+  this->states.resize(flat_outputs.size());
+  for (size_t i = 0; i < flat_outputs.size(); i++) {
+    if (flatness_map(flat_outputs[i], g, this->states[i]) != 0) {
+      LOG_ERROR("Orientation undefined at t = %f!", i * dt);
+      this->states.clear();
+      return -2;
+    }
+  }
+
+  this->dt = dt;
+  this->g = g;
+  this->loaded = true;
+  return 0;
+}
+
+int FlatnessPlan::plan(
+    const std::function<FlatOutput(const double)> &trajectory,
+    const double duration,
+    const double dt,
+    const double g) {
+  // pre-check
+  if (duration < 0.0 || dt <= 0.0) {
+    LOG_ERROR("Invalid flatness plan duration or time step!");
+    return -1;
+  }
+
+  // sample trajectory, the last sample is at the end of the trajectory
+  const size_t nb_samples = (size_t) ceil(duration / dt - 1e-9) + 1;
+  std::vector<FlatOutput> flat_outputs(nb_samples);
+  for (size_t i = 0; i < nb_samples; i++) {
+    flat_outputs[i] = trajectory(std::min(i * dt, duration));
+  }
+
+  return this->plan(flat_outputs, dt, g);
+}
+
+int FlatnessPlan::plan(const std::vector<Vec3> &pos,
+                       const std::vector<Vec3> &vel,
+                       const std::vector<double> &yaw,
+                       const double dt,
+                       const double g) {
+  // pre-check
+  const size_t n = pos.size();
+  if (n == 0 || vel.size() != n || (yaw.size() != 0 && yaw.size() != n)) {
+    LOG_ERROR("Invalid flatness plan samples!");
+    return -1;
+  } else if (dt <= 0.0) {
+    LOG_ERROR("Invalid flatness plan time step!");
+    return -1;
+  }
+
+  // central differences, one sided at the ends
+  auto diff = [n, dt](const std::vector<Vec3> &x, const size_t i) -> Vec3 {
+    if (n < 2) {
+      return Vec3::Zero();
+    }
+    const size_t a = (i == 0) ? 0 : i - 1;
+    const size_t b = (i == n - 1) ? n - 1 : i + 1;
+    return (x[b] - x[a]) / ((b - a) * dt);
+  };
+
+  std::vector<Vec3> acc(n);
+  for (size_t i = 0; i < n; i++) {
+    acc[i] = diff(vel, i);
+  }
+
+  std::vector<FlatOutput> flat_outputs(n);
+  for (size_t i = 0; i < n; i++) {
+    flat_outputs[i].pos = pos[i];
+    flat_outputs[i].vel = vel[i];
+    flat_outputs[i].acc = acc[i];
+    flat_outputs[i].jerk = diff(acc, i);
+    if (yaw.size()) {
+      const size_t a = (i == 0) ? 0 : i - 1;
+      const size_t b = (i == n - 1) ? n - 1 : i + 1;
+      flat_outputs[i].yaw = yaw[i];
+      if (b > a) {
+        const double dyaw = wrapToPi(yaw[b] - yaw[a]);
+        flat_outputs[i].yaw_rate = dyaw / ((b - a) * dt);
+      }
+    }
+  }
+
+  return this->plan(flat_outputs, dt, g);
+}
+
+double FlatnessPlan::duration() const {
+  if (this->states.size() == 0) {
+    return 0.0;
+  }
+  return (this->states.size() - 1) * this->dt;
+}
+
+int FlatnessPlan::evaluate(const double t, FlatState &state) const {
+  // pre-check
+  if (this->loaded == false) {
+    return -1;
+  }
+
+  // hold first and last state
+  const size_t last = this->states.size() - 1;
+  if (t <= 0.0 || last == 0) {
+    state = this->states[0];
+    return 0;
+  } else if (t >= this->duration()) {
+    state = this->states[last];
+    return 0;
+  }
+
+  // interpolate between neighbouring states
+  const size_t i = std::min((size_t) (t / this->dt), last - 1);
+  const double s = t / this->dt - i;
+  const FlatState &a = this->states[i];
+  const FlatState &b = this->states[i + 1];
+
+  state.pos = a.pos + s * (b.pos - a.pos);
+  state.vel = a.vel + s * (b.vel - a.vel);
+  state.acc = a.acc + s * (b.acc - a.acc);
+  state.orientation = a.orientation.slerp(s, b.orientation);
+  state.rpy = quatToEuler321(state.orientation);
+  state.thrust = a.thrust + s * (b.thrust - a.thrust);
+  state.omega = a.omega + s * (b.omega - a.omega);
+
+  return 0;
+}
+
+void FlatnessPlan::reset() {
+  this->loaded = false;
+  this->dt = 0.0;
+  this->states.clear();
+}
+
+} // namespace atl
@@ -0,0 +1,133 @@
+#include "atl/control/geometric_controller.hpp"
+
+namespace atl {
+
+int GeometricController::configure(const std::string &config_file) {
+  ConfigParser parser;
+  Vec3 inertia = this->J.diagonal();
+  double max_tilt = rad2deg(this->max_tilt);
+
+  // load config
+  parser.addParam("position_controller.k_x", &this->k_x);
+  parser.addParam("position_controller.k_v", &this->k_v);
+  parser.addParam("attitude_controller.k_R", &this->k_R);
+  parser.addParam("attitude_controller.k_omega", &this->k_omega);
+  parser.addParam("mass", &this->mass);
+  parser.addParam("inertia", &inertia, true);
+  parser.addParam("hover_throttle", &this->hover_throttle);
+  parser.addParam("max_tilt", &max_tilt, true);
+  parser.addParam("max_thrust", &this->max_thrust, true);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // check vehicle parameters
+  if (this->mass <= 0.0 || inertia.minCoeff() <= 0.0) {
+    LOG_ERROR("Invalid mass or inertia!");
+    return -2;
+  } else if (this->hover_throttle <= 0.0 || this->hover_throttle > 1.0) {
+    LOG_ERROR("Invalid hover throttle [%f]!", this->hover_throttle);
+    return -2;
+  } else if (max_tilt <= 0.0 || max_tilt >= 90.0) {
+    LOG_ERROR("Invalid max tilt [%f]!", max_tilt);
+    return -2;
+  }
+  this->J = inertia.asDiagonal();
+  this->max_tilt = deg2rad(max_tilt);
+
+  this->configured = true;
+  return 0;
+}
+
+Vec4 GeometricController::update(const Vec3 &pos_d,
+                                 const Vec3 &vel_d,
+                                 const Vec3 &acc_d,
+                                 const double yaw_d,
+                                 const Vec3 &pos,
+                                 const Vec3 &vel,
+                                 const Mat3 &R,
+                                 const double dt) {
+  // desired thrust vector
+  this->e_x = pos - pos_d;
+  this->e_v = vel - vel_d;
+  Vec3 F = -this->k_x.cwiseProduct(this->e_x);
+  F -= this->k_v.cwiseProduct(this->e_v);
+  F += this->mass * acc_d;
+  F(2) += this->mass * this->g;
+
+  // keep thrusting upwards and limit tilt
+  F(2) = std::max(F(2), 0.1 * this->mass * this->g);
+  const double F_xy = F.head(2).norm();
+  const double F_xy_max = F(2) * tan(this->max_tilt);
+  if (F_xy > F_xy_max) {
+    F.head(2) *= F_xy_max / F_xy;
+  }
+
+  // desired orientation, the body x-axis points towards the yaw setpoint
+  const Vec3 b3_d = F.normalized();
+  const Vec3 b1_c{cos(yaw_d), sin(yaw_d), 0.0};
+  const Vec3 b2_d = b3_d.cross(b1_c).normalized();
+  const Vec3 b1_d = b2_d.cross(b3_d);
+  const Mat3 R_d_prev = this->R_d;
+  this->R_d.col(0) = b1_d;
+  this->R_d.col(1) = b2_d;
+  this->R_d.col(2) = b3_d;
+
+  // desired body rates, skew(omega_d) = R_d^T * dR_d / dt
+  if (this->R_d_valid && dt > 0.0) {
+    const Mat3 dR = R_d_prev.transpose() * this->R_d;
+    this->omega_d = vee(dR - dR.transpose()) / (2.0 * dt);
+  }
+  this->R_d_valid = true;
+
+  // collective thrust along the current body z-axis
+  this->thrust = F.dot(R.col(2));
+  this->thrust = std::max(0.0, std::min(this->thrust, this->max_thrust));
+
+  // attitude command, euler 3-2-1 angles of the desired orientation
+  const double roll = atan2(this->R_d(2, 1), this->R_d(2, 2));
+  const double pitch = asin(-std::max(-1.0, std::min(this->R_d(2, 0), 1.0)));
+  const double yaw = atan2(this->R_d(1, 0), this->R_d(0, 0));
+  double throttle = this->hover_throttle * this->thrust;
+  throttle /= this->mass * this->g;
+  throttle = std::max(0.0, std::min(throttle, 1.0));
+  this->outputs << roll, pitch, yaw, throttle;
+
+  return this->outputs;
+}
+
+Vec3 GeometricController::updateAttitude(const Mat3 &R_d,
+                                         const Vec3 &omega_d,
+                                         const Mat3 &R,
+                                         const Vec3 &omega) {
+  // errors on SO(3)
+  const Mat3 R_dt_R = R_d.transpose() * R;
+  const Vec3 omega_d_B = R_dt_R.transpose() * omega_d;
+  this->e_R = 0.5 * vee(R_dt_R - R_dt_R.transpose());
+  this->e_omega = omega - omega_d_B;
+
+  // moments
+  this->moment = -this->k_R.cwiseProduct(this->e_R);
+  this->moment -= this->k_omega.cwiseProduct(this->e_omega);
+  this->moment += omega.cross(this->J * omega);
+  this->moment -= this->J * omega.cross(omega_d_B);
+
+  return this->moment;
+}
+
+void GeometricController::reset() {
+  this->e_x.setZero();
+  this->e_v.setZero();
+  this->e_R.setZero();
+  this->e_omega.setZero();
+  this->R_d.setIdentity();
+  this->omega_d.setZero();
+  this->R_d_valid = false;
+  this->thrust = 0.0;
+  this->moment.setZero();
+  this->outputs.setZero();
+}
+
+Vec3 vee(const Mat3 &S) { return Vec3{S(2, 1), S(0, 2), S(1, 0)}; }
+
+} // namespace atl
@@ -7,27 +7,24 @@ int LandingController::configure(const std::string &config_file) {
 
   // load config
   ConfigParser parser;
-  parser.addParam("roll_controller.k_p", &this->y_controller.k_p);
-  parser.addParam("roll_controller.k_i", &this->y_controller.k_i);
-  parser.addParam("roll_controller.k_d", &this->y_controller.k_d);
   parser.addParam("roll_controller.min", &this->roll_limit[0]);
   parser.addParam("roll_controller.max", &this->roll_limit[1]);
-
-  parser.addParam("pitch_controller.k_p", &this->x_controller.k_p);
-  parser.addParam("pitch_controller.k_i", &this->x_controller.k_i);
-  parser.addParam("pitch_controller.k_d", &this->x_controller.k_d);
   parser.addParam("pitch_controller.min", &this->pitch_limit[0]);
   parser.addParam("pitch_controller.max", &this->pitch_limit[1]);
-
-  parser.addParam("vz_controller.k_p", &this->vz_controller.k_p);
-  parser.addParam("vz_controller.k_i", &this->vz_controller.k_i);
-  parser.addParam("vz_controller.k_d", &this->vz_controller.k_d);
   parser.addParam("vz_controller.hover_throttle", &this->hover_throttle);
   parser.addParam("vz_controller.descent_velocity", &this->descent_velocity);
   if (parser.load(config_file) != 0) {
     return -1;
   }
 
+  // load pid gains, x and y are controlled through pitch and roll
+  const std::vector<std::string> axes = {"pitch_controller",
+                                         "roll_controller",
+                                         "vz_controller"};
+  if (this->pid.configure(config_file, axes) != 0) {
+    return -1;
+  }
+
   // convert roll and pitch limits from degrees to radians
   this->roll_limit[0] = deg2rad(this->roll_limit[0]);
   this->roll_limit[1] = deg2rad(this->roll_limit[1]);
@@ -48,13 +45,27 @@ Vec4 LandingController::update(const Vec3 &pos_errors_B,
     return this->outputs;
   }
 
+  // pid outputs, saturation limits stop the integrals winding up, gains are
+  // scheduled on the height above the target
+  // clang-format off
+  const Vec3 errors{pos_errors_B(0),
+                    pos_errors_B(1),
+                    this->descent_velocity - vel_W(2)};
+  this->pid.scheduleGains(-pos_errors_B(2));
+  this->pid.output_min << this->pitch_limit[0],
+                          -this->roll_limit[1],
+                          -this->hover_throttle;
+  this->pid.output_max << this->pitch_limit[1],
+                          -this->roll_limit[0],
+                          1.0 - this->hover_throttle;
+  // clang-format on
+  const Vec3 u = this->pid.update(errors.array(), this->dt).matrix();
+
   // roll, pitch, yaw and throttle (assuming NWU frame)
-  double r = -this->y_controller.update(pos_errors_B(1), this->dt);
-  double p = this->x_controller.update(pos_errors_B(0), this->dt);
+  double r = -u(1);
+  double p = u(0);
   double y = yaw_setpoint;
-  const double vz_error = this->descent_velocity - vel_W(2);
-  double t = this->hover_throttle;
-  t += this->vz_controller.update(vz_error, this->dt);
+  double t = this->hover_throttle + u(2);
   t /= fabs(cos(r) * cos(p)); // adjust throttle for roll and pitch
 
   // limit roll, pitch and throttle
@@ -73,11 +84,7 @@ Vec4 LandingController::update(const Vec3 &pos_errors_B,
   return outputs;
 }
 
-void LandingController::reset() {
-  this->x_controller.reset();
-  this->y_controller.reset();
-  this->vz_controller.reset();
-}
+void LandingController::reset() { this->pid.reset(); }
 
 void LandingController::printOutputs() {
   double r, p, t;
@@ -0,0 +1,216 @@
+#include "atl/control/landing_mpc.hpp"
+
+namespace atl {
+
+int LandingMPC::configure(const std::string &config_file) {
+  // load config
+  ConfigParser parser;
+  parser.addParam("horizon_dt", &this->horizon_dt);
+  parser.addParam("q_position", &this->q_position);
+  parser.addParam("q_velocity", &this->q_velocity);
+  parser.addParam("q_terminal", &this->q_terminal);
+  parser.addParam("r_input", &this->r_input);
+  parser.addParam("max_iter", &this->max_iter, true);
+  parser.addParam("tolerance", &this->tolerance, true);
+
+  parser.addParam("roll_limit.min", &this->roll_limit[0]);
+  parser.addParam("roll_limit.max", &this->roll_limit[1]);
+  parser.addParam("pitch_limit.min", &this->pitch_limit[0]);
+  parser.addParam("pitch_limit.max", &this->pitch_limit[1]);
+
+  parser.addParam("vz_controller.k_p", &this->vz_controller.k_p);
+  parser.addParam("vz_controller.k_i", &this->vz_controller.k_i);
+  parser.addParam("vz_controller.k_d", &this->vz_controller.k_d);
+  parser.addParam("vz_controller.hover_throttle", &this->hover_throttle);
+  parser.addParam("vz_controller.descent_velocity", &this->descent_velocity);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // check horizon and weights
+  if (this->horizon_dt <= 0.0) {
+    LOG_ERROR("Invalid landing MPC horizon_dt [%f]!", this->horizon_dt);
+    return -2;
+  } else if (this->r_input <= 0.0) {
+    LOG_ERROR("Landing MPC r_input has to be positive!");
+    return -2;
+  } else if (this->q_position < 0.0 || this->q_velocity < 0.0 ||
+             this->q_terminal < 0.0) {
+    LOG_ERROR("Landing MPC state weights have to be non-negative!");
+    return -2;
+  }
+
+  // convert roll and pitch limits from degrees to radians
+  this->roll_limit[0] = deg2rad(this->roll_limit[0]);
+  this->roll_limit[1] = deg2rad(this->roll_limit[1]);
+  this->pitch_limit[0] = deg2rad(this->pitch_limit[0]);
+  this->pitch_limit[1] = deg2rad(this->pitch_limit[1]);
+
+  this->buildQP();
+  this->reset();
+  this->configured = true;
+
+  return 0;
+}
+
+void LandingMPC::buildQP() {
+  const double dt = this->horizon_dt;
+
+  // relative double integrator driven by the quadrotor acceleration
+  Mat2 A;
+  A << 1.0, dt, 0.0, 1.0;
+  const Vec2 B{-0.5 * dt * dt, -dt};
+
+  // stacked prediction S = Phi s0 + Gamma U
+  Mat2 A_k = Mat2::Identity();
+  for (int k = 0; k < N; k++) {
+    A_k = A * A_k;
+    this->Phi.block<2, 2>(2 * k, 0) = A_k;
+
+    Vec2 AB = B;
+    for (int j = k; j >= 0; j--) {
+      this->Gamma.block<2, 1>(2 * k, j) = AB;
+      AB = A * AB;
+    }
+  }
+
+  // state weights, the last state is weighted as terminal cost
+  Eigen::Matrix<double, 2 * N, 1> Q;
+  for (int k = 0; k < N; k++) {
+    const double w = (k == N - 1) ? this->q_terminal : 1.0;
+    Q(2 * k) = w * this->q_position;
+    Q(2 * k + 1) = w * this->q_velocity;
+  }
+
+  // condensed cost and unconstrained gain
+  const Mat2NN QG = Q.asDiagonal() * this->Gamma;
+  this->H = this->Gamma.transpose() * QG;
+  this->H += this->r_input * MatN::Identity();
+  this->F = QG.transpose() * this->Phi;
+  this->K = -this->H.llt().solve(this->F);
+
+  // projected gradient step from the largest eigenvalue of H, which is its
+  // largest singular value as H is positive definite
+  Eigen::JacobiSVD<MatN> svd(this->H);
+  this->step_size = 1.0 / svd.singularValues()(0);
+}
+
+int LandingMPC::solve(const Vec2 &s0,
+                      const double lb,
+                      const double ub,
+                      VecN &u) {
+  // unconstrained solution
+  const VecN u_opt = this->K * s0;
+  if (u_opt.minCoeff() >= lb && u_opt.maxCoeff() <= ub) {
+    u = u_opt;
+    return 0;
+  }
+
+  // accelerated projected gradient from the warm start
+  const VecN f = this->F * s0;
+  u = u.cwiseMax(lb).cwiseMin(ub);
+  VecN y = u;
+  double t = 1.0;
+
+  int i = 0;
+  while (i < this->max_iter) {
+    i++;
+
+    const VecN grad = this->H * y + f;
+    const VecN u_next = (y - this->step_size * grad).cwiseMax(lb).cwiseMin(ub);
+    const double change = (u_next - u).cwiseAbs().maxCoeff();
+
+    const double t_next = (1.0 + sqrt(1.0 + 4.0 * t * t)) / 2.0;
+    y = u_next + ((t - 1.0) / t_next) * (u_next - u);
+    u = u_next;
+    t = t_next;
+
+    if (change < this->tolerance) {
+      break;
+    }
+  }
+
+  return i;
+}
+
+Vec4 LandingMPC::update(const Vec3 &pos_errors_B,
+                        const Vec3 &vel_errors_B,
+                        const Vec3 &velocity_W,
+                        const double yaw_setpoint,
+                        const double dt) {
+  // check rate
+  this->dt += dt;
+  if (this->dt < 0.01) {
+    return this->outputs;
+  }
+
+  // shift warm start by the prediction steps elapsed
+  this->shift_dt += this->dt;
+  while (this->shift_dt >= this->horizon_dt) {
+    const VecN u_x = this->u_x;
+    const VecN u_y = this->u_y;
+    this->u_x.head(N - 1) = u_x.tail(N - 1);
+    this->u_y.head(N - 1) = u_y.tail(N - 1);
+    this->shift_dt -= this->horizon_dt;
+  }
+
+  // acceleration bounds from the pitch and roll limits (NWU frame)
+  const double ax_lb = this->g * tan(this->pitch_limit[0]);
+  const double ax_ub = this->g * tan(this->pitch_limit[1]);
+  const double ay_lb = -this->g * tan(this->roll_limit[1]);
+  const double ay_ub = -this->g * tan(this->roll_limit[0]);
+
+  // solve horizontal approach
+  struct timespec solve_tic;
+  tic(&solve_tic);
+  const Vec2 s0_x{pos_errors_B(0), vel_errors_B(0)};
+  const Vec2 s0_y{pos_errors_B(1), vel_errors_B(1)};
+  this->nb_iter = this->solve(s0_x, ax_lb, ax_ub, this->u_x);
+  this->nb_iter += this->solve(s0_y, ay_lb, ay_ub, this->u_y);
+  this->solve_time = toc(&solve_tic);
+
+  // roll, pitch, yaw and throttle
+  double r = -atan(this->u_y(0) / this->g);
+  double p = atan(this->u_x(0) / this->g);
+  double y = yaw_setpoint;
+  const double vz_error = this->descent_velocity - velocity_W(2);
+  double t = this->hover_throttle;
+  t += this->vz_controller.update(vz_error, this->dt);
+  t /= fabs(cos(r) * cos(p)); // adjust throttle for roll and pitch
+
+  // limit roll, pitch and throttle
+  r = (r < this->roll_limit[0]) ? this->roll_limit[0] : r;
+  r = (r > this->roll_limit[1]) ? this->roll_limit[1] : r;
+  p = (p < this->pitch_limit[0]) ? this->pitch_limit[0] : p;
+  p = (p > this->pitch_limit[1]) ? this->pitch_limit[1] : p;
+  t = (t < 0) ? 0.0 : t;
+  t = (t > 1.0) ? 1.0 : t;
+
+  // keep track of outputs
+  this->outputs << r, p, y, t;
+  this->dt = 0.0;
+
+  return this->outputs;
+}
+
+void LandingMPC::reset() {
+  this->vz_controller.reset();
+  this->u_x.setZero();
+  this->u_y.setZero();
+  this->shift_dt = 0.0;
+}
+
+void LandingMPC::printOutputs() {
+  double r, p, t;
+
+  r = rad2deg(this->outputs(0));
+  p = rad2deg(this->outputs(1));
+  t = this->outputs(3);
+
+  std::cout << "roll: " << std::setprecision(2) << r << "\t";
+  std::cout << "pitch: " << std::setprecision(2) << p << "\t";
+  std::cout << "throttle: " << std::setprecision(2) << t << "\t";
+  std::cout << "solve time [ms]: " << this->solve_time * 1000.0 << std::endl;
+}
+
+} // namespace atl
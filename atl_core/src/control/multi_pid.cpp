@@ -0,0 +1,68 @@
+#include "atl/control/multi_pid.hpp"
+
+namespace atl {
+
+int GainSchedule::configure(const std::string &config_file,
+                            const std::string &prefix,
+                            const int nb_axes) {
+  ConfigParser parser;
+
+  // load config
+  this->loaded = false;
+  this->breakpoints.clear();
+  parser.addParam(prefix + ".breakpoints", &this->breakpoints, true);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  } else if (this->breakpoints.size() == 0) {
+    return 0;
+  }
+
+  parser = ConfigParser();
+  parser.addParam(prefix + ".k_p", &this->k_p);
+  parser.addParam(prefix + ".k_i", &this->k_i);
+  parser.addParam(prefix + ".k_d", &this->k_d);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // check schedule
+  const int rows = (int) this->breakpoints.size();
+  for (int i = 1; i < rows; i++) {
+    if (this->breakpoints[i] <= this->breakpoints[i - 1]) {
+      LOG_ERROR("Gain schedule breakpoints must be increasing!");
+      return -2;
+    }
+  }
+  const MatX *gains[3] = {&this->k_p, &this->k_i, &this->k_d};
+  for (int i = 0; i < 3; i++) {
+    if (gains[i]->rows() != rows || gains[i]->cols() != nb_axes) {
+      LOG_ERROR("Gain schedule gains must be %d x %d!", rows, nb_axes);
+      return -2;
+    }
+  }
+
+  this->loaded = true;
+  return 0;
+}
+
+void GainSchedule::lookup(const double x, int &row, double &alpha) const {
+  const std::vector<double> &bp = this->breakpoints;
+  const int last = (int) bp.size() - 1;
+
+  // hold gains beyond the first and last breakpoint
+  if (x <= bp[0]) {
+    row = 0;
+    alpha = 0.0;
+    return;
+  } else if (x >= bp[last]) {
+    row = last;
+    alpha = 0.0;
+    return;
+  }
+
+  // interpolate within interval
+  row = (int) (std::upper_bound(bp.begin(), bp.end(), x) - bp.begin()) - 1;
+  alpha = (x - bp[row]) / (bp[row + 1] - bp[row]);
+}
+
+} // namespace atl
@@ -3,6 +3,11 @@
 namespace atl {
 
 double PID::update(const double setpoint, const double input, const double dt) {
+  // keep previous output if no time has passed
+  if (dt <= 0.0) {
+    return this->error_p + this->error_i + this->error_d;
+  }
+
   // calculate errors
   double error = setpoint - input;
   this->error_sum += error * dt;
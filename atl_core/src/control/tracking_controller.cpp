@@ -6,28 +6,24 @@ int TrackingController::configure(const std::string &config_file) {
   ConfigParser parser;
 
   // load config
-  parser.addParam("roll_controller.k_p", &this->y_controller.k_p);
-  parser.addParam("roll_controller.k_i", &this->y_controller.k_i);
-  parser.addParam("roll_controller.k_d", &this->y_controller.k_d);
   parser.addParam("roll_controller.min", &this->roll_limit[0]);
   parser.addParam("roll_controller.max", &this->roll_limit[1]);
-
-  parser.addParam("pitch_controller.k_p", &this->x_controller.k_p);
-  parser.addParam("pitch_controller.k_i", &this->x_controller.k_i);
-  parser.addParam("pitch_controller.k_d", &this->x_controller.k_d);
   parser.addParam("pitch_controller.min", &this->pitch_limit[0]);
   parser.addParam("pitch_controller.max", &this->pitch_limit[1]);
-
-  parser.addParam("throttle_controller.k_p", &this->z_controller.k_p);
-  parser.addParam("throttle_controller.k_i", &this->z_controller.k_i);
-  parser.addParam("throttle_controller.k_d", &this->z_controller.k_d);
   parser.addParam("throttle_controller.hover_throttle", &this->hover_throttle);
-
   parser.addParam("track_offset", &this->track_offset);
   if (parser.load(config_file) != 0) {
     return -1;
   }
 
+  // load pid gains, x and y are controlled through pitch and roll
+  const std::vector<std::string> axes = {"pitch_controller",
+                                         "roll_controller",
+                                         "throttle_controller"};
+  if (this->pid.configure(config_file, axes) != 0) {
+    return -1;
+  }
+
   // convert roll and pitch limits from degrees to radians
   this->roll_limit[0] = deg2rad(this->roll_limit[0]);
   this->roll_limit[1] = deg2rad(this->roll_limit[1]);
@@ -54,12 +50,24 @@ AttitudeCommand TrackingController::update(const Vec3 &errors_B,
   // add offsets
   Vec3 errors = errors_B + this->track_offset;
 
+  // pid outputs, saturation limits stop the integrals winding up, gains are
+  // scheduled on the height above the target
+  // clang-format off
+  this->pid.scheduleGains(-errors_B(2));
+  this->pid.output_min << this->pitch_limit[0],
+                          -this->roll_limit[1],
+                          -this->hover_throttle;
+  this->pid.output_max << this->pitch_limit[1],
+                          -this->roll_limit[0],
+                          1.0 - this->hover_throttle;
+  // clang-format on
+  const Vec3 u = this->pid.update(errors.array(), this->dt).matrix();
+
   // roll, pitch, yaw and throttle (assuming NWU frame)
-  double r = -this->y_controller.update(errors(1), 0.0, this->dt);
-  double p = this->x_controller.update(errors(0), 0.0, this->dt);
+  double r = -u(1);
+  double p = u(0);
   double y = yaw_W;
-  double t = this->hover_throttle;
-  t += this->z_controller.update(errors(2), 0.0, this->dt);
+  double t = this->hover_throttle + u(2);
   t /= fabs(cos(r) * cos(p)); // adjust throttle for roll and pitch
 
   // limit roll, pitch
@@ -89,11 +97,7 @@ AttitudeCommand TrackingController::update(const Vec3 &target_pos_B,
   return this->update(errors, yaw_W, dt);
 }
 
-void TrackingController::reset() {
-  this->x_controller.reset();
-  this->y_controller.reset();
-  this->z_controller.reset();
-}
+void TrackingController::reset() { this->pid.reset(); }
 
 void TrackingController::printOutputs() {
   double r, p, t;
@@ -108,32 +112,18 @@ void TrackingController::printOutputs() {
 }
 
 void TrackingController::printErrors() {
-  double p = this->x_controller.error_p;
-  double i = this->x_controller.error_i;
-  double d = this->x_controller.error_d;
-
-  std::cout << "x_controller: " << std::endl;
-  std::cout << "\terror_p: " << std::setprecision(2) << p << "\t";
-  std::cout << "\terror_i: " << std::setprecision(2) << i << "\t";
-  std::cout << "\terror_d: " << std::setprecision(2) << d << std::endl;
-
-  p = this->y_controller.error_p;
-  i = this->y_controller.error_i;
-  d = this->y_controller.error_d;
-
-  std::cout << "y_controller: " << std::endl;
-  std::cout << "\terror_p: " << std::setprecision(2) << p << "\t";
-  std::cout << "\terror_i: " << std::setprecision(2) << i << "\t";
-  std::cout << "\terror_d: " << std::setprecision(2) << d << std::endl;
-
-  p = this->z_controller.error_p;
-  i = this->z_controller.error_i;
-  d = this->z_controller.error_d;
-
-  std::cout << "z_controller: " << std::endl;
-  std::cout << "\terror_p: " << std::setprecision(2) << p << "\t";
-  std::cout << "\terror_i: " << std::setprecision(2) << i << "\t";
-  std::cout << "\terror_d: " << std::setprecision(2) << d << std::endl;
+  const std::string axes[3] = {"x_controller", "y_controller", "z_controller"};
+
+  for (int k = 0; k < 3; k++) {
+    const double p = this->pid.error_p(k);
+    const double i = this->pid.error_i(k);
+    const double d = this->pid.error_d(k);
+
+    std::cout << axes[k] << ": " << std::endl;
+    std::cout << "\terror_p: " << std::setprecision(2) << p << "\t";
+    std::cout << "\terror_i: " << std::setprecision(2) << i << "\t";
+    std::cout << "\terror_d: " << std::setprecision(2) << d << std::endl;
+  }
 }
 
 } // namespace atl
@@ -6,7 +6,6 @@ int Trajectory::load(const int index,
                      const std::string &filepath,
                      const Vec3 &p0) {
   MatX traj_data;
-  Vec2 p, v, u, rel_p, rel_v;
 
   // pre-check
   if (file_exists(filepath) == false) {
@@ -15,6 +14,42 @@ int Trajectory::load(const int index,
   }
 
   // load trajectory file
+  this->reset();
+  csv2mat(filepath, true, traj_data);
+  if (traj_data.rows() == 0) {
+    LOG_ERROR(ETROWS, filepath.c_str());
+    return -2;
+  } else if (traj_data.cols() != 10) {
+    LOG_ERROR(ETCOLS, filepath.c_str());
+    return -2;
+  }
+
+  return this->load(index, traj_data, p0);
+}
+
+int Trajectory::load(const int index,
+                     const float *records,
+                     const int nb_rows,
+                     const Vec3 &p0) {
+  // pre-check
+  if (records == nullptr || nb_rows <= 0) {
+    return -2;
+  }
+
+  // records are row-major
+  typedef Eigen::Matrix<float, Eigen::Dynamic, 10, Eigen::RowMajor> Records;
+  const Eigen::Map<const Records> data(records, nb_rows, 10);
+  const MatX traj_data = data.cast<double>();
+  return this->load(index, traj_data, p0);
+}
+
+int Trajectory::load(const int index, const MatX &traj_data, const Vec3 &p0) {
+  // pre-check
+  this->reset();
+  if (traj_data.rows() < 2 || traj_data.cols() != 10) {
+    return -2;
+  }
+
   // assumes each column is:
   // - x
   // - vx
@@ -26,30 +61,21 @@ int Trajectory::load(const int index,
   // - rel_z
   // - rel_vx
   // - rel_vz
-  this->reset();
   this->index = index;
-  csv2mat(filepath, true, traj_data);
-  if (traj_data.rows() == 0) {
-    LOG_ERROR(ETROWS, filepath.c_str());
-    return -2;
-  } else if (traj_data.cols() != 10) {
-    LOG_ERROR(ETCOLS, filepath.c_str());
-    return -2;
-  }
 
   // set trajectory class
-  for (int i = 0; i < traj_data.rows(); i++) {
-    p << traj_data(i, 0), traj_data(i, 2);     // x, z
-    v << traj_data(i, 1), traj_data(i, 3);     // vx, vz
-    u << traj_data(i, 4), traj_data(i, 5);     // az, theta
-    rel_p << traj_data(i, 6), traj_data(i, 7); // rel_x, rel_z
-    rel_v << traj_data(i, 8), traj_data(i, 9); // rel_vx, rel_vz
-
-    this->pos.push_back(p);
-    this->vel.push_back(v);
-    this->inputs.push_back(u);
-    this->rel_pos.push_back(rel_p);
-    this->rel_vel.push_back(rel_v);
+  const size_t nb_rows = traj_data.rows();
+  this->pos.resize(nb_rows);
+  this->vel.resize(nb_rows);
+  this->inputs.resize(nb_rows);
+  this->rel_pos.resize(nb_rows);
+  this->rel_vel.resize(nb_rows);
+  for (size_t i = 0; i < nb_rows; i++) {
+    this->pos[i] << traj_data(i, 0), traj_data(i, 2);     // x, z
+    this->vel[i] << traj_data(i, 1), traj_data(i, 3);     // vx, vz
+    this->inputs[i] << traj_data(i, 4), traj_data(i, 5);  // az, theta
+    this->rel_pos[i] << traj_data(i, 6), traj_data(i, 7); // rel_x, rel_z
+    this->rel_vel[i] << traj_data(i, 8), traj_data(i, 9); // rel_vx, rel_vz
   }
 
   this->p0 = p0;
@@ -64,56 +90,118 @@ int Trajectory::update(const Vec3 &pos,
   // pre-check
   if (this->loaded == false) {
     return -1;
-  } else if (this->pos.size() < 2) {
-    wp_pos = this->pos.at(0);
-    wp_vel = this->vel.at(0);
-    wp_inputs = this->inputs.at(0);
-    return 0;
   }
 
   // setup
-  Vec2 wp_pos_start = this->pos.at(0);
-  Vec2 wp_pos_end = this->pos.at(1);
-
-  Vec2 wp_vel_start = this->vel.at(0);
-  Vec2 wp_vel_end = this->vel.at(1);
-
-  Vec2 wp_inputs_start = this->inputs.at(0);
-  Vec2 wp_inputs_end = this->inputs.at(1);
-
+  const int last = (int) this->pos.size() - 2;
   Vec2 q_pos;
   q_pos(0) = (this->p0.block(0, 0, 2, 1) - pos.block(0, 0, 2, 1)).norm();
   q_pos(1) = pos(2);
 
-  // find next waypoint position, velocity and inputs
-  double wp_percent = closest_point(wp_pos_start, wp_pos_end, q_pos, wp_pos);
-  wp_vel = lerp(wp_vel_start, wp_vel_end, wp_percent);
-  wp_inputs = lerp(wp_inputs_start, wp_inputs_end, wp_percent);
-
-  // update trajectory waypoints
-  if (wp_percent > 1.0) {
-    this->pos.pop_front();
-    this->vel.pop_front();
-    this->inputs.pop_front();
-    this->rel_pos.pop_front();
-    this->rel_vel.pop_front();
+  // advance past the segments the robot has passed
+  double wp_percent = this->project(this->cursor, q_pos, wp_pos);
+  while (wp_percent >= 1.0 && this->cursor < last) {
+    this->cursor++;
+    wp_percent = this->project(this->cursor, q_pos, wp_pos);
+  }
+
+  // look ahead for a closer segment
+  const int end = std::min(this->cursor + this->search_window, last);
+  const double s = std::max(0.0, std::min(wp_percent, 1.0));
+  const Vec2 &start = this->pos[this->cursor];
+  double best = (q_pos - lerp(start, this->pos[this->cursor + 1], s)).norm();
+  int best_segment = this->cursor;
+  for (int i = this->cursor + 1; i <= end; i++) {
+    Vec2 closest;
+    const double percent = this->project(i, q_pos, closest);
+    const double t = std::max(0.0, std::min(percent, 1.0));
+    const double d = (q_pos - lerp(this->pos[i], this->pos[i + 1], t)).norm();
+    if (d < best) {
+      best = d;
+      best_segment = i;
+    }
+  }
+  if (best_segment != this->cursor) {
+    this->cursor = best_segment;
+    wp_percent = this->project(this->cursor, q_pos, wp_pos);
+  }
+
+  // waypoint position, velocity and inputs, held at the ends of the
+  // trajectory instead of extrapolated
+  const int i = this->cursor;
+  wp_percent = std::max(0.0, std::min(wp_percent, 1.0));
+  wp_pos = lerp(this->pos[i], this->pos[i + 1], wp_percent);
+  wp_vel = lerp(this->vel[i], this->vel[i + 1], wp_percent);
+  wp_inputs = lerp(this->inputs[i], this->inputs[i + 1], wp_percent);
+  this->wp_time = (i + wp_percent) * this->dt;
+
+  return 0;
+}
+
+int Trajectory::sample(const double t,
+                       Vec2 &wp_pos,
+                       Vec2 &wp_vel,
+                       Vec2 &wp_inputs) const {
+  // pre-check
+  if (this->loaded == false) {
+    return -1;
   }
 
-  // debug
-  // std::cout << "pos: " << pos.transpose() << std::endl;
-  // std::cout << "wp_start: " << wp_pos_start.transpose() << std::endl;
-  // std::cout << "wp_end: " << wp_pos_end.transpose() << std::endl;
-  // std::cout << "wp_vel: " << wp_vel.transpose() << std::endl;
-  // std::cout << "wp: " << wp_pos.transpose() << std::endl;
-  // std::cout << "rel_pos: " << this->rel_pos.at(0).transpose() << std::endl;
-  // std::cout << "rel_vel: " << this->rel_vel.at(0).transpose() << std::endl;
-  // std::cout << "inputs: " << this->inputs.at(0).transpose() << std::endl;
-  // std::cout << "nb waypoints left: " << this->pos.size() << std::endl;
-  // std::cout << std::endl;
+  // waypoints either side of t
+  const int last = (int) this->pos.size() - 1;
+  const double k = std::max(0.0, std::min(t / this->dt, (double) last));
+  const int i = std::min((int) k, std::max(last - 1, 0));
+  const int j = std::min(i + 1, last);
+  const double mu = k - i;
+
+  wp_pos = lerp(this->pos[i], this->pos[j], mu);
+  wp_vel = lerp(this->vel[i], this->vel[j], mu);
+  wp_inputs = lerp(this->inputs[i], this->inputs[j], mu);
 
   return 0;
 }
 
+int Trajectory::planFeedForward() {
+  // pre-check
+  if (this->loaded == false) {
+    return -1;
+  }
+
+  // the trajectory lies in the x-z plane
+  std::vector<Vec3> plan_pos, plan_vel;
+  for (size_t i = 0; i < this->pos.size(); i++) {
+    plan_pos.emplace_back(this->pos[i](0), 0.0, this->pos[i](1));
+    plan_vel.emplace_back(this->vel[i](0), 0.0, this->vel[i](1));
+  }
+  if (this->plan.plan(plan_pos, plan_vel, {}, this->dt) != 0) {
+    LOG_ERROR("Failed to plan feed-forward for trajectory [%d]!", this->index);
+    return -2;
+  }
+
+  return 0;
+}
+
+int Trajectory::feedForward(FlatState &state) const {
+  return this->plan.evaluate(this->wp_time, state);
+}
+
+double Trajectory::project(const int i,
+                           const Vec2 &q_pos,
+                           Vec2 &closest) const {
+  const Vec2 &a = this->pos[i];
+  const Vec2 &b = this->pos[i + 1];
+  const Vec2 ab = b - a;
+  const double length2 = ab.squaredNorm();
+  if (length2 == 0.0) {
+    closest = a;
+    return 1.0;
+  }
+
+  const double t = (q_pos - a).dot(ab) / length2;
+  closest = a + t * ab;
+  return t;
+}
+
 void Trajectory::reset() {
   this->loaded = false;
   this->pos.clear();
@@ -122,6 +210,9 @@ void Trajectory::reset() {
   this->rel_pos.clear();
   this->rel_vel.clear();
   this->p0 << 0.0, 0.0, 0.0;
+  this->cursor = 0;
+  this->wp_time = 0.0;
+  this->plan.reset();
 }
 
 } // namespace atl
@@ -4,30 +4,28 @@ namespace atl {
 
 int TrajectoryController::configure(const std::string &config_file) {
   std::string traj_index_file;
+  std::string traj_library_file;
+  std::string traj_generator_file;
   std::string blackbox_file;
+  std::string feed_forward = "inputs";
+  double trajectory_dt = this->trajectory.dt;
 
   // load config
   ConfigParser parser;
-  parser.addParam("vx_controller.k_p", &this->vx_k_p);
-  parser.addParam("vx_controller.k_i", &this->vx_k_i);
-  parser.addParam("vx_controller.k_d", &this->vx_k_d);
   parser.addParam("vx_controller.min", &this->pitch_limit[0]);
   parser.addParam("vx_controller.max", &this->pitch_limit[1]);
-
-  parser.addParam("vy_controller.k_p", &this->vy_k_p);
-  parser.addParam("vy_controller.k_i", &this->vy_k_i);
-  parser.addParam("vy_controller.k_d", &this->vy_k_d);
   parser.addParam("vy_controller.min", &this->roll_limit[0]);
   parser.addParam("vy_controller.max", &this->roll_limit[1]);
-
-  parser.addParam("vz_controller.k_p", &this->vz_k_p);
-  parser.addParam("vz_controller.k_i", &this->vz_k_i);
-  parser.addParam("vz_controller.k_d", &this->vz_k_d);
   parser.addParam("vz_controller.min", &this->throttle_limit[0]);
   parser.addParam("vz_controller.max", &this->throttle_limit[1]);
 
-  parser.addParam("trajectory_index", &traj_index_file);
+  parser.addParam("trajectory_index", &traj_index_file, true);
+  parser.addParam("trajectory_library", &traj_library_file, true);
+  parser.addParam("trajectory_generator", &traj_generator_file, true);
   parser.addParam("trajectory_threshold", &this->trajectory_threshold);
+  parser.addParam("trajectory_dt", &trajectory_dt, true);
+  parser.addParam("feed_forward", &feed_forward, true);
+  parser.addParam("hover_throttle", &this->hover_throttle, true);
 
   parser.addParam("blackbox_enable", &this->blackbox_enable);
   parser.addParam("blackbox_rate", &this->blackbox_rate, true);
@@ -36,13 +34,62 @@ int TrajectoryController::configure(const std::string &config_file) {
     return -1;
   }
 
-  // load trajectory index
+  // load pid gains
+  const std::vector<std::string> axes = {"vx_controller",
+                                         "vy_controller",
+                                         "vz_controller"};
+  if (this->pid.configure(config_file, axes) != 0) {
+    return -1;
+  }
+
+  // check feed-forward
+  if (feed_forward == "inputs") {
+    this->feed_forward = FEED_FORWARD_INPUTS;
+  } else if (feed_forward == "flatness") {
+    this->feed_forward = FEED_FORWARD_FLATNESS;
+  } else {
+    LOG_ERROR("Invalid feed-forward [%s]!", feed_forward.c_str());
+    return -1;
+  }
+
+  // check trajectory dt
+  if (trajectory_dt <= 0.0) {
+    LOG_ERROR("Invalid trajectory dt [%f]!", trajectory_dt);
+    return -1;
+  }
+  this->trajectory.dt = trajectory_dt;
+
+  // load trajectory index, a trajectory library is memory-mapped now so
+  // loading a trajectory later does not touch the disk
   std::string config_dir = std::string(dirname((char *) config_file.c_str()));
-  paths_combine(config_dir, traj_index_file, traj_index_file);
-  if (this->traj_index.load(traj_index_file) != 0) {
+  if (traj_library_file != "") {
+    paths_combine(config_dir, traj_library_file, traj_library_file);
+    if (this->traj_index.loadLibrary(traj_library_file) != 0) {
+      return -2;
+    }
+  } else if (traj_index_file != "") {
+    paths_combine(config_dir, traj_index_file, traj_index_file);
+    if (this->traj_index.load(traj_index_file) != 0) {
+      return -2;
+    }
+  } else if (traj_generator_file == "") {
+    LOG_ERROR("No trajectory index, library or generator is set!");
     return -2;
   }
 
+  // configure trajectory generator
+  if (traj_generator_file != "") {
+    paths_combine(config_dir, traj_generator_file, traj_generator_file);
+    if (this->generator.configure(traj_generator_file) != 0) {
+      return -2;
+    } else if (fabs(this->generator.dt - this->trajectory.dt) > 1e-9) {
+      LOG_ERROR("Generator dt [%f] is not the trajectory dt [%f]!",
+                this->generator.dt,
+                this->trajectory.dt);
+      return -2;
+    }
+  }
+
   // prepare blackbox file
   if (this->blackbox_enable) {
     if (blackbox_file == "") {
@@ -75,12 +122,28 @@ int TrajectoryController::configure(const std::string &config_file) {
 
 int TrajectoryController::loadTrajectory(const Vec3 &pos,
                                          const Vec3 &target_pos_B,
+                                         const Vec3 &target_vel_B,
                                          const double v) {
   int retval;
 
-  // find trajectory
-  retval = this->traj_index.find(pos, v, this->trajectory);
-  UNUSED(target_pos_B);
+  // generate trajectory in the plane towards the target, or else find it
+  if (this->generator.configured) {
+    // plane x-axis, the horizontal direction towards the target
+    const Vec2 target_xy = target_pos_B.block(0, 0, 2, 1);
+    const double d = target_xy.norm();
+    const Vec2 x_axis = (d > 1e-6) ? Vec2{target_xy / d} : Vec2{1.0, 0.0};
+
+    // project the target velocity onto the plane
+    const Vec2 target_vel_xy = target_vel_B.block(0, 0, 2, 1);
+    const Vec2 start_pos{0.0, pos(2)};
+    const Vec2 start_vel{v, 0.0};
+    const Vec2 target_pos{d, pos(2) + target_pos_B(2)};
+    const Vec2 target_vel{x_axis.dot(target_vel_xy), target_vel_B(2)};
+    retval = this->generator.generate(
+        start_pos, start_vel, target_pos, target_vel, pos, this->trajectory);
+  } else {
+    retval = this->traj_index.find(pos, v, this->trajectory);
+  }
 
   // check retval
   if (retval == -2) {
@@ -93,47 +156,37 @@ int TrajectoryController::loadTrajectory(const Vec3 &pos,
     LOG_INFO(TLOAD, pos(2), v);
   }
 
+  // plan flatness feed-forward
+  if (this->feed_forward == FEED_FORWARD_FLATNESS) {
+    if (this->trajectory.planFeedForward() != 0) {
+      return -1;
+    }
+  }
+
   return 0;
 }
 
 int TrajectoryController::prepBlackbox(const std::string &blackbox_file) {
-  // setup
-  this->blackbox.open(blackbox_file);
-  if (!this->blackbox) {
-    return -1;
-  }
-
-  // write header
   // clang-format off
-  this->blackbox << "dt" << ",";
-  this->blackbox << "x" << ",";
-  this->blackbox << "y" << ",";
-  this->blackbox << "z" << ",";
-  this->blackbox << "vx" << ",";
-  this->blackbox << "vy" << ",";
-  this->blackbox << "vz" << ",";
-  this->blackbox << "wp_pos_x" << ",";
-  this->blackbox << "wp_pos_z" << ",";
-  this->blackbox << "wp_vel_x" << ",";
-  this->blackbox << "wp_vel_z" << ",";
-  this->blackbox << "target_x_B" << ",";
-  this->blackbox << "target_y_B" << ",";
-  this->blackbox << "target_z_B" << ",";
-  this->blackbox << "target_vx_B" << ",";
-  this->blackbox << "target_vy_B" << ",";
-  this->blackbox << "target_vz_B" << ",";
-  this->blackbox << "roll";
-  this->blackbox << "pitch";
-  this->blackbox << "yaw";
-  this->blackbox << std::endl;
+  const std::vector<std::string> fields = {
+    "dt",
+    "x", "y", "z",
+    "vx", "vy", "vz",
+    "wp_pos_x", "wp_pos_z",
+    "wp_vel_x", "wp_vel_z",
+    "wp_thrust", "wp_pitch",
+    "target_x_B", "target_y_B", "target_z_B",
+    "target_vx_B", "target_vy_B", "target_vz_B",
+    "roll", "pitch", "yaw",
+    "thrust",
+    "trajectory_index"
+  };
   // clang-format on
 
-  return 0;
-}
+  if (this->blackbox.configure(blackbox_file, fields) != 0) {
+    return -1;
+  }
 
-int TrajectoryController::recordTrajectoryIndex() {
-  this->blackbox << "trajectory index: " << this->trajectory.index;
-  this->blackbox << std::endl;
   return 0;
 }
 
@@ -149,38 +202,29 @@ int TrajectoryController::record(const Vec3 &pos,
                                  const double dt) {
   // pre-check
   this->blackbox_dt += dt;
-  if (this->blackbox_enable && this->blackbox_dt > this->blackbox_rate) {
+  if (!this->blackbox_enable || this->blackbox_dt < this->blackbox_rate) {
     return 0;
   }
 
-  // record
-  this->blackbox << dt << ",";
-  this->blackbox << pos(0) << ",";
-  this->blackbox << pos(1) << ",";
-  this->blackbox << pos(2) << ",";
-  this->blackbox << vel(0) << ",";
-  this->blackbox << vel(1) << ",";
-  this->blackbox << vel(2) << ",";
-  this->blackbox << wp_pos(0) << ",";
-  this->blackbox << wp_pos(1) << ",";
-  this->blackbox << wp_vel(0) << ",";
-  this->blackbox << wp_vel(1) << ",";
-  this->blackbox << wp_inputs(0) << ",";
-  this->blackbox << wp_inputs(1) << ",";
-  this->blackbox << target_pos_B(0) << ",";
-  this->blackbox << target_pos_B(1) << ",";
-  this->blackbox << target_pos_B(2) << ",";
-  this->blackbox << target_vel_B(0) << ",";
-  this->blackbox << target_vel_B(1) << ",";
-  this->blackbox << target_vel_B(2) << ",";
-  this->blackbox << rpy(0) << ",";
-  this->blackbox << rpy(1) << ",";
-  this->blackbox << rpy(2) << ",";
-  this->blackbox << thrust;
-  this->blackbox << std::endl;
+  // record, same order as the fields in prepBlackbox()
+  // clang-format off
+  const double row[] = {
+    this->blackbox_dt,
+    pos(0), pos(1), pos(2),
+    vel(0), vel(1), vel(2),
+    wp_pos(0), wp_pos(1),
+    wp_vel(0), wp_vel(1),
+    wp_inputs(0), wp_inputs(1),
+    target_pos_B(0), target_pos_B(1), target_pos_B(2),
+    target_vel_B(0), target_vel_B(1), target_vel_B(2),
+    rpy(0), rpy(1), rpy(2),
+    thrust,
+    (double) this->trajectory.index
+  };
+  // clang-format on
   this->blackbox_dt = 0.0;
 
-  return 0;
+  return this->blackbox.record(row);
 }
 
 Vec4 TrajectoryController::calculateVelocityErrors(const Vec3 &v_errors_B,
@@ -195,32 +239,27 @@ Vec4 TrajectoryController::calculateVelocityErrors(const Vec3 &v_errors_B,
     return this->outputs;
   }
 
-  // roll
-  double r = this->vy_k_p * v_errors_B(1);
-  r += this->vy_k_i * p_errors_B(1);
-  r += this->vy_k_d * (v_errors_B(1) - this->vy_error_prev) / this->dt;
-  r = -1 * r;
-
-  // pitch
-  this->vx_error_sum += v_errors_B(0);
-  double p = this->vx_k_p * v_errors_B(0);
-  p += this->vx_k_i * this->vx_error_sum;
-  p += this->vx_k_d * (v_errors_B(0) - this->vx_error_prev) / this->dt;
-
-  // yaw
+  // pid outputs, the integral of the velocity errors is the position error
+  // clang-format off
+  this->pid.output_min << this->pitch_limit[0],
+                          -this->roll_limit[1],
+                          this->throttle_limit[0];
+  this->pid.output_max << this->pitch_limit[1],
+                          -this->roll_limit[0],
+                          this->throttle_limit[1];
+  // clang-format on
+  Vec3 u;
+  u = this->pid.updateIntegral(v_errors_B.array(),
+                               p_errors_B.array(),
+                               this->dt);
+
+  // roll, pitch, yaw and throttle
+  double r = -u(1);
+  double p = u(0);
   double y = 0.0;
-
-  // throttle
-  double t = this->vz_k_p * v_errors_B(2);
-  t += this->vz_k_i * p_errors_B(2);
-  t += this->vz_k_d * (v_errors_B(2) - this->vz_error_prev) / this->dt;
+  double t = u(2);
   t /= fabs(cos(r) * cos(p)); // adjust throttle for roll and pitch
 
-  // keep track of previous errors
-  this->vx_error_prev = v_errors_B(0);
-  this->vy_error_prev = v_errors_B(1);
-  this->vz_error_prev = v_errors_B(2);
-
   // limit roll, pitch, throttle
   r = (r < this->roll_limit[0]) ? this->roll_limit[0] : r;
   r = (r > this->roll_limit[1]) ? this->roll_limit[1] : r;
@@ -251,8 +290,9 @@ int TrajectoryController::update(const Vec3 &target_pos_B,
     LOG_ERROR("Trajectory update failed!");
     return -1;
   }
-  Vec2 wp_rel_pos = this->trajectory.rel_pos.at(0);
-  // Vec2 wp_rel_vel = this->trajectory.rel_vel.at(0);
+  const int cursor = this->trajectory.cursor;
+  Vec2 wp_rel_pos = this->trajectory.rel_pos.at(cursor);
+  // Vec2 wp_rel_vel = this->trajectory.rel_vel.at(cursor);
 
   // calculate velocity in body frame
   const Vec3 vel_B = T_B_W{orientation_W} * vel_W;
@@ -274,10 +314,24 @@ int TrajectoryController::update(const Vec3 &target_pos_B,
       this->calculateVelocityErrors(v_errors_B, p_errors_B, yaw_W, dt);
 
   // add in feed-forward controls
-  this->outputs(0) += 0.0;          // roll
-  this->outputs(1) += wp_inputs(1); // pitch
-  this->outputs(2) += yaw_W;        // yaw
-  this->outputs(3) += wp_inputs(0); // thrust
+  if (this->feed_forward == FEED_FORWARD_FLATNESS) {
+    if (this->trajectory.feedForward(this->wp_state) != 0) {
+      LOG_ERROR("Trajectory feed-forward is not planned!");
+      return -1;
+    }
+    const FlatState &ff = this->wp_state;
+    wp_inputs(0) = this->hover_throttle * ff.thrust / this->trajectory.plan.g;
+    wp_inputs(1) = ff.rpy(1);
+    this->outputs(0) += ff.rpy(0);         // roll
+    this->outputs(1) += wp_inputs(1);      // pitch
+    this->outputs(2) += yaw_W + ff.rpy(2); // yaw
+    this->outputs(3) += wp_inputs(0);      // thrust
+  } else {
+    this->outputs(0) += 0.0;          // roll
+    this->outputs(1) += wp_inputs(1); // pitch
+    this->outputs(2) += yaw_W;        // yaw
+    this->outputs(3) += wp_inputs(0); // thrust
+  }
 
   // record
   const Vec3 rpy = quatToEuler321(orientation_W);
@@ -310,13 +364,7 @@ int TrajectoryController::update(const Vec3 &target_pos_B,
   return 0;
 }
 
-void TrajectoryController::reset() {
-  this->vx_error_prev = 0.0;
-  this->vy_error_prev = 0.0;
-  this->vz_error_prev = 0.0;
-
-  this->vx_error_sum = 0.0;
-}
+void TrajectoryController::reset() { this->pid.reset(); }
 
 void TrajectoryController::printOutputs() {
   double r, p, t;
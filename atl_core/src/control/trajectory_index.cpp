@@ -6,13 +6,18 @@ int TrajectoryIndex::load(const std::string &index_file,
                           const double pos_thres,
                           const double vel_thres) {
   // pre-check
+  this->loaded = false;
   if (file_exists(index_file) == false) {
     LOG_ERROR("File not found: %s", index_file.c_str());
     return -1;
+  } else if (pos_thres <= 0.0 || vel_thres <= 0.0) {
+    LOG_ERROR("Invalid trajectory index thresholds!");
+    return -3;
   }
 
   // load trajectory index
-  // assumes each column is: (index, p0_x, p0_z, pf_x, pf_z, z)
+  // assumes each column is: (index, p0_z, v)
+  this->library.close();
   csv2mat(index_file, true, this->index_data);
   this->traj_dir = std::string(dirname((char *) index_file.c_str()));
   this->pos_thres = pos_thres;
@@ -26,49 +31,245 @@ int TrajectoryIndex::load(const std::string &index_file,
     return -2;
   }
 
+  // build search tree
+  if (this->build() != 0) {
+    return -2;
+  }
+
+  return 0;
+}
+
+int TrajectoryIndex::loadLibrary(const std::string &library_file,
+                                 const double pos_thres,
+                                 const double vel_thres) {
+  // pre-check
+  this->loaded = false;
+  if (pos_thres <= 0.0 || vel_thres <= 0.0) {
+    LOG_ERROR("Invalid trajectory index thresholds!");
+    return -3;
+  }
+
+  // map trajectory library
+  const int retval = this->library.open(library_file);
+  if (retval != 0) {
+    return retval;
+  }
+  this->traj_dir = "";
+  this->pos_thres = pos_thres;
+  this->vel_thres = vel_thres;
+
+  // trajectory index from the index table of the library
+  const int nb_rows = this->library.nbTrajectories();
+  if (nb_rows == 0) {
+    LOG_ERROR(ETIROWS, library_file.c_str());
+    this->library.close();
+    return -2;
+  }
+  this->index_data.resize(nb_rows, 3);
+  for (int i = 0; i < nb_rows; i++) {
+    const TrajectoryLibraryEntry &entry = this->library.entries[i];
+    this->index_data(i, 0) = entry.index;
+    this->index_data(i, 1) = entry.z;
+    this->index_data(i, 2) = entry.v;
+  }
+
+  // build search tree
+  if (this->build() != 0) {
+    this->library.close();
+    return -2;
+  }
+
+  return 0;
+}
+
+int TrajectoryIndex::build() {
+  // pre-check
+  this->loaded = false;
+  this->tree.clear();
+  if (this->index_data.rows() == 0 || this->index_data.cols() != 3) {
+    return -1;
+  } else if (this->pos_thres <= 0.0 || this->vel_thres <= 0.0) {
+    return -1;
+  }
+
+  // normalized (z, v) of every row
+  const int nb_rows = this->index_data.rows();
+  this->tree.resize(nb_rows);
+  for (int i = 0; i < nb_rows; i++) {
+    this->tree[i].z = this->index_data(i, 1) / this->pos_thres;
+    this->tree[i].v = this->index_data(i, 2) / this->vel_thres;
+    this->tree[i].row = i;
+  }
+
+  // k-d tree, the median of every range splits it alternating between z
+  // and v, the children of a range are the halves either side of it
+  struct Range {
+    size_t lo;
+    size_t hi;
+    int axis;
+  };
+  std::vector<Range> stack = {{0, this->tree.size(), 0}};
+  while (stack.size()) {
+    const Range r = stack.back();
+    stack.pop_back();
+    if (r.hi - r.lo < 2) {
+      continue;
+    }
+
+    const size_t mid = r.lo + (r.hi - r.lo) / 2;
+    const int axis = r.axis;
+    std::nth_element(this->tree.begin() + r.lo,
+                     this->tree.begin() + mid,
+                     this->tree.begin() + r.hi,
+                     [axis](const TrajectoryIndexNode &a,
+                            const TrajectoryIndexNode &b) {
+                       return (axis == 0) ? a.z < b.z : a.v < b.v;
+                     });
+    stack.push_back({r.lo, mid, 1 - axis});
+    stack.push_back({mid + 1, r.hi, 1 - axis});
+  }
+
   this->loaded = true;
   return 0;
 }
 
-int TrajectoryIndex::find(const Vec3 &pos, const double v, Trajectory &traj) {
-  bool p_ok, v_ok;
-  std::vector<int> matches;
-  std::string traj_file;
+void TrajectoryIndex::search(const size_t lo,
+                             const size_t hi,
+                             const int axis,
+                             const double z,
+                             const double v,
+                             const size_t k,
+                             const bool within_thres,
+                             Candidates &candidates) const {
+  if (lo >= hi) {
+    return;
+  }
+
+  // node at the split
+  const size_t mid = lo + (hi - lo) / 2;
+  const TrajectoryIndexNode &node = this->tree[mid];
+  const double dz = z - node.z;
+  const double dv = v - node.v;
+  const double dist2 = dz * dz + dv * dv;
+  const bool ok = !within_thres || (fabs(dz) < 1.0 && fabs(dv) < 1.0);
+  if (ok && candidates.size() < k) {
+    candidates.push({dist2, (int) mid});
+  } else if (ok && dist2 < candidates.top().first) {
+    candidates.pop();
+    candidates.push({dist2, (int) mid});
+  }
+
+  // near side first, the far side only if it can hold something nearer
+  const double diff = (axis == 0) ? dz : dv;
+  const size_t near_lo = (diff < 0.0) ? lo : mid + 1;
+  const size_t near_hi = (diff < 0.0) ? mid : hi;
+  const size_t far_lo = (diff < 0.0) ? mid + 1 : lo;
+  const size_t far_hi = (diff < 0.0) ? hi : mid;
+  search(near_lo, near_hi, 1 - axis, z, v, k, within_thres, candidates);
+
+  const bool reachable = !within_thres || fabs(diff) < 1.0;
+  const bool full = candidates.size() >= k;
+  if (reachable && (!full || diff * diff < candidates.top().first)) {
+    search(far_lo, far_hi, 1 - axis, z, v, k, within_thres, candidates);
+  }
+}
 
+TrajectoryMatch TrajectoryIndex::toMatch(const int node,
+                                         const double dist2) const {
+  TrajectoryMatch match;
+  match.row = this->tree[node].row;
+  match.index = (int) this->index_data(match.row, 0);
+  match.z = this->index_data(match.row, 1);
+  match.v = this->index_data(match.row, 2);
+  match.distance = sqrt(dist2);
+  return match;
+}
+
+int TrajectoryIndex::nearest(const double z,
+                             const double v,
+                             TrajectoryMatch &match) const {
   // pre-check
   if (this->loaded == false) {
     return -1;
   }
 
-  // NOTE: the following is not the most efficient way of implementing a
-  // lookup table, a better way could involve a search tree and traverse it
-  // or even a bucket based approach. The following implements a list
-  // traversal type search which is approx O(n), ok for small lookups.
+  // nearest within the thresholds
+  Candidates candidates;
+  const double zn = z / this->pos_thres;
+  const double vn = v / this->vel_thres;
+  this->search(0, this->tree.size(), 0, zn, vn, 1, true, candidates);
+  if (candidates.size() == 0) {
+    return -2;
+  }
+  match = this->toMatch(candidates.top().second, candidates.top().first);
 
-  // find rows in the index that have same approx
-  // start height (z) and velocity (v)
-  for (int i = 0; i < this->index_data.rows(); i++) {
-    p_ok = fabs(pos(2) - this->index_data(i, 1)) < this->pos_thres;
-    v_ok = fabs(v - this->index_data(i, 2)) < this->vel_thres;
+  return 0;
+}
 
-    if (p_ok && v_ok) {
-      matches.push_back(i);
-    }
+int TrajectoryIndex::nearest(const double z,
+                             const double v,
+                             const int k,
+                             std::vector<TrajectoryMatch> &matches) const {
+  // pre-check
+  matches.clear();
+  if (this->loaded == false) {
+    return -1;
+  } else if (k <= 0) {
+    return 0;
+  }
+
+  // k nearest, the queue pops the furthest first
+  Candidates candidates;
+  const double zn = z / this->pos_thres;
+  const double vn = v / this->vel_thres;
+  this->search(0, this->tree.size(), 0, zn, vn, k, false, candidates);
+  matches.resize(candidates.size());
+  for (size_t i = matches.size(); i > 0; i--) {
+    matches[i - 1] =
+        this->toMatch(candidates.top().second, candidates.top().first);
+    candidates.pop();
   }
 
-  // check number of matches
-  if (matches.size() == 0) {
+  return 0;
+}
+
+int TrajectoryIndex::find(const Vec3 &pos,
+                          const double v,
+                          Trajectory &traj,
+                          TrajectoryMatch &match) {
+  // pre-check
+  if (this->loaded == false) {
+    return -1;
+  }
+
+  // find the nearest row in the index with approx the same start height
+  // (z) and velocity (v)
+  if (this->nearest(pos(2), v, match) != 0) {
     return -2; // found no trajectory
   }
 
-  // load trajectory
-  traj_file = this->traj_dir + "/";
-  traj_file += std::to_string((int) matches[0]) + ".csv";
-  if (traj.load(matches[0], traj_file, pos) != 0) {
+  // load trajectory from the library, or else from its file
+  if (this->library.loaded) {
+    int nb_rows = 0;
+    const float *records = this->library.trajectory(match.row, nb_rows);
+    if (traj.load(match.index, records, nb_rows, pos) != 0) {
+      return -3;
+    }
+    return 0;
+  }
+
+  std::string traj_file = this->traj_dir + "/";
+  traj_file += std::to_string(match.index) + ".csv";
+  if (traj.load(match.index, traj_file, pos) != 0) {
     return -3;
   }
 
   return 0;
 }
 
+int TrajectoryIndex::find(const Vec3 &pos, const double v, Trajectory &traj) {
+  TrajectoryMatch match;
+  return this->find(pos, v, traj, match);
+}
+
 } // namespace atl
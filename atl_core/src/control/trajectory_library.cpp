@@ -0,0 +1,171 @@
+#include "atl/control/trajectory_library.hpp"
+
+namespace atl {
+
+int TrajectoryLibrary::open(const std::string &file_path) {
+  // pre-check
+  this->close();
+  const int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    LOG_ERROR("Failed to open trajectory library [%s]!", file_path.c_str());
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    LOG_ERROR("Failed to open trajectory library [%s]!", file_path.c_str());
+    ::close(fd);
+    return -1;
+  }
+
+  // map the whole file and fault it in now rather than on the first lookup,
+  // the mapping stays valid after the file is closed
+  int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+  flags |= MAP_POPULATE;
+#endif
+  const size_t size = (size_t) st.st_size;
+  void *addr = mmap(NULL, size, PROT_READ, flags, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    LOG_ERROR("Failed to map trajectory library [%s]!", file_path.c_str());
+    return -1;
+  }
+  madvise(addr, size, MADV_WILLNEED);
+  this->data = std::shared_ptr<const char>(
+      (const char *) addr, [size](const char *p) { munmap((void *) p, size); });
+  this->size = size;
+
+  // header
+  const size_t header_size = sizeof(TrajectoryLibraryHeader);
+  const size_t entry_size = sizeof(TrajectoryLibraryEntry);
+  const TrajectoryLibraryHeader *header =
+      (const TrajectoryLibraryHeader *) this->data.get();
+  bool ok = size >= header_size;
+  ok = ok && memcmp(header->magic, TRAJ_LIBRARY_MAGIC, 8) == 0;
+  ok = ok && header->version == TRAJ_LIBRARY_VERSION;
+  ok = ok && header->nb_cols == TRAJ_LIBRARY_COLS;
+
+  // index table and records must fit in the file
+  size_t records_start = header_size;
+  if (ok) {
+    records_start += header->nb_trajectories * entry_size;
+    const size_t nb_values = header->nb_rows * header->nb_cols;
+    ok = size >= records_start + nb_values * sizeof(float);
+  }
+
+  const TrajectoryLibraryEntry *entries =
+      (const TrajectoryLibraryEntry *) (this->data.get() + header_size);
+  for (uint32_t i = 0; ok && i < header->nb_trajectories; i++) {
+    ok = entries[i].nb_rows > 0;
+    ok = ok && entries[i].offset + entries[i].nb_rows <= header->nb_rows;
+  }
+  if (ok == false) {
+    LOG_ERROR("Invalid trajectory library [%s]!", file_path.c_str());
+    this->close();
+    return -2;
+  }
+
+  this->file_path = file_path;
+  this->header = header;
+  this->entries = entries;
+  this->records = (const float *) (this->data.get() + records_start);
+  this->loaded = true;
+  return 0;
+}
+
+void TrajectoryLibrary::close() {
+  this->loaded = false;
+  this->file_path = "";
+  this->data.reset();
+  this->size = 0;
+  this->header = nullptr;
+  this->entries = nullptr;
+  this->records = nullptr;
+}
+
+int TrajectoryLibrary::nbTrajectories() const {
+  return (this->loaded) ? (int) this->header->nb_trajectories : 0;
+}
+
+const float *TrajectoryLibrary::trajectory(const int row, int &nb_rows) const {
+  nb_rows = 0;
+  if (this->loaded == false || row < 0 || row >= this->nbTrajectories()) {
+    return nullptr;
+  }
+
+  const TrajectoryLibraryEntry &entry = this->entries[row];
+  nb_rows = (int) entry.nb_rows;
+  return this->records + entry.offset * this->header->nb_cols;
+}
+
+int trajectory_library_create(const std::string &index_file,
+                              const std::string &library_file) {
+  // load trajectory index
+  // assumes each column is: (index, p0_z, v)
+  MatX index_data;
+  if (csv2mat(index_file, true, index_data) != 0) {
+    return -1;
+  } else if (index_data.rows() == 0 || index_data.cols() != 3) {
+    LOG_ERROR("Invalid trajectory index [%s]!", index_file.c_str());
+    return -1;
+  }
+  std::string index_path = index_file;
+  const std::string traj_dir = dirname(&index_path[0]);
+
+  // load trajectories
+  std::vector<TrajectoryLibraryEntry> entries;
+  std::vector<float> records;
+  for (int i = 0; i < index_data.rows(); i++) {
+    const std::string traj_file =
+        traj_dir + "/" + std::to_string((int) index_data(i, 0)) + ".csv";
+    MatX traj_data;
+    if (csv2mat(traj_file, true, traj_data) != 0) {
+      return -2;
+    } else if (traj_data.rows() == 0 || traj_data.cols() != 10) {
+      LOG_ERROR("Invalid trajectory [%s]!", traj_file.c_str());
+      return -2;
+    }
+
+    TrajectoryLibraryEntry entry;
+    entry.index = (int32_t) index_data(i, 0);
+    entry.nb_rows = (uint32_t) traj_data.rows();
+    entry.offset = records.size() / TRAJ_LIBRARY_COLS;
+    entry.z = index_data(i, 1);
+    entry.v = index_data(i, 2);
+    entries.push_back(entry);
+
+    for (int r = 0; r < traj_data.rows(); r++) {
+      for (int c = 0; c < traj_data.cols(); c++) {
+        records.push_back((float) traj_data(r, c));
+      }
+    }
+  }
+
+  // header
+  TrajectoryLibraryHeader header;
+  memcpy(header.magic, TRAJ_LIBRARY_MAGIC, 8);
+  header.nb_trajectories = (uint32_t) entries.size();
+  header.nb_rows = records.size() / TRAJ_LIBRARY_COLS;
+
+  // write trajectory library
+  FILE *file = fopen(library_file.c_str(), "wb");
+  if (file == NULL) {
+    LOG_ERROR("Failed to open [%s]!", library_file.c_str());
+    return -3;
+  }
+  const size_t entry_size = sizeof(TrajectoryLibraryEntry);
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+  ok = ok && fwrite(entries.data(), entry_size, entries.size(), file) ==
+                 entries.size();
+  ok = ok && fwrite(records.data(), sizeof(float), records.size(), file) ==
+                 records.size();
+  ok = (fclose(file) == 0) && ok;
+  if (ok == false) {
+    LOG_ERROR("Failed to write [%s]!", library_file.c_str());
+    return -3;
+  }
+
+  return 0;
+}
+
+} // namespace atl
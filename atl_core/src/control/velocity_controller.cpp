@@ -7,21 +7,10 @@ int VelocityController::configure(const std::string &config_file) {
 
   // load config
   // clang-format off
-  parser.addParam("vx_controller.k_p", &this->vx_controller.k_p);
-  parser.addParam("vx_controller.k_i", &this->vx_controller.k_i);
-  parser.addParam("vx_controller.k_d", &this->vx_controller.k_d);
   parser.addParam("vx_controller.pitch_min", &this->pitch_limit[0]);
   parser.addParam("vx_controller.pitch_max", &this->pitch_limit[1]);
-
-  parser.addParam("vy_controller.k_p", &this->vy_controller.k_p);
-  parser.addParam("vy_controller.k_i", &this->vy_controller.k_i);
-  parser.addParam("vy_controller.k_d", &this->vy_controller.k_d);
   parser.addParam("vy_controller.roll_min", &this->roll_limit[0]);
   parser.addParam("vy_controller.roll_max", &this->roll_limit[1]);
-
-  parser.addParam("vz_controller.k_p", &this->vz_controller.k_p);
-  parser.addParam("vz_controller.k_i", &this->vz_controller.k_i);
-  parser.addParam("vz_controller.k_d", &this->vz_controller.k_d);
   parser.addParam("vz_controller.throttle_min", &this->throttle_limit[0]);
   parser.addParam("vz_controller.throttle_max", &this->throttle_limit[1]);
   // clang-format on
@@ -36,6 +25,14 @@ int VelocityController::configure(const std::string &config_file) {
     return -1;
   }
 
+  // load pid gains
+  const std::vector<std::string> axes = {"vx_controller",
+                                         "vy_controller",
+                                         "vz_controller"};
+  if (this->pid.configure(config_file, axes) != 0) {
+    return -1;
+  }
+
   this->configured = true;
   return 0;
 }
@@ -49,19 +46,25 @@ Vec4 VelocityController::calculate(const Vec3 &setpoints_W,
     return this->outputs;
   }
 
-  // calculate errors
-  const Vec3 errors{setpoints_W(0) - actual_W(0),
-                    setpoints_W(1) - actual_W(1),
-                    setpoints_W(2) - actual_W(2)};
+  // pid outputs, saturation limits stop the integrals winding up
+  // clang-format off
+  this->pid.output_min << this->pitch_limit[0],
+                          -this->roll_limit[1],
+                          this->throttle_limit[0];
+  this->pid.output_max << this->pitch_limit[1],
+                          -this->roll_limit[0],
+                          this->throttle_limit[1];
+  // clang-format on
+  const Vec3 u =
+      this->pid.update(setpoints_W.array(), actual_W.array(), this->dt)
+          .matrix();
 
   // roll, pitch, yaw and throttle (assuming NWU frame)
-  // clang-format off
-  double r = -this->vy_controller.update(errors(1), 0.0, this->dt);
-  double p = this->vx_controller.update(errors(0), 0.0, this->dt);
+  double r = -u(1);
+  double p = u(0);
   double y = 0.0;
-  double t = this->vz_controller.update(errors(2), 0.0, this->dt);
-  t /= fabs(cos(r) * cos(p));  // adjust throttle for roll and pitch
-  // clang-format o
+  double t = u(2);
+  t /= fabs(cos(r) * cos(p)); // adjust throttle for roll and pitch
 
   // limit roll, pitch
   r = (r < this->roll_limit[0]) ? this->roll_limit[0] : r;
@@ -81,11 +84,7 @@ Vec4 VelocityController::calculate(const Vec3 &setpoints_W,
   return outputs;
 }
 
-void VelocityController::reset() {
-  this->vx_controller.reset();
-  this->vy_controller.reset();
-  this->vz_controller.reset();
-}
+void VelocityController::reset() { this->pid.reset(); }
 
 void VelocityController::printOutputs() {
   double r = rad2deg(this->outputs(0));
@@ -98,32 +97,18 @@ void VelocityController::printOutputs() {
 }
 
 void VelocityController::printErrors() {
-  double p = this->vx_controller.error_p;
-  double i = this->vx_controller.error_i;
-  double d = this->vx_controller.error_d;
-
-  std::cout << "x_controller: " << std::endl;
-  std::cout << "\terror_p: " << std::setprecision(2) << p << "\t";
-  std::cout << "\terror_i: " << std::setprecision(2) << i << "\t";
-  std::cout << "\terror_d: " << std::setprecision(2) << d << std::endl;
-
-  p = this->vy_controller.error_p;
-  i = this->vy_controller.error_i;
-  d = this->vy_controller.error_d;
-
-  std::cout << "y_controller: " << std::endl;
-  std::cout << "\terror_p: " << std::setprecision(2) << p << "\t";
-  std::cout << "\terror_i: " << std::setprecision(2) << i << "\t";
-  std::cout << "\terror_d: " << std::setprecision(2) << d << std::endl;
-
-  p = this->vz_controller.error_p;
-  i = this->vz_controller.error_i;
-  d = this->vz_controller.error_d;
-
-  std::cout << "z_controller: " << std::endl;
-  std::cout << "\terror_p: " << std::setprecision(2) << p << "\t";
-  std::cout << "\terror_i: " << std::setprecision(2) << i << "\t";
-  std::cout << "\terror_d: " << std::setprecision(2) << d << std::endl;
+  const std::string axes[3] = {"x_controller", "y_controller", "z_controller"};
+
+  for (int k = 0; k < 3; k++) {
+    const double p = this->pid.error_p(k);
+    const double i = this->pid.error_i(k);
+    const double d = this->pid.error_d(k);
+
+    std::cout << axes[k] << ": " << std::endl;
+    std::cout << "\terror_p: " << std::setprecision(2) << p << "\t";
+    std::cout << "\terror_i: " << std::setprecision(2) << i << "\t";
+    std::cout << "\terror_d: " << std::setprecision(2) << d << std::endl;
+  }
 }
 
 }  // namespace atl
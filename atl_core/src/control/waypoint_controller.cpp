@@ -6,26 +6,26 @@ int WaypointController::configure(const std::string &config_file) {
   ConfigParser parser;
 
   // load config
-  parser.addParam("at_controller.k_p", &this->at_controller.k_p);
-  parser.addParam("at_controller.k_i", &this->at_controller.k_i);
-  parser.addParam("at_controller.k_d", &this->at_controller.k_d);
   parser.addParam("at_controller.min", &this->pitch_limit[0]);
   parser.addParam("at_controller.max", &this->pitch_limit[1]);
-
-  parser.addParam("ct_controller.k_p", &this->ct_controller.k_p);
-  parser.addParam("ct_controller.k_i", &this->ct_controller.k_i);
-  parser.addParam("ct_controller.k_d", &this->ct_controller.k_d);
   parser.addParam("ct_controller.min", &this->roll_limit[0]);
   parser.addParam("ct_controller.max", &this->roll_limit[1]);
-
-  parser.addParam("z_controller.k_p", &this->z_controller.k_p);
-  parser.addParam("z_controller.k_i", &this->z_controller.k_i);
-  parser.addParam("z_controller.k_d", &this->z_controller.k_d);
   parser.addParam("z_controller.hover_throttle", &this->hover_throttle);
+  parser.addParam("blackbox_enable", &this->blackbox_enable, true);
+  parser.addParam("blackbox_rate", &this->blackbox_rate, true);
+  parser.addParam("blackbox_file", &this->blackbox_file, true);
   if (parser.load(config_file) != 0) {
     return -1;
   }
 
+  // load pid gains
+  const std::vector<std::string> axes = {"at_controller",
+                                         "ct_controller",
+                                         "z_controller"};
+  if (this->pid.configure(config_file, axes) != 0) {
+    return -1;
+  }
+
   // convert roll and pitch limits from degrees to radians
   this->roll_limit[0] = deg2rad(this->roll_limit[0]);
   this->roll_limit[1] = deg2rad(this->roll_limit[1]);
@@ -33,7 +33,7 @@ int WaypointController::configure(const std::string &config_file) {
   this->pitch_limit[1] = deg2rad(this->pitch_limit[1]);
 
   // prepare blackbox file
-  std::string blackbox_file = "/tmp/blackbox.dat";
+  const std::string &blackbox_file = this->blackbox_file;
   if (this->blackbox_enable) {
     if (blackbox_file == "") {
       LOG_ERROR("blackbox file is not set!");
@@ -54,45 +54,38 @@ int WaypointController::configure(const std::string &config_file) {
 }
 
 int WaypointController::prepBlackbox(const std::string &blackbox_file) {
-  // setup
-  this->blackbox.open(blackbox_file);
-  if (!this->blackbox) {
+  const std::vector<std::string> fields = {"dt",
+                                           "x",
+                                           "y",
+                                           "z",
+                                           "wp_x",
+                                           "wp_y",
+                                           "wp_z"};
+  if (this->blackbox.configure(blackbox_file, fields) != 0) {
     return -1;
   }
 
-  // write header
-  // clang-format off
-  this->blackbox << "dt" << ",";
-  this->blackbox << "x" << ",";
-  this->blackbox << "y" << ",";
-  this->blackbox << "z" << ",";
-  this->blackbox << "wp_x" << ",";
-  this->blackbox << "wp_y" << ",";
-  this->blackbox << "wp_z";
-  this->blackbox << std::endl;
-  // clang-format on
-
   return 0;
 }
 
 int WaypointController::record(const Vec3 &pos, const Vec3 &waypoint) {
   // pre-check
-  this->blackbox_dt += dt;
-  if (this->blackbox_enable && this->blackbox_dt > this->blackbox_rate) {
+  this->blackbox_dt += this->dt;
+  if (!this->blackbox_enable || this->blackbox_dt < this->blackbox_rate) {
     return 0;
   }
 
   // record
-  this->blackbox << pos(0) << ",";
-  this->blackbox << pos(1) << ",";
-  this->blackbox << pos(2) << ",";
-  this->blackbox << waypoint(0) << ",";
-  this->blackbox << waypoint(1) << ",";
-  this->blackbox << waypoint(2);
-  this->blackbox << std::endl;
+  // clang-format off
+  const double row[] = {
+    this->blackbox_dt,
+    pos(0), pos(1), pos(2),
+    waypoint(0), waypoint(1), waypoint(2)
+  };
+  // clang-format on
   this->blackbox_dt = 0.0;
 
-  return 0;
+  return this->blackbox.record(row);
 }
 
 double WaypointController::calcYawToWaypoint(const Vec3 &waypoint,
@@ -135,20 +128,26 @@ int WaypointController::update(Mission &mission,
   // Calculate velocity relative to quadrotor
   const Vec3 vel_B = T_P_W{pose.orientation} * vel;
 
-  // Roll
-  double r = -this->ct_controller.update(errors(1), this->dt);
-
-  // Pitch
-  double error_forward = mission.desired_velocity - vel_B(0);
-  double p = this->at_controller.update(error_forward, this->dt);
+  // pid outputs, saturation limits stop the integrals winding up
+  // clang-format off
+  const Vec3 pid_errors{mission.desiredVelocity() - vel_B(0),
+                        errors(1),
+                        waypoint(2) - pose.position(2)};
+  this->pid.scheduleGains(pose.position(2));
+  this->pid.output_min << this->pitch_limit[0],
+                          -this->roll_limit[1],
+                          -this->hover_throttle;
+  this->pid.output_max << this->pitch_limit[1],
+                          -this->roll_limit[0],
+                          1.0 - this->hover_throttle;
+  // clang-format on
+  const Vec3 u = this->pid.update(pid_errors.array(), this->dt).matrix();
 
-  // Yaw
+  // Roll, pitch, yaw and throttle
+  double r = -u(1);
+  double p = u(0);
   double y = mission.waypointHeading();
-
-  // Throttle
-  const double error_z = waypoint(2) - pose.position(2);
-  double t = this->hover_throttle;
-  t += this->z_controller.update(error_z, this->dt);
+  double t = this->hover_throttle + u(2);
   t /= fabs(cos(r) * cos(p)); // adjust throttle for roll and pitch
 
   // limit roll, pitch and throttle
@@ -168,11 +167,6 @@ int WaypointController::update(Mission &mission,
   return 0;
 }
 
-void WaypointController::reset() {
-  this->at_controller.reset();
-  this->ct_controller.reset();
-  this->z_controller.reset();
-  this->yaw_controller.reset();
-}
+void WaypointController::reset() { this->pid.reset(); }
 
 } // namespace atl
@@ -3,7 +3,8 @@
 namespace atl {
 
 bool LandingTarget::isTargetLosted() {
-  if (mtoc(&this->last_seen) > lost_threshold) {
+  if (this->last_seen < 0.0 ||
+      (this->clock() - this->last_seen) * 1000.0 > lost_threshold) {
     this->reset();
     return true;
   }
@@ -19,28 +20,34 @@ void LandingTarget::setTargetVelocity(Vec3 velocity) {
   this->velocity_B = velocity;
 }
 
-double LandingTarget::tracked() { return mtoc(&this->first_seen); }
+double LandingTarget::tracked() {
+  if (this->first_seen < 0.0) {
+    return 0.0;
+  }
+
+  return (this->clock() - this->first_seen) * 1000.0;
+}
 
 void LandingTarget::reset() {
   this->position_B << 0.0, 0.0, 0.0;
   this->velocity_B << 0.0, 0.0, 0.0;
   this->detected = false;
   this->losted = true;
-  this->first_seen = (struct timespec){0, 0};
-  this->last_seen = (struct timespec){0, 0};
+  this->first_seen = -1.0;
+  this->last_seen = -1.0;
 }
 
 void LandingTarget::update(bool detected) {
   // initialize target first seen
-  if (this->first_seen.tv_sec == 0) {
-    tic(&this->first_seen);
+  if (this->first_seen < 0.0) {
+    this->first_seen = this->clock();
   }
 
   // update target last seen
   this->detected = detected;
   if (detected) {
     this->losted = false;
-    tic(&this->last_seen);
+    this->last_seen = this->clock();
   }
 
   // target losted?
@@ -85,7 +85,9 @@ int EKFTracker::measurementUpdate(const VecX &h, const MatX &H, const VecX &y) {
   return 0;
 }
 
-void two_wheel_process_model(EKFTracker &ekf, MatX &G, VecX &g, double dt) {
+void two_wheel_process_model(const Eigen::Ref<const VecX> &x,
+                             const double dt,
+                             Eigen::Ref<VecX> g) {
   // x0 - x
   // x1 - y
   // x2 - z
@@ -95,22 +97,23 @@ void two_wheel_process_model(EKFTracker &ekf, MatX &G, VecX &g, double dt) {
   // x6 - omega
   // x7 - a
   // x8 - az
+  g(0) = x(0) + x(4) * cos(x(3)) * dt;
+  g(1) = x(1) + x(4) * sin(x(3)) * dt;
+  g(2) = x(2) + x(5) * dt;
+  g(3) = x(3) + x(6) * dt;
+  g(4) = x(4) + x(7) * dt;
+  g(5) = x(5) + x(8) * dt;
+  g(6) = x(6);
+  g(7) = x(7);
+  g(8) = x(8);
+}
 
-  // g - proces model
-  g(0) = ekf.mu(0) + ekf.mu(4) * cos(ekf.mu(3)) * dt;
-  g(1) = ekf.mu(1) + ekf.mu(4) * sin(ekf.mu(3)) * dt;
-  g(2) = ekf.mu(2) + ekf.mu(5) * dt;
-  g(3) = ekf.mu(3) + ekf.mu(6) * dt;
-  g(4) = ekf.mu(4) + ekf.mu(7) * dt;
-  g(5) = ekf.mu(5) + ekf.mu(8) * dt;
-  g(6) = ekf.mu(6);
-  g(7) = ekf.mu(7);
-  g(8) = ekf.mu(8);
-
-  // G - linearized process model
+void two_wheel_process_jacobian(const Eigen::Ref<const VecX> &x,
+                                const double dt,
+                                Eigen::Ref<MatX> G) {
   // clang-format off
-  G << 1, 0, 0, -dt * ekf.mu(4) * sin(ekf.mu(3)), dt * cos(ekf.mu(3)), 0,  0,  0,  0,
-       0, 1, 0, dt * ekf.mu(4) * cos(ekf.mu(3)), dt * sin(ekf.mu(3)), 0,  0,  0,  0,
+  G << 1, 0, 0, -dt * x(4) * sin(x(3)), dt * cos(x(3)), 0,  0,  0,  0,
+       0, 1, 0, dt * x(4) * cos(x(3)), dt * sin(x(3)), 0,  0,  0,  0,
        0, 0, 1, 0, 0, dt, 0, 0, 0,
        0, 0, 0, 1, 0, 0, dt, 0, 0,
        0, 0, 0, 0, 1, 0, 0, dt, 0,
@@ -121,12 +124,25 @@ void two_wheel_process_model(EKFTracker &ekf, MatX &G, VecX &g, double dt) {
   // clang-format on
 }
 
+void two_wheel_process_model(EKFTracker &ekf, MatX &G, VecX &g, double dt) {
+  two_wheel_process_model(ekf.mu, dt, g);
+  two_wheel_process_jacobian(ekf.mu, dt, G);
+}
+
+void two_wheel_measurement_model(const Eigen::Ref<const VecX> &x,
+                                 Eigen::Ref<VecX> h) {
+  h(0) = x(0); // x
+  h(1) = x(1); // y
+  h(2) = x(2); // z
+  h(3) = x(3); // theta
+}
+
 void two_wheel_measurement_model(EKFTracker &ekf, MatX &H, VecX &h) {
   H(0, 0) = 1.0; // x
   H(1, 1) = 1.0; // y
   H(2, 2) = 1.0; // z
   H(3, 3) = 1.0; // theta
-  h = H * ekf.mu_p;
+  two_wheel_measurement_model(ekf.mu_p, h);
 }
 
 } // namespace atl
@@ -0,0 +1,211 @@
+#include "atl/estimation/inertial_filter.hpp"
+
+namespace atl {
+
+int InertialFilter::configure(const std::string &config_file) {
+  ConfigParser parser;
+
+  // parse and load config file
+  parser.addParam("accel_noise", &this->accel_noise);
+  parser.addParam("gyro_noise", &this->gyro_noise);
+  parser.addParam("accel_bias_noise", &this->accel_bias_noise);
+  parser.addParam("gyro_bias_noise", &this->gyro_bias_noise);
+  parser.addParam("position_noise", &this->position_noise);
+  parser.addParam("velocity_noise", &this->velocity_noise);
+  parser.addParam("attitude_noise", &this->attitude_noise);
+  parser.addParam("init_position_std", &this->init_position_std, true);
+  parser.addParam("init_velocity_std", &this->init_velocity_std, true);
+  parser.addParam("init_attitude_std", &this->init_attitude_std, true);
+  parser.addParam("init_accel_bias_std", &this->init_accel_bias_std, true);
+  parser.addParam("init_gyro_bias_std", &this->init_gyro_bias_std, true);
+  parser.addParam("max_dt", &this->max_dt, true);
+  parser.addParam("max_latency", &this->max_latency, true);
+  parser.addParam("gravity", &this->gravity, true);
+  this->config_file = config_file;
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  this->configured = true;
+  return 0;
+}
+
+int InertialFilter::initialize(const double t,
+                               const Vec3 &position,
+                               const Vec3 &velocity,
+                               const Quaternion &orientation) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  // nominal state
+  this->t = t;
+  this->position = position;
+  this->velocity = velocity;
+  this->orientation = orientation.normalized();
+  this->accel_bias = Vec3::Zero();
+  this->gyro_bias = Vec3::Zero();
+
+  // error state covariance
+  ErrorVec std_dev;
+  std_dev.segment<3>(0).fill(this->init_position_std);
+  std_dev.segment<3>(3).fill(this->init_velocity_std);
+  std_dev.segment<3>(6).fill(this->init_attitude_std);
+  std_dev.segment<3>(9).fill(this->init_accel_bias_std);
+  std_dev.segment<3>(12).fill(this->init_gyro_bias_std);
+  this->P = std_dev.array().square().matrix().asDiagonal();
+
+  this->imu_received = false;
+  this->initialized = true;
+  return 0;
+}
+
+void InertialFilter::integrate(const IMUSample &imu, const double dt) {
+  const Mat3 R = this->orientation.toRotationMatrix();
+  const Vec3 a = imu.accel - this->accel_bias;
+  const Vec3 w = imu.gyro - this->gyro_bias;
+  const Quaternion dq = rvec2quat(w * dt);
+
+  // nominal state
+  const Vec3 acc = R * a + this->gravity;
+  this->position += this->velocity * dt + 0.5 * acc * dt * dt;
+  this->velocity += acc * dt;
+  this->orientation = (this->orientation * dq).normalized();
+
+  // error state transition
+  ErrorMat F = ErrorMat::Identity();
+  F.block<3, 3>(0, 3) = Mat3::Identity() * dt;
+  F.block<3, 3>(3, 6) = -R * skew(a) * dt;
+  F.block<3, 3>(3, 9) = -R * dt;
+  F.block<3, 3>(6, 6) = dq.toRotationMatrix().transpose();
+  F.block<3, 3>(6, 12) = -Mat3::Identity() * dt;
+
+  // process noise
+  ErrorVec q = ErrorVec::Zero();
+  q.segment<3>(3).fill(pow(this->accel_noise, 2) * dt);
+  q.segment<3>(6).fill(pow(this->gyro_noise, 2) * dt);
+  q.segment<3>(9).fill(pow(this->accel_bias_noise, 2) * dt);
+  q.segment<3>(12).fill(pow(this->gyro_bias_noise, 2) * dt);
+
+  // error covariance
+  this->P = F * this->P * F.transpose();
+  this->P.diagonal() += q;
+  this->P = 0.5 * (this->P + this->P.transpose()).eval();
+
+  this->t += dt;
+}
+
+int InertialFilter::propagate(const IMUSample &imu) {
+  // pre-check
+  if (this->initialized == false) {
+    return -1;
+  } else if (imu.t <= this->t) {
+    return -2;
+  }
+
+  // restart integration after a gap in the IMU stream
+  const double dt = imu.t - this->t;
+  this->imu_last = imu;
+  this->imu_received = true;
+  if (dt > this->max_dt) {
+    this->t = imu.t;
+    return -3;
+  }
+
+  // propagate
+  this->integrate(imu, dt);
+  this->t = imu.t;
+
+  return 0;
+}
+
+int InertialFilter::catchUp(const double t) {
+  // pre-check
+  if (this->initialized == false) {
+    return -1;
+  } else if (t < (this->t - this->max_latency)) {
+    return -2;
+  }
+
+  // hold last IMU sample up to the time of measurement
+  const double dt = t - this->t;
+  if (this->imu_received && dt > 0.0 && dt <= this->max_dt) {
+    this->integrate(this->imu_last, dt);
+    this->t = t;
+  }
+
+  return 0;
+}
+
+void InertialFilter::correct(const MeasurementMat &H,
+                             const Vec3 &r,
+                             const Vec3 &noise) {
+  const Mat3 V = noise.array().square().matrix().asDiagonal();
+
+  // kalman gain
+  const Mat3 S = H * this->P * H.transpose() + V;
+  const GainMat K = this->P * H.transpose() * S.inverse();
+  const ErrorVec dx = K * r;
+
+  // covariance update, Joseph form to keep P symmetric positive definite
+  const ErrorMat I_KH = ErrorMat::Identity() - K * H;
+  this->P = I_KH * this->P * I_KH.transpose() + K * V * K.transpose();
+
+  // inject error state into nominal state
+  this->position += dx.segment<3>(0);
+  this->velocity += dx.segment<3>(3);
+  this->orientation = this->orientation * rvec2quat(dx.segment<3>(6));
+  this->orientation.normalize();
+  this->accel_bias += dx.segment<3>(9);
+  this->gyro_bias += dx.segment<3>(12);
+}
+
+int InertialFilter::correctPosition(const double t, const Vec3 &position) {
+  const int retval = this->catchUp(t);
+  if (retval != 0) {
+    return retval;
+  }
+
+  MeasurementMat H = MeasurementMat::Zero();
+  H.block<3, 3>(0, 0) = Mat3::Identity();
+  this->correct(H, position - this->position, this->position_noise);
+
+  return 0;
+}
+
+int InertialFilter::correctVelocity(const double t, const Vec3 &velocity) {
+  const int retval = this->catchUp(t);
+  if (retval != 0) {
+    return retval;
+  }
+
+  MeasurementMat H = MeasurementMat::Zero();
+  H.block<3, 3>(0, 3) = Mat3::Identity();
+  this->correct(H, velocity - this->velocity, this->velocity_noise);
+
+  return 0;
+}
+
+int InertialFilter::correctAttitude(const double t,
+                                    const Quaternion &orientation) {
+  const int retval = this->catchUp(t);
+  if (retval != 0) {
+    return retval;
+  }
+
+  // attitude residual as a rotation vector in the body frame
+  Quaternion dq = this->orientation.conjugate() * orientation.normalized();
+  if (dq.w() < 0.0) {
+    dq.coeffs() *= -1.0;
+  }
+  const Eigen::AngleAxisd aa{dq};
+
+  MeasurementMat H = MeasurementMat::Zero();
+  H.block<3, 3>(0, 6) = Mat3::Identity();
+  this->correct(H, aa.angle() * aa.axis(), this->attitude_noise);
+
+  return 0;
+}
+
+} // namespace atl
@@ -0,0 +1,149 @@
+#include "atl/estimation/inertial_replay.hpp"
+
+namespace atl {
+
+int InertialReplay::load(const std::string &data_dir) {
+  std::string path;
+
+  // imu
+  paths_combine(data_dir, "imu.csv", path);
+  if (csv2mat(path, true, this->imu) != 0) {
+    LOG_ERROR("Failed to load IMU data [%s]!", path.c_str());
+    return -1;
+  }
+
+  // gps, velocity and attitude are optional
+  paths_combine(data_dir, "gps.csv", path);
+  if (file_exists(path) && csv2mat(path, true, this->gps) != 0) {
+    return -1;
+  }
+  paths_combine(data_dir, "velocity.csv", path);
+  if (file_exists(path) && csv2mat(path, true, this->velocity) != 0) {
+    return -1;
+  }
+  paths_combine(data_dir, "attitude.csv", path);
+  if (file_exists(path) && csv2mat(path, true, this->attitude) != 0) {
+    return -1;
+  }
+
+  return 0;
+}
+
+int InertialReplay::run(InertialFilter &filter) {
+  const double inf = std::numeric_limits<double>::infinity();
+  const int nb_imu = this->imu.rows();
+  const int nb_gps = this->gps.rows();
+  const int nb_velocity = this->velocity.rows();
+  const int nb_attitude = this->attitude.rows();
+  int i_imu = 0, i_gps = 0, i_velocity = 0, i_attitude = 0;
+  int nb_estimates = 0;
+  struct timespec wall_start;
+
+  // pre-check
+  if (filter.configured == false) {
+    return -1;
+  } else if (nb_imu == 0) {
+    return -2;
+  }
+
+  // setup
+  this->estimates.resize(nb_imu, 17);
+  this->nb_rejected = 0;
+  const double t0 = this->imu(0, 0);
+  tic(&wall_start);
+
+  while (true) {
+    // next event in time, IMU first on ties
+    const double t_imu = (i_imu < nb_imu) ? this->imu(i_imu, 0) : inf;
+    const double t_gps = (i_gps < nb_gps) ? this->gps(i_gps, 0) : inf;
+    const double t_vel =
+        (i_velocity < nb_velocity) ? this->velocity(i_velocity, 0) : inf;
+    const double t_att =
+        (i_attitude < nb_attitude) ? this->attitude(i_attitude, 0) : inf;
+    const double t = std::min(std::min(t_imu, t_gps), std::min(t_vel, t_att));
+    if (t == inf) {
+      break;
+    }
+
+    // pace replay
+    if (this->speed > 0.0) {
+      const double t_wall = (t - t0) / this->speed - toc(&wall_start);
+      if (t_wall > 0.0) {
+        struct timespec ts;
+        ts.tv_sec = (time_t) t_wall;
+        ts.tv_nsec = (long) ((t_wall - ts.tv_sec) * 1e9);
+        nanosleep(&ts, NULL);
+      }
+    }
+
+    // initialize filter from first GPS and attitude
+    if (filter.initialized == false && i_gps > 0 && i_attitude > 0) {
+      const MatX &q = this->attitude;
+      const Vec3 pos = this->gps.block(i_gps - 1, 1, 1, 3).transpose();
+      Vec3 vel{0.0, 0.0, 0.0};
+      if (i_velocity > 0) {
+        vel = this->velocity.block(i_velocity - 1, 1, 1, 3).transpose();
+      }
+      const Quaternion rot{q(i_attitude - 1, 1),
+                           q(i_attitude - 1, 2),
+                           q(i_attitude - 1, 3),
+                           q(i_attitude - 1, 4)};
+      const double t_pos = this->gps(i_gps - 1, 0);
+      const double t_rot = q(i_attitude - 1, 0);
+      filter.initialize(std::max(t_pos, t_rot), pos, vel, rot);
+    }
+
+    // feed event to filter
+    int retval = 0;
+    if (t == t_imu) {
+      const IMUSample sample{t,
+                             this->imu.block(i_imu, 1, 1, 3).transpose(),
+                             this->imu.block(i_imu, 4, 1, 3).transpose()};
+      retval = filter.propagate(sample);
+      i_imu++;
+
+      // record estimate
+      if (filter.initialized) {
+        const Quaternion &q = filter.orientation;
+        this->estimates.row(nb_estimates) << filter.t,
+            filter.position.transpose(), filter.velocity.transpose(), q.w(),
+            q.x(), q.y(), q.z(), filter.accel_bias.transpose(),
+            filter.gyro_bias.transpose();
+        nb_estimates++;
+      }
+
+    } else if (t == t_gps) {
+      const Vec3 pos = this->gps.block(i_gps, 1, 1, 3).transpose();
+      retval = filter.correctPosition(t, pos);
+      i_gps++;
+
+    } else if (t == t_vel) {
+      const Vec3 vel = this->velocity.block(i_velocity, 1, 1, 3).transpose();
+      retval = filter.correctVelocity(t, vel);
+      i_velocity++;
+
+    } else {
+      const MatX &q = this->attitude;
+      const Quaternion rot{q(i_attitude, 1),
+                           q(i_attitude, 2),
+                           q(i_attitude, 3),
+                           q(i_attitude, 4)};
+      retval = filter.correctAttitude(t, rot);
+      i_attitude++;
+    }
+
+    // not initialized (-1) is expected until the first GPS and attitude
+    if (retval < -1) {
+      this->nb_rejected++;
+    }
+  }
+  this->estimates.conservativeResize(nb_estimates, 17);
+
+  return 0;
+}
+
+int InertialReplay::save(const std::string &output_path) {
+  return mat2csv(output_path, this->estimates);
+}
+
+} // namespace atl
@@ -12,6 +12,21 @@ KFTracker::KFTracker() {
   this->sanity_dist = FLT_MAX;
   this->config_file = "";
 
+  this->gate_threshold = FLT_MAX;
+  this->max_rejected = INT_MAX;
+  this->nb_rejected = 0;
+  this->nis = 0.0;
+
+  this->noise_scaling = false;
+  this->ref_range = 0.0;
+  this->ref_decision_margin = 0.0;
+  this->ref_area = 0.0;
+  this->min_noise_scale = 0.1;
+  this->max_noise_scale = 100.0;
+
+  this->adaptive_noise = false;
+  this->adaptive_alpha = 0.3;
+
   this->mu = VecX::Zero(1);
 
   this->B = MatX::Zero(1, 1);
@@ -39,6 +54,16 @@ int KFTracker::configure(std::string config_file) {
   parser.addParam("motion_noise_matrix", &this->R);
   parser.addParam("measurement_matrix", &this->C);
   parser.addParam("measurement_noise_matrix", &this->Q);
+  parser.addParam("gate_threshold", &this->gate_threshold, true);
+  parser.addParam("max_rejected", &this->max_rejected, true);
+  parser.addParam("noise_scaling", &this->noise_scaling, true);
+  parser.addParam("ref_range", &this->ref_range, true);
+  parser.addParam("ref_decision_margin", &this->ref_decision_margin, true);
+  parser.addParam("ref_area", &this->ref_area, true);
+  parser.addParam("min_noise_scale", &this->min_noise_scale, true);
+  parser.addParam("max_noise_scale", &this->max_noise_scale, true);
+  parser.addParam("adaptive_noise", &this->adaptive_noise, true);
+  parser.addParam("adaptive_alpha", &this->adaptive_alpha, true);
   this->config_file = config_file;
   if (parser.load(config_file) != 0) {
     return -1;
@@ -70,6 +95,9 @@ int KFTracker::initialize(VecX mu) {
   this->mu_p = VecX::Zero(this->nb_states);
   this->S_p = MatX::Zero(this->nb_states, this->nb_states);
 
+  this->nb_rejected = 0;
+  this->nis = 0.0;
+
   // check
   if (this->checkDimensions() != 0) {
     return -2;
@@ -152,7 +180,52 @@ int KFTracker::sanityCheck(Vec3 prev_pos, Vec3 curr_pos) {
   return 0;
 }
 
-int KFTracker::estimate(MatX A, VecX y) {
+double KFTracker::noiseScale(const TagPose &tag) {
+  double scale = 1.0;
+
+  // pre-check
+  if (this->noise_scaling == false) {
+    return 1.0;
+  }
+
+  // pose error of a tag grows with the square of its range
+  const double range = tag.range();
+  if (this->ref_range > 0.0 && range > 0.0) {
+    scale *= pow(range / this->ref_range, 2);
+  }
+
+  // and shrinks with how confidently and how large it was detected
+  if (this->ref_decision_margin > 0.0 && tag.decision_margin > 0.0) {
+    scale *= this->ref_decision_margin / tag.decision_margin;
+  }
+  if (this->ref_area > 0.0 && tag.area > 0.0) {
+    scale *= this->ref_area / tag.area;
+  }
+
+  scale = std::max(scale, this->min_noise_scale);
+  scale = std::min(scale, this->max_noise_scale);
+  return scale;
+}
+
+int KFTracker::predict(MatX A) {
+  // pre-check
+  if (this->initialized == false) {
+    return -1;
+  } else if (A.rows() != this->nb_states || A.cols() != this->nb_states) {
+    LOG_ERROR(EASIZE, this->nb_states);
+    return -2;
+  }
+
+  // prediction update
+  mu_p = A * mu;
+  S_p = A * S * A.transpose() + R;
+  mu = mu_p;
+  S = S_p;
+
+  return 0;
+}
+
+int KFTracker::estimate(MatX A, VecX y, const double noise_scale) {
   // pre-check
   if (this->initialized == false) {
     return -1;
@@ -164,16 +237,52 @@ int KFTracker::estimate(MatX A, VecX y) {
     return -2;
   }
 
+  // no measurement, predict only without gating or adapting the noise
+  if (C.isZero()) {
+    return this->predict(A);
+  }
+
   // prediction update
   mu_p = A * mu;
   S_p = A * S * A.transpose() + R;
 
+  // innovation gating
+  const VecX innovation = y - C * mu_p;
+  const MatX S_y = C * S_p * C.transpose() + noise_scale * Q;
+  const Eigen::LDLT<MatX> S_y_ldlt = S_y.ldlt();
+  this->nis = innovation.dot(S_y_ldlt.solve(innovation));
+  if (this->nis > this->gate_threshold) {
+    mu = mu_p;
+    S = S_p;
+    this->nb_rejected++;
+    return (this->nb_rejected > this->max_rejected) ? -4 : -3;
+  }
+  this->nb_rejected = 0;
+
   // measurement update
-  K = S_p * C.transpose() * (C * S_p * C.transpose() + Q).inverse();
-  mu = mu_p + K * (y - C * mu_p);
+  K = S_y_ldlt.solve(C * S_p.transpose()).transpose();
+  mu = mu_p + K * innovation;
   S = (I - K * C) * S_p;
 
+  // adapt noise to the residual and innovation
+  if (this->adaptive_noise) {
+    const double a = this->adaptive_alpha;
+    const VecX residual = y - C * mu;
+    const MatX Q_k = residual * residual.transpose() + C * S * C.transpose();
+    const VecX dx = K * innovation;
+    Q = (1.0 - a) * Q + a * Q_k / noise_scale;
+    R = (1.0 - a) * R + a * dx * dx.transpose();
+  }
+
   return 0;
 }
 
+int KFTracker::estimate(MatX A, const TagPose &tag) {
+  if (tag.detected == false) {
+    return this->predict(A);
+  }
+
+  return this->estimate(A, tag.position, this->noiseScale(tag));
+}
+
 } // namespace atl
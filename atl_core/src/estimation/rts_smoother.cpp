@@ -0,0 +1,214 @@
+#include "atl/estimation/rts_smoother.hpp"
+
+namespace atl {
+
+typedef Eigen::Map<VecX> VecMap;
+typedef Eigen::Map<MatX> MatMap;
+typedef Eigen::Map<const VecX> ConstVecMap;
+typedef Eigen::Map<const MatX> ConstMatMap;
+
+/**
+ * Smoother gain G = S_k * A_k+1' * inv(S_p_k+1), solved with a Cholesky
+ * decomposition of the predicted covariance rather than inverting it
+ */
+static int rts_gain(const RTSSmoother &rts,
+                    const int k,
+                    Eigen::LLT<MatX> &llt,
+                    MatX &AS,
+                    MatX &G) {
+  const int n = rts.nb_states;
+  const int nn = n * n;
+  const ConstMatMap A1(rts.A.data() + (k + 1) * nn, n, n);
+  const ConstMatMap S_p1(rts.S_p.data() + (k + 1) * nn, n, n);
+  const ConstMatMap S_k(rts.S.data() + k * nn, n, n);
+
+  llt.compute(S_p1);
+  if (llt.info() != Eigen::Success) {
+    return -1;
+  }
+  AS.noalias() = A1 * S_k;
+  G = llt.solve(AS).transpose();
+
+  return 0;
+}
+
+void RTSSmoother::reserve(const int nb_states, const int nb_steps) {
+  const int n = nb_states;
+  const int nn = n * n;
+
+  this->A.reserve(nn * nb_steps);
+  this->mu_p.reserve(n * nb_steps);
+  this->S_p.reserve(nn * nb_steps);
+  this->mu.reserve(n * nb_steps);
+  this->S.reserve(nn * nb_steps);
+}
+
+void RTSSmoother::clear() {
+  this->nb_states = 0;
+  this->nb_steps = 0;
+
+  this->A.clear();
+  this->mu_p.clear();
+  this->S_p.clear();
+  this->mu.clear();
+  this->S.clear();
+
+  this->mu_s.clear();
+  this->S_s.clear();
+}
+
+int RTSSmoother::record(const KF &kf, const MatX &A) {
+  // pre-check
+  if (kf.initialized == false) {
+    return -1;
+  } else if (this->nb_steps == 0) {
+    this->nb_states = kf.mu.size();
+  } else if (this->nb_states != kf.mu.size()) {
+    return -2;
+  }
+
+  // record
+  const int n = this->nb_states;
+  const int nn = n * n;
+  this->A.insert(this->A.end(), A.data(), A.data() + nn);
+  this->mu_p.insert(this->mu_p.end(), kf.mu_p.data(), kf.mu_p.data() + n);
+  this->S_p.insert(this->S_p.end(), kf.S_p.data(), kf.S_p.data() + nn);
+  this->mu.insert(this->mu.end(), kf.mu.data(), kf.mu.data() + n);
+  this->S.insert(this->S.end(), kf.S.data(), kf.S.data() + nn);
+  this->nb_steps++;
+
+  return 0;
+}
+
+int RTSSmoother::smooth() {
+  // pre-check
+  if (this->nb_steps == 0) {
+    return -1;
+  }
+
+  // setup
+  const int n = this->nb_states;
+  const int nn = n * n;
+  Eigen::LLT<MatX> llt(n);
+  MatX AS(n, n), G(n, n), GdS(n, n);
+
+  // last smoothed estimate is the last filtered estimate
+  this->mu_s = this->mu;
+  this->S_s = this->S;
+
+  // backward pass
+  for (int k = this->nb_steps - 2; k >= 0; k--) {
+    if (rts_gain(*this, k, llt, AS, G) != 0) {
+      return -2;
+    }
+
+    const ConstVecMap mu_p1(this->mu_p.data() + (k + 1) * n, n);
+    const ConstMatMap S_p1(this->S_p.data() + (k + 1) * nn, n, n);
+    const ConstVecMap mu_s1(this->mu_s.data() + (k + 1) * n, n);
+    const ConstMatMap S_s1(this->S_s.data() + (k + 1) * nn, n, n);
+    VecMap mu_sk(this->mu_s.data() + k * n, n);
+    MatMap S_sk(this->S_s.data() + k * nn, n, n);
+
+    mu_sk.noalias() += G * (mu_s1 - mu_p1);
+    GdS.noalias() = G * (S_s1 - S_p1);
+    S_sk.noalias() += GdS * G.transpose();
+  }
+
+  return 0;
+}
+
+int RTSSmoother::smoothFixedLag(const int lag) {
+  // pre-check
+  if (this->nb_steps == 0) {
+    return -1;
+  }
+
+  // setup
+  const int n = this->nb_states;
+  const int nn = n * n;
+  Eigen::LLT<MatX> llt(n);
+  MatX AS(n, n), G(n, n);
+  VecX m(n);
+
+  // gains only depend on the forward pass, compute them once
+  std::vector<double> gains((this->nb_steps - 1) * nn);
+  for (int k = 0; k < this->nb_steps - 1; k++) {
+    if (rts_gain(*this, k, llt, AS, G) != 0) {
+      return -2;
+    }
+    std::copy(G.data(), G.data() + nn, gains.data() + k * nn);
+  }
+
+  // backward pass over the lag window of every step
+  this->mu_s.resize(this->nb_steps * n);
+  this->S_s.clear();
+  for (int k = 0; k < this->nb_steps; k++) {
+    const int end = std::min(k + lag, this->nb_steps - 1);
+    m = ConstVecMap(this->mu.data() + end * n, n);
+
+    for (int j = end - 1; j >= k; j--) {
+      const ConstMatMap G_j(gains.data() + j * nn, n, n);
+      const ConstVecMap mu_j(this->mu.data() + j * n, n);
+      const ConstVecMap mu_p1(this->mu_p.data() + (j + 1) * n, n);
+      m = mu_j + G_j * (m - mu_p1);
+    }
+
+    VecMap(this->mu_s.data() + k * n, n) = m;
+  }
+
+  return 0;
+}
+
+VecX RTSSmoother::filteredState(const int k) const {
+  const int n = this->nb_states;
+  return ConstVecMap(this->mu.data() + k * n, n);
+}
+
+VecX RTSSmoother::smoothedState(const int k) const {
+  const int n = this->nb_states;
+  return ConstVecMap(this->mu_s.data() + k * n, n);
+}
+
+MatX RTSSmoother::smoothedCovariance(const int k) const {
+  const int n = this->nb_states;
+  return ConstMatMap(this->S_s.data() + k * n * n, n, n);
+}
+
+int smooth_flights(
+    std::vector<RTSSmoother> &flights,
+    const int nb_threads,
+    const std::function<int(const int, RTSSmoother &)> &forward) {
+  std::atomic<int> next_flight{0};
+  std::atomic<int> nb_failed{0};
+  const int nb_flights = flights.size();
+
+  // worker takes the next unprocessed flight until none are left
+  auto worker = [&]() {
+    while (true) {
+      const int i = next_flight++;
+      if (i >= nb_flights) {
+        return;
+      }
+
+      if (forward && forward(i, flights[i]) != 0) {
+        nb_failed++;
+      } else if (flights[i].smooth() != 0) {
+        nb_failed++;
+      }
+    }
+  };
+
+  // run workers, the calling thread is one of them
+  std::vector<std::thread> threads;
+  for (int i = 1; i < std::min(nb_threads, nb_flights); i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  return nb_failed;
+}
+
+} // namespace atl
@@ -0,0 +1,300 @@
+#include "atl/estimation/tracker_bank.hpp"
+
+namespace atl {
+
+int TrackerBank::configure(const std::string &config_file) {
+  ConfigParser parser;
+
+  // parse and load config file
+  parser.addParam("max_tracks", &this->max_tracks);
+  parser.addParam("gate_threshold", &this->gate_threshold);
+  parser.addParam("track_timeout", &this->track_timeout);
+  parser.addParam("motion_noise", &this->motion_noise);
+  parser.addParam("measurement_noise", &this->measurement_noise);
+  this->config_file = config_file;
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // allocate track storage up front
+  this->track_id.assign(this->max_tracks, -1);
+  this->tag_id.assign(this->max_tracks, -1);
+  this->nb_updates.assign(this->max_tracks, 0);
+  this->last_updated.assign(this->max_tracks, 0.0);
+  for (int i = 0; i < 3; i++) {
+    this->pos[i].assign(this->max_tracks, 0.0);
+    this->vel[i].assign(this->max_tracks, 0.0);
+    this->acc[i].assign(this->max_tracks, 0.0);
+    this->S_pp[i].assign(this->max_tracks, 0.0);
+    this->S_pv[i].assign(this->max_tracks, 0.0);
+    this->S_pa[i].assign(this->max_tracks, 0.0);
+    this->S_vv[i].assign(this->max_tracks, 0.0);
+    this->S_va[i].assign(this->max_tracks, 0.0);
+    this->S_aa[i].assign(this->max_tracks, 0.0);
+  }
+  this->nb_tracks = 0;
+
+  this->configured = true;
+  return 0;
+}
+
+void TrackerBank::clear() { this->nb_tracks = 0; }
+
+int TrackerBank::findTag(const int tag_id) const {
+  for (int i = 0; i < this->nb_tracks; i++) {
+    if (this->tag_id[i] == tag_id) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+int TrackerBank::spawnTrack(const TagPose &tag, const double t) {
+  // pre-check
+  if (this->nb_tracks >= this->max_tracks) {
+    return -1;
+  }
+
+  // initialize track at measured position, same as KFTracker::initialize()
+  const int k = this->nb_tracks++;
+  this->track_id[k] = this->next_track_id++;
+  this->tag_id[k] = tag.id;
+  this->nb_updates[k] = 1;
+  this->last_updated[k] = t;
+  for (int i = 0; i < 3; i++) {
+    this->pos[i][k] = tag.position(i);
+    this->vel[i][k] = 0.0;
+    this->acc[i][k] = 0.0;
+    this->S_pp[i][k] = 1.0;
+    this->S_pv[i][k] = 0.0;
+    this->S_pa[i][k] = 0.0;
+    this->S_vv[i][k] = 1.0;
+    this->S_va[i][k] = 0.0;
+    this->S_aa[i][k] = 1.0;
+  }
+
+  return k;
+}
+
+void TrackerBank::retireTrack(const int index) {
+  const int last = --this->nb_tracks;
+  if (index == last) {
+    return;
+  }
+
+  // move last track into the retired slot to keep tracks contiguous
+  this->track_id[index] = this->track_id[last];
+  this->tag_id[index] = this->tag_id[last];
+  this->nb_updates[index] = this->nb_updates[last];
+  this->last_updated[index] = this->last_updated[last];
+  for (int i = 0; i < 3; i++) {
+    this->pos[i][index] = this->pos[i][last];
+    this->vel[i][index] = this->vel[i][last];
+    this->acc[i][index] = this->acc[i][last];
+    this->S_pp[i][index] = this->S_pp[i][last];
+    this->S_pv[i][index] = this->S_pv[i][last];
+    this->S_pa[i][index] = this->S_pa[i][last];
+    this->S_vv[i][index] = this->S_vv[i][last];
+    this->S_va[i][index] = this->S_va[i][last];
+    this->S_aa[i][index] = this->S_aa[i][last];
+  }
+}
+
+int TrackerBank::predict(const double dt) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  // A = [1, dt, dt^2 / 2; 0, 1, dt; 0, 0, 1] per axis
+  const double h = 0.5 * dt * dt;
+  const double r_p = this->motion_noise(0);
+  const double r_v = this->motion_noise(1);
+  const double r_a = this->motion_noise(2);
+  const int n = this->nb_tracks;
+
+  for (int i = 0; i < 3; i++) {
+    double *p = this->pos[i].data();
+    double *v = this->vel[i].data();
+    double *a = this->acc[i].data();
+    double *pp = this->S_pp[i].data();
+    double *pv = this->S_pv[i].data();
+    double *pa = this->S_pa[i].data();
+    double *vv = this->S_vv[i].data();
+    double *va = this->S_va[i].data();
+    double *aa = this->S_aa[i].data();
+
+    // mu_p = A * mu
+    for (int k = 0; k < n; k++) {
+      p[k] += v[k] * dt + a[k] * h;
+      v[k] += a[k] * dt;
+    }
+
+    // S_p = A * S * A' + R, expanded for the upper triangle
+    for (int k = 0; k < n; k++) {
+      const double r0_0 = pp[k] + dt * pv[k] + h * pa[k];
+      const double r0_1 = pv[k] + dt * vv[k] + h * va[k];
+      const double r0_2 = pa[k] + dt * va[k] + h * aa[k];
+      const double r1_1 = vv[k] + dt * va[k];
+      const double r1_2 = va[k] + dt * aa[k];
+
+      pp[k] = r0_0 + dt * r0_1 + h * r0_2 + r_p;
+      pv[k] = r0_1 + dt * r0_2;
+      pa[k] = r0_2;
+      vv[k] = r1_1 + dt * r1_2 + r_v;
+      va[k] = r1_2;
+      aa[k] += r_a;
+    }
+  }
+
+  return 0;
+}
+
+double TrackerBank::mahalanobis(const int index, const Vec3 &z) const {
+  double d2 = 0.0;
+
+  for (int i = 0; i < 3; i++) {
+    const double innovation = z(i) - this->pos[i][index];
+    const double s = this->S_pp[i][index] + this->measurement_noise(i);
+    d2 += innovation * innovation / s;
+  }
+
+  return d2;
+}
+
+void TrackerBank::updateTrack(const int index, const Vec3 &z, const double t) {
+  const int k = index;
+
+  for (int i = 0; i < 3; i++) {
+    // K = S_p * C' * (C * S_p * C' + Q)^-1, with C = [1, 0, 0]
+    const double s = this->S_pp[i][k] + this->measurement_noise(i);
+    const double k_p = this->S_pp[i][k] / s;
+    const double k_v = this->S_pv[i][k] / s;
+    const double k_a = this->S_pa[i][k] / s;
+
+    // mu = mu_p + K * (y - C * mu_p)
+    const double innovation = z(i) - this->pos[i][k];
+    this->pos[i][k] += k_p * innovation;
+    this->vel[i][k] += k_v * innovation;
+    this->acc[i][k] += k_a * innovation;
+
+    // S = (I - K * C) * S_p
+    const double pp = this->S_pp[i][k];
+    const double pv = this->S_pv[i][k];
+    const double pa = this->S_pa[i][k];
+    this->S_pp[i][k] = pp - k_p * pp;
+    this->S_pv[i][k] = pv - k_p * pv;
+    this->S_pa[i][k] = pa - k_p * pa;
+    this->S_vv[i][k] -= k_v * pv;
+    this->S_va[i][k] -= k_v * pa;
+    this->S_aa[i][k] -= k_a * pa;
+  }
+
+  this->nb_updates[k]++;
+  this->last_updated[k] = t;
+}
+
+int TrackerBank::update(const std::vector<TagPose> &tags, const double t) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  const int nb_tags = tags.size();
+  std::vector<bool> tag_used(nb_tags, false);
+  std::vector<bool> track_used(this->nb_tracks, false);
+
+  // merge detections of the same tag id into the first at their mean
+  // position, so a tag seen twice in a frame is one measurement
+  std::vector<Vec3> position(nb_tags);
+  std::vector<int> nb_merged(nb_tags, 1);
+  for (int j = 0; j < nb_tags; j++) {
+    position[j] = tags[j].position;
+    if (tags[j].id < 0) {
+      continue;
+    }
+
+    for (int i = 0; i < j; i++) {
+      if (tag_used[i] == false && tags[i].id == tags[j].id) {
+        nb_merged[i]++;
+        position[i] += (tags[j].position - position[i]) / nb_merged[i];
+        tag_used[j] = true;
+        break;
+      }
+    }
+  }
+
+  // associate by tag id
+  for (int j = 0; j < nb_tags; j++) {
+    if (tag_used[j] || tags[j].id < 0) {
+      continue;
+    }
+
+    const int k = this->findTag(tags[j].id);
+    if (k != -1 && track_used[k] == false) {
+      this->updateTrack(k, position[j], t);
+      track_used[k] = true;
+      tag_used[j] = true;
+    }
+  }
+
+  // associate detections without id by gated nearest neighbour
+  std::vector<std::pair<double, std::pair<int, int>>> candidates;
+  for (int j = 0; j < nb_tags; j++) {
+    if (tag_used[j] || tags[j].id >= 0) {
+      continue;
+    }
+
+    for (int k = 0; k < this->nb_tracks; k++) {
+      if (track_used[k]) {
+        continue;
+      }
+
+      const double d2 = this->mahalanobis(k, position[j]);
+      if (d2 < this->gate_threshold) {
+        candidates.push_back({d2, {j, k}});
+      }
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  for (size_t i = 0; i < candidates.size(); i++) {
+    const int j = candidates[i].second.first;
+    const int k = candidates[i].second.second;
+    if (tag_used[j] || track_used[k]) {
+      continue;
+    }
+
+    this->updateTrack(k, position[j], t);
+    track_used[k] = true;
+    tag_used[j] = true;
+  }
+
+  // retire stale tracks, iterate backwards since retiring swaps in the last
+  for (int k = this->nb_tracks - 1; k >= 0; k--) {
+    if ((t - this->last_updated[k]) > this->track_timeout) {
+      this->retireTrack(k);
+    }
+  }
+
+  // spawn tracks for unassociated detections
+  for (int j = 0; j < nb_tags; j++) {
+    if (tag_used[j] == false) {
+      TagPose tag = tags[j];
+      tag.position = position[j];
+      this->spawnTrack(tag, t);
+    }
+  }
+
+  return 0;
+}
+
+Vec3 TrackerBank::getPosition(const int index) const {
+  return Vec3{this->pos[0][index], this->pos[1][index], this->pos[2][index]};
+}
+
+Vec3 TrackerBank::getVelocity(const int index) const {
+  return Vec3{this->vel[0][index], this->vel[1][index], this->vel[2][index]};
+}
+
+} // namespace atl
@@ -0,0 +1,176 @@
+#include "atl/estimation/ukf_tracker.hpp"
+
+namespace atl {
+
+int UKFTracker::configure(const std::string &config_file) {
+  ConfigParser parser;
+  MatX R, Q;
+
+  // parse and load config file
+  parser.addParam("nb_states", &this->nb_states);
+  parser.addParam("motion_noise_matrix", &R);
+  parser.addParam("measurement_noise_matrix", &Q);
+  parser.addParam("alpha", &this->alpha, true);
+  parser.addParam("beta", &this->beta, true);
+  parser.addParam("kappa", &this->kappa, true);
+  this->config_file = config_file;
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // check dimensions
+  if (this->nb_states != UKF_NB_STATES) {
+    LOG_ERROR(EUKFNBSTATES, UKF_NB_STATES, this->nb_states);
+    LOG_ERROR(ECHECKCONFIG, this->config_file.c_str());
+    return -1;
+  } else if (R.rows() != UKF_NB_STATES || R.cols() != UKF_NB_STATES) {
+    LOG_ERROR(EUKFRSIZE, UKF_NB_STATES, UKF_NB_STATES);
+    LOG_ERROR(ECHECKCONFIG, this->config_file.c_str());
+    return -1;
+  } else if (Q.rows() != UKF_NB_MEASUREMENTS ||
+             Q.cols() != UKF_NB_MEASUREMENTS) {
+    LOG_ERROR(EUKFQSIZE, UKF_NB_MEASUREMENTS, UKF_NB_MEASUREMENTS);
+    LOG_ERROR(ECHECKCONFIG, this->config_file.c_str());
+    return -1;
+  }
+  this->R = R;
+  this->Q = Q;
+
+  // sigma point weights
+  const double n = UKF_NB_STATES;
+  this->lambda = pow(this->alpha, 2) * (n + this->kappa) - n;
+  this->W_m.fill(1.0 / (2.0 * (n + this->lambda)));
+  this->W_c.fill(1.0 / (2.0 * (n + this->lambda)));
+  this->W_m(0) = this->lambda / (n + this->lambda);
+  this->W_c(0) = this->W_m(0) + (1.0 - pow(this->alpha, 2) + this->beta);
+
+  this->configured = true;
+  return 0;
+}
+
+int UKFTracker::initialize(const VecX &mu) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  // initialize
+  this->mu = mu;
+
+  // this->R;  // set during configuration
+  // this->Q;  // set during configuration
+
+  this->S = StateMat::Identity();
+  this->K = GainMat::Zero();
+
+  this->mu_p = StateVec::Zero();
+  this->S_p = StateMat::Zero();
+
+  this->initialized = true;
+  return 0;
+}
+
+int UKFTracker::reset(const VecX &mu) {
+  // configure
+  if (this->configure(this->config_file) != 0) {
+    this->configured = false;
+    return -1;
+  }
+
+  // initialize
+  if (this->initialize(mu) != 0) {
+    this->initialized = false;
+    return -2;
+  }
+
+  return 0;
+}
+
+int UKFTracker::predictionUpdate(const double dt) {
+  // pre-check
+  if (this->initialized == false) {
+    return -1;
+  }
+
+  // sigma points
+  const Eigen::LLT<StateMat> llt((UKF_NB_STATES + this->lambda) * this->S);
+  if (llt.info() != Eigen::Success) {
+    LOG_ERROR(EUKFSIGMAS);
+    return -2;
+  }
+  const StateMat L = llt.matrixL();
+  this->X.col(0) = this->mu;
+  for (int i = 0; i < UKF_NB_STATES; i++) {
+    this->X.col(1 + i) = this->mu + L.col(i);
+    this->X.col(1 + UKF_NB_STATES + i) = this->mu - L.col(i);
+  }
+
+  // propagate sigma points through process model
+  for (int i = 0; i < UKF_NB_SIGMAS; i++) {
+    this->process_model(this->X.col(i), dt, this->X_p.col(i));
+  }
+
+  // angles are averaged as wrapped offsets from the first sigma point
+  const int a = this->state_angle_index;
+  if (a >= 0) {
+    for (int i = 1; i < UKF_NB_SIGMAS; i++) {
+      const double offset = wrapToPi(this->X_p(a, i) - this->X_p(a, 0));
+      this->X_p(a, i) = this->X_p(a, 0) + offset;
+    }
+  }
+
+  // predicted mean and covariance
+  this->mu_p = this->X_p * this->W_m;
+  this->S_p = this->R;
+  for (int i = 0; i < UKF_NB_SIGMAS; i++) {
+    const StateVec dx = this->X_p.col(i) - this->mu_p;
+    this->S_p += this->W_c(i) * dx * dx.transpose();
+  }
+
+  return 0;
+}
+
+int UKFTracker::measurementUpdate(const VecX &y) {
+  // pre-check
+  if (this->initialized == false) {
+    return -1;
+  }
+
+  // propagate predicted sigma points through measurement model
+  for (int i = 0; i < UKF_NB_SIGMAS; i++) {
+    this->measurement_model(this->X_p.col(i), this->Y.col(i));
+  }
+
+  // angles are averaged as wrapped offsets from the first sigma point
+  const int a = this->measurement_angle_index;
+  if (a >= 0) {
+    for (int i = 1; i < UKF_NB_SIGMAS; i++) {
+      const double offset = wrapToPi(this->Y(a, i) - this->Y(a, 0));
+      this->Y(a, i) = this->Y(a, 0) + offset;
+    }
+  }
+
+  // innovation and cross covariance
+  const MeasurementVec y_p = this->Y * this->W_m;
+  MeasurementMat S_y = this->Q;
+  GainMat S_xy = GainMat::Zero();
+  for (int i = 0; i < UKF_NB_SIGMAS; i++) {
+    const StateVec dx = this->X_p.col(i) - this->mu_p;
+    const MeasurementVec dy = this->Y.col(i) - y_p;
+    S_y += this->W_c(i) * dy * dy.transpose();
+    S_xy += this->W_c(i) * dx * dy.transpose();
+  }
+
+  // measurement update
+  MeasurementVec innovation = y - y_p;
+  if (a >= 0) {
+    innovation(a) = wrapToPi(innovation(a));
+  }
+  this->K = S_xy * S_y.inverse();
+  this->mu = this->mu_p + this->K * innovation;
+  this->S = this->S_p - this->K * S_y * this->K.transpose();
+
+  return 0;
+}
+
+} // namespace atl
@@ -12,6 +12,11 @@ int Mission::configure(const std::string &config_file) {
   parser.addParam("look_ahead_dist", &this->look_ahead_dist);
   parser.addParam("threshold_waypoint_gap", &this->threshold_waypoint_gap);
   parser.addParam("threshold_waypoint_reached", &this->threshold_waypoint_reached);
+  parser.addParam("smooth_path", &this->smooth_path, true);
+  parser.addParam("path_window", &this->path_window, true);
+  parser.addParam("max_acceleration", &this->profile.a_max, true);
+  parser.addParam("max_jerk", &this->profile.j_max, true);
+  parser.addParam("max_lateral_acceleration", &this->profile.a_lat_max, true);
   parser.addParam("waypoints", &waypoint_data);
   // clang-format on
   if (parser.load(config_file) != 0) {
@@ -111,6 +116,17 @@ int Mission::setHomePoint(double home_lat, double home_lon) {
   this->wp_start = this->local_waypoints[0];
   this->wp_end = this->local_waypoints[1];
 
+  // smooth path through the waypoints and its velocity profile
+  this->path_s = -1.0;
+  if (this->smooth_path) {
+    this->profile.v_max = this->desired_velocity;
+    if (this->path.load(this->local_waypoints) != 0) {
+      return -1;
+    } else if (this->profile.generate(this->path) != 0) {
+      return -1;
+    }
+  }
+
   return 0;
 }
 
@@ -130,6 +146,30 @@ Vec3 Mission::closestPoint(const Vec3 &position) {
   return this->wp_start + t * v2;
 }
 
+Vec3 Mission::pathClosestPoint(const Vec3 &position) {
+  Vec3 closest;
+  const double window = this->path_window;
+  this->path_s =
+      this->path.closestPoint(position, this->path_s, window, closest);
+
+  // waypoint pair of the path segment
+  const int i = this->path.segment(this->path_s);
+  this->waypoint_index = i;
+  this->wp_start = this->local_waypoints[i];
+  this->wp_end = this->local_waypoints[i + 1];
+
+  return closest;
+}
+
+double Mission::desiredVelocity() const {
+  if (this->smooth_path && this->profile.loaded) {
+    const double s = std::max(0.0, this->path_s) + this->look_ahead_dist;
+    return this->profile.speed(s);
+  }
+
+  return this->desired_velocity;
+}
+
 int Mission::pointLineSide(const Vec3 &position) {
   Vec3 a = this->wp_start;
   Vec3 b = this->wp_end;
@@ -170,8 +210,15 @@ double Mission::crossTrackError(const Vec3 &position, int mode) {
 }
 
 double Mission::waypointHeading() {
-  const double dx = this->wp_end(0) - this->wp_start(0);
-  const double dy = this->wp_end(1) - this->wp_start(1);
+  double dx = this->wp_end(0) - this->wp_start(0);
+  double dy = this->wp_end(1) - this->wp_start(1);
+
+  // tangent of the smoothed path
+  if (this->smooth_path && this->path.loaded) {
+    const Vec3 tangent = this->path.tangent(std::max(0.0, this->path_s));
+    dx = tangent(0);
+    dy = tangent(1);
+  }
 
   // calculate heading
   double heading = atan2(dy, dx);
@@ -224,6 +271,26 @@ int Mission::update(const Vec3 &position, Vec3 &waypoint) {
     return -3;
   }
 
+  // smoothed path, look ahead along the arc length until the end
+  if (this->smooth_path && this->path.loaded) {
+    this->pathClosestPoint(position);
+    const double s = this->path_s + this->look_ahead_dist;
+    waypoint = this->path.point(std::min(s, this->path.length));
+
+    const Vec3 end = this->local_waypoints.back();
+    if ((end - waypoint).norm() <= this->threshold_waypoint_reached) {
+      LOG_INFO("Mission path end (%f, %f, %f) reached!",
+               end(0),
+               end(1),
+               end(2));
+      this->completed = true;
+      this->waypoint_index = 0;
+      return -2;
+    }
+
+    return 0;
+  }
+
   // interpolate new waypoint
   waypoint = this->waypointInterpolate(position, this->look_ahead_dist);
 
@@ -67,10 +67,10 @@ Vec4 AttitudeController::update(const Vec4 &psetpoints,
 }
 
 // POSITION CONTROLLER
-Vec4 PositionController::update(const Vec3 &setpoints,
-                                const Vec4 &actual,
-                                double yaw,
-                                double dt) {
+Vec4 ModelPositionController::update(const Vec3 &setpoints,
+                                     const Vec4 &actual,
+                                     double yaw,
+                                     double dt) {
   // check rate
   this->dt += dt;
   if (this->dt < 0.01) {
@@ -149,6 +149,10 @@ int QuadrotorModel::update(const VecX &motor_inputs, double dt) {
   const double vy = this->linear_velocity(1);
   const double vz = this->linear_velocity(2);
 
+  const double fx = this->ext_force(0);
+  const double fy = this->ext_force(1);
+  const double fz = this->ext_force(2);
+
   const double Ix = this->Ix;
   const double Iy = this->Iy;
   const double Iz = this->Iz;
@@ -185,9 +189,9 @@ int QuadrotorModel::update(const VecX &motor_inputs, double dt) {
   this->position(0) = x + vx * dt;
   this->position(1) = y + vy * dt;
   this->position(2) = z + vz * dt;
-  this->linear_velocity(0) = vx + ((-kt * vx / m) + (1 / m) * (cos(ph) * sin(th) * cos(ps) + sin(ph) * sin(ps)) * tauf) * dt;
-  this->linear_velocity(1) = vy + ((-kt * vy / m) + (1 / m) * (cos(ph) * sin(th) * sin(ps) - sin(ph) * cos(ps)) * tauf) * dt;
-  this->linear_velocity(2) = vz + (-(kt * vz / m) + (1 / m) * (cos(ph) * cos(th)) * tauf - g) * dt;
+  this->linear_velocity(0) = vx + ((-kt * vx / m) + (1 / m) * (cos(ph) * sin(th) * cos(ps) + sin(ph) * sin(ps)) * tauf + fx / m) * dt;
+  this->linear_velocity(1) = vy + ((-kt * vy / m) + (1 / m) * (cos(ph) * sin(th) * sin(ps) - sin(ph) * cos(ps)) * tauf + fy / m) * dt;
+  this->linear_velocity(2) = vz + (-(kt * vz / m) + (1 / m) * (cos(ph) * cos(th)) * tauf - g + fz / m) * dt;
   // clang-format on
 
   // constrain yaw to be [-180, 180]
@@ -241,6 +245,54 @@ Vec4 QuadrotorModel::positionControllerControl(double dt) {
   return motor_inputs;
 }
 
+Vec4 QuadrotorModel::geometricControllerControl(double dt) {
+  // vehicle parameters come from the model
+  GeometricController &gc = this->geometric_controller;
+  gc.mass = this->m;
+  gc.g = this->g;
+  gc.J = Vec3{this->Ix, this->Iy, this->Iz}.asDiagonal();
+
+  // position loop
+  const Mat3 R = euler321ToRot(this->attitude);
+  gc.update(this->position_setpoints,
+            this->velocity_setpoints,
+            this->acceleration_setpoints,
+            this->yaw_setpoint,
+            this->position,
+            this->linear_velocity,
+            R,
+            dt);
+
+  // attitude loop
+  return this->geometricAttitudeControl(gc.R_d, gc.thrust);
+}
+
+Vec4 QuadrotorModel::geometricAttitudeControl(const Mat3 &R_d,
+                                              double thrust) {
+  // attitude loop, the model's angular velocity is in body rates
+  GeometricController &gc = this->geometric_controller;
+  const Mat3 R = euler321ToRot(this->attitude);
+  const Vec3 M = gc.updateAttitude(R_d, gc.omega_d, R, this->angular_velocity);
+
+  // invert the motor mixing in update()
+  // clang-format off
+  Mat4 A;
+  A << 1.0, 1.0, 1.0, 1.0,
+        0.0, -this->l, 0.0, this->l,
+        -this->l, 0.0, this->l, 0.0,
+        -this->d, this->d, -this->d, this->d;
+  // clang-format on
+  Vec4 motor_inputs = A.inverse() * Vec4{thrust, M(0), M(1), M(2)};
+
+  // limit outputs
+  const double max_thrust = 5.0;
+  for (int i = 0; i < 4; i++) {
+    motor_inputs(i) = std::max(0.0, std::min(motor_inputs(i), max_thrust));
+  }
+
+  return motor_inputs;
+}
+
 void QuadrotorModel::setAttitude(double roll,
                                  double pitch,
                                  double yaw,
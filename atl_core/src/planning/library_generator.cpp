@@ -0,0 +1,220 @@
+#include "atl/planning/library_generator.hpp"
+
+namespace atl {
+
+int LibraryGenerator::configure(const std::string &config_file) {
+  // load config
+  ConfigParser parser;
+  parser.addParam("z_min", &this->z_min);
+  parser.addParam("z_max", &this->z_max);
+  parser.addParam("z_step", &this->z_step);
+  parser.addParam("v_min", &this->v_min);
+  parser.addParam("v_max", &this->v_max);
+  parser.addParam("v_step", &this->v_step);
+  parser.addParam("dt", &this->dt, true);
+  parser.addParam("vz", &this->vz, true);
+  parser.addParam("nb_threads", &this->nb_threads, true);
+  parser.addParam("chunk_size", &this->chunk_size, true);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // check settings
+  if (this->z_min <= 0.0 || this->z_max < this->z_min || this->z_step <= 0) {
+    LOG_ERROR("Invalid start heights!");
+    return -2;
+  } else if (this->v_max < this->v_min || this->v_step <= 0.0) {
+    LOG_ERROR("Invalid target velocities!");
+    return -2;
+  } else if (this->dt <= 0.0 || this->vz >= 0.0 || this->chunk_size < 1) {
+    LOG_ERROR("Invalid time step, descent rate or chunk size!");
+    return -2;
+  }
+
+  this->configured = true;
+  return 0;
+}
+
+int LibraryGenerator::nbHeights() const {
+  return (int) floor((this->z_max - this->z_min) / this->z_step + 1e-9) + 1;
+}
+
+int LibraryGenerator::nbVelocities() const {
+  return (int) floor((this->v_max - this->v_min) / this->v_step + 1e-9) + 1;
+}
+
+double LibraryGenerator::height(const int i) const {
+  return this->z_min + i * this->z_step;
+}
+
+double LibraryGenerator::velocity(const int j) const {
+  return this->v_min + j * this->v_step;
+}
+
+int LibraryGenerator::resume(const std::string &output_dir) {
+  const int nb_cells = this->nbHeights() * this->nbVelocities();
+  const std::string index_path = output_dir + "/index.csv";
+  this->done.assign(nb_cells, 0);
+
+  // keep the lines of finished trajectories
+  std::ifstream index(index_path);
+  std::vector<std::string> lines;
+  std::string line;
+  std::getline(index, line);
+  while (std::getline(index, line)) {
+    int i;
+    double z, v;
+    if (sscanf(line.c_str(), "%d,%lf,%lf", &i, &z, &v) != 3) {
+      continue;
+    }
+    const std::string traj = output_dir + "/" + std::to_string(i) + ".csv";
+    if (i < 0 || i >= nb_cells || this->done[i] || !file_exists(traj)) {
+      continue;
+    }
+    this->done[i] = 1;
+    lines.push_back(line);
+  }
+  index.close();
+
+  // rewrite index
+  if (lines.size()) {
+    std::ofstream rewrite(index_path);
+    rewrite << "index,p0_z,v\n";
+    for (auto &l : lines) {
+      rewrite << l << "\n";
+    }
+  }
+
+  return (int) lines.size();
+}
+
+int LibraryGenerator::generate(const std::string &output_dir) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  // resume, append to the index of an earlier run
+  const int nb_v = this->nbVelocities();
+  const int nb_cells = this->nbHeights() * nb_v;
+  const std::string index_path = output_dir + "/index.csv";
+  this->nb_skipped = this->resume(output_dir);
+  this->nb_solved = 0;
+  this->nb_failed = 0;
+  if (this->nb_skipped > 0) {
+    this->index_file.open(index_path, std::ios::app);
+  } else {
+    this->index_file.open(index_path);
+    this->index_file << "index,p0_z,v\n" << std::flush;
+  }
+  if (this->index_file.good() == false) {
+    LOG_ERROR("Failed to open [%s]!", index_path.c_str());
+    this->index_file.close();
+    return -2;
+  }
+  LOG_INFO("Generating %d trajectories, %d already done",
+           nb_cells - this->nb_skipped,
+           this->nb_skipped);
+
+  struct timespec t_start;
+  tic(&t_start);
+
+  // chunks of consecutive velocities of a row
+  std::vector<std::pair<int, int>> chunks;
+  for (int i = 0; i < this->nbHeights(); i++) {
+    for (int j = 0; j < nb_v; j += this->chunk_size) {
+      const int j_end = std::min(j + this->chunk_size, nb_v);
+      chunks.emplace_back(i * nb_v + j, i * nb_v + j_end);
+    }
+  }
+
+  // workers pull the next chunk until none are left
+  int nb_threads = this->nb_threads;
+  if (nb_threads <= 0) {
+    nb_threads = std::max(1, (int) std::thread::hardware_concurrency());
+  }
+  nb_threads = std::max(1, std::min(nb_threads, (int) chunks.size()));
+
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    POpt popt;
+    size_t c;
+    while ((c = next.fetch_add(1)) < chunks.size()) {
+      std::vector<double> x;
+      double v_prev = 0.0;
+
+      for (int cell = chunks[c].first; cell < chunks[c].second; cell++) {
+        if (this->done[cell]) {
+          x.clear();
+          continue;
+        }
+        const double z = this->height(cell / nb_v);
+        const double v = this->velocity(cell % nb_v);
+
+        // warm start from the neighbour, shifted to the new velocity
+        struct problem_data p;
+        trajectory_landing_setup(&p, z, v, this->dt, this->vz);
+        for (size_t k = 0; k < x.size() / 6; k++) {
+          x[6 * k + 0] += (v - v_prev) * k * this->dt;
+          x[6 * k + 1] += (v - v_prev);
+        }
+        v_prev = v;
+
+        // optimize and save
+        const std::string traj = output_dir + "/" + std::to_string(cell);
+        int retval = popt.solve(p, x);
+        if (retval == 0) {
+          retval = trajectory_save(traj + ".csv.tmp", &p, x);
+        }
+        if (retval == 0) {
+          retval = rename((traj + ".csv.tmp").c_str(), (traj + ".csv").c_str());
+        }
+        if (retval != 0) {
+          LOG_ERROR("Failed to generate z: %.2f, v: %.2f!", z, v);
+          this->nb_failed++;
+          x.clear();
+          continue;
+        }
+
+        // record
+        std::lock_guard<std::mutex> guard(this->index_mutex);
+        this->index_file << cell << "," << z << "," << v << "\n" << std::flush;
+        this->done[cell] = 1;
+        this->nb_solved++;
+        LOG_INFO("[%d] z: %.2f, v: %.2f, solve [ms]: %.2f",
+                 cell,
+                 z,
+                 v,
+                 popt.problem.time_taken * 1e3);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < nb_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  this->index_file.close();
+  this->elapsed = toc(&t_start);
+
+  LOG_INFO("Generated %d trajectories (%d failed) in %.2f s, %.2f traj/s",
+           this->nb_solved.load(),
+           this->nb_failed.load(),
+           this->elapsed,
+           this->throughput());
+
+  return (this->nb_failed == 0) ? 0 : -3;
+}
+
+double LibraryGenerator::throughput() const {
+  if (this->elapsed <= 0.0) {
+    return 0.0;
+  }
+  return this->nb_solved / this->elapsed;
+}
+
+} // namespace atl
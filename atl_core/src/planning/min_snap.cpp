@@ -0,0 +1,226 @@
+#include "atl/planning/min_snap.hpp"
+
+namespace atl {
+
+double poly_evaluate(const Eigen::Matrix<double, 8, 1> &c,
+                     const double T,
+                     const double t,
+                     const int k) {
+  // horner's method on normalized time
+  const double tau = t / T;
+  double value = 0.0;
+  for (int i = 7; i >= k; i--) {
+    value = value * tau + PolyBVP<8>::falling(i, k) * c(i);
+  }
+
+  return value / pow(T, k);
+}
+
+/**
+ * Search the durations of the generator for the lowest cost feasible
+ * trajectory with the boundary value problem `bvp`
+ */
+template <int N>
+static int min_snap_search(MinSnapGenerator &gen,
+                           const PolyBVP<N> &bvp,
+                           const Vec2 &pos,
+                           const Vec2 &vel,
+                           const Vec2 &acc,
+                           const Vec2 &target_pos,
+                           const Vec2 &target_vel) {
+  typedef typename PolyBVP<N>::Coeffs Coeffs;
+  const int k_min = std::max(1, (int) ceil(gen.duration_min / gen.dt - 1e-9));
+  const int k_max = (int) floor(gen.duration_max / gen.dt + 1e-9);
+
+  // start state, position and derivatives up to jerk
+  const double start_x[4] = {pos(0), vel(0), acc(0), 0.0};
+  const double start_z[4] = {pos(1), vel(1), acc(1), 0.0};
+
+  double best = DBL_MAX;
+  gen.nb_evaluated = 0;
+  for (int k = k_min; k <= k_max; k++) {
+    const double T = k * gen.dt;
+    gen.nb_evaluated++;
+
+    // rendezvous with the target at constant velocity
+    const Vec2 end_pos = target_pos + target_vel * T;
+    const double end_x[4] = {end_pos(0), target_vel(0), 0.0, 0.0};
+    const double end_z[4] = {end_pos(1), target_vel(1) + gen.touchdown_vz};
+    const Coeffs cx = bvp.solve(start_x, end_x, T);
+    const Coeffs cz = bvp.solve(start_z, end_z, T);
+
+    // cost, skip the feasibility check if it cannot be the best
+    const double cost = bvp.cost(cx, T) + bvp.cost(cz, T);
+    const double total = cost + gen.time_weight * T;
+    if (total >= best) {
+      continue;
+    }
+
+    // feasibility, derivatives on normalized time scaled to real time
+    double dz[N] = {0.0};
+    double ddx[N] = {0.0};
+    double ddz[N] = {0.0};
+    for (int i = 0; i + 1 < N; i++) {
+      dz[i] = (i + 1) * cz(i + 1) / T;
+    }
+    for (int i = 0; i + 2 < N; i++) {
+      ddx[i] = (i + 2) * (i + 1) * cx(i + 2) / (T * T);
+      ddz[i] = (i + 2) * (i + 1) * cz(i + 2) / (T * T);
+    }
+
+    bool feasible = true;
+    for (int i = 0; i <= gen.nb_checks && feasible; i++) {
+      const double tau = (double) i / gen.nb_checks;
+      double z = 0.0, vz = 0.0, ax = 0.0, az = 0.0;
+      for (int j = N - 1; j >= 0; j--) {
+        z = z * tau + cz(j);
+        vz = vz * tau + dz[j];
+        ax = ax * tau + ddx[j];
+        az = az * tau + ddz[j];
+      }
+      az += gen.g;
+      const double thrust = sqrt(ax * ax + az * az);
+      const double tilt = atan2(fabs(ax), az);
+      const double ground = target_pos(1) + target_vel(1) * tau * T;
+
+      feasible = (thrust >= gen.thrust_min && thrust <= gen.thrust_max);
+      feasible &= (tilt <= gen.tilt_max);
+      feasible &= (vz >= gen.vz_min - 1e-9);
+      feasible &= (z >= ground - 1e-6);
+    }
+    if (feasible) {
+      best = total;
+      gen.duration = T;
+      gen.cost = cost;
+      gen.coeffs_x.setZero();
+      gen.coeffs_z.setZero();
+      gen.coeffs_x.head<N>() = cx;
+      gen.coeffs_z.head<N>() = cz;
+    }
+  }
+
+  return (best == DBL_MAX) ? -2 : 0;
+}
+
+int MinSnapGenerator::configure(const std::string &config_file) {
+  // load config
+  double tilt_max = rad2deg(this->tilt_max);
+  ConfigParser parser;
+  parser.addParam("order", &this->order, true);
+  parser.addParam("time_weight", &this->time_weight, true);
+  parser.addParam("duration_min", &this->duration_min, true);
+  parser.addParam("duration_max", &this->duration_max, true);
+  parser.addParam("dt", &this->dt, true);
+  parser.addParam("thrust_min", &this->thrust_min, true);
+  parser.addParam("thrust_max", &this->thrust_max, true);
+  parser.addParam("tilt_max", &tilt_max, true);
+  parser.addParam("vz_min", &this->vz_min, true);
+  parser.addParam("touchdown_vz", &this->touchdown_vz, true);
+  parser.addParam("nb_checks", &this->nb_checks, true);
+  parser.addParam("hover_throttle", &this->hover_throttle, true);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // check settings
+  if (this->order != 3 && this->order != 4) {
+    LOG_ERROR("Invalid order [%d], 3: jerk, 4: snap!", this->order);
+    return -2;
+  } else if (this->dt <= 0.0 || this->duration_min <= 0.0) {
+    LOG_ERROR("Invalid time step or duration!");
+    return -2;
+  } else if (this->duration_max < this->duration_min) {
+    LOG_ERROR("Invalid duration range!");
+    return -2;
+  } else if (this->thrust_max <= this->thrust_min || this->nb_checks < 1) {
+    LOG_ERROR("Invalid thrust limits or number of checks!");
+    return -2;
+  }
+
+  // convert tilt limit from degrees to radians
+  this->tilt_max = deg2rad(tilt_max);
+
+  this->configured = true;
+  return 0;
+}
+
+int MinSnapGenerator::solve(const Vec2 &pos,
+                            const Vec2 &vel,
+                            const Vec2 &acc,
+                            const Vec2 &target_pos,
+                            const Vec2 &target_vel) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  this->target_pos = target_pos;
+  this->target_vel = target_vel;
+  if (this->order == 3) {
+    return min_snap_search(
+        *this, this->jerk_bvp, pos, vel, acc, target_pos, target_vel);
+  }
+  return min_snap_search(
+      *this, this->snap_bvp, pos, vel, acc, target_pos, target_vel);
+}
+
+void MinSnapGenerator::evaluate(const double t,
+                                Vec2 &pos,
+                                Vec2 &vel,
+                                Vec2 &acc) const {
+  const double T = this->duration;
+  const double ts = std::max(0.0, std::min(t, T));
+  pos << poly_evaluate(this->coeffs_x, T, ts, 0),
+      poly_evaluate(this->coeffs_z, T, ts, 0);
+  vel << poly_evaluate(this->coeffs_x, T, ts, 1),
+      poly_evaluate(this->coeffs_z, T, ts, 1);
+  acc << poly_evaluate(this->coeffs_x, T, ts, 2),
+      poly_evaluate(this->coeffs_z, T, ts, 2);
+}
+
+int MinSnapGenerator::generate(const Vec2 &pos,
+                               const Vec2 &vel,
+                               const Vec2 &target_pos,
+                               const Vec2 &target_vel,
+                               const Vec3 &p0,
+                               Trajectory &traj) {
+  // solve
+  const int retval =
+      this->solve(pos, vel, Vec2{0.0, 0.0}, target_pos, target_vel);
+  if (retval != 0) {
+    return retval;
+  }
+
+  // sample every dt, the duration is a multiple of dt
+  const int nb_rows = (int) round(this->duration / this->dt) + 1;
+  MatX traj_data(nb_rows, 10);
+  for (int i = 0; i < nb_rows; i++) {
+    const double t = i * this->dt;
+    Vec2 p, v, a;
+    this->evaluate(t, p, v, a);
+    const Vec2 target = target_pos + target_vel * t;
+    const double az = a(1) + this->g;
+    const double thrust = sqrt(a(0) * a(0) + az * az);
+
+    traj_data(i, 0) = p(0);                                    // x
+    traj_data(i, 1) = v(0);                                    // vx
+    traj_data(i, 2) = p(1);                                    // z
+    traj_data(i, 3) = v(1);                                    // vz
+    traj_data(i, 4) = this->hover_throttle * thrust / this->g; // thrust
+    traj_data(i, 5) = atan2(a(0), az);                         // theta
+    traj_data(i, 6) = target(0) - p(0);                        // rel_x
+    traj_data(i, 7) = target(1) - p(1);                        // rel_z
+    traj_data(i, 8) = target_vel(0) - v(0);                    // rel_vx
+    traj_data(i, 9) = target_vel(1) - v(1);                    // rel_vz
+  }
+
+  // load trajectory
+  traj.dt = this->dt;
+  if (traj.load(-1, traj_data, p0) != 0) {
+    return -3;
+  }
+
+  return 0;
+}
+
+} // namespace atl
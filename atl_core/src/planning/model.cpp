@@ -77,7 +77,10 @@ int Simulator::configure(Vec4 x_init, Vec4 x_final, double m) {
   return 0;
 }
 
-int Simulator::simulate(double dt, double tend, MatX U, MatX &X) {
+int Simulator::simulate(double dt,
+                        double tend,
+                        const MatX &U,
+                        MatX &X) {
   Vec2 u, u_prev;
   int nb_ts;
 
@@ -122,4 +125,140 @@ int Simulator::simulate(double dt, double tend, MatX U, MatX &X) {
   return 0;
 }
 
+// BATCH SIMULATOR
+/**
+ * Sine and cosine of a block of angles
+ *
+ * Reduces the angles to [-pi, pi] by rounding with a magic number, then
+ * doubles the half angles. Their sine and cosine are minimax polynomials on
+ * [-pi / 2, pi / 2], accurate to 5e-9 and 4e-10, which is a degree lower
+ * than the Taylor series for single precision. Branch free, so it
+ * vectorizes.
+ */
+template <typename Block>
+static void batch_sincos(const Block &theta, Block &s, Block &c) {
+  const float magic = 12582912.0f; // 1.5 * 2^23, adding it rounds
+  const Block n = (theta * (float) (0.5 / M_PI) + magic) - magic;
+  const Block h = 0.5f * (theta - n * (float) (2.0 * M_PI));
+  const Block h2 = h.square();
+
+  // clang-format off
+  const Block sh = h * (1.0f + h2 * (-1.666666571e-1f + h2 * (8.333017292e-3f
+                   + h2 * (-1.980661522e-4f + h2 * 2.600054801e-6f))));
+  const Block ch = 1.0f + h2 * (-0.5f + h2 * (4.166665577e-2f
+                   + h2 * (-1.388856918e-3f + h2 * (2.476930508e-5f
+                   + h2 * -2.619383083e-7f))));
+  // clang-format on
+
+  const Block sh2 = sh + sh;
+  s = sh2 * ch;
+  c = 1.0f - sh2 * sh;
+}
+
+/**
+ * Propagate the `B` rollouts from `k` through every step
+ */
+template <int B>
+static void batch_rollout(BatchSimulator &sim,
+                          const int k,
+                          const int nb_ts,
+                          const float dt,
+                          const Eigen::MatrixXf &AZ,
+                          const Eigen::MatrixXf &THETA) {
+  typedef Eigen::Array<float, B, 1> Block;
+  const float g_dt = sim.g * dt;
+
+  // setup
+  Block x = Block::Constant(sim.x_init(0));
+  Block vx = Block::Constant(sim.x_init(1));
+  Block z = Block::Constant(sim.x_init(2));
+  Block vz = Block::Constant(sim.x_init(3));
+  Block z_min = z;
+  Block s, c;
+
+  // simulate, the inputs of a step are a contiguous column
+  for (int i = 0; i < nb_ts; i++) {
+    const Block az_dt = AZ.col(i).template segment<B>(k).array() * dt;
+    const Block theta = THETA.col(i).template segment<B>(k).array();
+    batch_sincos(theta, s, c);
+
+    x += vx * dt;
+    vx += az_dt * s;
+    z += vz * dt;
+    vz += az_dt * c - g_dt;
+    z_min = z_min.min(z);
+  }
+
+  // calculate error against final state
+  const Eigen::Vector4f xf = sim.x_final.cast<float>();
+  sim.x.template segment<B>(k) = x;
+  sim.vx.template segment<B>(k) = vx;
+  sim.z.template segment<B>(k) = z;
+  sim.vz.template segment<B>(k) = vz;
+  sim.z_min.template segment<B>(k) = z_min;
+  sim.dist_error.template segment<B>(k) =
+      (x - xf(0)).square() + (z - xf(2)).square();
+  sim.vel_error.template segment<B>(k) =
+      (vx - xf(1)).square() + (vz - xf(3)).square();
+}
+
+int BatchSimulator::configure(const Vec4 &x_init, const Vec4 &x_final) {
+  this->x_init = x_init;
+  this->x_final = x_final;
+
+  this->configured = true;
+  return 0;
+}
+
+int BatchSimulator::simulate(const double dt,
+                             const double tend,
+                             const Eigen::MatrixXf &AZ,
+                             const Eigen::MatrixXf &THETA) {
+  const int nb_ts = round(tend / dt);
+  const int N = AZ.rows();
+
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  } else if (AZ.cols() != nb_ts || THETA.cols() != nb_ts) {
+    return -2;
+  } else if (THETA.rows() != N) {
+    return -2;
+  }
+
+  // setup
+  this->x.resize(N);
+  this->vx.resize(N);
+  this->z.resize(N);
+  this->vz.resize(N);
+  this->d_az.resize(N);
+  this->d_theta.resize(N);
+  this->az_sum.resize(N);
+  this->dist_error.resize(N);
+  this->vel_error.resize(N);
+  this->z_min.resize(N);
+
+  // record energy used in terms of thrust and pitch change, it only
+  // depends on the inputs so it is accumulated a whole column at a time
+  this->d_az.setZero();
+  this->d_theta.setZero();
+  this->az_sum.setZero();
+  for (int i = 1; i < nb_ts; i++) {
+    this->d_az += (AZ.col(i) - AZ.col(i - 1)).array().abs();
+    this->d_theta += (THETA.col(i) - THETA.col(i - 1)).array().abs();
+    this->az_sum += AZ.col(i).array().abs();
+  }
+
+  // blocks of rollouts, then the remainder one by one
+  int k = 0;
+  for (; k + BATCH_SIM_BLOCK <= N; k += BATCH_SIM_BLOCK) {
+    batch_rollout<BATCH_SIM_BLOCK>(*this, k, nb_ts, dt, AZ, THETA);
+  }
+  for (; k < N; k++) {
+    batch_rollout<1>(*this, k, nb_ts, dt, AZ, THETA);
+  }
+
+  return 0;
+}
+
 } // namespace atl
@@ -0,0 +1,277 @@
+#include "atl/planning/mppi.hpp"
+
+namespace atl {
+
+int MPPIPlanner::configure(const std::string &config_file) {
+  // load config
+  double sigma_theta = rad2deg(this->sigma_theta);
+  double tilt_max = rad2deg(this->tilt_max);
+  ConfigParser parser;
+  parser.addParam("dt", &this->dt, true);
+  parser.addParam("max_steps", &this->max_steps, true);
+  parser.addParam("min_steps", &this->min_steps, true);
+  parser.addParam("descent_rate", &this->descent_rate, true);
+  parser.addParam("touchdown_vz", &this->touchdown_vz, true);
+  parser.addParam("nb_samples", &this->nb_samples, true);
+  parser.addParam("nb_threads", &this->nb_threads, true);
+  parser.addParam("seed", &this->seed, true);
+  parser.addParam("lambda", &this->lambda, true);
+  parser.addParam("sigma_az", &this->sigma_az, true);
+  parser.addParam("sigma_theta", &sigma_theta, true);
+  parser.addParam("thrust_min", &this->thrust_min, true);
+  parser.addParam("thrust_max", &this->thrust_max, true);
+  parser.addParam("tilt_max", &tilt_max, true);
+  parser.addParam("w_pos", &this->w_pos, true);
+  parser.addParam("w_vel", &this->w_vel, true);
+  parser.addParam("w_daz", &this->w_daz, true);
+  parser.addParam("w_dtheta", &this->w_dtheta, true);
+  parser.addParam("w_ground", &this->w_ground, true);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // check settings
+  if (this->dt <= 0.0 || this->descent_rate <= 0.0) {
+    LOG_ERROR("Invalid time step or descent rate!");
+    return -2;
+  } else if (this->min_steps < 1 || this->max_steps < this->min_steps) {
+    LOG_ERROR("Invalid horizon!");
+    return -2;
+  } else if (this->nb_samples < 1 || this->lambda <= 0.0) {
+    LOG_ERROR("Invalid number of samples or temperature!");
+    return -2;
+  } else if (this->thrust_max <= this->thrust_min) {
+    LOG_ERROR("Invalid thrust limits!");
+    return -2;
+  }
+
+  // convert angles from degrees to radians
+  this->sigma_theta = deg2rad(sigma_theta);
+  this->tilt_max = deg2rad(tilt_max);
+
+  // one batch of samples per thread
+  int nb_threads = this->nb_threads;
+  if (nb_threads <= 0) {
+    nb_threads = std::max(1, (int) std::thread::hardware_concurrency());
+  }
+  nb_threads = std::min(nb_threads, this->nb_samples);
+  this->stopWorkers();
+  this->batches.clear();
+  this->batches.resize(nb_threads);
+  for (int i = 0; i < nb_threads; i++) {
+    const int nb_rows = this->nb_samples / nb_threads;
+    const int rem = (i < this->nb_samples % nb_threads) ? 1 : 0;
+    this->batches[i].rng.seed(this->seed + i);
+    this->batches[i].cost.resize(nb_rows + rem);
+  }
+  this->startWorkers();
+
+  this->reset();
+  this->configured = true;
+  return 0;
+}
+
+void MPPIPlanner::startWorkers() {
+  this->stopping = false;
+  for (size_t i = 1; i < this->batches.size(); i++) {
+    this->workers.emplace_back(
+        &MPPIPlanner::workerLoop, this, (int) i, this->generation);
+  }
+}
+
+void MPPIPlanner::stopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(this->pool_mutex);
+    this->stopping = true;
+  }
+  this->pool_cv.notify_all();
+
+  for (auto &worker : this->workers) {
+    worker.join();
+  }
+  this->workers.clear();
+}
+
+void MPPIPlanner::workerLoop(const int i, uint64_t generation) {
+  std::unique_lock<std::mutex> lock(this->pool_mutex);
+  while (true) {
+    // wait for the next update
+    this->pool_cv.wait(lock, [&] {
+      return this->stopping || this->generation != generation;
+    });
+    if (this->stopping) {
+      return;
+    }
+    generation = this->generation;
+
+    // roll out batch
+    lock.unlock();
+    this->job(i);
+    lock.lock();
+    if (--this->nb_pending == 0) {
+      this->done_cv.notify_one();
+    }
+  }
+}
+
+void MPPIPlanner::runBatches(const std::function<void(const int)> &job) {
+  // hand the other batches to the workers
+  {
+    std::lock_guard<std::mutex> lock(this->pool_mutex);
+    this->job = job;
+    this->nb_pending = (int) this->workers.size();
+    this->generation++;
+  }
+  this->pool_cv.notify_all();
+
+  // roll out the first batch and wait for the others
+  job(0);
+  std::unique_lock<std::mutex> lock(this->pool_mutex);
+  this->done_cv.wait(lock, [&] { return this->nb_pending == 0; });
+  this->job = nullptr;
+}
+
+void MPPIPlanner::reset() {
+  this->nominal_az.resize(0);
+  this->nominal_theta.resize(0);
+  this->time_shift = 0.0;
+}
+
+int MPPIPlanner::update(const Vec2 &pos,
+                        const Vec2 &vel,
+                        const Vec2 &target_pos,
+                        const Vec2 &target_vel,
+                        const double dt,
+                        Vec2 &inputs) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+  struct timespec t_start;
+  tic(&t_start);
+
+  // new landing, hover for the time to descend to the target
+  if (this->horizon() == 0) {
+    const double height = pos(1) - target_pos(1);
+    const int steps = round(height / this->descent_rate / this->dt);
+    const int H = std::max(this->min_steps, std::min(this->max_steps, steps));
+    this->nominal_az = Eigen::VectorXf::Constant(H, this->g);
+    this->nominal_theta = Eigen::VectorXf::Zero(H);
+    this->time_shift = 0.0;
+  } else {
+    this->time_shift += dt;
+  }
+
+  // shift the nominal by the elapsed whole steps, pad with hover
+  const int nb_shift = (int) floor(this->time_shift / this->dt + 1e-6);
+  this->time_shift -= nb_shift * this->dt;
+  if (nb_shift > 0) {
+    const int H = this->horizon();
+    const int nb_keep = std::max(0, H - nb_shift);
+    const int H_new = std::max(this->min_steps, nb_keep);
+    Eigen::VectorXf az = Eigen::VectorXf::Constant(H_new, this->g);
+    Eigen::VectorXf theta = Eigen::VectorXf::Zero(H_new);
+    az.head(nb_keep) = this->nominal_az.tail(nb_keep);
+    theta.head(nb_keep) = this->nominal_theta.tail(nb_keep);
+    this->nominal_az = az;
+    this->nominal_theta = theta;
+  }
+
+  // interception with the target at the end of the horizon
+  const int H = this->horizon();
+  const double T = H * this->dt;
+  const Vec2 end_pos = target_pos + target_vel * T;
+  const Vec4 x_init{pos(0), vel(0), pos(1), vel(1)};
+  const double end_vz = target_vel(1) + this->touchdown_vz;
+  const Vec4 x_final{end_pos(0), target_vel(0), end_pos(1), end_vz};
+
+  // sample, roll out and cost, one batch per thread
+  const float az_min = this->thrust_min;
+  const float az_max = this->thrust_max;
+  const float theta_max = this->tilt_max;
+  const float sigma_az = this->sigma_az;
+  const float sigma_theta = this->sigma_theta;
+  const float w_pos = this->w_pos;
+  const float w_vel = this->w_vel;
+  const float w_daz = this->w_daz;
+  const float w_dtheta = this->w_dtheta;
+  const float w_ground = this->w_ground;
+  std::atomic<int> nb_failed{0};
+  auto worker = [&](const int i) {
+    MPPIBatch &batch = this->batches[i];
+    const int N = batch.cost.size();
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    batch.AZ.resize(N, H);
+    batch.THETA.resize(N, H);
+
+    // perturb the nominal, the first sample of the first batch is the
+    // nominal itself
+    const int first = (i == 0) ? 1 : 0;
+    for (int k = 0; k < H; k++) {
+      batch.AZ(0, k) = this->nominal_az(k);
+      batch.THETA(0, k) = this->nominal_theta(k);
+      for (int r = first; r < N; r++) {
+        batch.AZ(r, k) = this->nominal_az(k) + sigma_az * noise(batch.rng);
+      }
+      for (int r = first; r < N; r++) {
+        batch.THETA(r, k) =
+            this->nominal_theta(k) + sigma_theta * noise(batch.rng);
+      }
+    }
+    batch.AZ = batch.AZ.array().max(az_min).min(az_max).matrix();
+    batch.THETA = batch.THETA.array().max(-theta_max).min(theta_max).matrix();
+
+    // roll out
+    batch.sim.g = this->g;
+    batch.sim.configure(x_init, x_final);
+    if (batch.sim.simulate(this->dt, T, batch.AZ, batch.THETA) != 0) {
+      nb_failed++;
+      return;
+    }
+
+    // cost
+    const float ground = x_final(2);
+    const Eigen::ArrayXf below = (ground - batch.sim.z_min).max(0.0f);
+    batch.cost = w_pos * batch.sim.dist_error;
+    batch.cost += w_vel * batch.sim.vel_error;
+    batch.cost += w_daz * batch.sim.d_az;
+    batch.cost += w_dtheta * batch.sim.d_theta;
+    batch.cost += w_ground * below.square();
+  };
+
+  this->runBatches(worker);
+  if (nb_failed > 0) {
+    return -2;
+  }
+
+  // weight the samples by their cost relative to the best one
+  float cost_min = FLT_MAX;
+  for (auto &batch : this->batches) {
+    cost_min = std::min(cost_min, batch.cost.minCoeff());
+  }
+  double weight_sum = 0.0;
+  double weight_sq_sum = 0.0;
+  Eigen::VectorXf az_sum = Eigen::VectorXf::Zero(H);
+  Eigen::VectorXf theta_sum = Eigen::VectorXf::Zero(H);
+  const float inv_lambda = 1.0 / this->lambda;
+  for (auto &batch : this->batches) {
+    const Eigen::VectorXf w =
+        (-(batch.cost - cost_min) * inv_lambda).exp().matrix();
+    weight_sum += w.sum();
+    weight_sq_sum += w.squaredNorm();
+    az_sum.noalias() += batch.AZ.transpose() * w;
+    theta_sum.noalias() += batch.THETA.transpose() * w;
+  }
+
+  // new nominal, the best sample has weight 1 so the sum is at least 1
+  this->nominal_az = az_sum / (float) weight_sum;
+  this->nominal_theta = theta_sum / (float) weight_sum;
+  this->cost_min = cost_min;
+  this->nb_effective = weight_sum * weight_sum / weight_sq_sum;
+  inputs << this->nominal_az(0), this->nominal_theta(0);
+  this->elapsed = toc(&t_start);
+
+  return 0;
+}
+
+} // namespace atl
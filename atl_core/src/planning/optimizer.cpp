@@ -2,74 +2,127 @@
 
 namespace atl {
 
-double cost_func(const std::vector<double> &x,
-                 std::vector<double> &grad,
-                 void *data) {
-  UNUSED(data);
-
-  // calculate gradients
-  if (!grad.empty()) {
-    grad[0] = 0.0;
-    grad[1] = 0.5 / sqrt(x[1]);
+/**
+ * Objective, counts evaluations and stops the optimizer when asked to
+ */
+static double popt_cost_func(const std::vector<double> &x,
+                             std::vector<double> &grad,
+                             void *data) {
+  POpt *popt = (POpt *) data;
+  if (popt->stop_requested) {
+    throw nlopt::forced_stop();
   }
 
-  return sqrt(x[1]);
+  popt->nb_evaluations++;
+  return trajectory_cost_func(x, grad, &popt->problem);
 }
 
-double constraint_func(const std::vector<double> &x,
-                       std::vector<double> &grad,
-                       void *data) {
-  constraint_data *d;
-  double a, b;
-
-  // setup
-  d = reinterpret_cast<constraint_data *>(data);
-  a = d->a;
-  b = d->b;
-
-  // calculate gradients
-  if (!grad.empty()) {
-    grad[0] = 3 * a * (a * x[0] + b) * (a * x[0] + b);
-    grad[1] = -1.0;
+int POpt::solve(const struct problem_data &p, std::vector<double> &x) {
+  // pre-check
+  if (p.nb_steps < 3 || p.desired.cols() != p.nb_steps) {
+    LOG_ERROR("Invalid trajectory problem!");
+    return -1;
   }
 
-  return ((a * x[0] + b) * (a * x[0] + b) * (a * x[0] + b) - x[1]);
-}
-
-POpt::POpt() {}
-
-int POpt::run() {
-  double minf;
-  std::vector<double> lb(2);
-  std::vector<double> x(2);
-
   // setup
-  lb[0] = -HUGE_VAL;
-  lb[1] = 0;
-  x[0] = 1.234;
-  x[1] = 5.678;
-  constraint_data data[2] = {{2, 0}, {-1, 1}};
+  this->problem = p;
+  const int n = trajectory_nb_variables(&this->problem);
+  const int m = trajectory_nb_constraints(&this->problem);
+  if ((int) x.size() != n) {
+    trajectory_warm_start(&this->problem, x);
+  }
+  std::vector<double> lb, ub;
+  trajectory_bounds(&this->problem, lb, ub);
+  for (int i = 0; i < n; i++) {
+    x[i] = std::max(lb[i], std::min(x[i], ub[i]));
+  }
 
   // configure optimizer
-  this->opt = nlopt::opt(nlopt::LD_MMA, 2);
+  this->opt = nlopt::opt(nlopt::LD_SLSQP, n);
   this->opt.set_lower_bounds(lb);
-  this->opt.set_min_objective(cost_func, NULL);
+  this->opt.set_upper_bounds(ub);
+  this->opt.set_min_objective(popt_cost_func, this);
+  const std::vector<double> tol(m, this->constraint_tol);
+  this->opt.add_equality_mconstraint(
+      trajectory_constraints_func, &this->problem, tol);
+  this->opt.set_xtol_rel(this->xtol_rel);
+  this->opt.set_ftol_rel(this->ftol_rel);
+  this->opt.set_maxeval(this->max_evaluations);
+  if (this->max_time > 0.0) {
+    this->opt.set_maxtime(this->max_time);
+  }
+
+  // optimize, SLSQP may give up on round-off close to the optimum, so the
+  // solution is judged by its defects rather than by the result code
+  struct timespec t_start;
+  tic(&t_start);
+  this->nb_evaluations = 0;
+  try {
+    this->opt.optimize(x, this->cost);
+  } catch (const nlopt::forced_stop &e) {
+    return -3;
+  } catch (const nlopt::roundoff_limited &e) {
+    LOG_INFO("Trajectory optimization limited by round-off");
+  } catch (const std::exception &e) {
+    LOG_ERROR("Trajectory optimization failed [%s]!", e.what());
+    return -2;
+  }
+  this->problem.time_taken = toc(&t_start);
+
+  // check solution
+  std::vector<double> d(m);
+  trajectory_defects(&this->problem, x.data(), d.data());
+  this->violation = 0.0;
+  for (int i = 0; i < m; i++) {
+    this->violation = std::max(this->violation, fabs(d[i]));
+  }
+  std::vector<double> no_grad;
+  this->cost = trajectory_cost_func(x, no_grad, &this->problem);
+  this->solution = x;
+  if (this->violation > this->feasibility_tol) {
+    LOG_ERROR("Trajectory infeasible, largest defect [%f]!", this->violation);
+    return -2;
+  }
 
-  this->opt.add_inequality_constraint(constraint_func, &data[0], 1e-8);
-  this->opt.add_inequality_constraint(constraint_func, &data[1], 1e-8);
-  this->opt.set_xtol_rel(1e-4);
+  return 0;
+}
 
-  // optimize
-  nlopt::result result = this->opt.optimize(x, minf);
-  if (result < 0) {
+int POpt::start(const struct problem_data &p, const std::vector<double> &x) {
+  // pre-check
+  if (this->running) {
     return -1;
   }
+  if (this->thread.joinable()) {
+    this->thread.join();
+  }
 
-  std::cout << "x[0]: " << x[0] << std::endl;
-  std::cout << "x[1]: " << x[1] << std::endl;
-  std::cout << "result: " << minf << std::endl;
+  // start thread
+  this->stop_requested = false;
+  this->running = true;
+  this->thread = std::thread([this, p, x]() {
+    std::vector<double> guess = x;
+    this->retval = this->solve(p, guess);
+    this->running = false;
+  });
 
   return 0;
 }
 
+int POpt::result(std::vector<double> &x) {
+  if (this->thread.joinable()) {
+    this->thread.join();
+  }
+
+  x = this->solution;
+  return this->retval;
+}
+
+void POpt::stop() {
+  this->stop_requested = true;
+  if (this->thread.joinable()) {
+    this->thread.join();
+  }
+  this->stop_requested = false;
+}
+
 } // namespace atl
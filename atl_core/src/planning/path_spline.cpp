@@ -0,0 +1,180 @@
+#include "atl/planning/path_spline.hpp"
+
+namespace atl {
+
+/**
+ * Index of the last value at or before `x` in sorted `values`, clamped so
+ * that the next value exists
+ */
+static int interval_search(const std::vector<double> &values, const double x) {
+  const auto it = std::upper_bound(values.begin(), values.end(), x);
+  const int i = (int) (it - values.begin()) - 1;
+  return std::max(0, std::min(i, (int) values.size() - 2));
+}
+
+int PathSpline::load(const std::vector<Vec3> &waypoints, const int nb_samples) {
+  const int n = waypoints.size();
+
+  // pre-check
+  this->loaded = false;
+  if (n < 2 || nb_samples < 1) {
+    LOG_ERROR("Path needs 2 waypoints and 1 sample per segment!");
+    return -1;
+  }
+
+  // knots at the cumulative chord length
+  std::vector<double> knots = {0.0};
+  for (int i = 1; i < n; i++) {
+    const double h = (waypoints[i] - waypoints[i - 1]).norm();
+    if (h <= 0.0) {
+      LOG_ERROR("Repeated waypoint %d!", i);
+      return -2;
+    }
+    knots.push_back(knots.back() + h);
+  }
+
+  // second derivatives, natural end conditions M_0 = M_n-1 = 0, solved
+  // with the Thomas algorithm
+  std::vector<Vec3> M(n, Vec3::Zero());
+  std::vector<double> c(n, 0.0);
+  std::vector<Vec3> d(n, Vec3::Zero());
+  for (int i = 1; i + 1 < n; i++) {
+    const double h0 = knots[i] - knots[i - 1];
+    const double h1 = knots[i + 1] - knots[i];
+    const Vec3 rhs = 6.0 * ((waypoints[i + 1] - waypoints[i]) / h1 -
+                            (waypoints[i] - waypoints[i - 1]) / h0);
+    const double b = 2.0 * (h0 + h1) - h0 * c[i - 1];
+    c[i] = h1 / b;
+    d[i] = (rhs - h0 * d[i - 1]) / b;
+  }
+  for (int i = n - 2; i >= 1; i--) {
+    M[i] = d[i] - c[i] * M[i + 1];
+  }
+
+  this->nb_samples = nb_samples;
+  this->waypoints = waypoints;
+  this->knots = knots;
+  this->second_derivs = M;
+
+  // arc length lookup table, the chord length between samples
+  this->lut_s.clear();
+  this->lut_t.clear();
+  this->lut_p.clear();
+  for (int i = 0; i + 1 < n; i++) {
+    for (int j = 0; j < nb_samples; j++) {
+      const double mu = (double) j / nb_samples;
+      this->lut_t.push_back(knots[i] + mu * (knots[i + 1] - knots[i]));
+    }
+  }
+  this->lut_t.push_back(knots.back());
+  for (const double t : this->lut_t) {
+    const Vec3 p = this->evaluate(t);
+    if (this->lut_p.empty()) {
+      this->lut_s.push_back(0.0);
+    } else {
+      const double ds = (p - this->lut_p.back()).norm();
+      this->lut_s.push_back(this->lut_s.back() + ds);
+    }
+    this->lut_p.push_back(p);
+  }
+  this->length = this->lut_s.back();
+
+  this->loaded = true;
+  return 0;
+}
+
+Vec3 PathSpline::evaluate(const double t, const int k) const {
+  // segment containing t
+  const int i = interval_search(this->knots, t);
+
+  const double t0 = this->knots[i];
+  const double h = this->knots[i + 1] - t0;
+  const double ts = std::max(t0, std::min(t, this->knots[i + 1]));
+  const double b = (ts - t0) / h;
+  const double a = 1.0 - b;
+  const Vec3 &P0 = this->waypoints[i];
+  const Vec3 &P1 = this->waypoints[i + 1];
+  const Vec3 &M0 = this->second_derivs[i];
+  const Vec3 &M1 = this->second_derivs[i + 1];
+
+  switch (k) {
+    case 0:
+      return a * P0 + b * P1 +
+             ((a * a * a - a) * M0 + (b * b * b - b) * M1) * h * h / 6.0;
+    case 1:
+      return (P1 - P0) / h - (3.0 * a * a - 1.0) / 6.0 * h * M0 +
+             (3.0 * b * b - 1.0) / 6.0 * h * M1;
+    default: return a * M0 + b * M1;
+  }
+}
+
+double PathSpline::param(const double s) const {
+  // lookup table entry before s
+  const int j = interval_search(this->lut_s, s);
+
+  // interpolate the spline parameter
+  const double ds = this->lut_s[j + 1] - this->lut_s[j];
+  double mu = (ds > 0.0) ? (s - this->lut_s[j]) / ds : 0.0;
+  mu = std::max(0.0, std::min(mu, 1.0));
+  return this->lut_t[j] + mu * (this->lut_t[j + 1] - this->lut_t[j]);
+}
+
+Vec3 PathSpline::point(const double s) const {
+  return this->evaluate(this->param(s));
+}
+
+Vec3 PathSpline::tangent(const double s) const {
+  return this->evaluate(this->param(s), 1).normalized();
+}
+
+double PathSpline::curvature(const double s) const {
+  const double t = this->param(s);
+  const Vec3 d1 = this->evaluate(t, 1);
+  const Vec3 d2 = this->evaluate(t, 2);
+  return d1.cross(d2).norm() / pow(d1.norm(), 3);
+}
+
+int PathSpline::segment(const double s) const {
+  return interval_search(this->knots, this->param(s));
+}
+
+double PathSpline::closestPoint(const Vec3 &position,
+                                const double s_hint,
+                                const double window,
+                                Vec3 &closest) const {
+  // pre-check
+  if (this->loaded == false) {
+    return -1.0;
+  }
+
+  // lookup table entries to search
+  const int last = (int) this->lut_s.size() - 1;
+  int lo = 0;
+  int hi = last;
+  if (s_hint >= 0.0) {
+    lo = interval_search(this->lut_s, s_hint - window);
+    hi = interval_search(this->lut_s, s_hint + window) + 1;
+  }
+
+  // project onto the chords between the entries
+  double best = DBL_MAX;
+  double s_best = 0.0;
+  for (int j = lo; j < hi; j++) {
+    const Vec3 &a = this->lut_p[j];
+    const Vec3 ab = this->lut_p[j + 1] - a;
+    const double length2 = ab.squaredNorm();
+    double mu = (length2 > 0.0) ? (position - a).dot(ab) / length2 : 0.0;
+    mu = std::max(0.0, std::min(mu, 1.0));
+
+    const double dist = (a + mu * ab - position).squaredNorm();
+    if (dist < best) {
+      best = dist;
+      s_best = this->lut_s[j] + mu * (this->lut_s[j + 1] - this->lut_s[j]);
+    }
+  }
+
+  closest = this->point(s_best);
+  return s_best;
+}
+
+} // namespace atl
@@ -49,16 +49,25 @@ void trajectory_setup(struct problem_data *p,
 
   p->desired.resize(nb_states + nb_inputs, nb_steps);
   p->cost_weights = cost_weights;
+
+  p->dt = 0.1;
+  p->g = 9.81;
+  p->cdx = 0.0;
+  p->cdz = 0.0;
+
+  p->thrust_min = 0.0;
+  p->thrust_max = 20.0;
+  p->theta_max = deg2rad(60.0);
+  p->z_min = 0.0;
+  p->vz_min = -HUGE_VAL;
 }
 
 int trajectory_calculate_desired(struct problem_data *p) {
-  double dx;
   VecX x(6);
-  double m, c;
 
-  // calculate line equation, gradient and intersect
-  m = (p->pos_init(1) - p->pos_final(1)) / (p->pos_init(0) - p->pos_final(0));
-  c = p->pos_init(1) - m * p->pos_init(0);
+  // average velocity along the straight line path
+  const double duration = (p->nb_steps - 1) * p->dt;
+  const Vec2 vel = (p->pos_final - p->pos_init) / duration;
 
   // push initial x
   x(0) = p->pos_init(0); // state - x
@@ -69,19 +78,19 @@ int trajectory_calculate_desired(struct problem_data *p) {
   x(5) = p->theta_init;  // input - w
   p->desired.block(0, 0, 6, 1) = x;
 
-  // create points along the desired line path
-  dx = (p->pos_final(0) - p->pos_init(0)) / (double) (p->nb_steps - 1);
-  for (int i = 0; i < (p->nb_steps - 2); i++) {
-    x = p->desired.block(0, i, 6, 1);
+  // create points along the desired line path, vertical lines included
+  for (int i = 1; i < (p->nb_steps - 1); i++) {
+    const double s = (double) i / (double) (p->nb_steps - 1);
+    const Vec2 pos = p->pos_init + s * (p->pos_final - p->pos_init);
 
-    x(0) += dx;            // state - x
-    x(1) = p->vel_init(0); // state - vx
-    x(2) = m * x(0) + c;   // state - z
-    x(3) = p->vel_init(1); // state - vz
+    x(0) = pos(0);         // state - x
+    x(1) = vel(0);         // state - vx
+    x(2) = pos(1);         // state - z
+    x(3) = vel(1);         // state - vz
     x(4) = p->thrust_init; // input - az
     x(5) = p->theta_init;  // input - w
 
-    p->desired.block(0, i + 1, 6, 1) = x;
+    p->desired.block(0, i, 6, 1) = x;
   }
 
   // push final x
@@ -96,74 +105,338 @@ int trajectory_calculate_desired(struct problem_data *p) {
   return 0;
 }
 
-// double trajectory_cost_func(const std::vector<double> &x,
-//                             std::vector<double> &grad,
-//                             void *data) {
-//   double cost;
-//   struct problem_data *p;
-//   MatX X;
-//   VecX g;
-//   VecX x_opt, x_des;
-//   VecX z_opt, z_des;
-//   VecX u1_opt, u2_opt;
-//
-//   // setup
-//   cost = 0.0;
-//   p = (struct problem_data *) data;
-//   load_matrix(x, p->nb_states + p->nb_inputs, p->nb_steps, X);
-//   g = 9.81 * MatX::Ones(p->nb_steps, 1);
-//
-//   // position error cost
-//   x_opt = X.row(0);
-//   x_des = p->desired.row(0);
-//   cost += p->cost_weights[0] * (x_opt - x_des).norm();
-//
-//   z_opt = X.row(2);
-//   z_des = p->desired.row(2);
-//   cost += p->cost_weights[1] * (z_opt - z_des).norm();
-//
-//   // control input cost
-//   u1_opt = X.row(4);
-//   u2_opt = X.row(5);
-//   cost += p->cost_weights[2] * (u1_opt - g).squaredNorm();
-//   cost += p->cost_weights[3] * u2_opt.squaredNorm();
-//
-//   return cost;
-// }
-
-// double trajectory_constraint_func(const std::vector<double> &x,
-//                                   std::vector<double> &grad,
-//                                   void *data) {
-//   struct problem_data *p;
-//   double error, dt;
-//   MatX X;
-//   Vec4 x_curr, x_prev, x_dot;
-//   Vec2 u_prev;
-//
-//   // setup
-//   error = 0.0;
-//   dt = 0.1;
-//   p = (struct problem_data *) data;
-//   load_matrix(x, p->nb_states + p->nb_inputs, p->nb_steps, X);
-//
-//   for (int i = 0; i < (p->nb_steps - 1); i++) {
-//     u_prev = X.block(4, i, 2, 1);
-//     x_prev = X.block(0, i, 4, 1);
-//     x_curr = X.block(0, i + 1, 4, 1);
-//
-//     // clang-format off
-//     x_dot << x_prev(1),
-//              u_prev(0) * sin(u_prev(1)),
-//              x_prev(3),
-//              u_prev(0) * cos(u_prev(1));
-//     // clang-format on
-//
-//     // calculate feasible regions
-//     error += ((x_curr - x_prev) - dt * x_dot).sum();
-//   }
-//
-//   return error;
-// }
+int trajectory_landing_setup(struct problem_data *p,
+                             double z,
+                             double v,
+                             double dt,
+                             double vz) {
+  // pre-check
+  if (z <= 0.0 || dt <= 0.0 || vz >= 0.0) {
+    LOG_ERROR("Invalid landing problem!");
+    return -1;
+  }
+
+  // same weights, drag and bounds as the python planner
+  std::vector<double> cost_weights = {0.1, 0.1, 0.05, 1.0, 1.0, 10.0};
+  const int nb_steps = std::max(3, (int) round(z / -vz / dt) + 1);
+  trajectory_setup(p, 4, 2, nb_steps, cost_weights);
+  p->dt = dt;
+  p->cdx = 0.2;
+  p->vz_min = 1.2 * vz;
+
+  // start level at the target velocity, end on the target hovering
+  const double duration = (nb_steps - 1) * dt;
+  p->pos_init << 0.0, z;
+  p->pos_final << v * duration, 0.0;
+  p->vel_init << v, 0.0;
+  p->vel_final << v, 0.0;
+  p->thrust_init = p->g;
+  p->thrust_final = p->g;
+  p->theta_init = 0.0;
+  p->theta_final = 0.0;
+
+  return trajectory_calculate_desired(p);
+}
+
+int trajectory_nb_variables(const struct problem_data *p) {
+  return 6 * p->nb_steps;
+}
+
+int trajectory_nb_constraints(const struct problem_data *p) {
+  return 4 * (p->nb_steps - 1);
+}
+
+/**
+ * Cost weight `i`, zero if not given
+ */
+static double trajectory_weight(const struct problem_data *p, const size_t i) {
+  return (i < p->cost_weights.size()) ? p->cost_weights[i] : 0.0;
+}
+
+double trajectory_cost_func(const std::vector<double> &x,
+                            std::vector<double> &grad,
+                            void *data) {
+  const struct problem_data *p = (const struct problem_data *) data;
+  const MatX &D = p->desired;
+  const double w_x = trajectory_weight(p, 0);
+  const double w_z = trajectory_weight(p, 1);
+  const double w_az = trajectory_weight(p, 2);
+  const double w_theta = trajectory_weight(p, 3);
+  const double w_daz = trajectory_weight(p, 4);
+  const double w_dtheta = trajectory_weight(p, 5);
+
+  if (grad.empty() == false) {
+    std::fill(grad.begin(), grad.end(), 0.0);
+  }
+
+  double cost = 0.0;
+  for (int k = 0; k < p->nb_steps; k++) {
+    const double *s = &x[6 * k];
+
+    // position error and control input cost
+    const double ex = s[0] - D(0, k);
+    const double ez = s[2] - D(2, k);
+    const double eaz = s[4] - p->g;
+    cost += w_x * ex * ex + w_z * ez * ez;
+    cost += w_az * eaz * eaz + w_theta * s[5] * s[5];
+    if (grad.empty() == false) {
+      grad[6 * k + 0] += 2.0 * w_x * ex;
+      grad[6 * k + 2] += 2.0 * w_z * ez;
+      grad[6 * k + 4] += 2.0 * w_az * eaz;
+      grad[6 * k + 5] += 2.0 * w_theta * s[5];
+    }
+
+    // control input difference cost
+    if (k + 1 == p->nb_steps) {
+      continue;
+    }
+    const double daz = s[10] - s[4];
+    const double dtheta = s[11] - s[5];
+    cost += w_daz * daz * daz + w_dtheta * dtheta * dtheta;
+    if (grad.empty() == false) {
+      grad[6 * k + 4] -= 2.0 * w_daz * daz;
+      grad[6 * k + 10] += 2.0 * w_daz * daz;
+      grad[6 * k + 5] -= 2.0 * w_dtheta * dtheta;
+      grad[6 * k + 11] += 2.0 * w_dtheta * dtheta;
+    }
+  }
+
+  return cost;
+}
+
+double trajectory_constraint_func(const std::vector<double> &x,
+                                  std::vector<double> &grad,
+                                  void *data) {
+  const struct problem_data *p = (const struct problem_data *) data;
+  std::vector<double> d(trajectory_nb_constraints(p));
+  trajectory_defects(p, x.data(), d.data());
+
+  // squared defects, summing the signed ones would let violations cancel
+  double error = 0.0;
+  for (size_t i = 0; i < d.size(); i++) {
+    error += d[i] * d[i];
+  }
+
+  // gradient, 2 J^T d
+  if (grad.empty() == false) {
+    std::vector<int> rows, cols;
+    std::vector<double> values;
+    trajectory_constraint_structure(p, rows, cols);
+    trajectory_constraint_jacobian(p, x.data(), values);
+    std::fill(grad.begin(), grad.end(), 0.0);
+    for (size_t i = 0; i < values.size(); i++) {
+      grad[cols[i]] += 2.0 * d[rows[i]] * values[i];
+    }
+  }
+
+  return error;
+}
+
+void trajectory_constraints_func(unsigned m,
+                                 double *result,
+                                 unsigned n,
+                                 const double *x,
+                                 double *grad,
+                                 void *data) {
+  const struct problem_data *p = (const struct problem_data *) data;
+  trajectory_defects(p, x, result);
+
+  // scatter the sparse jacobian into the dense one nlopt expects
+  if (grad != nullptr) {
+    std::vector<int> rows, cols;
+    std::vector<double> values;
+    trajectory_constraint_structure(p, rows, cols);
+    trajectory_constraint_jacobian(p, x, values);
+    std::fill(grad, grad + m * n, 0.0);
+    for (size_t i = 0; i < values.size(); i++) {
+      grad[rows[i] * n + cols[i]] = values[i];
+    }
+  }
+}
+
+/**
+ * Continuous dynamics `f` of a step `s = [x, vx, z, vz, az, theta]`
+ */
+static void trajectory_dynamics(const struct problem_data *p,
+                                const double *s,
+                                double *f) {
+  f[0] = s[1];
+  f[1] = s[4] * sin(s[5]) - p->cdx * s[1];
+  f[2] = s[3];
+  f[3] = s[4] * cos(s[5]) - p->g - p->cdz * s[3];
+}
+
+void trajectory_defects(const struct problem_data *p,
+                        const double *x,
+                        double *d) {
+  const double h = 0.5 * p->dt;
+  double f_a[4];
+  double f_b[4];
+
+  trajectory_dynamics(p, &x[0], f_b);
+  for (int k = 0; k < (p->nb_steps - 1); k++) {
+    const double *s_a = &x[6 * k];
+    const double *s_b = &x[6 * (k + 1)];
+    std::copy(f_b, f_b + 4, f_a);
+    trajectory_dynamics(p, s_b, f_b);
+
+    for (int i = 0; i < 4; i++) {
+      d[4 * k + i] = s_b[i] - s_a[i] - h * (f_a[i] + f_b[i]);
+    }
+  }
+}
+
+/**
+ * Constraint jacobian non-zeros, only their `(row, col)` if `x` is null
+ */
+static void trajectory_jacobian(const struct problem_data *p,
+                                const double *x,
+                                std::vector<int> *rows,
+                                std::vector<int> *cols,
+                                std::vector<double> *values) {
+  const double h = 0.5 * p->dt;
+  const int nb_nonzeros = 20 * (p->nb_steps - 1);
+  if (rows != nullptr) {
+    rows->clear();
+    cols->clear();
+    rows->reserve(nb_nonzeros);
+    cols->reserve(nb_nonzeros);
+  }
+  if (values != nullptr) {
+    values->clear();
+    values->reserve(nb_nonzeros);
+  }
+
+  auto add = [&](const int row, const int col, const double value) {
+    if (rows != nullptr) {
+      rows->push_back(row);
+      cols->push_back(col);
+    }
+    if (values != nullptr) {
+      values->push_back(value);
+    }
+  };
+
+  for (int k = 0; k < (p->nb_steps - 1); k++) {
+    const int r = 4 * k;
+    const int a = 6 * k;
+    const int b = 6 * (k + 1);
+    const double az_a = (x != nullptr) ? x[a + 4] : 0.0;
+    const double az_b = (x != nullptr) ? x[b + 4] : 0.0;
+    const double theta_a = (x != nullptr) ? x[a + 5] : 0.0;
+    const double theta_b = (x != nullptr) ? x[b + 5] : 0.0;
+
+    // x
+    add(r + 0, a + 0, -1.0);
+    add(r + 0, a + 1, -h);
+    add(r + 0, b + 0, 1.0);
+    add(r + 0, b + 1, -h);
+
+    // vx
+    add(r + 1, a + 1, -1.0 + h * p->cdx);
+    add(r + 1, a + 4, -h * sin(theta_a));
+    add(r + 1, a + 5, -h * az_a * cos(theta_a));
+    add(r + 1, b + 1, 1.0 + h * p->cdx);
+    add(r + 1, b + 4, -h * sin(theta_b));
+    add(r + 1, b + 5, -h * az_b * cos(theta_b));
+
+    // z
+    add(r + 2, a + 2, -1.0);
+    add(r + 2, a + 3, -h);
+    add(r + 2, b + 2, 1.0);
+    add(r + 2, b + 3, -h);
+
+    // vz
+    add(r + 3, a + 3, -1.0 + h * p->cdz);
+    add(r + 3, a + 4, -h * cos(theta_a));
+    add(r + 3, a + 5, h * az_a * sin(theta_a));
+    add(r + 3, b + 3, 1.0 + h * p->cdz);
+    add(r + 3, b + 4, -h * cos(theta_b));
+    add(r + 3, b + 5, h * az_b * sin(theta_b));
+  }
+}
+
+void trajectory_constraint_structure(const struct problem_data *p,
+                                     std::vector<int> &rows,
+                                     std::vector<int> &cols) {
+  trajectory_jacobian(p, nullptr, &rows, &cols, nullptr);
+}
+
+void trajectory_constraint_jacobian(const struct problem_data *p,
+                                    const double *x,
+                                    std::vector<double> &values) {
+  trajectory_jacobian(p, x, nullptr, nullptr, &values);
+}
+
+void trajectory_bounds(const struct problem_data *p,
+                       std::vector<double> &lb,
+                       std::vector<double> &ub) {
+  const int n = trajectory_nb_variables(p);
+  lb.assign(n, -HUGE_VAL);
+  ub.assign(n, HUGE_VAL);
+
+  // free steps
+  for (int k = 1; k < (p->nb_steps - 1); k++) {
+    lb[6 * k + 2] = p->z_min;
+    lb[6 * k + 3] = p->vz_min;
+    lb[6 * k + 4] = p->thrust_min;
+    ub[6 * k + 4] = p->thrust_max;
+    lb[6 * k + 5] = -p->theta_max;
+    ub[6 * k + 5] = p->theta_max;
+  }
+
+  // fixed first and last steps
+  for (int i = 0; i < 6; i++) {
+    lb[i] = ub[i] = p->desired(i, 0);
+    lb[n - 6 + i] = ub[n - 6 + i] = p->desired(i, p->nb_steps - 1);
+  }
+}
+
+void trajectory_warm_start(const struct problem_data *p,
+                           std::vector<double> &x) {
+  std::vector<double> lb, ub;
+  trajectory_bounds(p, lb, ub);
+
+  x.clear();
+  load_matrix(p->desired, x);
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = std::max(lb[i], std::min(x[i], ub[i]));
+  }
+}
+
+int trajectory_save(const std::string &file_path,
+                    const struct problem_data *p,
+                    const std::vector<double> &x) {
+  std::ofstream output_file(file_path);
+  if (output_file.good() == false) {
+    LOG_ERROR("Failed to open [%s]!", file_path.c_str());
+    return -1;
+  }
+
+  // header
+  output_file << "x,vx,z,vz,thrust,theta,rel_x,rel_z,rel_vx,rel_vz\n";
+
+  // record, the target is met at the last step
+  output_file << std::setprecision(10);
+  for (int k = 0; k < p->nb_steps; k++) {
+    const double *s = &x[6 * k];
+    const double t_left = (p->nb_steps - 1 - k) * p->dt;
+    const Vec2 target = p->pos_final - p->vel_final * t_left;
+
+    output_file << s[0] << ",";                   // x
+    output_file << s[1] << ",";                   // vx
+    output_file << s[2] << ",";                   // z
+    output_file << s[3] << ",";                   // vz
+    output_file << s[4] / p->thrust_max << ",";   // thrust
+    output_file << s[5] << ",";                   // theta
+    output_file << target(0) - s[0] << ",";       // rel_x
+    output_file << target(1) - s[2] << ",";       // rel_z
+    output_file << p->vel_final(0) - s[1] << ",";  // rel_vx
+    output_file << p->vel_final(1) - s[3] << "\n"; // rel_vz
+  }
+
+  return 0;
+}
 
 int trajectory_record_optimization(std::string file_path,
                                    std::vector<double> x,
@@ -16,13 +16,13 @@ std::vector<Eigen::Vector2d> bezier_cubic_curve(Eigen::Vector2d p0,
 
   // calculate bezier points
   for (int i = 1; i < segment_count + 1; i++) {
+    t = i / (double) segment_count;
     double u = 1 - t;
     double tt = t * t;
     double uu = u * u;
     double uuu = uu * u;
     double ttt = tt * t;
 
-    t = i / (double) segment_count;
     p << 0.0, 0.0;
 
     // first term
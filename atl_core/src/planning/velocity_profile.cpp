@@ -0,0 +1,206 @@
+#include "atl/planning/velocity_profile.hpp"
+
+namespace atl {
+
+/**
+ * Accelerate along the grid from `v[first]` under the caps already in `v`,
+ * backwards from the last point when `forward` is false
+ */
+static void profile_pass(std::vector<double> &v,
+                         const double ds,
+                         const double a_max,
+                         const bool forward) {
+  const int n = v.size();
+  for (int k = 0; k + 1 < n; k++) {
+    const int i = forward ? k : n - 1 - k;
+    const int next = forward ? i + 1 : i - 1;
+    v[next] = std::min(v[next], sqrt(v[i] * v[i] + 2.0 * a_max * ds));
+  }
+}
+
+/**
+ * Motion along the grid in time, constant acceleration between the grid
+ * points and constant speed before the first and after the last point
+ */
+struct ProfileMotion {
+  std::vector<double> t; // time at the grid points
+  std::vector<double> p; // integral of the arc length up to the grid points
+  std::vector<double> v;
+  double ds = 0.0;
+
+  ProfileMotion(const std::vector<double> &v, const double ds) : v(v), ds(ds) {
+    const int n = v.size();
+    this->t.resize(n, 0.0);
+    this->p.resize(n, 0.0);
+    for (int i = 0; i + 1 < n; i++) {
+      const double dt = 2.0 * ds / (v[i] + v[i + 1]);
+      const double a = (v[i + 1] - v[i]) / dt;
+      this->t[i + 1] = this->t[i] + dt;
+      this->p[i + 1] = this->p[i] + i * ds * dt + v[i] * dt * dt / 2.0 +
+                       a * dt * dt * dt / 6.0;
+    }
+  }
+
+  /**
+   * Arc length `s` and its integral `p` at time `t`
+   */
+  void evaluate(const double t, double &s, double &p) const {
+    const int n = this->v.size();
+    if (t <= 0.0) {
+      s = this->v[0] * t;
+      p = this->v[0] * t * t / 2.0;
+      return;
+    } else if (t >= this->t[n - 1]) {
+      const double tau = t - this->t[n - 1];
+      const double length = (n - 1) * this->ds;
+      s = length + this->v[n - 1] * tau;
+      p = this->p[n - 1] + length * tau + this->v[n - 1] * tau * tau / 2.0;
+      return;
+    }
+
+    const auto it = std::upper_bound(this->t.begin(), this->t.end(), t);
+    const int i = (it - this->t.begin()) - 1;
+    const double tau = t - this->t[i];
+    const double dt = this->t[i + 1] - this->t[i];
+    const double a = (this->v[i + 1] - this->v[i]) / dt;
+    s = i * this->ds + this->v[i] * tau + a * tau * tau / 2.0;
+    p = this->p[i] + i * this->ds * tau + this->v[i] * tau * tau / 2.0 +
+        a * tau * tau * tau / 6.0;
+  }
+
+  /**
+   * Arc length and speed of the motion averaged over `[t - T / 2, t + T /
+   * 2]`
+   */
+  void average(const double t, const double T, double &s, double &v) const {
+    double s0, p0, s1, p1;
+    this->evaluate(t - T / 2.0, s0, p0);
+    this->evaluate(t + T / 2.0, s1, p1);
+    s = (p1 - p0) / T;
+    v = (s1 - s0) / T;
+  }
+};
+
+/**
+ * Limit the jerk of the profile to `j_max`
+ *
+ * Averages the speed of the motion over a moving window of `T = 2 a_max /
+ * j_max` in time. The averaged acceleration is the difference of two
+ * accelerations within `a_max` over `T`, so its rate of change is at most
+ * `j_max`, and it is itself an average so it stays within `a_max`. The
+ * averaged motion is sampled back onto the grid, where it reaches the grid
+ * point `s` at the time its arc length is `s`.
+ */
+static void profile_smooth(std::vector<double> &v,
+                           const double ds,
+                           const double T) {
+  const ProfileMotion motion(v, ds);
+  const int n = v.size();
+  const double t_end = motion.t[n - 1];
+
+  for (int k = 1; k + 1 < n; k++) {
+    // bisect the time the averaged arc length reaches the grid point
+    double t_lo = -T / 2.0;
+    double t_hi = t_end + T / 2.0;
+    double s_k, v_k = 0.0;
+    for (int iter = 0; iter < 64; iter++) {
+      const double t = (t_lo + t_hi) / 2.0;
+      motion.average(t, T, s_k, v_k);
+      if (s_k < k * ds) {
+        t_lo = t;
+      } else {
+        t_hi = t;
+      }
+    }
+    v[k] = v_k;
+  }
+}
+
+int VelocityProfile::generate(const PathSpline &path) {
+  // pre-check
+  this->loaded = false;
+  if (path.loaded == false) {
+    return -1;
+  } else if (this->v_max <= 0.0 || this->a_max <= 0.0 || this->j_max <= 0.0) {
+    LOG_ERROR("Invalid velocity, acceleration or jerk limit!");
+    return -2;
+  } else if (this->a_lat_max <= 0.0 || this->ds <= 0.0) {
+    LOG_ERROR("Invalid lateral acceleration limit or grid spacing!");
+    return -2;
+  }
+
+  // uniform grid over the path
+  const int nb_points = std::max(2, (int) ceil(path.length / this->ds) + 1);
+  const double ds = path.length / (nb_points - 1);
+
+  // speed limit and lateral acceleration cap
+  std::vector<double> caps(nb_points);
+  for (int i = 0; i < nb_points; i++) {
+    const double kappa = path.curvature(i * ds);
+    caps[i] = this->v_max;
+    if (kappa * this->v_max * this->v_max > this->a_lat_max) {
+      caps[i] = sqrt(this->a_lat_max / kappa);
+    }
+  }
+
+  // the jerk limit averages the speed over the window T, which covers at
+  // most `v_max T` of arc length, so every cap is lowered to the lowest cap
+  // within that distance. A start or end speed is held over it, so the
+  // averaged speed still starts and ends there.
+  const double T = 2.0 * this->a_max / this->j_max;
+  const int w = (int) ceil(this->v_max * T / ds);
+  const double v_start = std::min(caps.front(), std::max(0.0, this->v_start));
+  const double v_end = std::min(caps.back(), std::max(0.0, this->v_end));
+  std::vector<double> v(nb_points);
+  for (int i = 0; i < nb_points; i++) {
+    const int first = std::max(0, i - w);
+    const int last = std::min(nb_points - 1, i + w);
+    v[i] = *std::min_element(caps.begin() + first, caps.begin() + last + 1);
+    if (v_start > 0.0 && i <= w) {
+      v[i] = std::min(v[i], v_start);
+    }
+    if (v_end > 0.0 && i >= nb_points - 1 - w) {
+      v[i] = std::min(v[i], v_end);
+    }
+  }
+  v.front() = v_start;
+  v.back() = v_end;
+
+  // accelerate forwards, brake backwards, then limit the jerk
+  profile_pass(v, ds, this->a_max, true);
+  profile_pass(v, ds, this->a_max, false);
+  if (v.front() + v[1] > 0.0 && v[nb_points - 2] + v.back() > 0.0) {
+    profile_smooth(v, ds, T);
+  }
+
+  this->length = path.length;
+  this->ds_actual = ds;
+  this->speeds = v;
+  this->loaded = true;
+  return 0;
+}
+
+double VelocityProfile::speed(const double s) const {
+  // pre-check
+  if (this->loaded == false) {
+    return 0.0;
+  }
+
+  // grid point before s
+  const double k = std::max(0.0, std::min(s, this->length)) / this->ds_actual;
+  const int i = std::min((int) k, (int) this->speeds.size() - 2);
+  const double mu = std::min(k - i, 1.0);
+
+  return (1.0 - mu) * this->speeds[i] + mu * this->speeds[i + 1];
+}
+
+double VelocityProfile::duration() const {
+  double t = 0.0;
+  for (size_t i = 0; i + 1 < this->speeds.size(); i++) {
+    const double v = this->speeds[i] + this->speeds[i + 1];
+    t += (v > 0.0) ? 2.0 * this->ds_actual / v : INFINITY;
+  }
+  return t;
+}
+
+} // namespace atl
@@ -0,0 +1,366 @@
+#include "atl/quadrotor/control_executor.hpp"
+
+namespace atl {
+
+#define NSEC_PER_SEC 1000000000LL
+
+static int64_t timespec2ns(const struct timespec &t) {
+  return t.tv_sec * NSEC_PER_SEC + t.tv_nsec;
+}
+
+static struct timespec ns2timespec(const int64_t ns) {
+  struct timespec t;
+  t.tv_sec = ns / NSEC_PER_SEC;
+  t.tv_nsec = ns % NSEC_PER_SEC;
+  return t;
+}
+
+static int64_t monotonic_ns() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return timespec2ns(t);
+}
+
+void TimingHistogram::reset() {
+  for (int i = 0; i < EXECUTOR_HISTOGRAM_BINS; i++) {
+    this->counts[i] = 0;
+  }
+  this->nb_samples = 0;
+  this->max_ns = 0;
+}
+
+void TimingHistogram::add(const double t) {
+  int bin = (int) (t / this->bin_width);
+  bin = std::max(0, std::min(bin, EXECUTOR_HISTOGRAM_BINS - 1));
+  this->counts[bin].fetch_add(1, std::memory_order_relaxed);
+  this->nb_samples.fetch_add(1, std::memory_order_relaxed);
+
+  // only the executor thread adds samples
+  const uint64_t ns = (t > 0.0) ? (uint64_t) (t * 1e9) : 0;
+  if (ns > this->max_ns.load(std::memory_order_relaxed)) {
+    this->max_ns.store(ns, std::memory_order_relaxed);
+  }
+}
+
+double TimingHistogram::percentile(const double p) const {
+  const uint64_t nb_samples = this->nb_samples.load();
+  if (nb_samples == 0) {
+    return 0.0;
+  }
+
+  const double target = p * nb_samples;
+  uint64_t count = 0;
+  for (int i = 0; i < EXECUTOR_HISTOGRAM_BINS; i++) {
+    count += this->counts[i].load(std::memory_order_relaxed);
+    if (count >= target) {
+      return (i + 1) * this->bin_width;
+    }
+  }
+
+  return EXECUTOR_HISTOGRAM_BINS * this->bin_width;
+}
+
+double TimingHistogram::max() const { return this->max_ns.load() * 1e-9; }
+
+int ControlExecutor::configure(const std::string &config_file) {
+  ConfigParser parser;
+
+  // load config
+  parser.addParam("rate", &this->rate);
+  parser.addParam("realtime", &this->realtime, true);
+  parser.addParam("priority", &this->priority, true);
+  parser.addParam("cpu", &this->cpu, true);
+  parser.addParam("jitter_bin_width", &this->jitter.bin_width, true);
+  parser.addParam("execution_bin_width", &this->execution.bin_width, true);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+
+  // check rate
+  if (this->rate <= 0.0) {
+    LOG_ERROR("Invalid control executor rate [%f]!", this->rate);
+    return -2;
+  }
+
+  this->configured = true;
+  return 0;
+}
+
+int ControlExecutor::start(Quadrotor &quadrotor) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  } else if (quadrotor.configured == false) {
+    return -2;
+  } else if (this->running) {
+    return -3;
+  }
+
+  // start thread
+  this->quadrotor = &quadrotor;
+  this->mode = quadrotor.current_mode;
+  this->running = true;
+  this->thread = std::thread(&ControlExecutor::loop, this);
+
+  // real-time scheduling
+  if (this->realtime) {
+    struct sched_param param;
+    param.sched_priority = this->priority;
+    const pthread_t handle = this->thread.native_handle();
+    if (pthread_setschedparam(handle, SCHED_FIFO, &param) != 0) {
+      LOG_ERROR("Failed to set SCHED_FIFO, using default scheduling!");
+    }
+  }
+
+  // cpu affinity
+  if (this->cpu >= 0) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(this->cpu, &cpuset);
+    const pthread_t handle = this->thread.native_handle();
+    if (pthread_setaffinity_np(handle, sizeof(cpuset), &cpuset) != 0) {
+      LOG_ERROR("Failed to pin control executor to cpu [%d]!", this->cpu);
+    }
+  }
+
+  return 0;
+}
+
+void ControlExecutor::stop() {
+  this->running = false;
+  if (this->thread.joinable()) {
+    this->thread.join();
+  }
+}
+
+int ControlExecutor::post(const ControlCommand &command) {
+  if (this->commands.push(command) == false) {
+    LOG_ERROR("Control command queue full, command dropped!");
+    return -1;
+  }
+
+  return 0;
+}
+
+int ControlExecutor::setMode(const enum Mode mode) {
+  // pre-check
+  if (this->quadrotor == nullptr || this->quadrotor->configured == false) {
+    return -1;
+  } else if (mode < DISARM_MODE || mode > OFFBOARD_MODE) {
+    LOG_ERROR(EINVMODE);
+    return -2;
+  }
+
+  // post
+  ControlCommand command;
+  command.type = COMMAND_SET_MODE;
+  command.mode = mode;
+  return (this->post(command) == 0) ? 0 : -3;
+}
+
+int ControlExecutor::setYaw(const double yaw) {
+  ControlCommand command;
+  command.type = COMMAND_SET_YAW;
+  command.values[0] = yaw;
+  return this->post(command);
+}
+
+int ControlExecutor::setHomePoint(const double latitude,
+                                  const double longitude) {
+  ControlCommand command;
+  command.type = COMMAND_SET_HOME_POINT;
+  command.values[0] = latitude;
+  command.values[1] = longitude;
+  return this->post(command);
+}
+
+int ControlExecutor::setHoverPosition(const Vec3 &position) {
+  ControlCommand command;
+  command.type = COMMAND_SET_HOVER_POSITION;
+  Eigen::Map<Vec3>(command.values) = position;
+  return this->post(command);
+}
+
+int ControlExecutor::setHoverHeight(const double height) {
+  ControlCommand command;
+  command.type = COMMAND_SET_HOVER_HEIGHT;
+  command.values[0] = height;
+  return this->post(command);
+}
+
+int ControlExecutor::setOffboardSetpoint(const Vec3 &position,
+                                         const Vec3 &velocity,
+                                         const Vec3 &acceleration) {
+  ControlCommand command;
+  command.type = COMMAND_SET_OFFBOARD_SETPOINT;
+  Eigen::Map<Vec3>(command.values) = position;
+  Eigen::Map<Vec3>(command.values + 3) = velocity;
+  Eigen::Map<Vec3>(command.values + 6) = acceleration;
+  return this->post(command);
+}
+
+int ControlExecutor::setPositionGains(const ControllerGains &gains) {
+  ControlCommand command;
+  command.type = COMMAND_SET_POSITION_GAINS;
+  command.gains = gains;
+  return this->post(command);
+}
+
+int ControlExecutor::setTrackingGains(const ControllerGains &gains) {
+  ControlCommand command;
+  command.type = COMMAND_SET_TRACKING_GAINS;
+  command.gains = gains;
+  return this->post(command);
+}
+
+int ControlExecutor::reset() {
+  ControlCommand command;
+  command.type = COMMAND_RESET;
+  return this->post(command);
+}
+
+/**
+ * Set the gains of a position or tracking controller
+ */
+template <typename Controller>
+static void set_gains(const ControllerGains &gains, Controller &controller) {
+  for (int i = 0; i < 3; i++) {
+    controller.pid.k_p(i) = gains.k_p[i];
+    controller.pid.k_i(i) = gains.k_i[i];
+    controller.pid.k_d(i) = gains.k_d[i];
+  }
+  controller.roll_limit[0] = gains.roll_limit[0];
+  controller.roll_limit[1] = gains.roll_limit[1];
+  controller.pitch_limit[0] = gains.pitch_limit[0];
+  controller.pitch_limit[1] = gains.pitch_limit[1];
+  controller.hover_throttle = gains.hover_throttle;
+}
+
+int ControlExecutor::apply(const ControlCommand &command) {
+  Quadrotor &q = *this->quadrotor;
+  const double *values = command.values;
+
+  switch (command.type) {
+    case COMMAND_SET_MODE: return q.setMode(command.mode);
+    case COMMAND_SET_YAW: return q.setYaw(values[0]);
+    case COMMAND_SET_HOME_POINT: return q.setHomePoint(values[0], values[1]);
+    case COMMAND_SET_HOVER_POSITION:
+      q.hover_position = Vec3{values[0], values[1], values[2]};
+      return 0;
+    case COMMAND_SET_HOVER_HEIGHT: q.hover_position(2) = values[0]; return 0;
+    case COMMAND_SET_OFFBOARD_SETPOINT:
+      return q.setOffboardSetpoint(Vec3{values[0], values[1], values[2]},
+                                   Vec3{values[3], values[4], values[5]},
+                                   Vec3{values[6], values[7], values[8]});
+    case COMMAND_SET_POSITION_GAINS:
+      set_gains(command.gains, q.position_controller);
+      return 0;
+    case COMMAND_SET_TRACKING_GAINS:
+      set_gains(command.gains, q.tracking_controller);
+      for (int i = 0; i < 3; i++) {
+        q.tracking_controller.track_offset(i) = command.gains.track_offset[i];
+      }
+      return 0;
+    case COMMAND_RESET: return q.reset();
+  }
+
+  return -1;
+}
+
+int ControlExecutor::step(const double dt) {
+  ControlCommand command;
+
+  // latest inputs
+  this->state.read(this->snapshot);
+  if (this->snapshot.pose_updated) {
+    this->quadrotor->setPose(this->snapshot.pose);
+  }
+  if (this->snapshot.velocity_updated) {
+    this->quadrotor->setVelocity(this->snapshot.velocity);
+  }
+  if (this->snapshot.target_updated) {
+    const ControlTarget &target = this->snapshot.target;
+    this->quadrotor->setTargetPosition(target.position);
+    this->quadrotor->setTargetVelocity(target.velocity);
+    this->quadrotor->setTargetDetected(target.detected);
+  }
+
+  // commands
+  while (this->commands.pop(command)) {
+    this->apply(command);
+  }
+  this->mode = this->quadrotor->current_mode;
+  if (this->paused) {
+    return 0;
+  }
+
+  // step and publish outputs
+  const int retval = this->quadrotor->step(dt);
+  this->att_cmd.write(this->quadrotor->att_cmd);
+  this->mode = this->quadrotor->current_mode;
+  this->step_retval = retval;
+  this->nb_steps++;
+
+  return retval;
+}
+
+void ControlExecutor::resetStats() {
+  this->jitter.reset();
+  this->execution.reset();
+  this->nb_steps = 0;
+  this->nb_overruns = 0;
+  this->nb_missed = 0;
+}
+
+void ControlExecutor::printStats() {
+  std::cout << "steps: " << this->nb_steps << "\t";
+  std::cout << "overruns: " << this->nb_overruns << "\t";
+  std::cout << "missed: " << this->nb_missed << std::endl;
+
+  std::cout << "jitter [us] ";
+  std::cout << "p50: " << this->jitter.percentile(0.5) * 1e6 << "\t";
+  std::cout << "p99: " << this->jitter.percentile(0.99) * 1e6 << "\t";
+  std::cout << "max: " << this->jitter.max() * 1e6 << std::endl;
+
+  std::cout << "execution [us] ";
+  std::cout << "p50: " << this->execution.percentile(0.5) * 1e6 << "\t";
+  std::cout << "p99: " << this->execution.percentile(0.99) * 1e6 << "\t";
+  std::cout << "max: " << this->execution.max() * 1e6 << std::endl;
+}
+
+void ControlExecutor::loop() {
+  const int64_t period = (int64_t) (NSEC_PER_SEC / this->rate);
+  int64_t deadline = monotonic_ns();
+  int64_t dt = period;
+
+  while (this->running) {
+    // sleep until next deadline
+    deadline += period;
+    const struct timespec t_deadline = ns2timespec(deadline);
+    while (clock_nanosleep(CLOCK_MONOTONIC,
+                           TIMER_ABSTIME,
+                           &t_deadline,
+                           NULL) == EINTR) {
+    }
+
+    // step
+    const int64_t t_start = monotonic_ns();
+    this->step(dt * 1e-9);
+    const int64_t t_end = monotonic_ns();
+    this->jitter.add((t_start - deadline) * 1e-9);
+    this->execution.add((t_end - t_start) * 1e-9);
+
+    // overrun, skip the periods already missed instead of running them
+    // back to back
+    dt = period;
+    if (t_end > deadline + period) {
+      const int64_t nb_missed = (t_end - deadline) / period - 1;
+      this->nb_overruns++;
+      this->nb_missed += nb_missed;
+      deadline += nb_missed * period;
+      dt += nb_missed * period;
+    }
+  }
+}
+
+} // namespace atl
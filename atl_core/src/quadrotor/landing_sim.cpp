@@ -0,0 +1,430 @@
+#include "atl/quadrotor/landing_sim.hpp"
+
+namespace atl {
+
+int LandingSim::configure(const std::string &config_file) {
+  ConfigParser parser;
+  int seed = (int) this->seed;
+  double camera_fov = rad2deg(this->camera_fov);
+
+  // load config
+  parser.addParam("quadrotor_config", &this->quadrotor_config);
+  parser.addParam("tracker_config", &this->tracker_config);
+  parser.addParam("dt", &this->dt, true);
+  parser.addParam("duration", &this->duration, true);
+  parser.addParam("episodes", &this->nb_episodes, true);
+  parser.addParam("seed", &seed, true);
+  parser.addParam("threads", &this->nb_threads, true);
+  parser.addParam("success_radius", &this->success_radius, true);
+  parser.addParam("touchdown_height", &this->touchdown_height, true);
+  parser.addParam("detector.rate", &this->detection_rate, true);
+  parser.addParam("detector.fov", &camera_fov, true);
+  parser.addParam("detector.timeout", &this->detection_timeout, true);
+  parser.addParam("randomize.quad_offset", &this->quad_offset, true);
+  parser.addParam("randomize.target_offset", &this->target_offset, true);
+  parser.addParam("randomize.target_speed", &this->target_speed, true);
+  parser.addParam("randomize.target_turn_rate",
+                  &this->target_turn_rate,
+                  true);
+  parser.addParam("randomize.detection_noise", &this->detection_noise, true);
+  parser.addParam("randomize.detection_dropout",
+                  &this->detection_dropout,
+                  true);
+  parser.addParam("randomize.wind", &this->wind, true);
+  if (parser.load(config_file) != 0) {
+    return -1;
+  }
+  this->seed = (unsigned int) seed;
+  this->camera_fov = deg2rad(camera_fov);
+
+  // components, the paths are relative to the config file
+  std::string config_dir = std::string(dirname((char *) config_file.c_str()));
+  paths_combine(config_dir, this->quadrotor_config, this->quadrotor_config);
+  paths_combine(config_dir, this->tracker_config, this->tracker_config);
+
+  Quadrotor quadrotor;
+  KFTracker tracker;
+  if (quadrotor.configure(this->quadrotor_config) != 0) {
+    LOG_ERROR("Failed to configure [%s]!", this->quadrotor_config.c_str());
+    return -2;
+  } else if (tracker.configure(this->tracker_config) != 0) {
+    LOG_ERROR("Failed to configure [%s]!", this->tracker_config.c_str());
+    return -2;
+  } else if (tracker.nb_states != 9 || tracker.nb_dimensions != 3) {
+    LOG_ERROR("Tracker must be a 3D constant acceleration model!");
+    return -2;
+  }
+
+  // check settings
+  if (this->dt <= 0.0 || this->duration <= 0.0 || this->nb_episodes < 1) {
+    LOG_ERROR("Invalid time step, duration or number of episodes!");
+    return -3;
+  } else if (this->detection_rate <= 0.0 || camera_fov <= 0.0 ||
+             camera_fov >= 180.0) {
+    LOG_ERROR("Invalid detection rate or camera field of view!");
+    return -3;
+  }
+  const Vec2 *ranges[7] = {&this->quad_offset,
+                           &this->target_offset,
+                           &this->target_speed,
+                           &this->target_turn_rate,
+                           &this->detection_noise,
+                           &this->detection_dropout,
+                           &this->wind};
+  for (int i = 0; i < 7; i++) {
+    if ((*ranges[i])(0) > (*ranges[i])(1)) {
+      LOG_ERROR("Invalid randomization range [%f, %f]!",
+                (*ranges[i])(0),
+                (*ranges[i])(1));
+      return -3;
+    }
+  }
+
+  this->episodes.clear();
+  this->configured = true;
+  return 0;
+}
+
+LandingEpisode LandingSim::sample(const int index) const {
+  LandingEpisode episode;
+  episode.index = index;
+  episode.seed = this->seed + (unsigned int) index;
+
+  std::mt19937 rng(episode.seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  auto draw = [&](const Vec2 &range) {
+    return range(0) + uniform(rng) * (range(1) - range(0));
+  };
+  auto heading = [&]() { return -M_PI + 2.0 * M_PI * uniform(rng); };
+
+  // start offsets of the quadrotor from the hover position and of the
+  // target from the point below it
+  const double quad_r = draw(this->quad_offset);
+  const double quad_theta = heading();
+  episode.quad_start << quad_r * cos(quad_theta), quad_r * sin(quad_theta),
+      0.0;
+  const double target_r = draw(this->target_offset);
+  const double target_theta = heading();
+  episode.target_start << target_r * cos(target_theta),
+      target_r * sin(target_theta), heading();
+
+  // target motion, detector and wind
+  episode.target_speed = draw(this->target_speed);
+  episode.target_turn_rate = draw(this->target_turn_rate);
+  episode.detection_noise = draw(this->detection_noise);
+  episode.detection_dropout = draw(this->detection_dropout);
+  const double wind_speed = draw(this->wind);
+  const double wind_theta = heading();
+  episode.wind << wind_speed * cos(wind_theta), wind_speed * sin(wind_theta),
+      0.0;
+
+  return episode;
+}
+
+int LandingSim::simulate(LandingEpisode &episode) const {
+  double t = 0.0;
+  struct timespec t_start;
+
+  // quadrotor on the simulated clock and tracker
+  Quadrotor quadrotor;
+  KFTracker tracker;
+  quadrotor.clock = [&t]() { return t; };
+  if (quadrotor.configure(this->quadrotor_config) != 0) {
+    return -1;
+  } else if (tracker.configure(this->tracker_config) != 0) {
+    return -1;
+  }
+
+  // model hovering at the start, four motors with a max thrust of 5 N each
+  const double hover = quadrotor.position_controller.hover_throttle;
+  VecX pose = VecX::Zero(6);
+  pose.head(3) = quadrotor.hover_position + episode.quad_start;
+  QuadrotorModel model(pose);
+  model.m = 4.0 * 5.0 * hover / model.g;
+  model.attitude_setpoints << 0.0, 0.0, 0.0, hover;
+  model.ext_force = episode.wind;
+
+  // target on the ground below the hover position
+  Vec3 target_pose = episode.target_start;
+  target_pose(0) += quadrotor.hover_position(0);
+  target_pose(1) += quadrotor.hover_position(1);
+  TwoWheelRobot2DModel target(target_pose);
+  const Vec2 target_inputs{episode.target_speed, episode.target_turn_rate};
+
+  // detector noise, seeded apart from the generator of the conditions
+  std::seed_seq detector_seed{episode.seed, 1u};
+  std::mt19937 rng(detector_seed);
+  std::normal_distribution<double> noise(0.0, episode.detection_noise);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const double tan_fov = tan(this->camera_fov / 2.0);
+  double next_detection = 0.0;
+  double last_detection = -FLT_MAX;
+  Vec3 y{0.0, 0.0, 0.0};
+  MatX A(9, 9);
+  const double dt = this->dt;
+  MATRIX_A_CONSTANT_ACCELERATION_XYZ(A);
+
+  for (; t < this->duration; t += this->dt) {
+    episode.nb_steps++;
+
+    // target
+    tic(&t_start);
+    target.update(target_inputs, this->dt);
+    const Vec3 target_pos{target.pose(0), target.pose(1), 0.0};
+    episode.timing[SIM_TARGET] += toc(&t_start);
+
+    // detector, relative position in the body planar frame while the
+    // target is within the field of view
+    tic(&t_start);
+    bool measured = false;
+    if (t >= next_detection) {
+      next_detection += 1.0 / this->detection_rate;
+      const Vec3 rel = target_pos - model.position;
+      const bool visible = -rel(2) * tan_fov >= rel.head(2).norm();
+      if (visible && uniform(rng) >= episode.detection_dropout) {
+        y << rel(0) + noise(rng), rel(1) + noise(rng), rel(2) + noise(rng);
+        measured = true;
+        last_detection = t;
+        episode.nb_detections++;
+      }
+    }
+    episode.timing[SIM_DETECTOR] += toc(&t_start);
+
+    // tracker, predicts only between measurements
+    tic(&t_start);
+    if (measured && tracker.initialized == false) {
+      VecX mu = VecX::Zero(9);
+      mu.head(3) = y;
+      tracker.initialize(mu);
+    } else if (tracker.initialized) {
+      const TagPose tag{0, measured, y, Quaternion::Identity()};
+      if (tracker.estimate(A, tag) == -4) {
+        tracker.initialized = false;
+      }
+    }
+    const bool detected = tracker.initialized &&
+                          (t - last_detection) < this->detection_timeout;
+    episode.timing[SIM_TRACKER] += toc(&t_start);
+
+    // quadrotor, yaw is held at zero
+    tic(&t_start);
+    const Pose quad_pose("",
+                         model.attitude(0),
+                         model.attitude(1),
+                         model.attitude(2),
+                         model.position(0),
+                         model.position(1),
+                         model.position(2));
+    quadrotor.setPose(quad_pose);
+    quadrotor.setVelocity(model.linear_velocity);
+    if (tracker.initialized) {
+      quadrotor.setTargetPosition(tracker.mu.head(3));
+      quadrotor.setTargetVelocity(tracker.mu.segment(3, 3));
+    }
+    quadrotor.setTargetDetected(detected);
+    quadrotor.step(this->dt);
+    const AttitudeCommand &att_cmd = quadrotor.att_cmd;
+    episode.timing[SIM_QUADROTOR] += toc(&t_start);
+
+    // touch down, disarming cuts the motors
+    const double height = model.position(2) - target_pos(2);
+    const bool disarmed = quadrotor.current_mode == DISARM_MODE;
+    if (height <= this->touchdown_height || disarmed) {
+      const bool landing = disarmed || quadrotor.current_mode == LANDING_MODE;
+      const Vec3 error = target_pos - model.position;
+      episode.touchdown_error = error.head(2).norm();
+      episode.touchdown_time = t;
+      episode.success = episode.touchdown_error <= this->success_radius;
+      episode.success &= landing;
+      if (landing == false) {
+        episode.outcome = "crashed";
+      } else {
+        episode.outcome = episode.success ? "landed" : "missed";
+      }
+      break;
+    }
+
+    // vehicle
+    tic(&t_start);
+    model.attitude_setpoints << att_cmd.rpy, att_cmd.throttle;
+    model.update(model.attitudeControllerControl(this->dt), this->dt);
+    episode.timing[SIM_MODEL] += toc(&t_start);
+
+    // diverged or flipped over
+    const double tilt = acos(cos(model.attitude(0)) * cos(model.attitude(1)));
+    if (!model.position.allFinite() || tilt > deg2rad(80.0)) {
+      episode.outcome = "crashed";
+      break;
+    }
+  }
+  episode.final_mode = quadrotor.current_mode;
+
+  return 0;
+}
+
+int LandingSim::run() {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  struct timespec t_start;
+  tic(&t_start);
+
+  // draw conditions up front so the results do not depend on the threads
+  this->episodes.clear();
+  for (int i = 0; i < this->nb_episodes; i++) {
+    this->episodes.push_back(this->sample(i));
+  }
+
+  // workers pull the next episode until none are left
+  int nb_threads = this->nb_threads;
+  if (nb_threads <= 0) {
+    nb_threads = std::max(1, (int) std::thread::hardware_concurrency());
+  }
+  nb_threads = std::min(nb_threads, this->nb_episodes);
+
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    size_t i;
+    while ((i = next.fetch_add(1)) < this->episodes.size()) {
+      this->simulate(this->episodes[i]);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < nb_threads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  this->elapsed = toc(&t_start);
+
+  return 0;
+}
+
+double LandingSim::successRate() const {
+  if (this->episodes.size() == 0) {
+    return 0.0;
+  }
+
+  int nb_success = 0;
+  for (auto &episode : this->episodes) {
+    nb_success += episode.success ? 1 : 0;
+  }
+
+  return nb_success / (double) this->episodes.size();
+}
+
+double LandingSim::touchdownError(const double p) const {
+  std::vector<double> errors;
+  for (auto &episode : this->episodes) {
+    if (episode.outcome == "landed" || episode.outcome == "missed") {
+      errors.push_back(episode.touchdown_error);
+    }
+  }
+  if (errors.size() == 0) {
+    return -1.0;
+  }
+
+  std::sort(errors.begin(), errors.end());
+  const double q = std::max(0.0, std::min(p, 1.0));
+  return errors[(size_t) round(q * (errors.size() - 1))];
+}
+
+int LandingSim::saveReport(const std::string &report_file) const {
+  std::ofstream report(report_file);
+  if (!report) {
+    LOG_ERROR("Failed to open [%s]!", report_file.c_str());
+    return -1;
+  }
+
+  // outcomes
+  const std::string outcomes[4] = {"landed", "missed", "crashed", "timeout"};
+  int counts[4] = {0, 0, 0, 0};
+  int nb_steps = 0;
+  double touchdown_time = 0.0;
+  double timing[SIM_NB_COMPONENTS] = {0.0, 0.0, 0.0, 0.0, 0.0};
+  for (auto &episode : this->episodes) {
+    for (int k = 0; k < 4; k++) {
+      counts[k] += (episode.outcome == outcomes[k]) ? 1 : 0;
+    }
+    touchdown_time += episode.success ? episode.touchdown_time : 0.0;
+    nb_steps += episode.nb_steps;
+    for (int k = 0; k < SIM_NB_COMPONENTS; k++) {
+      timing[k] += episode.timing[k];
+    }
+  }
+
+  report << "episodes: " << this->episodes.size() << std::endl;
+  report << "time [s]: " << this->elapsed << std::endl;
+  report << "simulated [s]: " << nb_steps * this->dt << std::endl;
+  report << "success rate: " << this->successRate() << std::endl;
+  for (int k = 0; k < 4; k++) {
+    report << std::left << std::setw(16) << outcomes[k] + ":";
+    report << counts[k] << std::endl;
+  }
+  if (counts[0] > 0) {
+    report << "mean landing time [s]: " << touchdown_time / counts[0];
+    report << std::endl;
+  }
+  report << std::endl;
+
+  // touchdown error distribution
+  const double percentiles[5] = {0.0, 0.5, 0.9, 0.99, 1.0};
+  report << "touchdown error [m]:" << std::endl;
+  for (int k = 0; k < 5; k++) {
+    const int p = (int) round(100 * percentiles[k]);
+    report << std::setw(16) << "p" + std::to_string(p);
+    report << this->touchdownError(percentiles[k]) << std::endl;
+  }
+  report << std::endl;
+
+  // timing per simulation step
+  const std::string components[SIM_NB_COMPONENTS] = {"target",
+                                                     "detector",
+                                                     "tracker",
+                                                     "quadrotor",
+                                                     "model"};
+  report << "timing per step [us]:" << std::endl;
+  for (int k = 0; k < SIM_NB_COMPONENTS; k++) {
+    report << std::setw(16) << components[k];
+    report << ((nb_steps) ? timing[k] / nb_steps * 1e6 : 0.0) << std::endl;
+  }
+
+  return report ? 0 : -1;
+}
+
+int LandingSim::saveEpisodes(const std::string &output_file) const {
+  std::ofstream output(output_file);
+  if (!output) {
+    LOG_ERROR("Failed to open [%s]!", output_file.c_str());
+    return -1;
+  }
+
+  // header
+  output << "index,seed,quad_x,quad_y,target_x,target_y,target_heading,";
+  output << "target_speed,target_turn_rate,detection_noise,";
+  output << "detection_dropout,wind_x,wind_y,outcome,touchdown_error,";
+  output << "touchdown_time,final_mode,nb_detections" << std::endl;
+
+  // episodes
+  for (auto &e : this->episodes) {
+    output << e.index << "," << e.seed << ",";
+    output << e.quad_start(0) << "," << e.quad_start(1) << ",";
+    output << e.target_start(0) << "," << e.target_start(1) << ",";
+    output << e.target_start(2) << ",";
+    output << e.target_speed << "," << e.target_turn_rate << ",";
+    output << e.detection_noise << "," << e.detection_dropout << ",";
+    output << e.wind(0) << "," << e.wind(1) << ",";
+    output << e.outcome << "," << e.touchdown_error << ",";
+    output << e.touchdown_time << "," << e.final_mode << ",";
+    output << e.nb_detections << std::endl;
+  }
+
+  return output ? 0 : -1;
+}
+
+} // namespace atl
@@ -5,6 +5,7 @@ namespace atl {
 int Quadrotor::configure(const std::string &config_path) {
   std::string config_file;
   std::string mission_file;
+  std::string landing_controller = "pid";
   ConfigParser parser;
 
   // position controller
@@ -23,6 +24,10 @@ int Quadrotor::configure(const std::string &config_path) {
   config_file = config_path + "/controllers/" + "waypoint_controller.yaml";
   CONFIGURE_CONTROLLER(this->waypoint_controller, config_file, FCONFWCTRL);
 
+  // geometric controller
+  config_file = config_path + "/controllers/" + "geometric_controller.yaml";
+  CONFIGURE_CONTROLLER(this->geometric_controller, config_file, FCONFGCTRL);
+
   // load config
   parser.addParam("hover_position", &this->hover_position);
   parser.addParam("recover_height", &this->recover_height);
@@ -33,26 +38,136 @@ int Quadrotor::configure(const std::string &config_path) {
   parser.addParam("min_discover_time", &this->min_discover_time);
   parser.addParam("min_tracking_time", &this->min_tracking_time);
   parser.addParam("mission", &mission_file);
+  parser.addParam("landing_controller", &landing_controller, true);
   if (parser.load(config_path + "/config.yaml") != 0) {
     return -1;
   }
 
+  // landing mpc
+  if (landing_controller == "mpc") {
+    config_file = config_path + "/controllers/" + "landing_mpc.yaml";
+    CONFIGURE_CONTROLLER(this->landing_mpc, config_file, FCONFLMPC);
+    this->landing_mpc_enabled = true;
+  } else if (landing_controller != "pid") {
+    LOG_ERROR("Invalid landing controller [%s]!", landing_controller.c_str());
+    return -1;
+  }
+
   // mission
   paths_combine(config_path, mission_file, mission_file);
   if (this->mission.configure(mission_file) != 0) {
     return -2;
   }
 
+  // mode state machine
+  if (this->configureModes() != 0) {
+    return -1;
+  }
+
   // misc
   this->landing_target.lost_threshold = this->target_lost_threshold;
-  this->current_mode = DISCOVER_MODE;
+  this->landing_target.clock = [this]() { return this->clock(); };
   this->configured = true;
+  this->mode_machine.start(DISCOVER_MODE);
+  this->current_mode = DISCOVER_MODE;
 
   return 0;
 error:
   return -1;
 }
 
+int Quadrotor::configureModes() {
+  StateMachine &sm = this->mode_machine;
+  int retval = 0;
+  sm = StateMachine();
+  sm.clock = [this]() { return this->clock(); };
+
+  // states
+  // clang-format off
+  auto log = [](const char *msg) { return [msg]() { LOG_INFO("%s", msg); }; };
+  auto hold = [this]() {
+    // hold position until an offboard setpoint arrives
+    LOG_INFO(INFO_OMODE);
+    this->offboard_position = this->hover_position;
+    this->offboard_velocity.setZero();
+    this->offboard_acceleration.setZero();
+  };
+  auto wp_start = [this]() {
+    LOG_INFO(INFO_WMODE);
+    this->waypoint_retval = 0;
+  };
+  retval |= sm.addState(DISARM_MODE, "DISARM_MODE", -1, log(INFO_KMODE));
+  retval |= sm.addState(FLIGHT_MODES, "FLIGHT_MODES");
+  retval |= sm.addState(HOVER_MODE, "HOVER_MODE", FLIGHT_MODES, log(INFO_HMODE));
+  retval |= sm.addState(DISCOVER_MODE, "DISCOVER_MODE", FLIGHT_MODES, log(INFO_DMODE));
+  retval |= sm.addState(WAYPOINT_MODE, "WAYPOINT_MODE", FLIGHT_MODES, wp_start);
+  retval |= sm.addState(OFFBOARD_MODE, "OFFBOARD_MODE", FLIGHT_MODES, hold);
+  retval |= sm.addState(TARGET_MODES, "TARGET_MODES", FLIGHT_MODES);
+  retval |= sm.addState(TRACKING_MODE, "TRACKING_MODE", TARGET_MODES, log(INFO_TMODE));
+  retval |= sm.addState(LANDING_MODE, "LANDING_MODE", TARGET_MODES, log(INFO_LMODE));
+  // clang-format on
+
+  // discover -> tracking
+  auto discovered = [this]() {
+    const double t = this->mode_machine.timeInState() * 1000.0;
+    return this->auto_track && this->targetAcquired() &&
+           t > this->min_discover_time;
+  };
+  retval |= sm.addTransition(DISCOVER_MODE, TRACKING_MODE, discovered);
+
+  // tracking -> landing
+  auto tracked = [this]() {
+    const double t = this->mode_machine.timeInState() * 1000.0;
+    return this->auto_land && this->targetAcquired() &&
+           t > this->min_tracking_time;
+  };
+  retval |= sm.addTransition(TRACKING_MODE, LANDING_MODE, tracked);
+
+  // landing -> disarm
+  auto landed = [this]() {
+    return this->auto_disarm && this->targetAcquired() &&
+           this->landing_target.position_B.norm() < 0.1;
+  };
+  retval |= sm.addTransition(LANDING_MODE, DISARM_MODE, landed);
+
+  // tracking or landing -> discover, climb back to the recover height
+  auto lost = [this]() { return this->targetLost(); };
+  auto recover = [this]() {
+    LOG_INFO("Landing Target is lost!");
+    this->landing_target.reset();
+    this->target_last_seen = -1.0;
+    this->hover_position(2) = this->recover_height;
+  };
+  retval |= sm.addTransition(TARGET_MODES, DISCOVER_MODE, lost, recover);
+
+  // waypoint -> hover, once the mission failed or is complete
+  auto wp_failed = [this]() { return this->waypoint_retval == -1; };
+  auto wp_done = [this]() { return this->waypoint_retval == -2; };
+  retval |= sm.addTransition(WAYPOINT_MODE,
+                             HOVER_MODE,
+                             wp_failed,
+                             log("Failed to load mission!"));
+  retval |= sm.addTransition(WAYPOINT_MODE,
+                             HOVER_MODE,
+                             wp_done,
+                             log("Mission complete!"));
+
+  return (retval == 0) ? 0 : -1;
+}
+
+bool Quadrotor::targetAcquired() {
+  return this->landing_target.detected && this->targetLost() == false;
+}
+
+bool Quadrotor::targetLost() {
+  if (this->target_last_seen < 0.0) {
+    return true;
+  }
+
+  const double t = (this->clock() - this->target_last_seen) * 1000.0;
+  return t > this->target_lost_threshold;
+}
+
 int Quadrotor::setHomePoint(const double latitude, const double longitude) {
   // pre-check
   if (this->configured == false) {
@@ -72,17 +187,14 @@ int Quadrotor::setMode(const enum Mode &mode) {
     return -1;
   }
 
-  // set mode
+  // set mode, superstates are not modes
   this->current_mode = mode;
-  switch (mode) {
-    case DISARM_MODE: LOG_INFO(INFO_KMODE); break;
-    case HOVER_MODE: LOG_INFO(INFO_HMODE); break;
-    case DISCOVER_MODE: LOG_INFO(INFO_DMODE); break;
-    case TRACKING_MODE: LOG_INFO(INFO_TMODE); break;
-    case LANDING_MODE: LOG_INFO(INFO_LMODE); break;
-    case WAYPOINT_MODE: LOG_INFO(INFO_WMODE); break;
-    default: LOG_ERROR(EINVMODE); return -2;
+  if (mode < DISARM_MODE || mode > OFFBOARD_MODE) {
+    LOG_ERROR(EINVMODE);
+    this->mode_machine.stop();
+    return -2;
   }
+  this->mode_machine.transition(mode);
 
   return 0;
 }
@@ -156,6 +268,9 @@ int Quadrotor::setTargetDetected(bool detected) {
 
   // set target detected
   this->landing_target.update(detected);
+  if (detected) {
+    this->target_last_seen = this->clock();
+  }
 
   return 0;
 }
@@ -187,6 +302,22 @@ int Quadrotor::setHoverPosition(const Vec3 &position) {
   return 0;
 }
 
+int Quadrotor::setOffboardSetpoint(const Vec3 &position,
+                                   const Vec3 &velocity,
+                                   const Vec3 &acceleration) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
+  }
+
+  // set offboard setpoint
+  this->offboard_position = position;
+  this->offboard_velocity = velocity;
+  this->offboard_acceleration = acceleration;
+
+  return 0;
+}
+
 bool Quadrotor::conditionsMet(const bool *conditions, int nb_conditions) {
   for (int i = 0; i < nb_conditions; i++) {
     if (conditions[i] == false) {
@@ -221,22 +352,6 @@ int Quadrotor::stepDiscoverMode(const double dt) {
 
   // hover in place
   this->stepHoverMode(dt);
-  if (this->discover_tic.tv_sec == 0) {
-    tic(&this->discover_tic);
-  }
-
-  // transition
-  bool conditions[3] = {false, false, false};
-  conditions[0] = this->landing_target.detected;
-  conditions[1] = this->landing_target.losted == false;
-  conditions[2] = mtoc(&this->discover_tic) > this->min_discover_time;
-
-  // transition to tracking mode
-  if (this->conditionsMet(conditions, 3) && this->auto_track) {
-    LOG_INFO("Transitioning to [TRACKING MODE]!");
-    this->setMode(TRACKING_MODE);
-    this->discover_tic = (struct timespec){0, 0};
-  }
 
   return 0;
 }
@@ -255,32 +370,8 @@ int Quadrotor::stepTrackingMode(const double dt) {
                                    dt);
   this->att_cmd = AttitudeCommand(this->tracking_controller.outputs);
 
-  // update hover position and tracking timer
+  // update hover position
   this->setHoverXYPosition(this->pose.position);
-  if (this->tracking_tic.tv_sec == 0) {
-    tic(&this->tracking_tic);
-  }
-
-  // check conditions
-  bool conditions[3] = {false, false, false};
-  conditions[0] = this->landing_target.detected;
-  conditions[1] = this->landing_target.losted == false;
-  conditions[2] = mtoc(&this->tracking_tic) > this->min_tracking_time;
-
-  // transition to landing mode
-  if (this->conditionsMet(conditions, 3) && this->auto_land) {
-    LOG_INFO("Transitioning to [LANDING MODE]!");
-    this->setMode(LANDING_MODE);
-    this->tracking_tic = (struct timespec){0, 0};
-
-    // transition back to discover mode
-  } else if (this->landing_target.isTargetLosted()) {
-    LOG_INFO("Landing Target is lost!");
-    LOG_INFO("Transitioning back to [DISCOVER_MODE]!");
-    this->setMode(DISCOVER_MODE);
-    this->tracking_tic = (struct timespec){0, 0};
-    this->hover_position(2) = this->recover_height;
-  }
 
   return 0;
 }
@@ -292,43 +383,29 @@ int Quadrotor::stepLandingMode(const double dt) {
   }
 
   // land on target
-  this->landing_controller.update(this->landing_target.position_B,
-                                  this->velocity,
-                                  this->yaw_setpoint,
-                                  dt);
-  this->att_cmd = AttitudeCommand(this->landing_controller.outputs);
-
-  // update hover position and tracking timer
-  this->setHoverPosition(this->pose.position);
-  if (this->landing_tic.tv_sec == 0) {
-    tic(&this->landing_tic);
+  if (this->landing_mpc_enabled) {
+    this->landing_mpc.update(this->landing_target.position_B,
+                             this->landing_target.velocity_B,
+                             this->velocity,
+                             this->yaw_setpoint,
+                             dt);
+    this->att_cmd = AttitudeCommand(this->landing_mpc.outputs);
+  } else {
+    this->landing_controller.update(this->landing_target.position_B,
+                                    this->velocity,
+                                    this->yaw_setpoint,
+                                    dt);
+    this->att_cmd = AttitudeCommand(this->landing_controller.outputs);
   }
 
-  // check conditions
-  bool conditions[3] = {false, false, false};
-  conditions[0] = this->landing_target.detected;
-  conditions[1] = this->landing_target.losted == false;
-  conditions[2] = this->landing_target.position_B.norm() < 0.1;
-
-  // transition to disarm mode
-  if (this->conditionsMet(conditions, 3) && this->auto_disarm) {
-    this->setMode(DISARM_MODE);
-    this->landing_tic = (struct timespec){0, 0};
-
-  } else if (this->landing_target.isTargetLosted()) {
-    // transition back to discovery mode
-    LOG_INFO("Landing Target is losted!");
-    LOG_INFO("Transitioning back to [DISCOVER_MODE]!");
-    this->setMode(DISCOVER_MODE);
-    this->landing_tic = (struct timespec){0, 0};
-    this->hover_position(2) = this->recover_height;
-  }
+  // update hover position
+  this->setHoverPosition(this->pose.position);
 
   return 0;
 }
 
 int Quadrotor::stepWaypointMode(const double dt) {
-  int retval;
+  int retval = 0;
 
   // pre-check
   if (this->configured == false) {
@@ -358,10 +435,11 @@ int Quadrotor::stepWaypointMode(const double dt) {
       LOG_INFO("Quadrotor arrived at first waypoint!");
       LOG_INFO("Waypoing mission in 5s!");
       this->wp_mission_ready = true;
-      tic(&this->waypoint_tic);
+      this->waypoint_tic = this->clock();
     }
 
-  } else if (this->wp_mission_ready && toc(&this->waypoint_tic) <= 5.0) {
+  } else if (this->wp_mission_ready &&
+             this->clock() - this->waypoint_tic <= 5.0) {
     // hover at first waypoint and do a 5 second count down
     const Vec3 wp_start = this->mission.local_waypoints[0];
     this->setHoverPosition(wp_start);
@@ -369,7 +447,7 @@ int Quadrotor::stepWaypointMode(const double dt) {
     this->yaw_setpoint = this->mission.waypointHeading();
 
     // count down
-    float wp_clock = toc(&this->waypoint_tic);
+    const double wp_clock = this->clock() - this->waypoint_tic;
     if (wp_clock > 1.0 && this->waypoint_countdown[0] == false) {
       LOG_INFO("... 4s");
       this->waypoint_countdown[0] = true;
@@ -385,7 +463,7 @@ int Quadrotor::stepWaypointMode(const double dt) {
       this->waypoint_countdown[3] = true;
     }
 
-  } else if (this->wp_mission_ready && toc(&this->waypoint_tic) > 5.0) {
+  } else if (this->wp_mission_ready) {
     // travel through waypoints
     retval = this->waypoint_controller.update(this->mission,
                                               this->pose,
@@ -395,23 +473,33 @@ int Quadrotor::stepWaypointMode(const double dt) {
     this->yaw_setpoint = this->att_cmd.rpy(2);
   }
 
-  // update hover position
+  // update hover position and mission status for the mode transitions
   this->setHoverPosition(this->pose.position);
+  this->waypoint_retval = retval;
+
+  return 0;
+}
 
-  // check conditions
-  if (retval == -1) {
-    // transition to hover mode
-    LOG_ERROR("Failed to load mission!");
-    LOG_INFO("Transitioning to [HOVER MODE]!");
-    this->setMode(HOVER_MODE);
-
-  } else if (retval == -2) {
-    // transition to hover mode
-    LOG_INFO("Mission complete!");
-    LOG_INFO("Transitioning to [HOVER MODE]!");
-    this->setMode(HOVER_MODE);
+int Quadrotor::stepOffboardMode(const double dt) {
+  // pre-check
+  if (this->configured == false) {
+    return -1;
   }
 
+  // track offboard setpoint
+  this->geometric_controller.update(this->offboard_position,
+                                    this->offboard_velocity,
+                                    this->offboard_acceleration,
+                                    this->yaw_setpoint,
+                                    this->pose.position,
+                                    this->velocity,
+                                    this->pose.rotationMatrix(),
+                                    dt);
+  this->att_cmd = AttitudeCommand(this->geometric_controller.outputs);
+
+  // update hover position
+  this->setHoverPosition(this->pose.position);
+
   return 0;
 }
 
@@ -419,7 +507,9 @@ int Quadrotor::reset() {
   this->position_controller.reset();
   this->tracking_controller.reset();
   this->landing_controller.reset();
+  this->landing_mpc.reset();
   this->waypoint_controller.reset();
+  this->geometric_controller.reset();
 
   return 0;
 }
@@ -439,12 +529,18 @@ int Quadrotor::step(const double dt) {
     case TRACKING_MODE: retval = this->stepTrackingMode(dt); break;
     case LANDING_MODE: retval = this->stepLandingMode(dt); break;
     case WAYPOINT_MODE: retval = this->stepWaypointMode(dt); break;
+    case OFFBOARD_MODE: retval = this->stepOffboardMode(dt); break;
     default:
       LOG_ERROR(EINVMODE);
       retval = this->stepHoverMode(dt);
       break;
   }
 
+  // mode transitions
+  if (this->mode_machine.update() == 1) {
+    this->current_mode = (enum Mode) this->mode_machine.current;
+  }
+
   return retval;
 }
 
@@ -0,0 +1,68 @@
+#include "atl/quadrotor/state_store.hpp"
+
+namespace atl {
+
+int StateStore::read(StateSnapshot &snapshot) const {
+  uint32_t seq[7];
+  Coefficients<3> position;
+  Coefficients<4> orientation;
+  Coefficients<3> velocity;
+  Coefficients<3> target_position;
+  Coefficients<3> target_velocity;
+  bool target_detected;
+  RadioState radio;
+  int retries = -1;
+  bool valid;
+
+  // copy every channel, retry if any of them was written meanwhile
+  do {
+    retries++;
+    seq[0] = this->position.readBegin();
+    seq[1] = this->orientation.readBegin();
+    seq[2] = this->velocity.readBegin();
+    seq[3] = this->target_position.readBegin();
+    seq[4] = this->target_velocity.readBegin();
+    seq[5] = this->target_detected.readBegin();
+    seq[6] = this->radio.readBegin();
+
+    this->position.readCopy(position);
+    this->orientation.readCopy(orientation);
+    this->velocity.readCopy(velocity);
+    this->target_position.readCopy(target_position);
+    this->target_velocity.readCopy(target_velocity);
+    this->target_detected.readCopy(target_detected);
+    this->radio.readCopy(radio);
+
+    valid = this->position.readValid(seq[0]);
+    valid &= this->orientation.readValid(seq[1]);
+    valid &= this->velocity.readValid(seq[2]);
+    valid &= this->target_position.readValid(seq[3]);
+    valid &= this->target_velocity.readValid(seq[4]);
+    valid &= this->target_detected.readValid(seq[5]);
+    valid &= this->radio.readValid(seq[6]);
+  } while (valid == false);
+
+  // flag what changed since the previous snapshot
+  const uint32_t *prev = snapshot.sequences;
+  snapshot.pose_updated = (seq[0] != prev[0] || seq[1] != prev[1]);
+  snapshot.velocity_updated = (seq[2] != prev[2]);
+  snapshot.target_updated =
+      (seq[3] != prev[3] || seq[4] != prev[4] || seq[5] != prev[5]);
+  snapshot.radio_updated = (seq[6] != prev[6]);
+  for (int i = 0; i < 7; i++) {
+    snapshot.sequences[i] = seq[i];
+  }
+
+  // snapshot
+  snapshot.pose.position = position.vector();
+  snapshot.pose.orientation = Quaternion(orientation.vector());
+  snapshot.velocity = velocity.vector();
+  snapshot.target.position = target_position.vector();
+  snapshot.target.velocity = target_velocity.vector();
+  snapshot.target.detected = target_detected;
+  snapshot.radio = radio;
+
+  return retries;
+}
+
+} // namespace atl
@@ -34,7 +34,7 @@ int8_t MPU6050::configure() {
   this->roll = 0.0f;
   this->temperature = 0.0f;
 
-  this->last_updated = clock();
+  tic(&this->last_updated);
   this->sample_rate = -1.0;
   this->dplf_config = 0;
 
@@ -125,7 +125,6 @@ int8_t MPU6050::getData() {
   char raw_data[14];
   int8_t raw_temp;
   float dt;
-  clock_t time_now;
   int retval;
 
   /* read this data */
@@ -166,9 +165,9 @@ int8_t MPU6050::getData() {
   this->gyro.y = this->gyro.raw_y / this->gyro.sensitivity;
   this->gyro.z = this->gyro.raw_z / this->gyro.sensitivity;
 
-  /* calculate dt */
-  time_now = clock();
-  dt = ((double) time_now - this->last_updated) / CLOCKS_PER_SEC;
+  /* calculate dt, wall time since last update */
+  dt = toc(&this->last_updated);
+  tic(&this->last_updated);
 
   /* complimentary filter */
   this->accelerometerCalcAngle();
@@ -180,9 +179,6 @@ int8_t MPU6050::getData() {
   this->pitch += this->pitch_offset;
   this->roll += this->roll_offset;
 
-  /* set last_updated */
-  this->last_updated = clock();
-
   return 0;
 }
 
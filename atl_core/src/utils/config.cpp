@@ -172,6 +172,7 @@ int ConfigParser::checkVector(const std::string &key,
                               const bool optional) {
   int retval;
   int vector_size;
+  YAML::Node node;
 
   // pre-check
   if (this->config_loaded == false) {
@@ -192,11 +193,12 @@ int ConfigParser::checkVector(const std::string &key,
   }
 
   // check number of values
-  if (this->root[key].size() != static_cast<size_t>(vector_size)) {
+  this->getYamlNode(key, node);
+  if (node.size() != static_cast<size_t>(vector_size)) {
     LOG_ERROR("Vector [%s] should have %d values but config has %d!",
               key.c_str(),
               vector_size,
-              static_cast<int>(this->root[key].size()));
+              static_cast<int>(node.size()));
     return -4;
   }
 
@@ -206,6 +208,7 @@ int ConfigParser::checkVector(const std::string &key,
 int ConfigParser::checkMatrix(const std::string &key, const bool optional) {
   int retval;
   const std::string targets[3] = {"rows", "cols", "data"};
+  YAML::Node node;
 
   // pre-check
   if (this->config_loaded == false) {
@@ -219,8 +222,9 @@ int ConfigParser::checkMatrix(const std::string &key, const bool optional) {
   }
 
   // check fields
+  this->getYamlNode(key, node);
   for (int i = 0; i < 3; i++) {
-    if (!this->root[key][targets[i]]) {
+    if (!node[targets[i]]) {
       LOG_ERROR("Key [%s] is missing for matrix [%s]!",
                 targets[i].c_str(),
                 key.c_str());
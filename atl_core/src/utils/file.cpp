@@ -17,7 +17,6 @@ bool file_exists(const std::string &fp) {
 int remove_dir(const std::string &path) {
   DIR *dir = opendir(path.c_str());
   struct dirent *next_file;
-  char filepath[256];
 
   // pre-check
   if (dir == NULL) {
@@ -29,8 +28,8 @@ int remove_dir(const std::string &path) {
   // remove files in path
   while ((next_file = readdir(dir)) != NULL) {
     // build the path for each file in the folder
-    sprintf(filepath, "%s/%s", path.c_str(), next_file->d_name);
-    remove(filepath);
+    const std::string filepath = path + "/" + next_file->d_name;
+    remove(filepath.c_str());
   }
 
   // remove dir
@@ -0,0 +1,302 @@
+#include "atl/utils/flight_recorder.hpp"
+
+namespace atl {
+
+int FlightRecorder::configure(const std::string &file_path,
+                              const std::vector<std::string> &fields,
+                              const size_t capacity) {
+  // pre-check
+  if (fields.size() == 0) {
+    LOG_ERROR("Flight recorder needs at least one field!");
+    return -1;
+  } else if (capacity == 0 || this->chunk_size == 0) {
+    LOG_ERROR("Invalid flight recorder capacity [%zu]!", capacity);
+    return -1;
+  }
+  this->close();
+
+  // preallocate ring buffer
+  this->file_path = file_path;
+  this->fields = fields;
+  this->nb_fields = fields.size();
+  this->capacity = 1;
+  while (this->capacity < capacity) {
+    this->capacity <<= 1;
+  }
+  this->ring.assign(this->capacity * this->nb_fields, 0.0);
+  this->head = 0;
+  this->tail = 0;
+  this->nb_dropped = 0;
+  this->nb_written = 0;
+
+  // open flight log and write schema header
+  this->file = fopen(file_path.c_str(), "wb");
+  if (this->file == NULL) {
+    LOG_ERROR("Failed to open flight log [%s]!", file_path.c_str());
+    return -2;
+  }
+
+  const uint32_t version = FLIGHT_LOG_VERSION;
+  const uint32_t nb_fields = (uint32_t) this->nb_fields;
+  bool ok = fwrite(FLIGHT_LOG_MAGIC, 1, 8, this->file) == 8;
+  ok = ok && fwrite(&version, sizeof(uint32_t), 1, this->file) == 1;
+  ok = ok && fwrite(&nb_fields, sizeof(uint32_t), 1, this->file) == 1;
+  for (size_t i = 0; i < this->nb_fields; i++) {
+    const uint32_t length = (uint32_t) fields[i].size();
+    ok = ok && fwrite(&length, sizeof(uint32_t), 1, this->file) == 1;
+    ok = ok && fwrite(fields[i].c_str(), 1, length, this->file) == length;
+  }
+  if (ok == false || fflush(this->file) != 0) {
+    LOG_ERROR("Failed to write flight log [%s]!", file_path.c_str());
+    fclose(this->file);
+    this->file = NULL;
+    return -2;
+  }
+
+  // start writer
+  this->running = true;
+  this->writer = std::thread(&FlightRecorder::loop, this);
+  this->configured = true;
+
+  return 0;
+}
+
+int FlightRecorder::record(const double *values) {
+  if (this->configured == false) {
+    return -1;
+  }
+
+  // drop row instead of waiting on the writer when full
+  const uint64_t head = this->head.load(std::memory_order_relaxed);
+  const uint64_t tail = this->tail.load(std::memory_order_acquire);
+  if (head - tail >= this->capacity) {
+    this->nb_dropped.fetch_add(1, std::memory_order_relaxed);
+    return -1;
+  }
+
+  // copy row and publish
+  const size_t slot = (size_t) (head & (this->capacity - 1));
+  double *row = &this->ring[slot * this->nb_fields];
+  memcpy(row, values, this->nb_fields * sizeof(double));
+  this->head.store(head + 1, std::memory_order_release);
+
+  return 0;
+}
+
+int FlightRecorder::drain() {
+  if (this->file == NULL) {
+    return 0;
+  }
+
+  const uint64_t head = this->head.load(std::memory_order_acquire);
+  uint64_t tail = this->tail.load(std::memory_order_relaxed);
+  int nb_rows = 0;
+
+  while (tail < head) {
+    // a chunk is contiguous up to the end of the ring buffer
+    const size_t slot = (size_t) (tail & (this->capacity - 1));
+    uint64_t n = std::min((uint64_t) this->chunk_size, head - tail);
+    n = std::min(n, (uint64_t) (this->capacity - slot));
+
+    const uint32_t chunk_rows = (uint32_t) n;
+    const double *rows = &this->ring[slot * this->nb_fields];
+    const size_t nb_values = n * this->nb_fields;
+    if (fwrite(&chunk_rows, sizeof(uint32_t), 1, this->file) != 1 ||
+        fwrite(rows, sizeof(double), nb_values, this->file) != nb_values) {
+      LOG_ERROR("Failed to write flight log [%s]!", this->file_path.c_str());
+      return -1;
+    }
+
+    // release the slots to the producer
+    tail += n;
+    nb_rows += (int) n;
+    this->tail.store(tail, std::memory_order_release);
+  }
+
+  if (nb_rows) {
+    fflush(this->file);
+  }
+  this->nb_written += nb_rows;
+
+  return nb_rows;
+}
+
+void FlightRecorder::close() {
+  this->configured = false;
+  {
+    std::lock_guard<std::mutex> lock(this->writer_mutex);
+    this->running = false;
+  }
+  this->writer_cv.notify_all();
+  if (this->writer.joinable()) {
+    this->writer.join();
+  }
+
+  if (this->file) {
+    this->drain();
+    fclose(this->file);
+    this->file = NULL;
+  }
+}
+
+void FlightRecorder::loop() {
+  const auto period = std::chrono::duration<double>(this->flush_period);
+
+  std::unique_lock<std::mutex> lock(this->writer_mutex);
+
+  while (this->running) {
+    this->writer_cv.wait_for(lock, period);
+    if (this->drain() == -1) {
+      break;
+    }
+  }
+}
+
+int flight_log_load(const std::string &file_path,
+                    std::vector<std::string> &fields,
+                    MatX &data) {
+  // open flight log
+  FILE *file = fopen(file_path.c_str(), "rb");
+  if (file == NULL) {
+    LOG_ERROR("Failed to open flight log [%s]!", file_path.c_str());
+    return -1;
+  }
+
+  // schema header
+  char magic[8];
+  uint32_t version = 0;
+  uint32_t nb_fields = 0;
+  bool ok = fread(magic, 1, 8, file) == 8;
+  ok = ok && memcmp(magic, FLIGHT_LOG_MAGIC, 8) == 0;
+  ok = ok && fread(&version, sizeof(uint32_t), 1, file) == 1;
+  ok = ok && version == FLIGHT_LOG_VERSION;
+  ok = ok && fread(&nb_fields, sizeof(uint32_t), 1, file) == 1;
+  ok = ok && nb_fields > 0;
+
+  fields.clear();
+  for (uint32_t i = 0; ok && i < nb_fields; i++) {
+    uint32_t length = 0;
+    ok = fread(&length, sizeof(uint32_t), 1, file) == 1;
+    std::string name(length, '\0');
+    ok = ok && fread(&name[0], 1, length, file) == length;
+    fields.push_back(name);
+  }
+  if (ok == false) {
+    LOG_ERROR("Invalid flight log [%s]!", file_path.c_str());
+    fclose(file);
+    return -2;
+  }
+
+  // chunks, stop at the last complete row
+  std::vector<double> values;
+  uint32_t nb_rows = 0;
+  while (fread(&nb_rows, sizeof(uint32_t), 1, file) == 1) {
+    const size_t offset = values.size();
+    const size_t nb_values = (size_t) nb_rows * nb_fields;
+    values.resize(offset + nb_values);
+    const size_t n = fread(&values[offset], sizeof(double), nb_values, file);
+    values.resize(offset + (n / nb_fields) * nb_fields);
+    if (n != nb_values) {
+      LOG_ERROR("Flight log [%s] is truncated!", file_path.c_str());
+      break;
+    }
+  }
+  fclose(file);
+
+  // rows are stored row-major
+  const int rows = (int) (values.size() / nb_fields);
+  data.resize(rows, nb_fields);
+  for (int i = 0; i < rows; i++) {
+    for (uint32_t j = 0; j < nb_fields; j++) {
+      data(i, j) = values[i * nb_fields + j];
+    }
+  }
+
+  return 0;
+}
+
+int flight_log2csv(const std::string &log_path, const std::string &csv_path) {
+  // load flight log
+  std::vector<std::string> fields;
+  MatX data;
+  if (flight_log_load(log_path, fields, data) != 0) {
+    return -1;
+  }
+
+  // open csv file
+  std::ofstream csv(csv_path);
+  if (!csv) {
+    LOG_ERROR("Failed to open csv file [%s]!", csv_path.c_str());
+    return -2;
+  }
+
+  // header and rows
+  for (size_t j = 0; j < fields.size(); j++) {
+    csv << fields[j] << ((j + 1 == fields.size()) ? "\n" : ",");
+  }
+  csv << std::setprecision(17);
+  for (long i = 0; i < data.rows(); i++) {
+    for (long j = 0; j < data.cols(); j++) {
+      csv << data(i, j) << ((j + 1 == data.cols()) ? "\n" : ",");
+    }
+  }
+
+  return csv ? 0 : -2;
+}
+
+int flight_log2npy(const std::string &log_path, const std::string &npy_path) {
+  // load flight log
+  std::vector<std::string> fields;
+  MatX data;
+  if (flight_log_load(log_path, fields, data) != 0) {
+    return -1;
+  }
+
+  // npy header, a structured dtype keeps the field names, the values are
+  // written as they are in memory so the dtype carries the host byte order
+  const uint16_t byte_order = 1;
+  const bool little_endian = *((const uint8_t *) &byte_order) == 1;
+  const std::string dtype = little_endian ? "<f8" : ">f8";
+  std::string header = "{'descr': [";
+  for (size_t j = 0; j < fields.size(); j++) {
+    header += "('" + fields[j] + "', '" + dtype + "'), ";
+  }
+  header += "], 'fortran_order': False, ";
+  header += "'shape': (" + std::to_string(data.rows()) + ",), }";
+
+  // pad so the data starts on a 64 byte boundary
+  const size_t preamble = 10;
+  while ((preamble + header.size() + 1) % 64 != 0) {
+    header += ' ';
+  }
+  header += '\n';
+  if (header.size() > UINT16_MAX) {
+    LOG_ERROR("Too many fields for npy file [%s]!", npy_path.c_str());
+    return -2;
+  }
+
+  // write file, each record is one row
+  FILE *file = fopen(npy_path.c_str(), "wb");
+  if (file == NULL) {
+    LOG_ERROR("Failed to open npy file [%s]!", npy_path.c_str());
+    return -2;
+  }
+
+  const uint8_t version[2] = {1, 0};
+  const uint8_t header_len[2] = {(uint8_t) (header.size() & 0xFF),
+                                 (uint8_t) (header.size() >> 8)};
+  bool ok = fwrite("\x93NUMPY", 1, 6, file) == 6;
+  ok = ok && fwrite(version, 1, 2, file) == 2;
+  ok = ok && fwrite(header_len, 1, 2, file) == 2;
+  ok = ok && fwrite(header.c_str(), 1, header.size(), file) == header.size();
+
+  const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      rows = data;
+  const size_t nb_values = (size_t) rows.size();
+  ok = ok && fwrite(rows.data(), sizeof(double), nb_values, file) == nb_values;
+  fclose(file);
+
+  return ok ? 0 : -2;
+}
+
+} // namespace atl
@@ -78,7 +78,11 @@ void load_matrix(const MatX &A, std::vector<double> &x) {
 }
 
 double wrapTo180(const double euler_angle) {
-  return fmod((euler_angle + 180.0), 360.0) - 180.0;
+  double angle = fmod((euler_angle + 180.0), 360.0);
+  if (angle < 0.0) {
+    angle += 360.0;
+  }
+  return angle - 180.0;
 }
 
 double wrapTo360(const double euler_angle) {
@@ -181,6 +185,28 @@ Mat3 rotz(const double angle) {
   return R;
 }
 
+Mat3 skew(const Vec3 &x) {
+  Mat3 S;
+  // clang-format off
+  S << 0.0, -x(2), x(1),
+       x(2), 0.0, -x(0),
+       -x(1), x(0), 0.0;
+  // clang-format on
+  return S;
+}
+
+Quaternion rvec2quat(const Vec3 &rvec) {
+  const double angle = rvec.norm();
+
+  // small angle approximation
+  if (angle < 1e-8) {
+    Quaternion q{1.0, 0.5 * rvec(0), 0.5 * rvec(1), 0.5 * rvec(2)};
+    return q.normalized();
+  }
+
+  return Quaternion{Eigen::AngleAxisd(angle, rvec / angle)};
+}
+
 Quaternion euler123ToQuat(const Vec3 &euler) {
   const double alpha = euler(0);
   const double beta = euler(1);
@@ -0,0 +1,180 @@
+#include "atl/utils/state_machine.hpp"
+
+namespace atl {
+
+int StateMachine::addState(const int id,
+                           const std::string &name,
+                           const int parent,
+                           const std::function<void(void)> &entry,
+                           const std::function<void(void)> &exit) {
+  // pre-check
+  if (id < 0 || this->find(id) != -1) {
+    LOG_ERROR("Invalid or duplicate state id [%d]!", id);
+    return -1;
+  } else if (parent != -1 && this->find(parent) == -1) {
+    LOG_ERROR("Parent state [%d] not found!", parent);
+    return -2;
+  }
+
+  // add state
+  SMState state;
+  state.id = id;
+  state.name = name;
+  state.parent = parent;
+  state.entry = entry;
+  state.exit = exit;
+  this->states.push_back(state);
+
+  return 0;
+}
+
+int StateMachine::addTransition(const int from,
+                                const int to,
+                                const std::function<bool(void)> &guard,
+                                const std::function<void(void)> &action) {
+  // pre-check
+  if (this->find(from) == -1 || this->find(to) == -1) {
+    LOG_ERROR("Invalid transition [%d] -> [%d]!", from, to);
+    return -1;
+  }
+
+  // add transition
+  SMTransition transition;
+  transition.from = from;
+  transition.to = to;
+  transition.guard = guard;
+  transition.action = action;
+  this->transitions.push_back(transition);
+
+  return 0;
+}
+
+int StateMachine::start(const int id) {
+  // pre-check
+  if (this->find(id) == -1) {
+    LOG_ERROR("State [%d] not found!", id);
+    return -1;
+  }
+
+  this->current = -1;
+  return this->transition(id);
+}
+
+void StateMachine::stop() {
+  for (int s = this->current; s != -1;) {
+    const SMState &state = this->states[this->find(s)];
+    if (state.exit) {
+      state.exit();
+    }
+    s = state.parent;
+  }
+  this->current = -1;
+}
+
+int StateMachine::transition(const int id,
+                             const std::function<void(void)> &action) {
+  // pre-check
+  if (this->find(id) == -1) {
+    LOG_ERROR("State [%d] not found!", id);
+    return -1;
+  }
+
+  // target state and its ancestors, from the target upwards
+  std::vector<int> target_path;
+  for (int s = id; s != -1; s = this->states[this->find(s)].parent) {
+    target_path.push_back(s);
+  }
+
+  // exit up to the closest common ancestor, the target itself is always
+  // exited and re-entered if it is the current state or one of its parents
+  int lca = -1;
+  for (int s = this->current; s != -1;) {
+    const SMState &state = this->states[this->find(s)];
+    bool common = false;
+    for (size_t i = 1; i < target_path.size(); i++) {
+      common |= (target_path[i] == s);
+    }
+    if (common) {
+      lca = s;
+      break;
+    }
+    if (state.exit) {
+      state.exit();
+    }
+    s = state.parent;
+  }
+
+  // transition action
+  if (action) {
+    action();
+  }
+
+  // enter from below the common ancestor down to the target
+  this->current = id;
+  this->entry_time = this->clock();
+  size_t depth = 0;
+  while (depth < target_path.size() && target_path[depth] != lca) {
+    depth++;
+  }
+  for (size_t i = depth; i > 0; i--) {
+    const SMState &state = this->states[this->find(target_path[i - 1])];
+    if (state.entry) {
+      state.entry();
+    }
+  }
+
+  return 0;
+}
+
+int StateMachine::update() {
+  // pre-check
+  if (this->current == -1) {
+    return -1;
+  }
+
+  // check transitions of the current state, then of its ancestors
+  for (int s = this->current; s != -1;) {
+    for (size_t i = 0; i < this->transitions.size(); i++) {
+      const SMTransition &t = this->transitions[i];
+      if (t.from == s && (!t.guard || t.guard())) {
+        this->transition(t.to, t.action);
+        return 1;
+      }
+    }
+    s = this->states[this->find(s)].parent;
+  }
+
+  return 0;
+}
+
+bool StateMachine::isIn(const int id) const {
+  for (int s = this->current; s != -1;) {
+    if (s == id) {
+      return true;
+    }
+    s = this->states[this->find(s)].parent;
+  }
+
+  return false;
+}
+
+double StateMachine::timeInState() const {
+  return this->clock() - this->entry_time;
+}
+
+std::string StateMachine::currentName() const {
+  const int index = this->find(this->current);
+  return (index == -1) ? "" : this->states[index].name;
+}
+
+int StateMachine::find(const int id) const {
+  for (size_t i = 0; i < this->states.size(); i++) {
+    if (this->states[i].id == id) {
+      return (int) i;
+    }
+  }
+
+  return -1;
+}
+
+} // namespace atl
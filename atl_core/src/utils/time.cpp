@@ -23,4 +23,10 @@ double time_now() {
   return ((double) t.tv_sec + ((double) t.tv_usec) / 1000000.0);
 }
 
+double time_monotonic() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return ((double) t.tv_sec + ((double) t.tv_nsec) / 1000000000.0);
+}
+
 } // namespace atl
@@ -86,6 +86,18 @@ int MichiganDetector::extractTags(cv::Mat &image, std::vector<TagPose> &tags) {
   return 0;
 }
 
+/**
+ * Area of quadrilateral in pixels squared, corners in order (shoelace)
+ */
+static double
+polygon_area(const Vec2 &p1, const Vec2 &p2, const Vec2 &p3, const Vec2 &p4) {
+  const double sum = (p1(0) * p2(1) - p2(0) * p1(1)) +
+                     (p2(0) * p3(1) - p3(0) * p2(1)) +
+                     (p3(0) * p4(1) - p4(0) * p3(1)) +
+                     (p4(0) * p1(1) - p1(0) * p4(1));
+  return 0.5 * fabs(sum);
+}
+
 int MichiganDetector::obtainPose(apriltag_detection_t *tag, TagPose &tag_pose) {
   double tag_size = 0.0;
 
@@ -126,7 +138,7 @@ int MichiganDetector::obtainPose(apriltag_detection_t *tag, TagPose &tag_pose) {
     p2(1) = tag->p[1][1];
 
     p3(0) = tag->p[2][0];
-    p3(0) = tag->p[2][1];
+    p3(1) = tag->p[2][1];
 
     p4(0) = tag->p[3][0];
     p4(1) = tag->p[3][1];
@@ -139,7 +151,7 @@ int MichiganDetector::obtainPose(apriltag_detection_t *tag, TagPose &tag_pose) {
     p2(1) = tag->p[1][1];
 
     p3(0) = tag->p[2][0];
-    p3(0) = tag->p[2][1];
+    p3(1) = tag->p[2][1];
 
     p4(0) = tag->p[3][0];
     p4(1) = tag->p[3][1];
@@ -190,6 +202,8 @@ int MichiganDetector::obtainPose(apriltag_detection_t *tag, TagPose &tag_pose) {
   tag_pose.detected = true;
   tag_pose.position = t;
   tag_pose.orientation = Quaternion{R};
+  tag_pose.decision_margin = tag->decision_margin;
+  tag_pose.area = polygon_area(p1, p2, p3, p4);
 
   return 0;
 }
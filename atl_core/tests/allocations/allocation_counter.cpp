@@ -0,0 +1,63 @@
+#include <errno.h>
+#include <stdint.h>
+
+#include "allocation_counter.hpp"
+
+// glibc's own allocator, which the replacements below forward to
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+
+// allocations of each thread
+static thread_local size_t nb_allocations = 0;
+
+static inline void count_allocation() { nb_allocations++; }
+
+extern "C" {
+
+void *malloc(size_t size) {
+  count_allocation();
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size) {
+  count_allocation();
+  return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  count_allocation();
+  return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+  count_allocation();
+  return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+  count_allocation();
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+  count_allocation();
+  *ptr = __libc_memalign(alignment, size);
+  return (*ptr == NULL) ? ENOMEM : 0;
+}
+
+void free(void *ptr) { __libc_free(ptr); }
+
+} // extern "C"
+
+namespace atl {
+
+AllocationCounter::AllocationCounter() : start(nb_allocations) {}
+
+size_t AllocationCounter::count() const { return nb_allocations - start; }
+
+} // namespace atl
@@ -0,0 +1,30 @@
+#ifndef ATL_TESTS_ALLOCATION_COUNTER_HPP
+#define ATL_TESTS_ALLOCATION_COUNTER_HPP
+
+#include <stddef.h>
+
+namespace atl {
+
+/**
+ * Allocation counter
+ *
+ * Counts the heap allocations of the calling thread since it was created.
+ * `atl_alloc_tests` replaces `malloc()` and its relatives, so the count
+ * covers `operator new`, the standard containers and Eigen's aligned
+ * allocator alike. The replacement only exists in that executable, the
+ * other targets keep the system allocator.
+ */
+class AllocationCounter {
+public:
+  size_t start = 0;
+
+  AllocationCounter();
+
+  /**
+   * @return Number of allocations since construction
+   */
+  size_t count() const;
+};
+
+} // namespace atl
+#endif
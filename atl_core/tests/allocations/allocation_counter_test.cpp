@@ -0,0 +1,46 @@
+#include <atomic>
+#include <thread>
+
+#include "atl/atl_test.hpp"
+#include "atl/utils/math.hpp"
+
+#include "allocation_counter.hpp"
+
+namespace atl {
+
+TEST(AllocationCounter, count) {
+  // nothing allocated
+  AllocationCounter counter;
+  EXPECT_EQ(0u, counter.count());
+
+  // operator new, the vector and its buffer
+  std::vector<int> *v = new std::vector<int>(10);
+  EXPECT_EQ(2u, counter.count());
+  delete v;
+
+  // Eigen's aligned allocator and dynamic matrices
+  AllocationCounter eigen_counter;
+  std::vector<Vec2, Eigen::aligned_allocator<Vec2>> points(50);
+  MatX A(10, 10);
+  EXPECT_EQ(2u, eigen_counter.count());
+  EXPECT_EQ(4u, counter.count());
+
+  // reallocation
+  points.resize(100);
+  EXPECT_EQ(3u, eigen_counter.count());
+
+  // only the allocations of the calling thread, starting the thread
+  // allocates so the thread waits for the counter
+  std::atomic<bool> go{false};
+  std::thread thread([&go]() {
+    while (go == false) {
+    }
+    delete new std::vector<int>(10);
+  });
+  AllocationCounter thread_counter;
+  go = true;
+  thread.join();
+  EXPECT_EQ(0u, thread_counter.count());
+}
+
+} // namespace atl
@@ -0,0 +1,40 @@
+#include "atl/control/trajectory.hpp"
+#include "atl/atl_test.hpp"
+
+#include "../allocation_counter.hpp"
+
+#define TEST_TRAJ "tests/configs/trajectory/0.csv"
+
+namespace atl {
+
+TEST(Trajectory, updateAllocations) {
+  Trajectory traj;
+  Vec3 pos;
+  Vec2 wp_pos, wp_vel, wp_inputs;
+
+  pos << 0.0, 0.0, 5.0;
+  traj.load(1, TEST_TRAJ, pos);
+
+  // no allocations for the whole landing, and the waypoints stay where
+  // they are
+  const Vec2 *pos_data = traj.pos.data();
+  const Vec2 *vel_data = traj.vel.data();
+  const Vec2 *inputs_data = traj.inputs.data();
+  const Vec2 *rel_pos_data = traj.rel_pos.data();
+  const Vec2 *rel_vel_data = traj.rel_vel.data();
+  AllocationCounter counter;
+  for (int i = 0; i <= 500; i++) {
+    pos << 0.0, 0.0, 5.0 - i * 0.01;
+    traj.update(pos, wp_pos, wp_vel, wp_inputs);
+  }
+
+  EXPECT_EQ(0u, counter.count());
+  EXPECT_EQ(pos_data, traj.pos.data());
+  EXPECT_EQ(vel_data, traj.vel.data());
+  EXPECT_EQ(inputs_data, traj.inputs.data());
+  EXPECT_EQ(rel_pos_data, traj.rel_pos.data());
+  EXPECT_EQ(rel_vel_data, traj.rel_vel.data());
+  EXPECT_EQ(48, traj.cursor);
+}
+
+} // namespace atl
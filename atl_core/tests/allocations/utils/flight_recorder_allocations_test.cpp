@@ -0,0 +1,29 @@
+#include "atl/utils/flight_recorder.hpp"
+#include "atl/atl_test.hpp"
+
+#include "../allocation_counter.hpp"
+
+#define TEST_LOG "/tmp/flight_recorder_allocations_test.dat"
+
+namespace atl {
+
+TEST(Utils_flight_recorder, recordAllocations) {
+  FlightRecorder recorder;
+  recorder.flush_period = 0.001;
+  recorder.configure(TEST_LOG, {"t", "x", "y", "z"}, 1024);
+
+  // no allocations on the control thread, while the writer keeps draining
+  // and dropping rows once the ring buffer is full
+  AllocationCounter counter;
+  for (int i = 0; i < 50000; i++) {
+    const double row[4] = {(double) i, 1.0, 2.0, 3.0};
+    recorder.record(row);
+  }
+  EXPECT_EQ(0u, counter.count());
+
+  // and the writer did run alongside
+  recorder.close();
+  EXPECT_GT(recorder.nb_written, 0u);
+}
+
+} // namespace atl
@@ -0,0 +1,44 @@
+#include "atl/planning/library_generator.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_CONFIG "tests/configs/planning/library_generator.yaml"
+#define TEST_OUTPUT_DIR "/tmp/atl_library_generator_benchmark"
+
+namespace atl {
+
+static double generate(LibraryGenerator &generator, const int nb_threads) {
+  remove_dir(TEST_OUTPUT_DIR);
+  mkdir(TEST_OUTPUT_DIR, 0755);
+  generator.nb_threads = nb_threads;
+  EXPECT_EQ(0, generator.generate(TEST_OUTPUT_DIR));
+  EXPECT_EQ(generator.nbHeights() * generator.nbVelocities(),
+            generator.nb_solved.load());
+  return generator.throughput();
+}
+
+TEST(LibraryGenerator, benchmark) {
+  LibraryGenerator generator;
+
+  // the python planner's problem, 2 - 5 m onto targets at 1 - 8 m/s
+  generator.configure(TEST_CONFIG);
+  generator.z_min = 2.0;
+  generator.z_max = 5.0;
+  generator.v_min = 1.0;
+  generator.v_max = 8.0;
+  generator.dt = 0.08;
+  generator.chunk_size = 2;
+
+  const double serial = generate(generator, 1);
+  const double parallel = generate(generator, 0);
+  std::cout << "trajectories: " << generator.nb_solved.load() << "\t";
+  std::cout << "threads: " << std::thread::hardware_concurrency() << "\t";
+  std::cout << "serial [traj/s]: " << serial << "\t";
+  std::cout << "parallel [traj/s]: " << parallel << std::endl;
+
+  // the python job spends seconds per trajectory, and the thread pool must
+  // not be slower than a single thread
+  EXPECT_GE(parallel, 1.0);
+  EXPECT_GE(parallel, 0.9 * serial);
+}
+
+} // namespace atl
@@ -0,0 +1,51 @@
+#include "atl/planning/min_snap.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_CONFIG "tests/configs/planning/min_snap.yaml"
+
+namespace atl {
+
+TEST(MinSnapGenerator, benchmark) {
+  MinSnapGenerator generator;
+  Trajectory traj;
+  const Vec3 p0{0.0, 0.0, 5.0};
+  const int nb_solves = 200;
+  generator.configure(TEST_CONFIG);
+
+  // random start heights, velocities and target offsets
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> height(2.0, 8.0);
+  std::uniform_real_distribution<double> velocity(0.0, 4.0);
+  std::uniform_real_distribution<double> offset(0.0, 3.0);
+
+  int nb_solved = 0;
+  struct timespec t_start;
+  tic(&t_start);
+  for (int i = 0; i < nb_solves; i++) {
+    const double v = velocity(rng);
+    const Vec2 pos{0.0, height(rng)};
+    const Vec2 vel{v, 0.0};
+    const Vec2 target_pos{offset(rng), 0.0};
+    const Vec2 target_vel{v, 0.0};
+    const Vec2 acc{0.0, 0.0};
+    nb_solved += (generator.solve(pos, vel, acc, target_pos, target_vel) == 0);
+  }
+  const double t_solve = toc(&t_start) / nb_solves;
+
+  tic(&t_start);
+  for (int i = 0; i < nb_solves; i++) {
+    const Vec2 pos{0.0, 5.0};
+    const Vec2 vel{1.0, 0.0};
+    generator.generate(pos, vel, Vec2{1.0, 0.0}, vel, p0, traj);
+  }
+  const double t_generate = toc(&t_start) / nb_solves;
+
+  std::cout << "solved: " << nb_solved << "/" << nb_solves << "\t";
+  std::cout << "evaluated: " << generator.nb_evaluated << "\t";
+  std::cout << "solve [us]: " << t_solve * 1e6 << "\t";
+  std::cout << "generate [us]: " << t_generate * 1e6 << std::endl;
+  EXPECT_EQ(nb_solves, nb_solved);
+  EXPECT_LT(t_solve, 1e-3);
+}
+
+} // namespace atl
@@ -0,0 +1,64 @@
+#include "atl/planning/model.hpp"
+#include "atl/atl_test.hpp"
+
+namespace atl {
+
+TEST(BatchSimulator, benchmark) {
+  BatchSimulator batch;
+  Simulator sim;
+  Vec4 x_init, x_final;
+  const int N = 1024;
+  const int nb_ts = 50;
+  const int nb_runs = 20;
+
+  // setup
+  x_init << 0.0, 1.0, 5.0, 0.0;
+  x_final << 5.0, 1.0, 0.0, 0.0;
+  batch.configure(x_init, x_final);
+  sim.configure(x_init, x_final, 1.0);
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<float> theta(-0.3, 0.3);
+  Eigen::MatrixXf AZ = Eigen::MatrixXf::Constant(N, nb_ts, 9.81);
+  Eigen::MatrixXf THETA(N, nb_ts);
+  for (int k = 0; k < N; k++) {
+    for (int i = 0; i < nb_ts; i++) {
+      THETA(k, i) = theta(rng);
+    }
+  }
+  std::vector<MatX> U(N, MatX(2, nb_ts));
+  for (int k = 0; k < N; k++) {
+    U[k].row(0) = AZ.row(k).cast<double>();
+    U[k].row(1) = THETA.row(k).cast<double>();
+  }
+
+  // best of the runs, so a preempted run does not skew the ratio
+  struct timespec t_start;
+  double t_loop = INFINITY;
+  double t_batch = INFINITY;
+  double checksum = 0.0;
+  MatX X;
+  for (int r = 0; r < nb_runs; r++) {
+    // looping simulate()
+    tic(&t_start);
+    for (int k = 0; k < N; k++) {
+      sim.simulate(0.1, 5.0, U[k], X);
+      checksum += sim.dist_error;
+    }
+    t_loop = std::min(t_loop, (double) toc(&t_start));
+
+    // batched
+    tic(&t_start);
+    batch.simulate(0.1, 5.0, AZ, THETA);
+    t_batch = std::min(t_batch, (double) toc(&t_start));
+    checksum -= batch.dist_error.sum();
+  }
+
+  std::cout << "rollouts: " << N << "\t";
+  std::cout << "loop [us]: " << t_loop * 1e6 << "\t";
+  std::cout << "batch [us]: " << t_batch * 1e6 << "\t";
+  std::cout << "speed up: " << t_loop / t_batch << std::endl;
+  EXPECT_NEAR(0.0, checksum / (nb_runs * N), 1e-3);
+  EXPECT_GE(t_loop / t_batch, 10.0);
+}
+
+} // namespace atl
@@ -0,0 +1,103 @@
+#include "atl/control/autotune.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_CONFIG "tests/configs/control/autotune/autotune.yaml"
+#define TEST_OUTPUT "/tmp/autotune_test.yaml"
+#define TEST_REPORT "/tmp/autotune_test.txt"
+
+namespace atl {
+
+TEST(AutoTuner, configure) {
+  AutoTuner tuner;
+
+  EXPECT_EQ(-1, tuner.configure("/nonexistent/autotune.yaml"));
+  EXPECT_EQ(0, tuner.configure(TEST_CONFIG));
+  EXPECT_TRUE(tuner.configured);
+  EXPECT_EQ("position", tuner.controller);
+  EXPECT_EQ(3u, tuner.axes.size());
+  EXPECT_FLOAT_EQ(0.005, tuner.dt);
+  EXPECT_EQ(8, tuner.population);
+  EXPECT_EQ(3, tuner.max_generations);
+
+  ASSERT_EQ(2u, tuner.scenarios.size());
+  EXPECT_EQ("step_x", tuner.scenarios[0].name);
+  EXPECT_EQ("step", tuner.scenarios[0].type);
+  EXPECT_FLOAT_EQ(1.0, tuner.scenarios[0].step(0));
+  EXPECT_EQ("hover", tuner.scenarios[1].type);
+  EXPECT_FLOAT_EQ(0.5, tuner.scenarios[1].wind(0));
+
+  // gains are (k_p, k_i, k_d) of pitch, roll and throttle
+  ASSERT_EQ(AUTOTUNE_NB_GAINS, tuner.initial_gains.size());
+  EXPECT_FLOAT_EQ(0.2, tuner.initial_gains(0));
+  EXPECT_FLOAT_EQ(0.1, tuner.initial_gains(2));
+  EXPECT_FLOAT_EQ(0.15, tuner.initial_gains(6));
+  EXPECT_FLOAT_EQ(0.05, tuner.initial_gains(8));
+}
+
+TEST(AutoTuner, simulate) {
+  AutoTuner tuner;
+  tuner.configure(TEST_CONFIG);
+
+  // hand tuned gains settle onto the step
+  TuningMetrics metrics;
+  metrics = tuner.simulate(tuner.scenarios[0], tuner.initial_gains);
+  EXPECT_FALSE(metrics.failed);
+  EXPECT_GT(metrics.ise, 0.0);
+  EXPECT_GT(metrics.effort, 0.0);
+  EXPECT_LT(metrics.ise, 4.0);
+
+  // wind pushes the quadrotor off the setpoint
+  metrics = tuner.simulate(tuner.scenarios[1], tuner.initial_gains);
+  EXPECT_FALSE(metrics.failed);
+  EXPECT_GT(metrics.ise, 0.0);
+
+  // zero gains drift away with the wind
+  VecX zero = VecX::Zero(AUTOTUNE_NB_GAINS);
+  TuningMetrics drift = tuner.simulate(tuner.scenarios[1], zero);
+  EXPECT_TRUE(drift.failed || drift.ise > metrics.ise);
+}
+
+TEST(AutoTuner, optimize) {
+  AutoTuner tuner;
+  EXPECT_EQ(-1, tuner.optimize());
+
+  tuner.configure(TEST_CONFIG);
+  EXPECT_EQ(0, tuner.optimize());
+  EXPECT_LE(tuner.best_cost, tuner.initial_cost);
+  EXPECT_EQ(4u, tuner.history.size());
+  EXPECT_EQ(8 * 4, tuner.nb_evaluations);
+  for (size_t i = 1; i < tuner.history.size(); i++) {
+    EXPECT_LE(tuner.history[i], tuner.history[i - 1]);
+  }
+
+  // result does not depend on the number of threads
+  AutoTuner serial;
+  serial.configure(TEST_CONFIG);
+  serial.nb_threads = 1;
+  serial.optimize();
+  EXPECT_TRUE(serial.best_gains.isApprox(tuner.best_gains));
+  EXPECT_DOUBLE_EQ(serial.best_cost, tuner.best_cost);
+}
+
+TEST(AutoTuner, saveConfigAndReport) {
+  AutoTuner tuner;
+  tuner.configure(TEST_CONFIG);
+  tuner.max_generations = 1;
+  tuner.optimize();
+
+  // tuned config loads back into the controller
+  EXPECT_EQ(0, tuner.saveConfig(TEST_OUTPUT));
+  PositionController controller;
+  EXPECT_EQ(0, controller.configure(TEST_OUTPUT));
+  EXPECT_NEAR(tuner.best_gains(0), controller.pid.k_p(0), 1e-3);
+  EXPECT_NEAR(tuner.best_gains(8), controller.pid.k_d(2), 1e-3);
+  EXPECT_FLOAT_EQ(0.5, controller.hover_throttle);
+
+  EXPECT_EQ(0, tuner.saveReport(TEST_REPORT));
+  std::ifstream report(TEST_REPORT);
+  std::string line;
+  std::getline(report, line);
+  EXPECT_EQ("controller: position", line);
+}
+
+} // namespace atl
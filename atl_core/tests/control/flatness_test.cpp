@@ -0,0 +1,162 @@
+#include "atl/control/flatness.hpp"
+#include "atl/atl_test.hpp"
+
+namespace atl {
+
+// circle of radius r at angular velocity w, 1 m above the origin, while
+// yawing at yaw_rate
+static FlatOutput circle(const double t) {
+  const double r = 2.0;
+  const double w = 1.5;
+  const double yaw_rate = 0.8;
+
+  FlatOutput flat;
+  flat.pos << r * cos(w * t), r * sin(w * t), 1.0;
+  flat.vel << -r * w * sin(w * t), r * w * cos(w * t), 0.0;
+  flat.acc << -r * w * w * cos(w * t), -r * w * w * sin(w * t), 0.0;
+  flat.jerk << r * w * w * w * sin(w * t), -r * w * w * w * cos(w * t), 0.0;
+  flat.yaw = wrapToPi(yaw_rate * t);
+  flat.yaw_rate = yaw_rate;
+  return flat;
+}
+
+TEST(Flatness, hover) {
+  FlatOutput flat;
+  FlatState state;
+  flat.pos << 1.0, 2.0, 3.0;
+  flat.yaw = 0.5;
+
+  EXPECT_EQ(0, flatness_map(flat, 9.81, state));
+  EXPECT_FLOAT_EQ(9.81, state.thrust);
+  EXPECT_NEAR(0.0, state.rpy(0), 1e-9);
+  EXPECT_NEAR(0.0, state.rpy(1), 1e-9);
+  EXPECT_NEAR(0.5, state.rpy(2), 1e-9);
+  EXPECT_NEAR(0.0, state.omega.norm(), 1e-9);
+  EXPECT_TRUE(state.pos.isApprox(flat.pos));
+}
+
+TEST(Flatness, acceleration) {
+  FlatOutput flat;
+  FlatState state;
+
+  // accelerating forwards (+x) pitches forwards
+  flat.acc << 3.0, 0.0, 0.0;
+  EXPECT_EQ(0, flatness_map(flat, 9.81, state));
+  EXPECT_NEAR(atan2(3.0, 9.81), state.rpy(1), 1e-9);
+  EXPECT_NEAR(0.0, state.rpy(0), 1e-9);
+  EXPECT_NEAR(sqrt(9.0 + 9.81 * 9.81), state.thrust, 1e-9);
+
+  // accelerating left (+y) rolls left, which is a negative roll in NWU
+  flat.acc << 0.0, 3.0, 0.0;
+  EXPECT_EQ(0, flatness_map(flat, 9.81, state));
+  EXPECT_NEAR(-atan2(3.0, 9.81), state.rpy(0), 1e-9);
+
+  // free fall
+  flat.acc << 0.0, 0.0, -9.81;
+  EXPECT_EQ(-1, flatness_map(flat, 9.81, state));
+}
+
+TEST(Flatness, bodyRates) {
+  // body rates match the finite difference of the orientation
+  const double h = 1e-5;
+  for (double t = 0.0; t < 5.0; t += 0.37) {
+    FlatState state, prev, next;
+    flatness_map(circle(t), 9.81, state);
+    flatness_map(circle(t - h), 9.81, prev);
+    flatness_map(circle(t + h), 9.81, next);
+
+    const Mat3 R = state.orientation.toRotationMatrix();
+    const Mat3 R_prev = prev.orientation.toRotationMatrix();
+    const Mat3 R_next = next.orientation.toRotationMatrix();
+    const Mat3 dR = R.transpose() * (R_next - R_prev) / (2.0 * h);
+    const Vec3 omega{dR(2, 1), dR(0, 2), dR(1, 0)};
+    EXPECT_NEAR(omega(0), state.omega(0), 1e-5);
+    EXPECT_NEAR(omega(1), state.omega(1), 1e-5);
+    EXPECT_NEAR(omega(2), state.omega(2), 1e-5);
+  }
+}
+
+TEST(FlatnessPlan, plan) {
+  FlatnessPlan plan;
+  FlatState state;
+
+  EXPECT_EQ(-1, plan.evaluate(0.0, state));
+  EXPECT_EQ(-1, plan.plan(circle, 10.0, 0.0));
+  EXPECT_EQ(0, plan.plan(circle, 10.0, 0.01));
+  EXPECT_TRUE(plan.loaded);
+  EXPECT_EQ(1001u, plan.states.size());
+  EXPECT_FLOAT_EQ(10.0, plan.duration());
+
+  // interpolated plan matches the flatness map between samples
+  for (double t = 0.005; t < 10.0; t += 0.123) {
+    FlatState expected;
+    flatness_map(circle(t), 9.81, expected);
+    EXPECT_EQ(0, plan.evaluate(t, state));
+    EXPECT_LT((expected.pos - state.pos).norm(), 1e-3);
+    EXPECT_NEAR(expected.thrust, state.thrust, 1e-6);
+    EXPECT_LT(expected.orientation.angularDistance(state.orientation), 1e-3);
+    EXPECT_LT((expected.omega - state.omega).norm(), 1e-2);
+  }
+
+  // held outside of the plan
+  plan.evaluate(-1.0, state);
+  EXPECT_TRUE(state.pos.isApprox(plan.states.front().pos));
+  plan.evaluate(11.0, state);
+  EXPECT_TRUE(state.pos.isApprox(plan.states.back().pos));
+
+  plan.reset();
+  EXPECT_FALSE(plan.loaded);
+}
+
+TEST(FlatnessPlan, planFromSamples) {
+  // positions and velocities only, acceleration and jerk are differentiated
+  const double dt = 0.01;
+  std::vector<Vec3> pos, vel;
+  std::vector<double> yaw;
+  for (double t = 0.0; t <= 5.0; t += dt) {
+    const FlatOutput flat = circle(t);
+    pos.push_back(flat.pos);
+    vel.push_back(flat.vel);
+    yaw.push_back(flat.yaw);
+  }
+
+  FlatnessPlan plan;
+  EXPECT_EQ(-1, plan.plan(pos, {}, yaw, dt));
+  EXPECT_EQ(0, plan.plan(pos, vel, yaw, dt));
+
+  FlatState state, expected;
+  flatness_map(circle(2.0), 9.81, expected);
+  plan.evaluate(2.0, state);
+  EXPECT_NEAR(expected.thrust, state.thrust, 1e-3);
+  EXPECT_LT(expected.orientation.angularDistance(state.orientation), 1e-3);
+  EXPECT_LT((expected.omega - state.omega).norm(), 1e-3);
+}
+
+TEST(FlatnessPlan, evaluateBenchmark) {
+  FlatnessPlan short_plan, long_plan;
+  short_plan.plan(circle, 1.0, 0.01);
+  long_plan.plan(circle, 1000.0, 0.01);
+
+  // evaluation does not depend on the length of the plan
+  const int nb_evaluations = 100000;
+  double elapsed[2];
+  FlatnessPlan *plans[2] = {&short_plan, &long_plan};
+  for (int k = 0; k < 2; k++) {
+    FlatState state;
+    double thrust = 0.0;
+    struct timespec t_start;
+    tic(&t_start);
+    for (int i = 0; i < nb_evaluations; i++) {
+      const double t = fmod(i * 0.0137, plans[k]->duration());
+      plans[k]->evaluate(t, state);
+      thrust += state.thrust;
+    }
+    elapsed[k] = toc(&t_start) / nb_evaluations;
+    EXPECT_GT(thrust, 0.0);
+  }
+  std::cout << "evaluate [us] ";
+  std::cout << "1 s plan: " << elapsed[0] * 1e6 << "\t";
+  std::cout << "1000 s plan: " << elapsed[1] * 1e6 << std::endl;
+}
+
+} // namespace atl
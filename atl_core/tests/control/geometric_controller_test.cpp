@@ -0,0 +1,170 @@
+#include "atl/control/geometric_controller.hpp"
+#include "atl/atl_test.hpp"
+#include "atl/models/quadrotor.hpp"
+
+#define TEST_CONFIG "tests/configs/control/geometric_controller.yaml"
+
+namespace atl {
+
+TEST(GeometricController, configure) {
+  GeometricController controller;
+
+  EXPECT_EQ(0, controller.configure(TEST_CONFIG));
+  EXPECT_TRUE(controller.configured);
+  EXPECT_FLOAT_EQ(4.0, controller.k_x(0));
+  EXPECT_FLOAT_EQ(3.0, controller.k_v(2));
+  EXPECT_FLOAT_EQ(3.0, controller.k_R(2));
+  EXPECT_FLOAT_EQ(1.5, controller.k_omega(0));
+  EXPECT_FLOAT_EQ(1.0, controller.mass);
+  EXPECT_FLOAT_EQ(0.1927, controller.J(2, 2));
+  EXPECT_FLOAT_EQ(0.0, controller.J(0, 1));
+  EXPECT_FLOAT_EQ(0.6, controller.hover_throttle);
+  EXPECT_FLOAT_EQ(deg2rad(45.0), controller.max_tilt);
+}
+
+TEST(GeometricController, vee) {
+  const Vec3 x{1.0, 2.0, 3.0};
+  EXPECT_TRUE(x.isApprox(vee(skew(x))));
+}
+
+TEST(GeometricController, hover) {
+  GeometricController controller;
+  controller.configure(TEST_CONFIG);
+
+  // at the setpoint the thrust carries the weight and the body is level
+  const Vec3 zero{0.0, 0.0, 0.0};
+  const Vec3 pos{1.0, 2.0, 3.0};
+  const Mat3 R = Mat3::Identity();
+  const Vec4 outputs =
+      controller.update(pos, zero, zero, 0.0, pos, zero, R, 0.01);
+  EXPECT_NEAR(controller.mass * controller.g, controller.thrust, 1e-9);
+  EXPECT_TRUE(controller.R_d.isApprox(Mat3::Identity()));
+  EXPECT_NEAR(0.0, outputs(0), 1e-9);
+  EXPECT_NEAR(0.0, outputs(1), 1e-9);
+  EXPECT_NEAR(0.0, outputs(2), 1e-9);
+  EXPECT_NEAR(0.6, outputs(3), 1e-9);
+
+  const Vec3 M = controller.updateAttitude(controller.R_d, zero, R, zero);
+  EXPECT_NEAR(0.0, M.norm(), 1e-9);
+}
+
+TEST(GeometricController, attitudeCommand) {
+  GeometricController controller;
+  controller.configure(TEST_CONFIG);
+
+  // setpoint in front (+x) and to the left (+y) in NWU, facing 90 deg
+  const Vec3 zero{0.0, 0.0, 0.0};
+  const Vec3 pos{0.0, 0.0, 3.0};
+  const Mat3 R = Mat3::Identity();
+  controller.update(Vec3{0.5, 0.0, 3.0}, zero, zero, 0.0, pos, zero, R, 0.01);
+  EXPECT_GT(controller.outputs(1), 0.0);
+  EXPECT_NEAR(0.0, controller.outputs(0), 1e-9);
+
+  controller.update(Vec3{0.0, 0.5, 3.0}, zero, zero, 0.0, pos, zero, R, 0.01);
+  EXPECT_LT(controller.outputs(0), 0.0);
+  EXPECT_NEAR(0.0, controller.outputs(1), 1e-9);
+
+  controller.update(pos, zero, zero, M_PI / 2.0, pos, zero, R, 0.01);
+  EXPECT_NEAR(M_PI / 2.0, controller.outputs(2), 1e-9);
+
+  // tilt is limited for far away setpoints
+  const Vec3 far{100.0, 0.0, 3.0};
+  controller.update(far, zero, zero, 0.0, pos, zero, R, 0.01);
+  const double tilt = acos(controller.R_d(2, 2));
+  EXPECT_NEAR(controller.max_tilt, tilt, 1e-9);
+}
+
+TEST(GeometricController, yawWrap) {
+  GeometricController controller;
+  controller.configure(TEST_CONFIG);
+
+  // yaw error across +-180 deg is the short way round
+  const Vec3 zero{0.0, 0.0, 0.0};
+  const Mat3 R_d = rotz(M_PI - 0.1);
+  const Mat3 R = rotz(-M_PI + 0.1);
+  controller.updateAttitude(R_d, zero, R, zero);
+  EXPECT_NEAR(0.0, controller.e_R(0), 1e-9);
+  EXPECT_NEAR(0.0, controller.e_R(1), 1e-9);
+  EXPECT_NEAR(sin(0.2), controller.e_R(2), 1e-9);
+  EXPECT_LT(controller.moment(2), 0.0);
+}
+
+TEST(GeometricController, largeTiltRecovery) {
+  // start almost upside down and fall back to level hover
+  VecX pose(6);
+  pose << 0.0, 0.0, 10.0, 2.5, 0.3, 3.0;
+  QuadrotorModel quad(pose);
+  quad.position_setpoints = Vec3{0.0, 0.0, 10.0};
+  quad.yaw_setpoint = -3.0;
+
+  const double dt = 0.001;
+  for (double t = 0.0; t < 5.0; t += dt) {
+    quad.update(quad.geometricControllerControl(dt), dt);
+  }
+
+  EXPECT_NEAR(0.0, quad.attitude(0), 0.01);
+  EXPECT_NEAR(0.0, quad.attitude(1), 0.01);
+  EXPECT_NEAR(-3.0, quad.attitude(2), 0.01);
+  EXPECT_LT((quad.position - quad.position_setpoints).norm(), 0.2);
+}
+
+TEST(GeometricController, trackCircle) {
+  // circle of radius 2 m at 2 rad/s, 8 m/s^2 or ~39 deg of tilt, while
+  // spinning yaw through +-180 deg
+  const double r = 2.0;
+  const double w = 2.0;
+  VecX pose(6);
+  pose << r, 0.0, 5.0, 0.0, 0.0, 0.0;
+  QuadrotorModel quad(pose);
+  quad.linear_velocity << 0.0, r * w, 0.0;
+
+  const double dt = 0.001;
+  double max_error = 0.0;
+  double max_tilt = 0.0;
+  for (double t = 0.0; t < 10.0; t += dt) {
+    quad.position_setpoints << r * cos(w * t), r * sin(w * t), 5.0;
+    quad.velocity_setpoints << -r * w * sin(w * t), r * w * cos(w * t), 0.0;
+    quad.acceleration_setpoints << -r * w * w * cos(w * t),
+        -r * w * w * sin(w * t), 0.0;
+    quad.yaw_setpoint = wrapToPi(w * t);
+    quad.update(quad.geometricControllerControl(dt), dt);
+
+    // skip the transient
+    if (t > 3.0) {
+      const Vec3 e = quad.position - quad.position_setpoints;
+      const double tilt = acos(euler321ToRot(quad.attitude)(2, 2));
+      max_error = std::max(max_error, e.norm());
+      max_tilt = std::max(max_tilt, tilt);
+    }
+  }
+
+  EXPECT_GT(max_tilt, deg2rad(35.0));
+  EXPECT_LT(max_error, 0.15);
+}
+
+TEST(GeometricController, benchmark) {
+  GeometricController controller;
+  controller.configure(TEST_CONFIG);
+
+  const Vec3 zero{0.0, 0.0, 0.0};
+  const Vec3 omega{0.1, -0.2, 0.3};
+  const Mat3 R = euler321ToRot(Vec3{0.1, -0.2, 0.3});
+  const int nb_iterations = 100000;
+
+  // position and attitude loop
+  struct timespec t_start;
+  tic(&t_start);
+  Vec3 moment = zero;
+  for (int i = 0; i < nb_iterations; i++) {
+    const Vec3 pos{0.001 * i, 0.0, 3.0};
+    controller.update(zero, zero, zero, 0.5, pos, zero, R, 0.01);
+    moment += controller.updateAttitude(controller.R_d, zero, R, omega);
+  }
+  const double elapsed = toc(&t_start);
+  const double per_update = elapsed / nb_iterations;
+  std::cout << "update [us]: " << per_update * 1e6 << std::endl;
+
+  EXPECT_TRUE(moment.allFinite());
+}
+
+} // namespace atl
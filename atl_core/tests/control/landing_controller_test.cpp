@@ -12,17 +12,17 @@ TEST(LandingController, constructor) {
 
   EXPECT_FLOAT_EQ(0.0, controller.dt);
 
-  EXPECT_FLOAT_EQ(0.0, controller.x_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.x_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.x_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(0));
 
-  EXPECT_FLOAT_EQ(0.0, controller.y_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.y_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.y_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(1));
 
-  EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(0.0, controller.roll_limit[0]);
   EXPECT_FLOAT_EQ(0.0, controller.roll_limit[1]);
@@ -51,17 +51,17 @@ TEST(LandingController, configure) {
 
   EXPECT_FLOAT_EQ(0.0, controller.dt);
 
-  EXPECT_FLOAT_EQ(1.0, controller.x_controller.k_p);
-  EXPECT_FLOAT_EQ(2.0, controller.x_controller.k_i);
-  EXPECT_FLOAT_EQ(3.0, controller.x_controller.k_d);
+  EXPECT_FLOAT_EQ(1.0, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(2.0, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(3.0, controller.pid.k_d(0));
 
-  EXPECT_FLOAT_EQ(1.0, controller.y_controller.k_p);
-  EXPECT_FLOAT_EQ(2.0, controller.y_controller.k_i);
-  EXPECT_FLOAT_EQ(3.0, controller.y_controller.k_d);
+  EXPECT_FLOAT_EQ(1.0, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(2.0, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(3.0, controller.pid.k_d(1));
 
-  EXPECT_FLOAT_EQ(1.0, controller.vz_controller.k_p);
-  EXPECT_FLOAT_EQ(2.0, controller.vz_controller.k_i);
-  EXPECT_FLOAT_EQ(3.0, controller.vz_controller.k_d);
+  EXPECT_FLOAT_EQ(1.0, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(2.0, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(3.0, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(deg2rad(-20.0), controller.roll_limit[0]);
   EXPECT_FLOAT_EQ(deg2rad(20.0), controller.roll_limit[1]);
@@ -0,0 +1,271 @@
+#include "atl/control/landing_mpc.hpp"
+#include "atl/atl_test.hpp"
+#include "atl/control/landing_controller.hpp"
+#include "atl/models/quadrotor.hpp"
+
+#define TEST_CONFIG "tests/configs/control/landing_mpc.yaml"
+#define TEST_PID_CONFIG "tests/configs/control/landing_pid_benchmark.yaml"
+
+namespace atl {
+
+struct LandingResult {
+  bool landed = false;
+  double landing_time = 0.0;
+  double landing_error = 0.0;
+  std::vector<double> solve_times;
+};
+
+/**
+ * Land the quadrotor model on a target moving at constant velocity, the
+ * controller sees the true relative position and velocity of the target
+ */
+template <typename T>
+static LandingResult simulate_landing(T &controller,
+                                      const Vec3 &target_pos,
+                                      const Vec3 &target_vel) {
+  LandingResult result;
+  const double dt = 0.001;
+  const double max_time = 20.0;
+
+  VecX pose = VecX::Zero(6);
+  pose(2) = 3.0;
+  QuadrotorModel quad(pose);
+
+  for (double t = 0.0; t < max_time; t += dt) {
+    // relative target state
+    const Vec3 target = target_pos + t * target_vel;
+    const Vec3 pos_errors = target - quad.position;
+    const Vec3 vel_errors = target_vel - quad.linear_velocity;
+
+    // touchdown
+    if (quad.position(2) <= 0.05) {
+      result.landed = true;
+      result.landing_time = t;
+      result.landing_error = pos_errors.head(2).norm();
+      break;
+    }
+
+    // control
+    const Vec3 velocity = quad.linear_velocity;
+    const Vec4 outputs =
+        controller.update(pos_errors, vel_errors, velocity, dt);
+    if (controller.updated()) {
+      result.solve_times.push_back(controller.solveTime());
+    }
+    quad.attitude_setpoints = outputs;
+    quad.update(quad.attitudeControllerControl(dt), dt);
+  }
+
+  return result;
+}
+
+static double percentile(std::vector<double> x, const double p) {
+  if (x.size() == 0) {
+    return 0.0;
+  }
+  std::sort(x.begin(), x.end());
+  return x[(size_t) (p * (x.size() - 1))];
+}
+
+/**
+ * Common interface for the PID and MPC landing controllers
+ */
+struct PIDLanding {
+  LandingController controller;
+  double solve_time = 0.0;
+
+  // the PID tracks the position errors and the descent velocity only
+  Vec4 update(const Vec3 &pos_errors,
+              const Vec3 &,
+              const Vec3 &velocity_W,
+              double dt) {
+    struct timespec t;
+    tic(&t);
+    const Vec4 outputs =
+        this->controller.update(pos_errors, velocity_W, 0.0, dt);
+    this->solve_time = toc(&t);
+    return outputs;
+  }
+  bool updated() { return this->controller.dt == 0.0; }
+  double solveTime() { return this->solve_time; }
+};
+
+struct MPCLanding {
+  LandingMPC controller;
+
+  Vec4 update(const Vec3 &pos_errors,
+              const Vec3 &vel_errors,
+              const Vec3 &velocity_W,
+              double dt) {
+    return this->controller.update(pos_errors,
+                                   vel_errors,
+                                   velocity_W,
+                                   0.0,
+                                   dt);
+  }
+  bool updated() { return this->controller.dt == 0.0; }
+  double solveTime() { return this->controller.solve_time; }
+};
+
+TEST(LandingMPC, constructor) {
+  LandingMPC controller;
+
+  EXPECT_FALSE(controller.configured);
+
+  EXPECT_FLOAT_EQ(0.0, controller.dt);
+  EXPECT_FLOAT_EQ(0.0, controller.roll_limit[0]);
+  EXPECT_FLOAT_EQ(0.0, controller.roll_limit[1]);
+  EXPECT_FLOAT_EQ(0.0, controller.pitch_limit[0]);
+  EXPECT_FLOAT_EQ(0.0, controller.pitch_limit[1]);
+  EXPECT_FLOAT_EQ(0.0, controller.hover_throttle);
+
+  EXPECT_FLOAT_EQ(0.0, controller.outputs(0));
+  EXPECT_FLOAT_EQ(0.0, controller.outputs(1));
+  EXPECT_FLOAT_EQ(0.0, controller.outputs(2));
+  EXPECT_FLOAT_EQ(0.0, controller.outputs(3));
+}
+
+TEST(LandingMPC, configure) {
+  LandingMPC controller;
+
+  EXPECT_EQ(0, controller.configure(TEST_CONFIG));
+  EXPECT_TRUE(controller.configured);
+
+  EXPECT_FLOAT_EQ(0.1, controller.horizon_dt);
+  EXPECT_FLOAT_EQ(10.0, controller.q_position);
+  EXPECT_FLOAT_EQ(1.0, controller.q_velocity);
+  EXPECT_FLOAT_EQ(10.0, controller.q_terminal);
+  EXPECT_FLOAT_EQ(1.0, controller.r_input);
+  EXPECT_EQ(200, controller.max_iter);
+  EXPECT_FLOAT_EQ(1e-6, controller.tolerance);
+
+  EXPECT_FLOAT_EQ(deg2rad(-20.0), controller.roll_limit[0]);
+  EXPECT_FLOAT_EQ(deg2rad(20.0), controller.roll_limit[1]);
+  EXPECT_FLOAT_EQ(deg2rad(-20.0), controller.pitch_limit[0]);
+  EXPECT_FLOAT_EQ(deg2rad(20.0), controller.pitch_limit[1]);
+
+  EXPECT_FLOAT_EQ(0.1, controller.vz_controller.k_p);
+  EXPECT_FLOAT_EQ(0.5, controller.hover_throttle);
+  EXPECT_FLOAT_EQ(-0.3, controller.descent_velocity);
+
+  EXPECT_GT(controller.step_size, 0.0);
+}
+
+TEST(LandingMPC, buildQP) {
+  LandingMPC controller;
+  controller.configure(TEST_CONFIG);
+
+  // prediction matches rolling the model forward
+  const double dt = controller.horizon_dt;
+  LandingMPC::VecN u;
+  for (int i = 0; i < LandingMPC::N; i++) {
+    u(i) = sin(i * 0.3);
+  }
+  const Vec2 s0{1.0, -0.5};
+  const VecX S = controller.Phi * s0 + controller.Gamma * u;
+
+  Vec2 s = s0;
+  for (int k = 0; k < LandingMPC::N; k++) {
+    s(0) = s(0) + dt * s(1) - 0.5 * dt * dt * u(k);
+    s(1) = s(1) - dt * u(k);
+    EXPECT_NEAR(s(0), S(2 * k), 1e-9);
+    EXPECT_NEAR(s(1), S(2 * k + 1), 1e-9);
+  }
+
+  // hessian is symmetric positive definite
+  EXPECT_TRUE(controller.H.isApprox(controller.H.transpose()));
+  EXPECT_EQ(Eigen::Success, controller.H.llt().info());
+}
+
+TEST(LandingMPC, solve) {
+  LandingMPC controller;
+  controller.configure(TEST_CONFIG);
+
+  // unconstrained, target ahead so accelerate forwards first
+  LandingMPC::VecN u = LandingMPC::VecN::Zero();
+  const Vec2 s0{1.0, 0.0};
+  EXPECT_EQ(0, controller.solve(s0, -100.0, 100.0, u));
+  EXPECT_GT(u(0), 0.0);
+  const LandingMPC::VecN grad = controller.H * u + controller.F * s0;
+  EXPECT_NEAR(0.0, grad.norm(), 1e-9);
+
+  // constrained, check the projected gradient vanishes
+  const Vec2 s1{20.0, 0.0};
+  const double lb = -1.0;
+  const double ub = 1.0;
+  u.setZero();
+  const int nb_iter = controller.solve(s1, lb, ub, u);
+  EXPECT_GT(nb_iter, 0);
+  EXPECT_LE(u.maxCoeff(), ub);
+  EXPECT_GE(u.minCoeff(), lb);
+  EXPECT_FLOAT_EQ(ub, u(0));
+
+  const LandingMPC::VecN g = controller.H * u + controller.F * s1;
+  for (int i = 0; i < LandingMPC::N; i++) {
+    if (u(i) > lb + 1e-6 && u(i) < ub - 1e-6) {
+      EXPECT_NEAR(0.0, g(i), 1e-3);
+    } else if (u(i) >= ub - 1e-6) {
+      EXPECT_LE(g(i), 1e-3);
+    } else {
+      EXPECT_GE(g(i), -1e-3);
+    }
+  }
+
+  // warm start from the solution converges straight away
+  LandingMPC::VecN u_warm = u;
+  EXPECT_LT(controller.solve(s1, lb, ub, u_warm), nb_iter);
+  EXPECT_TRUE(u_warm.isApprox(u, 1e-4));
+}
+
+TEST(LandingMPC, update) {
+  LandingMPC controller;
+  controller.configure(TEST_CONFIG);
+
+  // target ahead and to the left, pitch forward and roll left (NWU)
+  const Vec3 pos_errors{1.0, 1.0, -3.0};
+  const Vec3 vel_errors{0.0, 0.0, 0.0};
+  const Vec3 velocity{0.0, 0.0, 0.0};
+  const Vec4 outputs =
+      controller.update(pos_errors, vel_errors, velocity, 0.2, 0.01);
+
+  EXPECT_GT(outputs(1), 0.0);
+  EXPECT_LT(outputs(0), 0.0);
+  EXPECT_FLOAT_EQ(0.2, outputs(2));
+  EXPECT_GT(outputs(3), 0.0);
+  EXPECT_LE(outputs(3), 1.0);
+}
+
+TEST(LandingMPC, closedLoopBenchmark) {
+  const Vec3 target_pos{2.0, -1.0, 0.0};
+  const Vec3 target_vel{0.5, 0.3, 0.0};
+
+  // pid
+  PIDLanding pid;
+  pid.controller.configure(TEST_PID_CONFIG);
+  const LandingResult pid_result =
+      simulate_landing(pid, target_pos, target_vel);
+
+  // mpc
+  MPCLanding mpc;
+  mpc.controller.configure(TEST_CONFIG);
+  const LandingResult mpc_result =
+      simulate_landing(mpc, target_pos, target_vel);
+
+  // report
+  const std::vector<double> &st = mpc_result.solve_times;
+  std::cout << "pid landing error [m]: " << pid_result.landing_error;
+  std::cout << "\t time [s]: " << pid_result.landing_time << std::endl;
+  std::cout << "mpc landing error [m]: " << mpc_result.landing_error;
+  std::cout << "\t time [s]: " << mpc_result.landing_time << std::endl;
+  std::cout << "mpc solve time [ms] ";
+  std::cout << "p50: " << percentile(st, 0.5) * 1000.0 << "\t";
+  std::cout << "p99: " << percentile(st, 0.99) * 1000.0 << "\t";
+  std::cout << "max: " << percentile(st, 1.0) * 1000.0 << std::endl;
+
+  EXPECT_TRUE(pid_result.landed);
+  EXPECT_TRUE(mpc_result.landed);
+  EXPECT_LT(mpc_result.landing_error, pid_result.landing_error);
+  EXPECT_LT(mpc_result.landing_error, 0.1);
+}
+
+} // namespace atl
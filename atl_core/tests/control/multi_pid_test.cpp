@@ -0,0 +1,210 @@
+#include "atl/control/multi_pid.hpp"
+#include "atl/atl_test.hpp"
+#include "atl/control/pid.hpp"
+
+#define TEST_CONFIG "tests/configs/control/multi_pid.yaml"
+
+namespace atl {
+
+typedef MultiPID<3>::ArrayN Array3;
+
+TEST(MultiPID, constructor) {
+  MultiPID<3> controller;
+
+  EXPECT_TRUE(controller.k_p.isZero());
+  EXPECT_TRUE(controller.k_i.isZero());
+  EXPECT_TRUE(controller.k_d.isZero());
+  EXPECT_TRUE(controller.b.isOnes());
+  EXPECT_TRUE(controller.c.isOnes());
+  EXPECT_TRUE(controller.tau_d.isZero());
+  EXPECT_FALSE(controller.schedule.loaded);
+
+  EXPECT_TRUE(controller.error_prev.isZero());
+  EXPECT_TRUE(controller.error_sum.isZero());
+  EXPECT_TRUE(controller.outputs.isZero());
+}
+
+TEST(MultiPID, configure) {
+  MultiPID<3> controller;
+
+  const std::vector<std::string> axes = {"x_controller",
+                                         "y_controller",
+                                         "z_controller"};
+  EXPECT_EQ(0, controller.configure(TEST_CONFIG, axes));
+
+  EXPECT_FLOAT_EQ(1.0, controller.k_p(0));
+  EXPECT_FLOAT_EQ(2.0, controller.k_i(0));
+  EXPECT_FLOAT_EQ(3.0, controller.k_d(0));
+  EXPECT_FLOAT_EQ(0.05, controller.tau_d(0));
+
+  EXPECT_FLOAT_EQ(4.0, controller.k_p(1));
+  EXPECT_FLOAT_EQ(5.0, controller.k_i(1));
+  EXPECT_FLOAT_EQ(6.0, controller.k_d(1));
+  EXPECT_FLOAT_EQ(0.5, controller.b(1));
+  EXPECT_FLOAT_EQ(0.0, controller.c(1));
+
+  EXPECT_FLOAT_EQ(7.0, controller.k_p(2));
+  EXPECT_FLOAT_EQ(8.0, controller.k_i(2));
+  EXPECT_FLOAT_EQ(9.0, controller.k_d(2));
+  EXPECT_FLOAT_EQ(0.0, controller.tau_d(2));
+  EXPECT_FLOAT_EQ(1.0, controller.b(2));
+
+  EXPECT_TRUE(controller.schedule.loaded);
+  EXPECT_EQ(3, (int) controller.schedule.breakpoints.size());
+  EXPECT_FLOAT_EQ(10.0, controller.schedule.k_p(2, 2));
+
+  // wrong number of axes
+  MultiPID<2> invalid;
+  EXPECT_EQ(-1, invalid.configure(TEST_CONFIG, axes));
+}
+
+TEST(MultiPID, update) {
+  MultiPID<3> controller;
+  controller.k_p = Array3{1.0, 2.0, 0.5};
+  controller.k_i = Array3{1.0, 0.1, 0.0};
+  controller.k_d = Array3{1.0, 0.0, 0.2};
+
+  // same outputs as one scalar PID per axis
+  PID pids[3];
+  for (int i = 0; i < 3; i++) {
+    pids[i] = PID(controller.k_p(i), controller.k_i(i), controller.k_d(i));
+  }
+
+  for (int k = 0; k < 20; k++) {
+    const Array3 setpoints{10.0, sin(k * 0.1), -1.0};
+    const Array3 actual{k * 0.5, 0.0, cos(k * 0.2)};
+    const Array3 outputs = controller.update(setpoints, actual, 0.1);
+
+    for (int i = 0; i < 3; i++) {
+      const double output = pids[i].update(setpoints(i), actual(i), 0.1);
+      EXPECT_NEAR(output, outputs(i), 1e-9);
+      EXPECT_NEAR(pids[i].error_sum, controller.error_sum(i), 1e-9);
+    }
+  }
+
+  // invalid time step keeps the previous outputs
+  const Array3 outputs = controller.outputs;
+  const Array3 error_sum = controller.error_sum;
+  const Array3 setpoints{1.0, 2.0, 3.0};
+  EXPECT_TRUE(controller.update(setpoints, 0.0).isApprox(outputs));
+  EXPECT_TRUE(controller.update(setpoints, -0.1).isApprox(outputs));
+  EXPECT_TRUE(controller.error_sum.isApprox(error_sum));
+  EXPECT_TRUE(controller.outputs.allFinite());
+}
+
+TEST(MultiPID, antiWindup) {
+  MultiPID<3> controller;
+  controller.k_p = Array3::Constant(1.0);
+  controller.k_i = Array3::Constant(1.0);
+  controller.output_min = Array3::Constant(-2.0);
+  controller.output_max = Array3::Constant(2.0);
+
+  // saturate for a long time
+  const Array3 errors{5.0, -5.0, 0.5};
+  for (int k = 0; k < 100; k++) {
+    controller.update(errors, 0.1);
+  }
+  EXPECT_FLOAT_EQ(5.0, controller.outputs(0));
+  EXPECT_FLOAT_EQ(-5.0, controller.outputs(1));
+  EXPECT_FLOAT_EQ(0.0, controller.error_sum(0));
+  EXPECT_FLOAT_EQ(0.0, controller.error_sum(1));
+  EXPECT_NEAR(2.0, controller.outputs(2), 0.1);
+
+  // integral not wound up, so the output leaves saturation straight away
+  const Array3 outputs = controller.update(-errors, 0.1);
+  EXPECT_LT(outputs(0), 0.0);
+  EXPECT_GT(outputs(1), 0.0);
+}
+
+TEST(MultiPID, derivativeFilter) {
+  MultiPID<3> controller;
+  controller.k_d = Array3::Constant(1.0);
+  controller.tau_d = Array3{0.0, 0.1, 1.0};
+
+  // step in error, a longer time constant gives a smaller kick
+  const Array3 outputs = controller.update(Array3::Ones(), 0.01);
+  EXPECT_FLOAT_EQ(100.0, outputs(0));
+  EXPECT_LT(outputs(1), outputs(0));
+  EXPECT_LT(outputs(2), outputs(1));
+  EXPECT_GT(outputs(2), 0.0);
+}
+
+TEST(MultiPID, setpointWeighting) {
+  MultiPID<3> controller;
+  controller.k_p = Array3::Constant(1.0);
+  controller.k_d = Array3::Constant(1.0);
+  controller.b = Array3{1.0, 0.5, 0.0};
+  controller.c = Array3{1.0, 0.0, 0.0};
+
+  // setpoint step does not kick the derivative when c = 0
+  const Array3 setpoints = Array3::Constant(2.0);
+  const Array3 outputs = controller.update(setpoints, Array3::Zero(), 0.1);
+  EXPECT_FLOAT_EQ(2.0, controller.error_p(0));
+  EXPECT_FLOAT_EQ(1.0, controller.error_p(1));
+  EXPECT_FLOAT_EQ(0.0, controller.error_p(2));
+  EXPECT_FLOAT_EQ(20.0, controller.error_d(0));
+  EXPECT_FLOAT_EQ(0.0, controller.error_d(1));
+  EXPECT_FLOAT_EQ(22.0, outputs(0));
+  EXPECT_FLOAT_EQ(1.0, outputs(1));
+}
+
+TEST(MultiPID, gainSchedule) {
+  MultiPID<3> controller;
+
+  const std::vector<std::string> axes = {"x_controller",
+                                         "y_controller",
+                                         "z_controller"};
+  controller.configure(TEST_CONFIG, axes);
+
+  // hold below first breakpoint
+  controller.scheduleGains(-1.0);
+  EXPECT_FLOAT_EQ(1.0, controller.k_p(0));
+  EXPECT_FLOAT_EQ(3.0, controller.k_d(0));
+
+  // interpolate
+  controller.scheduleGains(0.5);
+  EXPECT_FLOAT_EQ(1.5, controller.k_p(0));
+  EXPECT_FLOAT_EQ(4.5, controller.k_p(1));
+  EXPECT_FLOAT_EQ(2.0, controller.k_d(0));
+  EXPECT_FLOAT_EQ(5.0, controller.k_i(1));
+
+  controller.scheduleGains(2.0);
+  EXPECT_FLOAT_EQ(3.0, controller.k_p(0));
+  EXPECT_FLOAT_EQ(9.0, controller.k_p(2));
+
+  // hold above last breakpoint
+  controller.scheduleGains(10.0);
+  EXPECT_FLOAT_EQ(4.0, controller.k_p(0));
+  EXPECT_FLOAT_EQ(10.0, controller.k_p(2));
+  EXPECT_FLOAT_EQ(3.0, controller.k_d(2));
+}
+
+TEST(MultiPID, updateIntegral) {
+  MultiPID<3> controller;
+  controller.k_p = Array3::Constant(1.0);
+  controller.k_i = Array3::Constant(2.0);
+
+  const Array3 errors{1.0, 2.0, 3.0};
+  const Array3 error_sums{0.5, -0.5, 0.0};
+  const Array3 outputs = controller.updateIntegral(errors, error_sums, 0.1);
+  EXPECT_TRUE(controller.error_sum.isApprox(error_sums));
+  EXPECT_FLOAT_EQ(2.0, outputs(0));
+  EXPECT_FLOAT_EQ(1.0, outputs(1));
+  EXPECT_FLOAT_EQ(3.0, outputs(2));
+}
+
+TEST(MultiPID, reset) {
+  MultiPID<3> controller;
+  controller.k_p = Array3::Constant(1.0);
+  controller.k_i = Array3::Constant(1.0);
+  controller.update(Array3::Ones(), 0.1);
+
+  controller.reset();
+  EXPECT_TRUE(controller.error_prev.isZero());
+  EXPECT_TRUE(controller.error_sum.isZero());
+  EXPECT_TRUE(controller.derivative.isZero());
+  EXPECT_TRUE(controller.outputs.isZero());
+  EXPECT_FLOAT_EQ(1.0, controller.k_p(0));
+}
+
+} // namespace atl
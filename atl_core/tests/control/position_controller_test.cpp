@@ -12,17 +12,17 @@ TEST(PositionController, constructor) {
 
   EXPECT_FLOAT_EQ(0.0, controller.dt);
 
-  EXPECT_FLOAT_EQ(0.0, controller.x_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.x_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.x_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(0));
 
-  EXPECT_FLOAT_EQ(0.0, controller.y_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.y_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.y_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(1));
 
-  EXPECT_FLOAT_EQ(0.0, controller.z_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.z_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.z_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(0.0, controller.hover_throttle);
 
@@ -51,17 +51,17 @@ TEST(PositionController, configure) {
 
   EXPECT_FLOAT_EQ(0.0, controller.dt);
 
-  EXPECT_FLOAT_EQ(0.1, controller.x_controller.k_p);
-  EXPECT_FLOAT_EQ(0.2, controller.x_controller.k_i);
-  EXPECT_FLOAT_EQ(0.3, controller.x_controller.k_d);
+  EXPECT_FLOAT_EQ(0.1, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(0.2, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(0.3, controller.pid.k_d(0));
 
-  EXPECT_FLOAT_EQ(0.1, controller.y_controller.k_p);
-  EXPECT_FLOAT_EQ(0.2, controller.y_controller.k_i);
-  EXPECT_FLOAT_EQ(0.3, controller.y_controller.k_d);
+  EXPECT_FLOAT_EQ(0.1, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(0.2, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(0.3, controller.pid.k_d(1));
 
-  EXPECT_FLOAT_EQ(0.1, controller.z_controller.k_p);
-  EXPECT_FLOAT_EQ(0.2, controller.z_controller.k_i);
-  EXPECT_FLOAT_EQ(0.3, controller.z_controller.k_d);
+  EXPECT_FLOAT_EQ(0.1, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(0.2, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(0.3, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(0.6, controller.hover_throttle);
 
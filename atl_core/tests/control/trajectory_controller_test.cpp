@@ -2,6 +2,10 @@
 #include "atl/atl_test.hpp"
 
 #define TEST_CONFIG "tests/configs/control/trajectory_controller.yaml"
+#define TEST_FF_CONFIG "tests/configs/control/trajectory_controller_ff.yaml"
+#define TEST_GEN_CONFIG "tests/configs/control/trajectory_controller_gen.yaml"
+#define TEST_GEN_DT_CONFIG                                                     \
+  "tests/configs/control/trajectory_controller_gen_dt.yaml"
 
 namespace atl {
 
@@ -13,17 +17,17 @@ TEST(TrajectoryController, constructor) {
   EXPECT_FLOAT_EQ(0.0, controller.dt);
   EXPECT_FLOAT_EQ(0.0, controller.blackbox_dt);
 
-  // EXPECT_FLOAT_EQ(0.0, controller.vx_controller.k_p);
-  // EXPECT_FLOAT_EQ(0.0, controller.vx_controller.k_i);
-  // EXPECT_FLOAT_EQ(0.0, controller.vx_controller.k_d);
-  //
-  // EXPECT_FLOAT_EQ(0.0, controller.vy_controller.k_p);
-  // EXPECT_FLOAT_EQ(0.0, controller.vy_controller.k_i);
-  // EXPECT_FLOAT_EQ(0.0, controller.vy_controller.k_d);
-  //
-  // EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_p);
-  // EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_i);
-  // EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(0));
+
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(1));
+
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(0.0, controller.roll_limit[0]);
   EXPECT_FLOAT_EQ(0.0, controller.roll_limit[1]);
@@ -58,17 +62,17 @@ TEST(TrajectoryController, configure) {
   EXPECT_FLOAT_EQ(0.0, controller.dt);
   EXPECT_FLOAT_EQ(0.0, controller.blackbox_dt);
 
-  // EXPECT_FLOAT_EQ(1.0, controller.vx_controller.k_p);
-  // EXPECT_FLOAT_EQ(2.0, controller.vx_controller.k_i);
-  // EXPECT_FLOAT_EQ(3.0, controller.vx_controller.k_d);
-  //
-  // EXPECT_FLOAT_EQ(1.0, controller.vy_controller.k_p);
-  // EXPECT_FLOAT_EQ(2.0, controller.vy_controller.k_i);
-  // EXPECT_FLOAT_EQ(3.0, controller.vy_controller.k_d);
-  //
-  // EXPECT_FLOAT_EQ(1.0, controller.vz_controller.k_p);
-  // EXPECT_FLOAT_EQ(2.0, controller.vz_controller.k_i);
-  // EXPECT_FLOAT_EQ(3.0, controller.vz_controller.k_d);
+  EXPECT_FLOAT_EQ(1.0, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(2.0, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(3.0, controller.pid.k_d(0));
+
+  EXPECT_FLOAT_EQ(1.0, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(2.0, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(3.0, controller.pid.k_d(1));
+
+  EXPECT_FLOAT_EQ(1.0, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(2.0, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(3.0, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(deg2rad(-20.0), controller.roll_limit[0]);
   EXPECT_FLOAT_EQ(deg2rad(20.0), controller.roll_limit[1]);
@@ -107,7 +111,7 @@ TEST(TrajectoryController, loadTrajectory) {
   v = 0;
 
   controller.configure(TEST_CONFIG);
-  retval = controller.loadTrajectory(p0, pf, v);
+  retval = controller.loadTrajectory(p0, pf, Vec3{0.0, 0.0, 0.0}, v);
 
   EXPECT_EQ(0, retval);
   EXPECT_TRUE(controller.trajectory.loaded);
@@ -116,6 +120,93 @@ TEST(TrajectoryController, loadTrajectory) {
   EXPECT_EQ(50, controller.trajectory.inputs.size());
 }
 
+TEST(TrajectoryController, loadGeneratedTrajectory) {
+  TrajectoryController controller;
+  const Vec3 p0{0.0, 0.0, 5.0};
+  EXPECT_EQ(0, controller.configure(TEST_GEN_CONFIG));
+
+  // target 5 m away, ahead and to the left, driving along the body x-axis
+  const Vec3 target_pos_B{3.0, 4.0, -5.0};
+  const Vec3 target_vel_B{1.0, 0.0, 0.0};
+  EXPECT_EQ(0, controller.loadTrajectory(p0, target_pos_B, target_vel_B, 0.5));
+  EXPECT_TRUE(controller.trajectory.loaded);
+
+  // the target velocity is projected onto the plane towards the target
+  const MinSnapGenerator &generator = controller.generator;
+  EXPECT_NEAR(5.0, generator.target_pos(0), 1e-9);
+  EXPECT_NEAR(0.0, generator.target_pos(1), 1e-9);
+  EXPECT_NEAR(0.6, generator.target_vel(0), 1e-9);
+  EXPECT_NEAR(0.0, generator.target_vel(1), 1e-9);
+
+  // and the trajectory ends moving with the target
+  const Trajectory &traj = controller.trajectory;
+  EXPECT_NEAR(0.6, traj.vel.back()(0), 1e-6);
+  EXPECT_NEAR(0.0, traj.rel_vel.back()(0), 1e-6);
+
+  // the generator and trajectory time steps must agree
+  TrajectoryController mismatched;
+  EXPECT_EQ(-2, mismatched.configure(TEST_GEN_DT_CONFIG));
+  EXPECT_FALSE(mismatched.configured);
+}
+
+TEST(TrajectoryController, flatnessFeedForward) {
+  TrajectoryController controller;
+  const Vec3 p0{0.0, 0.0, 5.0};
+
+  EXPECT_EQ(0, controller.configure(TEST_FF_CONFIG));
+  EXPECT_EQ(FEED_FORWARD_FLATNESS, controller.feed_forward);
+  EXPECT_FLOAT_EQ(0.6, controller.hover_throttle);
+
+  // accelerate forwards at 0.5 m/s^2 while descending at 0.1 m/s
+  Trajectory &traj = controller.trajectory;
+  MatX traj_data = MatX::Zero(50, 10);
+  for (int i = 0; i < 50; i++) {
+    const double t = i * traj.dt;
+    traj_data(i, 0) = 0.25 * t * t;
+    traj_data(i, 1) = 0.5 * t;
+    traj_data(i, 2) = 5.0 - 0.1 * t;
+    traj_data(i, 3) = -0.1;
+  }
+  EXPECT_EQ(0, traj.load(0, traj_data, p0));
+  EXPECT_EQ(0, traj.planFeedForward());
+
+  // on waypoint i of the trajectory
+  const int i = 25;
+  const Vec3 pos{traj.pos[i](0), 0.0, traj.pos[i](1)};
+  const double yaw = 0.3;
+  EXPECT_EQ(0,
+            controller.update(Vec3::Zero(),
+                              Vec3::Zero(),
+                              pos,
+                              Vec3::Zero(),
+                              Quaternion::Identity(),
+                              yaw,
+                              0.1));
+  EXPECT_NEAR(i * traj.dt, traj.wp_time, 1e-6);
+
+  // attitude and thrust of the flatness map at the waypoint
+  FlatOutput flat;
+  FlatState expected;
+  flat.pos = pos;
+  flat.vel << traj.vel[i](0), 0.0, traj.vel[i](1);
+  flat.acc << 0.5, 0.0, 0.0;
+  EXPECT_EQ(0, flatness_map(flat, traj.plan.g, expected));
+  EXPECT_GT(fabs(expected.rpy(1)), 0.04);
+
+  const double thrust = 0.6 * expected.thrust / traj.plan.g;
+  EXPECT_NEAR(expected.rpy(0), controller.outputs(0), 1e-6);
+  EXPECT_NEAR(expected.rpy(1), controller.outputs(1), 1e-6);
+  EXPECT_NEAR(yaw + expected.rpy(2), controller.outputs(2), 1e-6);
+  EXPECT_NEAR(thrust, controller.outputs(3), 1e-6);
+
+  // loading a trajectory plans its feed-forward
+  traj.reset();
+  const Vec3 target_pos_B{5.0, 0.0, -5.0};
+  EXPECT_EQ(0, controller.loadTrajectory(p0, target_pos_B, Vec3::Zero(), 0.0));
+  EXPECT_TRUE(traj.plan.loaded);
+  EXPECT_EQ(traj.pos.size(), traj.plan.states.size());
+}
+
 // TEST(TrajectoryController, calculateVelocityErrors) {
 //   Vec3 v_errors;
 //   double dt;
@@ -49,4 +49,164 @@ TEST(TrajectoryIndex, find) {
   EXPECT_EQ(50, traj.rel_vel.size());
 }
 
+// index of n trajectories with random start heights and velocities
+static void random_index(const int n, TrajectoryIndex &index) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> height(1.0, 10.0);
+  std::uniform_real_distribution<double> velocity(-2.0, 2.0);
+
+  index.index_data.resize(n, 3);
+  for (int i = 0; i < n; i++) {
+    index.index_data(i, 0) = i;
+    index.index_data(i, 1) = height(rng);
+    index.index_data(i, 2) = velocity(rng);
+  }
+  index.pos_thres = 0.2;
+  index.vel_thres = 0.2;
+  index.build();
+}
+
+// brute force distances of every row to (z, v)
+static std::vector<std::pair<double, int>>
+brute_force(const TrajectoryIndex &index, const double z, const double v) {
+  std::vector<std::pair<double, int>> dists;
+  for (int i = 0; i < index.index_data.rows(); i++) {
+    const double dz = (z - index.index_data(i, 1)) / index.pos_thres;
+    const double dv = (v - index.index_data(i, 2)) / index.vel_thres;
+    dists.push_back({sqrt(dz * dz + dv * dv), i});
+  }
+  std::sort(dists.begin(), dists.end());
+  return dists;
+}
+
+TEST(TrajectoryIndex, loadInvalid) {
+  TrajectoryIndex index;
+
+  EXPECT_EQ(-1, index.load("/nonexistent/index.csv"));
+  EXPECT_EQ(-3, index.load(TEST_TRAJ_INDEX, 0.0, 0.2));
+  EXPECT_FALSE(index.loaded);
+}
+
+TEST(TrajectoryIndex, nearest) {
+  TrajectoryIndex index;
+  TrajectoryMatch match;
+
+  // not loaded
+  EXPECT_EQ(-1, index.nearest(5.0, 0.0, match));
+
+  // the nearest row is returned, not the first one within the thresholds
+  index.index_data.resize(3, 3);
+  index.index_data << 0, 5.15, 0.0,
+                      1, 5.0, 0.05,
+                      2, 8.0, 0.0;
+  index.pos_thres = 0.2;
+  index.vel_thres = 0.2;
+  EXPECT_EQ(0, index.build());
+  EXPECT_EQ(0, index.nearest(5.02, 0.0, match));
+  EXPECT_EQ(1, match.row);
+  EXPECT_EQ(1, match.index);
+  EXPECT_FLOAT_EQ(5.0, match.z);
+  EXPECT_NEAR(sqrt(0.1 * 0.1 + 0.25 * 0.25), match.distance, 1e-9);
+
+  // nothing within the thresholds
+  EXPECT_EQ(-2, index.nearest(6.5, 0.0, match));
+  EXPECT_EQ(-2, index.nearest(5.0, 0.5, match));
+}
+
+TEST(TrajectoryIndex, nearestRandom) {
+  TrajectoryIndex index;
+  random_index(2000, index);
+
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<double> height(0.0, 11.0);
+  std::uniform_real_distribution<double> velocity(-2.5, 2.5);
+  for (int i = 0; i < 200; i++) {
+    const double z = height(rng);
+    const double v = velocity(rng);
+    const auto expected = brute_force(index, z, v);
+
+    // k nearest match the brute force distances in order
+    std::vector<TrajectoryMatch> matches;
+    EXPECT_EQ(0, index.nearest(z, v, 5, matches));
+    ASSERT_EQ(5u, matches.size());
+    for (int k = 0; k < 5; k++) {
+      EXPECT_NEAR(expected[k].first, matches[k].distance, 1e-9);
+    }
+
+    // nearest within the thresholds
+    int best = -1;
+    for (auto &e : expected) {
+      const double dz = fabs(z - index.index_data(e.second, 1));
+      const double dv = fabs(v - index.index_data(e.second, 2));
+      if (dz < index.pos_thres && dv < index.vel_thres) {
+        best = e.second;
+        break;
+      }
+    }
+    TrajectoryMatch match;
+    const int retval = index.nearest(z, v, match);
+    EXPECT_EQ((best == -1) ? -2 : 0, retval);
+    if (best != -1) {
+      EXPECT_EQ(best, match.row);
+    }
+  }
+
+  // fewer rows than k
+  std::vector<TrajectoryMatch> matches;
+  random_index(3, index);
+  EXPECT_EQ(0, index.nearest(5.0, 0.0, 10, matches));
+  EXPECT_EQ(3u, matches.size());
+}
+
+TEST(TrajectoryIndex, benchmark) {
+  const int sizes[3] = {1000, 100000, 1000000};
+  const int nb_queries = 10000;
+
+  for (int s = 0; s < 3; s++) {
+    TrajectoryIndex index;
+    struct timespec t_start;
+    tic(&t_start);
+    random_index(sizes[s], index);
+    const double t_build = toc(&t_start);
+
+    // k-d tree
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> height(1.0, 10.0);
+    std::uniform_real_distribution<double> velocity(-2.0, 2.0);
+    int nb_found = 0;
+    tic(&t_start);
+    for (int i = 0; i < nb_queries; i++) {
+      TrajectoryMatch match;
+      nb_found += (index.nearest(height(rng), velocity(rng), match) == 0);
+    }
+    const double t_tree = toc(&t_start) / nb_queries;
+
+    // linear scan for the nearest row within the thresholds
+    const int nb_scans = std::max(1, nb_queries * 1000 / sizes[s]);
+    int nb_scanned = 0;
+    tic(&t_start);
+    for (int i = 0; i < nb_scans; i++) {
+      const double z = height(rng);
+      const double v = velocity(rng);
+      double best = -1.0;
+      for (int j = 0; j < index.index_data.rows(); j++) {
+        const double dz = (z - index.index_data(j, 1)) / index.pos_thres;
+        const double dv = (v - index.index_data(j, 2)) / index.vel_thres;
+        const double d = dz * dz + dv * dv;
+        if (fabs(dz) < 1.0 && fabs(dv) < 1.0 && (best < 0.0 || d < best)) {
+          best = d;
+        }
+      }
+      nb_scanned += (best >= 0.0);
+    }
+    const double t_scan = toc(&t_start) / nb_scans;
+
+    std::cout << "rows: " << sizes[s] << "\t";
+    std::cout << "build [ms]: " << t_build * 1e3 << "\t";
+    std::cout << "k-d tree [us]: " << t_tree * 1e6 << "\t";
+    std::cout << "linear scan [us]: " << t_scan * 1e6 << std::endl;
+    EXPECT_GT(nb_found + nb_scanned, 0);
+  }
+}
+
 } // end of atl namepsace
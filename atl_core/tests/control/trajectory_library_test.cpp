@@ -0,0 +1,159 @@
+#include "atl/control/trajectory_index.hpp"
+#include "atl/control/trajectory_library.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_TRAJ_INDEX "tests/configs/trajectory/index.csv"
+#define TEST_TRAJ "tests/configs/trajectory/0.csv"
+#define TEST_LIBRARY "/tmp/atl_trajectory_library.bin"
+
+namespace atl {
+
+TEST(TrajectoryLibrary, constructor) {
+  TrajectoryLibrary library;
+
+  EXPECT_FALSE(library.loaded);
+  EXPECT_EQ(0, library.nbTrajectories());
+}
+
+TEST(TrajectoryLibrary, create) {
+  TrajectoryLibrary library;
+  MatX traj_data;
+  int nb_rows;
+
+  // create and open
+  EXPECT_EQ(0, trajectory_library_create(TEST_TRAJ_INDEX, TEST_LIBRARY));
+  EXPECT_EQ(0, library.open(TEST_LIBRARY));
+  EXPECT_TRUE(library.loaded);
+  EXPECT_EQ(1, library.nbTrajectories());
+
+  // index table
+  EXPECT_EQ(0, library.entries[0].index);
+  EXPECT_EQ(50u, library.entries[0].nb_rows);
+  EXPECT_FLOAT_EQ(5.0, library.entries[0].z);
+  EXPECT_FLOAT_EQ(0.0, library.entries[0].v);
+
+  // records match the trajectory file
+  csv2mat(TEST_TRAJ, true, traj_data);
+  const float *records = library.trajectory(0, nb_rows);
+  ASSERT_TRUE(records != nullptr);
+  ASSERT_EQ(traj_data.rows(), nb_rows);
+  for (int i = 0; i < nb_rows; i++) {
+    for (int j = 0; j < 10; j++) {
+      EXPECT_FLOAT_EQ((float) traj_data(i, j), records[i * 10 + j]);
+    }
+  }
+
+  // out of range
+  EXPECT_TRUE(library.trajectory(1, nb_rows) == nullptr);
+  EXPECT_EQ(0, nb_rows);
+}
+
+TEST(TrajectoryLibrary, createInvalid) {
+  EXPECT_EQ(-1, trajectory_library_create("/nonexistent.csv", TEST_LIBRARY));
+  EXPECT_EQ(-3, trajectory_library_create(TEST_TRAJ_INDEX, "/nonexistent/x"));
+}
+
+TEST(TrajectoryLibrary, openInvalid) {
+  TrajectoryLibrary library;
+
+  // not found
+  EXPECT_EQ(-1, library.open("/nonexistent.bin"));
+
+  // not a trajectory library
+  EXPECT_EQ(-2, library.open(TEST_TRAJ));
+  EXPECT_FALSE(library.loaded);
+
+  // truncated
+  EXPECT_EQ(0, trajectory_library_create(TEST_TRAJ_INDEX, TEST_LIBRARY));
+  const std::string truncated = "/tmp/atl_trajectory_library_truncated.bin";
+  std::ifstream src(TEST_LIBRARY, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(src)),
+                    std::istreambuf_iterator<char>());
+  std::ofstream dst(truncated, std::ios::binary);
+  dst.write(bytes.data(), bytes.size() - 4);
+  dst.close();
+  EXPECT_EQ(-2, library.open(truncated));
+  EXPECT_FALSE(library.loaded);
+}
+
+TEST(TrajectoryLibrary, copy) {
+  TrajectoryLibrary library;
+  int nb_rows;
+
+  // copies share the mapping, it outlives the original
+  trajectory_library_create(TEST_TRAJ_INDEX, TEST_LIBRARY);
+  library.open(TEST_LIBRARY);
+  TrajectoryLibrary copy = library;
+  library.close();
+  EXPECT_FALSE(library.loaded);
+  EXPECT_TRUE(copy.loaded);
+  EXPECT_TRUE(copy.trajectory(0, nb_rows) != nullptr);
+  EXPECT_EQ(50, nb_rows);
+}
+
+TEST(TrajectoryLibrary, find) {
+  TrajectoryIndex csv_index;
+  TrajectoryIndex lib_index;
+  Trajectory csv_traj;
+  Trajectory lib_traj;
+  const Vec3 pos{0.0, 0.0, 5.0};
+
+  // setup
+  trajectory_library_create(TEST_TRAJ_INDEX, TEST_LIBRARY);
+  EXPECT_EQ(0, csv_index.load(TEST_TRAJ_INDEX));
+  EXPECT_EQ(0, lib_index.loadLibrary(TEST_LIBRARY));
+  EXPECT_EQ(-3, lib_index.loadLibrary(TEST_LIBRARY, 0.0, 0.2));
+  EXPECT_EQ(0, lib_index.loadLibrary(TEST_LIBRARY));
+  EXPECT_EQ(1, lib_index.index_data.rows());
+
+  // same trajectory from the library and the CSV file
+  EXPECT_EQ(0, csv_index.find(pos, 0.0, csv_traj));
+  EXPECT_EQ(0, lib_index.find(pos, 0.0, lib_traj));
+  EXPECT_EQ(0, lib_traj.index);
+  ASSERT_EQ(csv_traj.pos.size(), lib_traj.pos.size());
+  for (size_t i = 0; i < csv_traj.pos.size(); i++) {
+    EXPECT_TRUE(csv_traj.pos[i].isApprox(lib_traj.pos[i], 1e-6));
+    EXPECT_TRUE(csv_traj.vel[i].isApprox(lib_traj.vel[i], 1e-6));
+    EXPECT_TRUE(csv_traj.rel_pos[i].isApprox(lib_traj.rel_pos[i], 1e-6));
+  }
+  EXPECT_EQ(-2, lib_index.find(Vec3{0.0, 0.0, 9.0}, 0.0, lib_traj));
+}
+
+TEST(TrajectoryLibrary, benchmark) {
+  TrajectoryIndex csv_index;
+  TrajectoryIndex lib_index;
+  Trajectory traj;
+  const Vec3 pos{0.0, 0.0, 5.0};
+  const int nb_loads = 200;
+  struct timespec t_start;
+
+  // configure time
+  trajectory_library_create(TEST_TRAJ_INDEX, TEST_LIBRARY);
+  tic(&t_start);
+  csv_index.load(TEST_TRAJ_INDEX);
+  const double t_csv_load = toc(&t_start);
+  tic(&t_start);
+  lib_index.loadLibrary(TEST_LIBRARY);
+  const double t_lib_load = toc(&t_start);
+
+  // trajectory load latency
+  tic(&t_start);
+  for (int i = 0; i < nb_loads; i++) {
+    csv_index.find(pos, 0.0, traj);
+  }
+  const double t_csv = toc(&t_start) / nb_loads;
+
+  tic(&t_start);
+  for (int i = 0; i < nb_loads; i++) {
+    lib_index.find(pos, 0.0, traj);
+  }
+  const double t_lib = toc(&t_start) / nb_loads;
+
+  std::cout << "configure [us] csv: " << t_csv_load * 1e6;
+  std::cout << "\tlibrary: " << t_lib_load * 1e6 << std::endl;
+  std::cout << "find [us] csv: " << t_csv * 1e6;
+  std::cout << "\tlibrary: " << t_lib * 1e6 << std::endl;
+  EXPECT_LT(t_lib, t_csv);
+}
+
+} // namespace atl
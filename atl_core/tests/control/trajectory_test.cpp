@@ -28,6 +28,46 @@ TEST(Trajectory, load) {
   EXPECT_EQ(50, traj.inputs.size());
   EXPECT_EQ(50, traj.rel_pos.size());
   EXPECT_EQ(50, traj.rel_vel.size());
+
+  // no flatness plan until it is planned
+  EXPECT_FALSE(traj.plan.loaded);
+  EXPECT_FLOAT_EQ(0.0, traj.wp_time);
+
+  // a single waypoint has no segment to track
+  EXPECT_EQ(-2, traj.load(1, MatX::Zero(1, 10), pos));
+  EXPECT_FALSE(traj.loaded);
+}
+
+TEST(Trajectory, feedForward) {
+  Trajectory traj;
+  const Vec3 pos{0.0, 0.0, 5.0};
+  FlatState state;
+
+  // not loaded
+  EXPECT_EQ(-1, traj.planFeedForward());
+
+  // flatness plan over the trajectory, one state per row
+  traj.load(1, TEST_TRAJ, pos);
+  EXPECT_EQ(-1, traj.feedForward(state));
+  EXPECT_EQ(0, traj.planFeedForward());
+  EXPECT_EQ(0, traj.feedForward(state));
+  EXPECT_TRUE(traj.plan.loaded);
+  EXPECT_EQ(50, traj.plan.states.size());
+  EXPECT_FLOAT_EQ(49 * traj.dt, traj.plan.duration());
+
+  // a free fall loads and tracks, but has no feed-forward
+  MatX traj_data = MatX::Zero(10, 10);
+  for (int i = 0; i < 10; i++) {
+    const double t = i * traj.dt;
+    traj_data(i, 2) = 5.0 - 0.5 * 9.81 * t * t;
+    traj_data(i, 3) = -9.81 * t;
+  }
+  Vec2 wp_pos, wp_vel, wp_inputs;
+  EXPECT_EQ(0, traj.load(1, traj_data, pos));
+  EXPECT_EQ(0, traj.update(pos, wp_pos, wp_vel, wp_inputs));
+  EXPECT_EQ(-2, traj.planFeedForward());
+  EXPECT_EQ(-1, traj.feedForward(state));
+  EXPECT_FALSE(traj.plan.loaded);
 }
 
 TEST(Trajectory, update) {
@@ -38,11 +78,83 @@ TEST(Trajectory, update) {
   pos << 0.0, 0.0, 5.0;
   traj.load(1, TEST_TRAJ, pos);
 
-  // pos << 0.0, 0.0, 5.0;
-  // traj.update(pos, wp_pos, wp_vel, wp_inputs);
-  // EXPECT_FLOAT_EQ(0.0, wp_pos(0));
-  // EXPECT_FLOAT_EQ(5.0, wp_pos(1));
-  // EXPECT_FLOAT_EQ(0.0, wp_vel(0));
+  // the first segments hover at 5m, the tracked segment is the first one
+  // descending
+  EXPECT_EQ(0, traj.update(pos, wp_pos, wp_vel, wp_inputs));
+  EXPECT_EQ(2, traj.cursor);
+  EXPECT_NEAR(0.0, wp_pos(0), 1e-4);
+  EXPECT_NEAR(5.0, wp_pos(1), 1e-4);
+  EXPECT_NEAR(2 * traj.dt, traj.wp_time, 1e-6);
+
+  // descend along the trajectory one waypoint at a time, just past each
+  for (int i = 4; i < 49; i++) {
+    const double z = traj.pos[i](1) - 1e-4;
+    pos << 0.0, 0.0, z;
+    EXPECT_EQ(0, traj.update(pos, wp_pos, wp_vel, wp_inputs));
+    EXPECT_EQ(i, traj.cursor);
+    EXPECT_NEAR(z, wp_pos(1), 1e-6);
+    EXPECT_NEAR(i * traj.dt, traj.wp_time, 2e-3);
+  }
+}
+
+TEST(Trajectory, updateJump) {
+  Trajectory traj;
+  Vec3 pos;
+  Vec2 wp_pos, wp_vel, wp_inputs;
+
+  pos << 0.0, 0.0, 5.0;
+  traj.load(1, TEST_TRAJ, pos);
+  traj.update(pos, wp_pos, wp_vel, wp_inputs);
+
+  // jump 28 waypoints down in one update, halfway into segment 30
+  const double z = 0.5 * (traj.pos[30](1) + traj.pos[31](1));
+  pos << 0.0, 0.0, z;
+  EXPECT_EQ(0, traj.update(pos, wp_pos, wp_vel, wp_inputs));
+  EXPECT_EQ(30, traj.cursor);
+  EXPECT_NEAR(z, wp_pos(1), 1e-6);
+  EXPECT_TRUE(wp_vel.isApprox(lerp(traj.vel[30], traj.vel[31], 0.5), 1e-3));
+  EXPECT_NEAR(30.5 * traj.dt, traj.wp_time, 1e-3);
+
+  // the cursor never moves back
+  pos << 0.0, 0.0, 4.0;
+  traj.update(pos, wp_pos, wp_vel, wp_inputs);
+  EXPECT_EQ(30, traj.cursor);
+
+  // jump past the end of the trajectory
+  pos << 0.0, 0.0, -1.0;
+  traj.update(pos, wp_pos, wp_vel, wp_inputs);
+  EXPECT_EQ(48, traj.cursor);
+  EXPECT_NEAR(49 * traj.dt, traj.wp_time, 1e-6);
+  EXPECT_TRUE(wp_pos.isApprox(traj.pos.back()));
+  EXPECT_TRUE(wp_vel.isApprox(traj.vel.back()));
+  EXPECT_TRUE(wp_inputs.isApprox(traj.inputs.back()));
+}
+
+TEST(Trajectory, sample) {
+  Trajectory traj;
+  Vec3 pos;
+  Vec2 wp_pos, wp_vel, wp_inputs;
+
+  // not loaded
+  EXPECT_EQ(-1, traj.sample(0.0, wp_pos, wp_vel, wp_inputs));
+
+  // waypoints
+  pos << 0.0, 0.0, 5.0;
+  traj.load(1, TEST_TRAJ, pos);
+  EXPECT_EQ(0, traj.sample(10 * traj.dt, wp_pos, wp_vel, wp_inputs));
+  EXPECT_TRUE(wp_pos.isApprox(traj.pos[10]));
+  EXPECT_TRUE(wp_vel.isApprox(traj.vel[10]));
+  EXPECT_TRUE(wp_inputs.isApprox(traj.inputs[10]));
+
+  // between waypoints
+  traj.sample(10.25 * traj.dt, wp_pos, wp_vel, wp_inputs);
+  EXPECT_TRUE(wp_pos.isApprox(lerp(traj.pos[10], traj.pos[11], 0.25)));
+
+  // outside of the trajectory
+  traj.sample(-1.0, wp_pos, wp_vel, wp_inputs);
+  EXPECT_TRUE(wp_pos.isApprox(traj.pos[0]));
+  traj.sample(100.0, wp_pos, wp_vel, wp_inputs);
+  EXPECT_TRUE(wp_pos.isApprox(traj.pos[49]));
 }
 
 TEST(Trajectory, reset) {
@@ -55,6 +167,9 @@ TEST(Trajectory, reset) {
   EXPECT_EQ(0, traj.pos.size());
   EXPECT_EQ(0, traj.vel.size());
   EXPECT_EQ(0, traj.inputs.size());
+  EXPECT_EQ(0, traj.cursor);
+  EXPECT_FALSE(traj.plan.loaded);
+  EXPECT_FLOAT_EQ(0.0, traj.wp_time);
 }
 
 } // end of atl namepsace
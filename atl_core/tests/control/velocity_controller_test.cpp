@@ -12,17 +12,17 @@ TEST(VelocityController, constructor) {
 
   EXPECT_FLOAT_EQ(0.0, controller.dt);
 
-  EXPECT_FLOAT_EQ(0.0, controller.vx_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.vx_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.vx_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(0));
 
-  EXPECT_FLOAT_EQ(0.0, controller.vy_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.vy_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.vy_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(1));
 
-  EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.vz_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(0.0, controller.roll_limit[0]);
   EXPECT_FLOAT_EQ(0.0, controller.roll_limit[1]);
@@ -52,17 +52,17 @@ TEST(VelocityController, configure) {
 
   EXPECT_FLOAT_EQ(0.0, controller.dt);
 
-  EXPECT_FLOAT_EQ(0.1, controller.vx_controller.k_p);
-  EXPECT_FLOAT_EQ(0.2, controller.vx_controller.k_i);
-  EXPECT_FLOAT_EQ(0.3, controller.vx_controller.k_d);
+  EXPECT_FLOAT_EQ(0.1, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(0.2, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(0.3, controller.pid.k_d(0));
 
-  EXPECT_FLOAT_EQ(0.1, controller.vy_controller.k_p);
-  EXPECT_FLOAT_EQ(0.2, controller.vy_controller.k_i);
-  EXPECT_FLOAT_EQ(0.3, controller.vy_controller.k_d);
+  EXPECT_FLOAT_EQ(0.1, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(0.2, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(0.3, controller.pid.k_d(1));
 
-  EXPECT_FLOAT_EQ(0.1, controller.vz_controller.k_p);
-  EXPECT_FLOAT_EQ(0.2, controller.vz_controller.k_i);
-  EXPECT_FLOAT_EQ(0.3, controller.vz_controller.k_d);
+  EXPECT_FLOAT_EQ(0.1, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(0.2, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(0.3, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(deg2rad(-40.0), deg2rad(controller.roll_limit[0]));
   EXPECT_FLOAT_EQ(deg2rad(40.0), deg2rad(controller.roll_limit[1]));
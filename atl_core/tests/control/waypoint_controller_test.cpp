@@ -12,18 +12,15 @@ TEST(WaypointController, constructor) {
 
   EXPECT_FLOAT_EQ(0.0, controller.dt);
 
-  EXPECT_FLOAT_EQ(0.0, controller.at_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.at_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.at_controller.k_d);
-  EXPECT_FLOAT_EQ(0.0, controller.ct_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.ct_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.ct_controller.k_d);
-  EXPECT_FLOAT_EQ(0.0, controller.z_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.z_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.z_controller.k_d);
-  EXPECT_FLOAT_EQ(0.0, controller.yaw_controller.k_p);
-  EXPECT_FLOAT_EQ(0.0, controller.yaw_controller.k_i);
-  EXPECT_FLOAT_EQ(0.0, controller.yaw_controller.k_d);
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(0));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(1));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_p(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_i(2));
+  EXPECT_FLOAT_EQ(0.0, controller.pid.k_d(2));
 
   EXPECT_FLOAT_EQ(0.0, controller.roll_limit[0]);
   EXPECT_FLOAT_EQ(0.0, controller.roll_limit[1]);
@@ -11,24 +11,26 @@ TEST(LandingTarget, constructor) {
   EXPECT_FLOAT_EQ(0.0, landing_target.position_B(2));
   EXPECT_FALSE(landing_target.detected);
   EXPECT_TRUE(landing_target.losted);
-  EXPECT_FLOAT_EQ(0.0, landing_target.last_seen.tv_sec);
-  EXPECT_FLOAT_EQ(0.0, landing_target.last_seen.tv_nsec);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.last_seen);
 
   EXPECT_FLOAT_EQ(1000.0, landing_target.lost_threshold);
 }
 
 TEST(LandingTarget, isTargetLosted) {
   LandingTarget landing_target;
+  double t = 10.0;
+  landing_target.clock = [&t]() { return t; };
 
   // check initial LandingTarget::losted
   EXPECT_TRUE(landing_target.losted);
 
   // test LandingTarget::isTargetLosted() return false
-  tic(&landing_target.last_seen);
+  landing_target.last_seen = t;
+  t += 0.5 * landing_target.lost_threshold / 1000.0;
   EXPECT_FALSE(landing_target.isTargetLosted());
 
   // test LandingTarget::isTargetLosted() return true
-  sleep(landing_target.lost_threshold / 1000.0);
+  t += landing_target.lost_threshold / 1000.0;
   EXPECT_TRUE(landing_target.isTargetLosted());
 
   EXPECT_FLOAT_EQ(0.0, landing_target.position_B(0));
@@ -36,10 +38,8 @@ TEST(LandingTarget, isTargetLosted) {
   EXPECT_FLOAT_EQ(0.0, landing_target.position_B(2));
   EXPECT_FALSE(landing_target.detected);
   EXPECT_TRUE(landing_target.losted);
-  EXPECT_FLOAT_EQ(0.0, landing_target.first_seen.tv_sec);
-  EXPECT_FLOAT_EQ(0.0, landing_target.first_seen.tv_nsec);
-  EXPECT_FLOAT_EQ(0.0, landing_target.last_seen.tv_sec);
-  EXPECT_FLOAT_EQ(0.0, landing_target.last_seen.tv_nsec);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.first_seen);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.last_seen);
 }
 
 TEST(LandingTarget, setTargetPosition) {
@@ -57,8 +57,7 @@ TEST(LandingTarget, setTargetPosition) {
   EXPECT_FLOAT_EQ(0.0, landing_target.velocity_B(2));
   EXPECT_FALSE(landing_target.detected);
   EXPECT_TRUE(landing_target.losted);
-  EXPECT_EQ(0, landing_target.last_seen.tv_sec);
-  EXPECT_EQ(0, landing_target.last_seen.tv_nsec);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.last_seen);
 }
 
 TEST(LandingTarget, setTargetVelocity) {
@@ -76,23 +75,26 @@ TEST(LandingTarget, setTargetVelocity) {
   EXPECT_FLOAT_EQ(3.0, landing_target.velocity_B(2));
   EXPECT_FALSE(landing_target.detected);
   EXPECT_TRUE(landing_target.losted);
-  EXPECT_EQ(0, landing_target.last_seen.tv_sec);
-  EXPECT_EQ(0, landing_target.last_seen.tv_nsec);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.last_seen);
 }
 
 TEST(LandingTarget, tracked) {
   LandingTarget landing_target;
   Vec3 position;
+  double t = 10.0;
+  landing_target.clock = [&t]() { return t; };
+
+  EXPECT_FLOAT_EQ(0.0, landing_target.tracked());
 
   position << 1.0, 2.0, 3.0;
   landing_target.setTargetPosition(position);
   landing_target.update(true);
 
-  sleep(1);
-  ASSERT_NEAR(1000.0, landing_target.tracked(), 10.0);
+  t += 1.0;
+  ASSERT_NEAR(1000.0, landing_target.tracked(), 1e-6);
 
-  sleep(1);
-  ASSERT_NEAR(2000.0, landing_target.tracked(), 10.0);
+  t += 1.0;
+  ASSERT_NEAR(2000.0, landing_target.tracked(), 1e-6);
 }
 
 TEST(LandingTarget, reset) {
@@ -105,15 +107,15 @@ TEST(LandingTarget, reset) {
   EXPECT_FLOAT_EQ(0.0, landing_target.position_B(2));
   EXPECT_FALSE(landing_target.detected);
   EXPECT_TRUE(landing_target.losted);
-  EXPECT_FLOAT_EQ(0.0, landing_target.first_seen.tv_sec);
-  EXPECT_FLOAT_EQ(0.0, landing_target.first_seen.tv_nsec);
-  EXPECT_FLOAT_EQ(0.0, landing_target.last_seen.tv_sec);
-  EXPECT_FLOAT_EQ(0.0, landing_target.last_seen.tv_nsec);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.first_seen);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.last_seen);
 }
 
 TEST(LandingTarget, update) {
   LandingTarget landing_target;
   Vec3 position;
+  double t = 10.0;
+  landing_target.clock = [&t]() { return t; };
 
   // 1st update
   landing_target.lost_threshold = 2000;
@@ -124,10 +126,8 @@ TEST(LandingTarget, update) {
   EXPECT_FLOAT_EQ(0.0, landing_target.position_B(2));
   EXPECT_FALSE(landing_target.detected);
   EXPECT_TRUE(landing_target.losted);
-  EXPECT_EQ(0, landing_target.first_seen.tv_sec);
-  EXPECT_EQ(0, landing_target.first_seen.tv_nsec);
-  EXPECT_EQ(0, landing_target.last_seen.tv_sec);
-  EXPECT_EQ(0, landing_target.last_seen.tv_nsec);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.first_seen);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.last_seen);
 
   // 2rd update - set target position
   position << 1.0, 2.0, 3.0;
@@ -139,13 +139,11 @@ TEST(LandingTarget, update) {
   EXPECT_FLOAT_EQ(3.0, landing_target.position_B(2));
   EXPECT_TRUE(landing_target.detected);
   EXPECT_FALSE(landing_target.losted);
-  ASSERT_NE(0, landing_target.first_seen.tv_sec);
-  ASSERT_NE(0, landing_target.first_seen.tv_nsec);
-  ASSERT_NE(0, landing_target.last_seen.tv_sec);
-  ASSERT_NE(0, landing_target.last_seen.tv_nsec);
+  ASSERT_FLOAT_EQ(10.0, landing_target.first_seen);
+  ASSERT_FLOAT_EQ(10.0, landing_target.last_seen);
 
   // 3rd update - target not detected
-  sleep(1);
+  t += 1.0;
   position << 3.0, 2.0, 1.0;
   landing_target.setTargetPosition(position);
   landing_target.update(false);
@@ -155,13 +153,11 @@ TEST(LandingTarget, update) {
   EXPECT_FLOAT_EQ(1.0, landing_target.position_B(2));
   EXPECT_FALSE(landing_target.detected);
   EXPECT_FALSE(landing_target.losted);
-  ASSERT_NE(0, landing_target.first_seen.tv_sec);
-  ASSERT_NE(0, landing_target.first_seen.tv_nsec);
-  ASSERT_NE(0, landing_target.last_seen.tv_sec);
-  ASSERT_NE(0, landing_target.last_seen.tv_nsec);
+  ASSERT_FLOAT_EQ(10.0, landing_target.first_seen);
+  ASSERT_FLOAT_EQ(10.0, landing_target.last_seen);
 
   // 4th update - target losted
-  sleep(landing_target.lost_threshold / 1000.0);
+  t += landing_target.lost_threshold / 1000.0;
   landing_target.update(false);
 
   EXPECT_FLOAT_EQ(0.0, landing_target.position_B(0));
@@ -169,10 +165,8 @@ TEST(LandingTarget, update) {
   EXPECT_FLOAT_EQ(0.0, landing_target.position_B(2));
   EXPECT_FALSE(landing_target.detected);
   EXPECT_TRUE(landing_target.losted);
-  EXPECT_EQ(0, landing_target.first_seen.tv_sec);
-  EXPECT_EQ(0, landing_target.first_seen.tv_nsec);
-  EXPECT_EQ(0, landing_target.last_seen.tv_sec);
-  EXPECT_EQ(0, landing_target.last_seen.tv_nsec);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.first_seen);
+  EXPECT_FLOAT_EQ(-1.0, landing_target.last_seen);
 }
 
 } // namespace atl
@@ -0,0 +1,89 @@
+#include "atl/atl_test.hpp"
+#include "atl/estimation/inertial_filter.hpp"
+
+#define TEST_CONFIG "tests/configs/estimation/inertial_filter.yaml"
+
+namespace atl {
+
+TEST(InertialFilter, configure) {
+  InertialFilter filter;
+
+  EXPECT_EQ(0, filter.configure(TEST_CONFIG));
+  EXPECT_TRUE(filter.configured);
+  EXPECT_FLOAT_EQ(0.05, filter.accel_noise);
+  EXPECT_FLOAT_EQ(0.005, filter.gyro_noise);
+  EXPECT_FLOAT_EQ(0.5, filter.position_noise(0));
+  EXPECT_FLOAT_EQ(0.2, filter.init_accel_bias_std);
+  EXPECT_FLOAT_EQ(-9.81, filter.gravity(2));
+}
+
+TEST(InertialFilter, propagateAtRest) {
+  InertialFilter filter;
+  const Vec3 pos{1.0, 2.0, 3.0};
+  const Vec3 vel{0.0, 0.0, 0.0};
+  const Quaternion rot = euler321ToQuat(Vec3{0.0, 0.0, 1.0});
+
+  // not initialized
+  filter.configure(TEST_CONFIG);
+  EXPECT_EQ(-1, filter.propagate(IMUSample()));
+
+  // stationary IMU measures gravity only
+  filter.initialize(0.0, pos, vel, rot);
+  const Vec3 accel{0.0, 0.0, 9.81};
+  const Vec3 gyro{0.0, 0.0, 0.0};
+  for (int i = 1; i <= 1000; i++) {
+    EXPECT_EQ(0, filter.propagate(IMUSample(i * 0.005, accel, gyro)));
+  }
+
+  EXPECT_FLOAT_EQ(5.0, filter.t);
+  EXPECT_TRUE((filter.position - pos).norm() < 1e-9);
+  EXPECT_TRUE(filter.velocity.norm() < 1e-9);
+  EXPECT_TRUE(filter.orientation.isApprox(rot));
+
+  // uncertainty grows without corrections
+  EXPECT_TRUE(filter.P(0, 0) > 1.0);
+}
+
+TEST(InertialFilter, timestamps) {
+  InertialFilter filter;
+  const Vec3 zero{0.0, 0.0, 0.0};
+  const Vec3 accel{0.0, 0.0, 9.81};
+
+  filter.configure(TEST_CONFIG);
+  filter.initialize(1.0, zero, zero, Quaternion::Identity());
+
+  // out of order sample is ignored
+  EXPECT_EQ(0, filter.propagate(IMUSample(1.01, accel, zero)));
+  EXPECT_EQ(-2, filter.propagate(IMUSample(1.005, accel, zero)));
+  EXPECT_FLOAT_EQ(1.01, filter.t);
+
+  // gap larger than max_dt restarts integration
+  EXPECT_EQ(-3, filter.propagate(IMUSample(2.0, accel, zero)));
+  EXPECT_FLOAT_EQ(2.0, filter.t);
+
+  // correction ahead of the IMU holds the last sample up to its time
+  EXPECT_EQ(0, filter.correctPosition(2.05, zero));
+  EXPECT_FLOAT_EQ(2.05, filter.t);
+
+  // slightly late correction is applied, stale one is rejected
+  EXPECT_EQ(0, filter.correctPosition(1.95, zero));
+  EXPECT_EQ(-2, filter.correctPosition(1.5, zero));
+}
+
+TEST(InertialFilter, correctAttitude) {
+  InertialFilter filter;
+  const Vec3 zero{0.0, 0.0, 0.0};
+  const Quaternion measured = euler321ToQuat(Vec3{0.0, 0.0, 0.2});
+
+  filter.configure(TEST_CONFIG);
+  filter.initialize(0.0, zero, zero, Quaternion::Identity());
+
+  // repeated attitude corrections converge on measured yaw
+  for (int i = 0; i < 20; i++) {
+    filter.correctAttitude(0.0, measured);
+  }
+  EXPECT_NEAR(0.2, quatToEuler321(filter.orientation)(2), 1e-3);
+  EXPECT_TRUE(filter.P(8, 8) < pow(filter.attitude_noise(2), 2));
+}
+
+} // namespace atl
@@ -0,0 +1,232 @@
+#include <sys/stat.h>
+
+#include <fstream>
+#include <random>
+
+#include "atl/atl_test.hpp"
+#include "atl/estimation/inertial_replay.hpp"
+
+#define TEST_CONFIG "tests/configs/estimation/inertial_filter.yaml"
+#define TEST_DATA_DIR "/tmp/inertial_replay_test"
+
+namespace atl {
+
+/**
+ * Simulated flight, circling at 5 m radius while slowly bobbing up and down
+ * and rocking in roll and pitch
+ */
+static Vec3 sim_position(const double t) {
+  return Vec3{5.0 * cos(0.5 * t), 5.0 * sin(0.5 * t), 2.0 + sin(0.2 * t)};
+}
+
+static Vec3 sim_velocity(const double t) {
+  return Vec3{-2.5 * sin(0.5 * t), 2.5 * cos(0.5 * t), 0.2 * cos(0.2 * t)};
+}
+
+static Vec3 sim_acceleration(const double t) {
+  return Vec3{-1.25 * cos(0.5 * t),
+              -1.25 * sin(0.5 * t),
+              -0.04 * sin(0.2 * t)};
+}
+
+static Quaternion sim_orientation(const double t) {
+  const double roll = 0.1 * sin(t);
+  const double pitch = 0.1 * cos(0.7 * t);
+  const double yaw = 0.5 * t + M_PI / 2.0;
+
+  return Quaternion{Eigen::AngleAxisd(yaw, Vec3::UnitZ()) *
+                    Eigen::AngleAxisd(pitch, Vec3::UnitY()) *
+                    Eigen::AngleAxisd(roll, Vec3::UnitX())};
+}
+
+static Vec3 sim_angular_velocity(const double t) {
+  const double h = 1e-4;
+  const Quaternion dq =
+      sim_orientation(t - h).conjugate() * sim_orientation(t + h);
+  const Eigen::AngleAxisd aa{dq};
+  return aa.angle() * aa.axis() / (2.0 * h);
+}
+
+static void simulate(InertialReplay &replay, const double duration) {
+  std::default_random_engine rgen;
+  std::uniform_real_distribution<double> jitter(-0.001, 0.001);
+  std::normal_distribution<double> accel_noise(0.0, 0.05);
+  std::normal_distribution<double> gyro_noise(0.0, 0.005);
+  std::normal_distribution<double> gps_noise(0.0, 0.5);
+  std::normal_distribution<double> vel_noise(0.0, 0.05);
+  std::normal_distribution<double> att_noise(0.0, 0.01);
+  const Vec3 accel_bias{0.1, -0.1, 0.05};
+  const Vec3 gyro_bias{0.01, -0.01, 0.005};
+  const Vec3 gravity{0.0, 0.0, -9.81};
+
+  // IMU at roughly 200 Hz with jittery timestamps
+  const int nb_imu = duration / 0.005;
+  replay.imu.resize(nb_imu, 7);
+  for (int i = 0; i < nb_imu; i++) {
+    const double t = (i + 1) * 0.005 + jitter(rgen);
+    const Mat3 R = sim_orientation(t).toRotationMatrix();
+    const Vec3 noise_a{accel_noise(rgen), accel_noise(rgen), accel_noise(rgen)};
+    const Vec3 noise_g{gyro_noise(rgen), gyro_noise(rgen), gyro_noise(rgen)};
+    const Vec3 a = R.transpose() * (sim_acceleration(t) - gravity);
+    const Vec3 w = sim_angular_velocity(t);
+    replay.imu.row(i) << t, (a + accel_bias + noise_a).transpose(),
+        (w + gyro_bias + noise_g).transpose();
+  }
+
+  // GPS at 5 Hz
+  const int nb_gps = duration / 0.2;
+  replay.gps.resize(nb_gps, 4);
+  for (int i = 0; i < nb_gps; i++) {
+    const double t = i * 0.2;
+    const Vec3 noise{gps_noise(rgen), gps_noise(rgen), gps_noise(rgen)};
+    replay.gps.row(i) << t, (sim_position(t) + noise).transpose();
+  }
+
+  // velocity at 10 Hz
+  const int nb_vel = duration / 0.1;
+  replay.velocity.resize(nb_vel, 4);
+  for (int i = 0; i < nb_vel; i++) {
+    const double t = i * 0.1;
+    const Vec3 noise{vel_noise(rgen), vel_noise(rgen), vel_noise(rgen)};
+    replay.velocity.row(i) << t, (sim_velocity(t) + noise).transpose();
+  }
+
+  // attitude at 50 Hz
+  const int nb_att = duration / 0.02;
+  replay.attitude.resize(nb_att, 5);
+  for (int i = 0; i < nb_att; i++) {
+    const double t = i * 0.02;
+    const Vec3 noise{att_noise(rgen), att_noise(rgen), att_noise(rgen)};
+    const Quaternion q = sim_orientation(t) * rvec2quat(noise);
+    replay.attitude.row(i) << t, q.w(), q.x(), q.y(), q.z();
+  }
+}
+
+static void save_stream(const std::string &path,
+                        const std::string &header,
+                        const MatX &data) {
+  std::ofstream outfile(path);
+  outfile << header << std::endl;
+  outfile << std::setprecision(12);
+  for (int i = 0; i < data.rows(); i++) {
+    for (int j = 0; j < data.cols(); j++) {
+      outfile << data(i, j) << ((j + 1) != data.cols() ? "," : "\n");
+    }
+  }
+}
+
+TEST(InertialReplay, run) {
+  const double duration = 60.0;
+  InertialReplay replay;
+  InertialFilter filter;
+
+  // not configured
+  simulate(replay, duration);
+  EXPECT_EQ(-1, replay.run(filter));
+
+  // replay as fast as possible
+  struct timespec t_start;
+  filter.configure(TEST_CONFIG);
+  tic(&t_start);
+  EXPECT_EQ(0, replay.run(filter));
+  const double t_replay = toc(&t_start);
+  EXPECT_EQ(0, replay.nb_rejected);
+  EXPECT_TRUE(replay.estimates.rows() > 0.9 * replay.imu.rows());
+  EXPECT_TRUE(t_replay < duration);
+  std::cout << "replayed " << duration << "s in " << t_replay << "s";
+  std::cout << std::endl;
+
+  // evaluate after convergence
+  double pos_sse = 0.0;
+  double vel_sse = 0.0;
+  double att_max = 0.0;
+  int nb_samples = 0;
+  for (int i = 0; i < replay.estimates.rows(); i++) {
+    const double t = replay.estimates(i, 0);
+    if (t < 10.0) {
+      continue;
+    }
+
+    const Vec3 pos = replay.estimates.block(i, 1, 1, 3).transpose();
+    const Vec3 vel = replay.estimates.block(i, 4, 1, 3).transpose();
+    const Quaternion q{replay.estimates(i, 7),
+                       replay.estimates(i, 8),
+                       replay.estimates(i, 9),
+                       replay.estimates(i, 10)};
+    const Eigen::AngleAxisd att_err{q.conjugate() * sim_orientation(t)};
+
+    pos_sse += (pos - sim_position(t)).squaredNorm();
+    vel_sse += (vel - sim_velocity(t)).squaredNorm();
+    att_max = std::max(att_max, std::min(att_err.angle(),
+                                         2.0 * M_PI - att_err.angle()));
+    nb_samples++;
+  }
+  const double pos_rmse = sqrt(pos_sse / nb_samples);
+  const double vel_rmse = sqrt(vel_sse / nb_samples);
+  std::cout << "position rmse: " << pos_rmse << " m\t";
+  std::cout << "velocity rmse: " << vel_rmse << " m/s\t";
+  std::cout << "max attitude error: " << att_max << " rad" << std::endl;
+
+  // fused estimate beats raw GPS noise (0.5 m per axis)
+  EXPECT_TRUE(pos_rmse < 0.5);
+  EXPECT_TRUE(vel_rmse < 0.1);
+  EXPECT_TRUE(att_max < 0.05);
+
+  // gyro bias is observable and estimated
+  EXPECT_NEAR(0.01, filter.gyro_bias(0), 0.005);
+  EXPECT_NEAR(-0.01, filter.gyro_bias(1), 0.005);
+  EXPECT_NEAR(0.005, filter.gyro_bias(2), 0.005);
+}
+
+TEST(InertialReplay, deterministic) {
+  InertialReplay replay;
+  InertialFilter filter1;
+  InertialFilter filter2;
+
+  simulate(replay, 10.0);
+  filter1.configure(TEST_CONFIG);
+  filter2.configure(TEST_CONFIG);
+
+  replay.run(filter1);
+  const MatX estimates = replay.estimates;
+  replay.run(filter2);
+
+  EXPECT_EQ(estimates.rows(), replay.estimates.rows());
+  EXPECT_TRUE(estimates == replay.estimates);
+}
+
+TEST(InertialReplay, loadAndSave) {
+  InertialReplay recorded;
+  InertialReplay replay;
+  InertialFilter filter;
+
+  // record sensor streams
+  simulate(recorded, 5.0);
+  remove_dir(TEST_DATA_DIR);
+  mkdir(TEST_DATA_DIR, 0777);
+  // clang-format off
+  save_stream(TEST_DATA_DIR "/imu.csv", "t,ax,ay,az,wx,wy,wz", recorded.imu);
+  save_stream(TEST_DATA_DIR "/gps.csv", "t,x,y,z", recorded.gps);
+  save_stream(TEST_DATA_DIR "/attitude.csv", "t,qw,qx,qy,qz", recorded.attitude);
+  // clang-format on
+
+  // load and replay at 10x real time
+  EXPECT_EQ(0, replay.load(TEST_DATA_DIR));
+  EXPECT_EQ(recorded.imu.rows(), replay.imu.rows());
+  EXPECT_EQ(recorded.gps.rows(), replay.gps.rows());
+  EXPECT_EQ(0, replay.velocity.rows());
+  EXPECT_TRUE(replay.imu.isApprox(recorded.imu, 1e-9));
+
+  struct timespec t_start;
+  filter.configure(TEST_CONFIG);
+  replay.speed = 10.0;
+  tic(&t_start);
+  EXPECT_EQ(0, replay.run(filter));
+  EXPECT_NEAR(0.5, toc(&t_start), 0.1);
+
+  // save estimates
+  EXPECT_EQ(0, replay.save(TEST_DATA_DIR "/estimates.csv"));
+  EXPECT_EQ(replay.estimates.rows(), csvrows(TEST_DATA_DIR "/estimates.csv"));
+}
+
+} // namespace atl
@@ -6,6 +6,7 @@
 #include "atl/estimation/kf_tracker.hpp"
 
 #define TEST_CONFIG "tests/configs/estimation/kf_tracker.yaml"
+#define TEST_GATING_CONFIG "tests/configs/estimation/kf_tracker_gating.yaml"
 #define TEST_OUTPUT_FILE "/tmp/estimation_kf_tracker_test.output"
 
 namespace atl {
@@ -43,6 +44,276 @@ recordTimeStep(std::ofstream &output_file, int i, Vec3 mea, Vec3 est) {
   output_file << est(2) << std::endl;
 }
 
+/**
+ * Noisy log of a tag detected at 30 Hz while moving between 2 and 10 m away
+ * from the camera. Detection noise grows with the square of the range and
+ * shrinks with the decision margin, 3% of the detections are misdetections
+ * a few meters off with low decision margin.
+ */
+static void simulate_detections(std::vector<double> &time,
+                                std::vector<Vec3> &truth,
+                                std::vector<TagPose> &tags) {
+  std::default_random_engine rgen;
+  std::normal_distribution<double> noise(0.0, 1.0);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  const double focal = 500.0;  // pixels
+  const double tag_size = 0.5; // m
+  const double dt = 1.0 / 30.0;
+
+  for (int i = 0; i < 1800; i++) {
+    const double t = i * dt;
+    const Vec3 pos{2.0 * cos(0.3 * t),
+                   2.0 * sin(0.3 * t),
+                   6.0 + 4.0 * sin(0.1 * t)};
+    const double range = pos.norm();
+
+    TagPose tag;
+    tag.id = 0;
+    tag.detected = true;
+    tag.area = pow(focal * tag_size / range, 2);
+    tag.decision_margin = 60.0 + 140.0 * unit(rgen);
+    const double sigma = 0.02 * pow(range / 5.0, 2) *
+                         sqrt(100.0 / tag.decision_margin);
+    const Vec3 err{noise(rgen), noise(rgen), noise(rgen)};
+    tag.position = pos + sigma * err;
+
+    // misdetection
+    if (unit(rgen) < 0.03) {
+      tag.decision_margin = 50.0 + 20.0 * unit(rgen);
+      tag.position += (2.0 + 3.0 * unit(rgen)) * err.normalized();
+    }
+
+    time.push_back(t);
+    truth.push_back(pos);
+    tags.push_back(tag);
+  }
+}
+
+/**
+ * Replay detections through the tracker the way the estimator node does,
+ * resetting the tracker when the estimate fails the sanity check
+ */
+static void replay_detections(KFTracker &tracker,
+                              const std::vector<TagPose> &tags,
+                              const std::vector<Vec3> &truth,
+                              int &nb_resets,
+                              double &rmse) {
+  const double dt = 1.0 / 30.0;
+  MatX A(9, 9);
+  VecX mu = VecX::Zero(9);
+  Vec3 prev_pos = tags[0].position;
+  double sse = 0.0;
+
+  MATRIX_A_CONSTANT_ACCELERATION_XYZ(A);
+  mu.head(3) = tags[0].position;
+  tracker.initialize(mu);
+  nb_resets = 0;
+
+  for (size_t i = 1; i < tags.size(); i++) {
+    const int retval = tracker.estimate(A, tags[i]);
+    const Vec3 pos = tracker.mu.head(3);
+
+    if (retval == -4 || tracker.sanityCheck(prev_pos, pos) == -2) {
+      mu.head(3) = tags[i].position;
+      mu.tail(6).setZero();
+      tracker.initialize(mu);
+      nb_resets++;
+    }
+    if (retval != -3) {
+      prev_pos = tags[i].position;
+    }
+
+    sse += (tracker.mu.head(3) - truth[i]).squaredNorm();
+  }
+  rmse = sqrt(sse / (tags.size() - 1));
+}
+
+TEST(KFTracker, configure) {
+  KFTracker tracker;
+
+  EXPECT_EQ(0, tracker.configure(TEST_GATING_CONFIG));
+  EXPECT_FLOAT_EQ(11.345, tracker.gate_threshold);
+  EXPECT_EQ(15, tracker.max_rejected);
+  EXPECT_TRUE(tracker.noise_scaling);
+  EXPECT_FLOAT_EQ(5.0, tracker.ref_range);
+  EXPECT_FLOAT_EQ(100.0, tracker.ref_decision_margin);
+  EXPECT_FLOAT_EQ(2500.0, tracker.ref_area);
+  EXPECT_FALSE(tracker.adaptive_noise);
+
+  // gating and scaling are optional
+  KFTracker plain;
+  EXPECT_EQ(0, plain.configure(TEST_CONFIG));
+  EXPECT_FLOAT_EQ(FLT_MAX, plain.gate_threshold);
+  EXPECT_FALSE(plain.noise_scaling);
+}
+
+TEST(KFTracker, noiseScale) {
+  KFTracker tracker;
+  TagPose tag(0, true, Vec3{0.0, 0.0, 5.0}, Quaternion::Identity());
+
+  // disabled
+  tracker.configure(TEST_CONFIG);
+  tag.decision_margin = 10.0;
+  EXPECT_FLOAT_EQ(1.0, tracker.noiseScale(tag));
+
+  // at reference
+  tracker.configure(TEST_GATING_CONFIG);
+  tag.decision_margin = 100.0;
+  tag.area = 2500.0;
+  EXPECT_FLOAT_EQ(1.0, tracker.noiseScale(tag));
+
+  // twice as far, the tag is also 4 times smaller in the image
+  tag.position << 0.0, 0.0, 10.0;
+  tag.area = 625.0;
+  EXPECT_FLOAT_EQ(16.0, tracker.noiseScale(tag));
+
+  // less confident detection
+  tag.decision_margin = 50.0;
+  EXPECT_FLOAT_EQ(32.0, tracker.noiseScale(tag));
+
+  // clamped
+  tag.position << 0.0, 0.0, 100.0;
+  EXPECT_FLOAT_EQ(tracker.max_noise_scale, tracker.noiseScale(tag));
+}
+
+TEST(KFTracker, innovationGating) {
+  KFTracker tracker;
+  const double dt = 0.1;
+  MatX A(9, 9);
+  VecX mu = VecX::Zero(9);
+  VecX y = VecX::Zero(3);
+
+  tracker.configure(TEST_GATING_CONFIG);
+  tracker.initialize(mu);
+  MATRIX_A_CONSTANT_ACCELERATION_XYZ(A);
+
+  // settle on the origin
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(0, tracker.estimate(A, y));
+  }
+  EXPECT_TRUE(tracker.nis < tracker.gate_threshold);
+
+  // outlier is rejected and the estimate is the prediction
+  y << 3.0, 0.0, 0.0;
+  EXPECT_EQ(-3, tracker.estimate(A, y));
+  EXPECT_TRUE(tracker.nis > tracker.gate_threshold);
+  EXPECT_TRUE(tracker.mu.isApprox(tracker.mu_p));
+  EXPECT_EQ(1, tracker.nb_rejected);
+
+  // good measurement resets the count of rejected measurements
+  y << 0.0, 0.0, 0.0;
+  EXPECT_EQ(0, tracker.estimate(A, y));
+  EXPECT_EQ(0, tracker.nb_rejected);
+
+  // target moved, too many consecutive rejections
+  y << 3.0, 0.0, 0.0;
+  for (int i = 0; i < tracker.max_rejected; i++) {
+    EXPECT_EQ(-3, tracker.estimate(A, y));
+  }
+  EXPECT_EQ(-4, tracker.estimate(A, y));
+}
+
+TEST(KFTracker, missedDetections) {
+  KFTracker tracker;
+  const double dt = 0.1;
+  MatX A(9, 9);
+  VecX mu = VecX::Zero(9);
+  TagPose tag{0, true, Vec3{0.0, 0.0, 0.0}, Quaternion::Identity()};
+
+  tracker.configure(TEST_GATING_CONFIG);
+  tracker.adaptive_noise = true;
+  tracker.initialize(mu);
+  MATRIX_A_CONSTANT_ACCELERATION_XYZ(A);
+
+  // settle on the origin then reject an outlier
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(0, tracker.estimate(A, tag));
+  }
+  tag.position << 3.0, 0.0, 0.0;
+  EXPECT_EQ(-3, tracker.estimate(A, tag));
+  EXPECT_EQ(1, tracker.nb_rejected);
+
+  // missed detections only predict, the noise and the count of rejected
+  // measurements are left as is
+  const MatX Q = tracker.Q;
+  const MatX R = tracker.R;
+  tag.detected = false;
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(0, tracker.estimate(A, tag));
+    EXPECT_TRUE(tracker.mu.isApprox(tracker.mu_p));
+  }
+  EXPECT_TRUE(tracker.Q.isApprox(Q));
+  EXPECT_TRUE(tracker.R.isApprox(R));
+  EXPECT_EQ(1, tracker.nb_rejected);
+
+  // same with a measurement matrix that is all zero
+  tracker.C.setZero();
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(0, tracker.estimate(A, tag.position));
+  }
+  EXPECT_TRUE(tracker.Q.isApprox(Q));
+  EXPECT_TRUE(tracker.R.isApprox(R));
+  EXPECT_EQ(1, tracker.nb_rejected);
+}
+
+TEST(KFTracker, replayNoisyLog) {
+  std::vector<double> time;
+  std::vector<Vec3> truth;
+  std::vector<TagPose> tags;
+  simulate_detections(time, truth, tags);
+
+  // euclidean sanity check only
+  KFTracker baseline;
+  int baseline_resets = 0;
+  double baseline_rmse = 0.0;
+  baseline.configure(TEST_GATING_CONFIG);
+  baseline.gate_threshold = FLT_MAX;
+  baseline.noise_scaling = false;
+  replay_detections(baseline, tags, truth, baseline_resets, baseline_rmse);
+
+  // innovation gating and confidence scaled measurement noise
+  KFTracker tracker;
+  int resets = 0;
+  double rmse = 0.0;
+  tracker.configure(TEST_GATING_CONFIG);
+  replay_detections(tracker, tags, truth, resets, rmse);
+
+  std::cout << "baseline resets: " << baseline_resets << "\t";
+  std::cout << "rmse: " << baseline_rmse << " m" << std::endl;
+  std::cout << "gated resets: " << resets << "\t";
+  std::cout << "rmse: " << rmse << " m" << std::endl;
+  EXPECT_TRUE(resets < baseline_resets);
+  EXPECT_TRUE(rmse < 0.5 * baseline_rmse);
+}
+
+TEST(KFTracker, adaptiveNoise) {
+  std::vector<double> time;
+  std::vector<Vec3> truth;
+  std::vector<TagPose> tags;
+  simulate_detections(time, truth, tags);
+
+  // measurement noise 100 times too large
+  KFTracker fixed;
+  int fixed_resets = 0;
+  double fixed_rmse = 0.0;
+  fixed.configure(TEST_GATING_CONFIG);
+  fixed.Q *= 100.0;
+  replay_detections(fixed, tags, truth, fixed_resets, fixed_rmse);
+
+  // adapted from the innovation history
+  KFTracker adaptive;
+  int adaptive_resets = 0;
+  double adaptive_rmse = 0.0;
+  adaptive.configure(TEST_GATING_CONFIG);
+  adaptive.Q *= 100.0;
+  adaptive.adaptive_noise = true;
+  replay_detections(adaptive, tags, truth, adaptive_resets, adaptive_rmse);
+
+  std::cout << "fixed rmse: " << fixed_rmse << " m\t";
+  std::cout << "adaptive rmse: " << adaptive_rmse << " m" << std::endl;
+  EXPECT_TRUE(adaptive_rmse < fixed_rmse);
+}
+
 TEST(KFTracker, sanityCheck) {
   int retval;
   KFTracker tracker;
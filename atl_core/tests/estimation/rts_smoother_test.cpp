@@ -0,0 +1,223 @@
+#include <random>
+
+#include "atl/atl_test.hpp"
+#include "atl/estimation/kf_tracker.hpp"
+#include "atl/estimation/rts_smoother.hpp"
+
+namespace atl {
+
+/**
+ * Simulate constant velocity target along x, run the forward pass of a
+ * Kalman filter over noisy position measurements and record it
+ */
+static int simulate_flight(const int seed,
+                           const int nb_steps,
+                           RTSSmoother &rts,
+                           MatX &truth,
+                           MatX &measurements) {
+  std::default_random_engine rgen(seed);
+  std::normal_distribution<double> process_noise(0.0, 0.05);
+  std::normal_distribution<double> measurement_noise(0.0, 0.5);
+  const double dt = 0.02;
+  MatX A(2, 2), R(2, 2), C(1, 2), Q(1, 1);
+  VecX x(2), y(1);
+  KF kf;
+
+  // setup
+  // clang-format off
+  MATRIX_A_CONSTANT_VELOCITY_X(A);
+  R << 1e-4, 0.0,
+       0.0, pow(0.05, 2);
+  C << 1.0, 0.0;
+  Q << pow(0.5, 2);
+  x << 0.0, 1.0;
+  // clang-format on
+  kf.init(x, R, C, Q);
+  rts.clear();
+  rts.reserve(2, nb_steps);
+  truth.resize(nb_steps, 2);
+  measurements.resize(nb_steps, 1);
+
+  // forward pass
+  for (int k = 0; k < nb_steps; k++) {
+    x = A * x;
+    x(1) += process_noise(rgen);
+    y(0) = x(0) + measurement_noise(rgen);
+    truth.row(k) = x.transpose();
+    measurements.row(k) = y.transpose();
+
+    kf.estimate(A, y);
+    if (rts.record(kf, A) != 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+TEST(RTSSmoother, record) {
+  RTSSmoother rts;
+  KF kf;
+  MatX A = MatX::Identity(2, 2);
+
+  // not initialized
+  EXPECT_EQ(-1, rts.record(kf, A));
+
+  // record
+  kf.init(VecX::Zero(2), A, MatX::Identity(1, 2), MatX::Identity(1, 1));
+  kf.estimate(A, VecX::Ones(1));
+  EXPECT_EQ(0, rts.record(kf, A));
+  EXPECT_EQ(0, rts.record(kf, A));
+  EXPECT_EQ(2, rts.nb_states);
+  EXPECT_EQ(2, rts.nb_steps);
+  EXPECT_EQ(8, (int) rts.S.size());
+  EXPECT_TRUE(rts.filteredState(1).isApprox(kf.mu));
+
+  // number of states must not change
+  KF kf3;
+  const MatX I3 = MatX::Identity(3, 3);
+  kf3.init(VecX::Zero(3), I3, MatX::Identity(1, 3), MatX::Identity(1, 1));
+  EXPECT_EQ(-2, rts.record(kf3, I3));
+
+  // nothing to smooth
+  rts.clear();
+  EXPECT_EQ(-1, rts.smooth());
+}
+
+TEST(RTSSmoother, matchesBatchSolution) {
+  const int N = 20;
+  const int n = 2;
+  RTSSmoother rts;
+  MatX truth, Y;
+
+  // forward pass and smooth
+  simulate_flight(0, N, rts, truth, Y);
+  EXPECT_EQ(0, rts.smooth());
+
+  // same problem as one linear least squares in information form, the
+  // prior x0 ~ N(0, I) followed by N steps of x_k = A x_k-1 + w, y_k = C x_k
+  const double dt = 0.02;
+  MatX A(2, 2), R(2, 2), C(1, 2), Q(1, 1);
+  // clang-format off
+  MATRIX_A_CONSTANT_VELOCITY_X(A);
+  R << 1e-4, 0.0,
+       0.0, pow(0.05, 2);
+  C << 1.0, 0.0;
+  Q << pow(0.5, 2);
+  // clang-format on
+  const MatX R_inv = R.inverse();
+  const MatX Q_inv = Q.inverse();
+
+  MatX H = MatX::Zero(n * (N + 1), n * (N + 1));
+  VecX b = VecX::Zero(n * (N + 1));
+  VecX x0(2);
+  x0 << 0.0, 1.0;
+  H.block(0, 0, n, n) += MatX::Identity(n, n);
+  b.segment(0, n) += x0;
+  for (int k = 1; k <= N; k++) {
+    const int i = (k - 1) * n;
+    const int j = k * n;
+    H.block(i, i, n, n) += A.transpose() * R_inv * A;
+    H.block(i, j, n, n) -= A.transpose() * R_inv;
+    H.block(j, i, n, n) -= R_inv * A;
+    H.block(j, j, n, n) += R_inv + C.transpose() * Q_inv * C;
+    b.segment(j, n) += C.transpose() * Q_inv * Y.row(k - 1).transpose();
+  }
+  const VecX x_batch = H.ldlt().solve(b);
+  const MatX S_batch = H.inverse();
+
+  for (int k = 0; k < N; k++) {
+    const VecX x_k = x_batch.segment((k + 1) * n, n);
+    const MatX S_k = S_batch.block((k + 1) * n, (k + 1) * n, n, n);
+    EXPECT_TRUE((x_k - rts.smoothedState(k)).norm() < 1e-6);
+    EXPECT_TRUE((S_k - rts.smoothedCovariance(k)).norm() < 1e-6);
+  }
+}
+
+TEST(RTSSmoother, smoothBeatsFilter) {
+  const int N = 5000;
+  RTSSmoother rts;
+  MatX truth, Y;
+
+  simulate_flight(1, N, rts, truth, Y);
+  EXPECT_EQ(0, rts.smooth());
+
+  double filtered_sse = 0.0;
+  double smoothed_sse = 0.0;
+  for (int k = 0; k < N; k++) {
+    filtered_sse += pow(rts.filteredState(k)(0) - truth(k, 0), 2);
+    smoothed_sse += pow(rts.smoothedState(k)(0) - truth(k, 0), 2);
+
+    // smoothing never increases uncertainty
+    EXPECT_TRUE(rts.smoothedCovariance(k)(0, 0) <= rts.S[k * 4] + 1e-12);
+  }
+  const double filtered_rmse = sqrt(filtered_sse / N);
+  const double smoothed_rmse = sqrt(smoothed_sse / N);
+  std::cout << "filtered rmse: " << filtered_rmse << "\t";
+  std::cout << "smoothed rmse: " << smoothed_rmse << std::endl;
+  EXPECT_TRUE(smoothed_rmse < filtered_rmse);
+
+  // last step has no future measurements
+  EXPECT_TRUE(rts.smoothedState(N - 1).isApprox(rts.filteredState(N - 1)));
+}
+
+TEST(RTSSmoother, smoothFixedLag) {
+  const int N = 500;
+  RTSSmoother full;
+  RTSSmoother rts;
+  MatX truth, Y;
+
+  simulate_flight(2, N, full, truth, Y);
+  simulate_flight(2, N, rts, truth, Y);
+  full.smooth();
+
+  // zero lag is the filtered estimate
+  EXPECT_EQ(0, rts.smoothFixedLag(0));
+  for (int k = 0; k < N; k++) {
+    EXPECT_TRUE(rts.smoothedState(k).isApprox(rts.filteredState(k)));
+  }
+
+  // lag covering the flight is the full smoother
+  EXPECT_EQ(0, rts.smoothFixedLag(N));
+  for (int k = 0; k < N; k++) {
+    EXPECT_TRUE((rts.smoothedState(k) - full.smoothedState(k)).norm() < 1e-9);
+  }
+}
+
+TEST(RTSSmoother, smoothFlights) {
+  const int nb_flights = 16;
+  const int nb_steps = 6000; // 2 minutes at 50 Hz
+  std::vector<MatX> truths(nb_flights);
+  std::vector<MatX> measurements(nb_flights);
+  struct timespec t_start;
+
+  // forward pass and smooth flights, one thread and multiple threads
+  auto forward = [&](const int i, RTSSmoother &rts) {
+    return simulate_flight(i, nb_steps, rts, truths[i], measurements[i]);
+  };
+
+  std::vector<RTSSmoother> serial(nb_flights);
+  tic(&t_start);
+  EXPECT_EQ(0, smooth_flights(serial, 1, forward));
+  const double t_serial = toc(&t_start);
+
+  const int nb_cpus = std::thread::hardware_concurrency();
+  const int nb_threads = std::max(2, nb_cpus);
+  std::vector<RTSSmoother> parallel(nb_flights);
+  tic(&t_start);
+  EXPECT_EQ(0, smooth_flights(parallel, nb_threads, forward));
+  const double t_parallel = toc(&t_start);
+
+  // results must not depend on threading
+  for (int i = 0; i < nb_flights; i++) {
+    EXPECT_EQ(serial[i].nb_steps, parallel[i].nb_steps);
+    EXPECT_TRUE(serial[i].mu_s == parallel[i].mu_s);
+  }
+
+  const double log_hours = nb_flights * nb_steps * 0.02 / 3600.0;
+  std::cout << log_hours << " hours of log, ";
+  std::cout << "1 thread: " << t_serial << "s, ";
+  std::cout << nb_threads << " threads: " << t_parallel << "s" << std::endl;
+}
+
+} // namespace atl
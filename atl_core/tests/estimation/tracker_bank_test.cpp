@@ -0,0 +1,234 @@
+#include "atl/atl_test.hpp"
+#include "atl/estimation/kf.hpp"
+#include "atl/estimation/kf_tracker.hpp"
+#include "atl/estimation/tracker_bank.hpp"
+
+#define TEST_CONFIG "tests/configs/estimation/tracker_bank.yaml"
+
+namespace atl {
+
+TEST(TrackerBank, configure) {
+  TrackerBank bank;
+
+  EXPECT_EQ(0, bank.configure(TEST_CONFIG));
+  EXPECT_TRUE(bank.configured);
+  EXPECT_EQ(64, bank.max_tracks);
+  EXPECT_FLOAT_EQ(11.345, bank.gate_threshold);
+  EXPECT_FLOAT_EQ(1.0, bank.track_timeout);
+  EXPECT_FLOAT_EQ(0.1, bank.motion_noise(0));
+  EXPECT_FLOAT_EQ(0.5, bank.measurement_noise(2));
+  EXPECT_EQ(64, (int) bank.pos[0].size());
+  EXPECT_EQ(0, bank.nb_tracks);
+}
+
+TEST(TrackerBank, matchesKF) {
+  TrackerBank bank;
+  KF kf;
+  MatX A(9, 9), R(9, 9), C(3, 9), Q(3, 3);
+  VecX mu(9);
+
+  // setup bank with a single track
+  bank.configure(TEST_CONFIG);
+  const Vec3 pos{1.0, 2.0, 3.0};
+  bank.spawnTrack(TagPose(0, true, pos, Quaternion::Identity()), 0.0);
+
+  // setup equivalent dense kalman filter
+  // clang-format off
+  mu << 1.0, 2.0, 3.0,
+        0.0, 0.0, 0.0,
+        0.0, 0.0, 0.0;
+  R = MatX::Zero(9, 9);
+  R.block(0, 0, 3, 3) = bank.motion_noise(0) * Mat3::Identity();
+  R.block(3, 3, 3, 3) = bank.motion_noise(1) * Mat3::Identity();
+  R.block(6, 6, 3, 3) = bank.motion_noise(2) * Mat3::Identity();
+  C = MatX::Zero(3, 9);
+  C.block(0, 0, 3, 3) = Mat3::Identity();
+  Q = bank.measurement_noise.asDiagonal();
+  // clang-format on
+  kf.init(mu, R, C, Q);
+
+  // estimate
+  const double dt = 0.1;
+  for (int i = 0; i < 50; i++) {
+    const Vec3 y{1.0 + 0.5 * i * dt, 2.0 - 0.2 * i * dt, 3.0};
+
+    MATRIX_A_CONSTANT_ACCELERATION_XYZ(A);
+    kf.estimate(A, y);
+
+    bank.predict(dt);
+    bank.updateTrack(0, y, i * dt);
+  }
+
+  // assert
+  for (int i = 0; i < 3; i++) {
+    EXPECT_NEAR(kf.mu(i), bank.pos[i][0], 1e-9);
+    EXPECT_NEAR(kf.mu(3 + i), bank.vel[i][0], 1e-9);
+    EXPECT_NEAR(kf.mu(6 + i), bank.acc[i][0], 1e-9);
+    EXPECT_NEAR(kf.S(i, i), bank.S_pp[i][0], 1e-9);
+    EXPECT_NEAR(kf.S(i, 3 + i), bank.S_pv[i][0], 1e-9);
+    EXPECT_NEAR(kf.S(i, 6 + i), bank.S_pa[i][0], 1e-9);
+    EXPECT_NEAR(kf.S(3 + i, 3 + i), bank.S_vv[i][0], 1e-9);
+    EXPECT_NEAR(kf.S(3 + i, 6 + i), bank.S_va[i][0], 1e-9);
+    EXPECT_NEAR(kf.S(6 + i, 6 + i), bank.S_aa[i][0], 1e-9);
+  }
+}
+
+TEST(TrackerBank, associateById) {
+  TrackerBank bank;
+  std::vector<TagPose> tags;
+
+  // spawn two tracks
+  bank.configure(TEST_CONFIG);
+  tags.emplace_back(1, true, Vec3{0.0, 0.0, 0.0}, Quaternion::Identity());
+  tags.emplace_back(2, true, Vec3{0.1, 0.0, 0.0}, Quaternion::Identity());
+  bank.update(tags, 0.0);
+  EXPECT_EQ(2, bank.nb_tracks);
+
+  // tags swap order and overlap, ids must still be respected
+  tags.clear();
+  tags.emplace_back(2, true, Vec3{0.2, 0.0, 0.0}, Quaternion::Identity());
+  tags.emplace_back(1, true, Vec3{0.0, 0.1, 0.0}, Quaternion::Identity());
+  bank.predict(0.1);
+  bank.update(tags, 0.1);
+  EXPECT_EQ(2, bank.nb_tracks);
+
+  const int k1 = bank.findTag(1);
+  const int k2 = bank.findTag(2);
+  EXPECT_EQ(2, bank.nb_updates[k1]);
+  EXPECT_EQ(2, bank.nb_updates[k2]);
+  EXPECT_TRUE(bank.getPosition(k1)(1) > 0.0);
+  EXPECT_TRUE(bank.getPosition(k2)(0) > 0.1);
+}
+
+TEST(TrackerBank, mergeSameId) {
+  TrackerBank bank;
+  std::vector<TagPose> tags;
+
+  // the same tag detected twice in a frame spawns one track at the mean
+  bank.configure(TEST_CONFIG);
+  tags.emplace_back(1, true, Vec3{0.0, 0.0, 0.0}, Quaternion::Identity());
+  tags.emplace_back(1, true, Vec3{0.2, 0.0, 0.0}, Quaternion::Identity());
+  tags.emplace_back(2, true, Vec3{5.0, 0.0, 0.0}, Quaternion::Identity());
+  bank.update(tags, 0.0);
+  EXPECT_EQ(2, bank.nb_tracks);
+  EXPECT_NEAR(0.1, bank.getPosition(bank.findTag(1))(0), 1e-9);
+
+  // and updates the track once
+  tags.clear();
+  tags.emplace_back(1, true, Vec3{0.1, 0.0, 0.0}, Quaternion::Identity());
+  tags.emplace_back(2, true, Vec3{5.0, 0.0, 0.0}, Quaternion::Identity());
+  tags.emplace_back(1, true, Vec3{0.3, 0.0, 0.0}, Quaternion::Identity());
+  bank.predict(0.1);
+  bank.update(tags, 0.1);
+  EXPECT_EQ(2, bank.nb_tracks);
+  EXPECT_EQ(2, bank.nb_updates[bank.findTag(1)]);
+  EXPECT_EQ(2, bank.nb_updates[bank.findTag(2)]);
+}
+
+TEST(TrackerBank, associateByMahalanobis) {
+  TrackerBank bank;
+  std::vector<TagPose> tags;
+
+  // spawn two tracks far apart without tag ids
+  bank.configure(TEST_CONFIG);
+  tags.emplace_back(-1, true, Vec3{0.0, 0.0, 0.0}, Quaternion::Identity());
+  tags.emplace_back(-1, true, Vec3{10.0, 0.0, 0.0}, Quaternion::Identity());
+  bank.update(tags, 0.0);
+  EXPECT_EQ(2, bank.nb_tracks);
+  const int id0 = bank.track_id[0];
+  const int id1 = bank.track_id[1];
+
+  // measurements close to each track, in reverse order
+  tags.clear();
+  tags.emplace_back(-1, true, Vec3{10.2, 0.0, 0.0}, Quaternion::Identity());
+  tags.emplace_back(-1, true, Vec3{0.2, 0.0, 0.0}, Quaternion::Identity());
+  bank.predict(0.1);
+  bank.update(tags, 0.1);
+  EXPECT_EQ(2, bank.nb_tracks);
+  EXPECT_EQ(id0, bank.track_id[0]);
+  EXPECT_EQ(id1, bank.track_id[1]);
+  EXPECT_NEAR(0.2, bank.pos[0][0], 0.1);
+  EXPECT_NEAR(10.2, bank.pos[0][1], 0.1);
+
+  // measurement outside the gate spawns a new track
+  tags.clear();
+  tags.emplace_back(-1, true, Vec3{50.0, 0.0, 0.0}, Quaternion::Identity());
+  bank.predict(0.1);
+  bank.update(tags, 0.2);
+  EXPECT_EQ(3, bank.nb_tracks);
+}
+
+TEST(TrackerBank, spawnAndRetire) {
+  TrackerBank bank;
+  std::vector<TagPose> tags;
+
+  // spawn more tracks than the bank can hold
+  bank.configure(TEST_CONFIG);
+  bank.max_tracks = 4;
+  for (int i = 0; i < 6; i++) {
+    const Vec3 pos{i * 1.0, 0.0, 0.0};
+    tags.emplace_back(i, true, pos, Quaternion::Identity());
+  }
+  bank.update(tags, 0.0);
+  EXPECT_EQ(4, bank.nb_tracks);
+
+  // keep updating tag 3 only, others should retire after the timeout
+  tags.clear();
+  tags.emplace_back(3, true, Vec3{3.0, 0.0, 0.0}, Quaternion::Identity());
+  for (int i = 1; i <= 15; i++) {
+    bank.predict(0.1);
+    bank.update(tags, i * 0.1);
+  }
+  EXPECT_EQ(1, bank.nb_tracks);
+  EXPECT_EQ(3, bank.tag_id[0]);
+  EXPECT_EQ(-1, bank.findTag(0));
+}
+
+TEST(TrackerBank, benchmark) {
+  const int nb_tracks[3] = {1, 8, 64};
+  const int nb_steps = 10000;
+  const double dt = 0.01;
+
+  for (int i = 0; i < 3; i++) {
+    const int n = nb_tracks[i];
+    TrackerBank bank;
+    std::vector<KF> kfs(n);
+    MatX A(9, 9), C(3, 9);
+    struct timespec t_start;
+
+    // setup
+    bank.configure(TEST_CONFIG);
+    C = MatX::Zero(3, 9);
+    C.block(0, 0, 3, 3) = Mat3::Identity();
+    for (int k = 0; k < n; k++) {
+      const Vec3 pos{k * 1.0, 0.0, 0.0};
+      bank.spawnTrack(TagPose(k, true, pos, Quaternion::Identity()), 0.0);
+      kfs[k].init(VecX::Zero(9), MatX::Identity(9, 9), C, Mat3::Identity());
+    }
+
+    // batched prediction
+    tic(&t_start);
+    for (int s = 0; s < nb_steps; s++) {
+      bank.predict(dt);
+    }
+    const double t_bank = toc(&t_start);
+
+    // equivalent dense per-track prediction
+    MATRIX_A_CONSTANT_ACCELERATION_XYZ(A);
+    tic(&t_start);
+    for (int s = 0; s < nb_steps; s++) {
+      for (int k = 0; k < n; k++) {
+        kfs[k].mu_p = A * kfs[k].mu;
+        kfs[k].S_p = A * kfs[k].S * A.transpose() + kfs[k].R;
+      }
+    }
+    const double t_dense = toc(&t_start);
+
+    std::cout << "tracks: " << n << "\t";
+    std::cout << "bank: " << t_bank / nb_steps * 1e6 << " us/step\t";
+    std::cout << "dense kf: " << t_dense / nb_steps * 1e6 << " us/step";
+    std::cout << std::endl;
+  }
+}
+
+} // namespace atl
@@ -246,4 +246,45 @@ TEST(Mission, update) {
   EXPECT_EQ(3, mission.local_waypoints.size());
 }
 
+TEST(Mission, smoothPath) {
+  // fly a point robot towards the waypoint at constant speed, with and
+  // without the smoothed path
+  for (bool smooth : {false, true}) {
+    Mission mission;
+    mission.configure(TEST_CONFIG);
+    mission.smooth_path = smooth;
+    mission.look_ahead_dist = 1.0;
+    mission.threshold_waypoint_reached = 0.5;
+    EXPECT_EQ(0, mission.setHomePoint(43.474024, -80.540287));
+    EXPECT_EQ(smooth, mission.path.loaded);
+
+    Vec3 position = mission.local_waypoints[0];
+    Vec3 waypoint;
+    double heading_prev = mission.waypointHeading();
+    double heading_step = 0.0;
+    int retval = 0;
+    for (int i = 0; i < 2000 && retval == 0; i++) {
+      retval = mission.update(position, waypoint);
+      EXPECT_GT(mission.desiredVelocity(), 0.0);
+      EXPECT_LE(mission.desiredVelocity(), mission.desired_velocity + 1e-9);
+      const Vec3 dir = waypoint - position;
+      position += 0.05 * dir / dir.norm();
+
+      const double heading = mission.waypointHeading();
+      heading_step = std::max(heading_step,
+                              fabs(wrapToPi(heading - heading_prev)));
+      heading_prev = heading;
+    }
+    EXPECT_EQ(-2, retval);
+    EXPECT_TRUE(mission.completed);
+
+    // the heading turns gradually along the smoothed path
+    if (smooth) {
+      EXPECT_LT(heading_step, deg2rad(5.0));
+    } else {
+      EXPECT_GT(heading_step, deg2rad(45.0));
+    }
+  }
+}
+
 } // namespace atl
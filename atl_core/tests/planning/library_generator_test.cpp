@@ -0,0 +1,93 @@
+#include "atl/control/trajectory_index.hpp"
+#include "atl/planning/library_generator.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_CONFIG "tests/configs/planning/library_generator.yaml"
+#define TEST_OUTPUT_DIR "/tmp/atl_library_generator"
+
+namespace atl {
+
+static void setup_output_dir() {
+  remove_dir(TEST_OUTPUT_DIR);
+  mkdir(TEST_OUTPUT_DIR, 0755);
+}
+
+TEST(LibraryGenerator, configure) {
+  LibraryGenerator generator;
+
+  EXPECT_EQ(0, generator.configure(TEST_CONFIG));
+  EXPECT_TRUE(generator.configured);
+  EXPECT_EQ(2, generator.nbHeights());
+  EXPECT_EQ(3, generator.nbVelocities());
+  EXPECT_FLOAT_EQ(5.0, generator.height(1));
+  EXPECT_FLOAT_EQ(3.0, generator.velocity(2));
+  EXPECT_EQ(2, generator.nb_threads);
+  EXPECT_EQ(-1, generator.configure("/nonexistent.yaml"));
+}
+
+TEST(LibraryGenerator, generate) {
+  LibraryGenerator generator;
+  MatX index_data;
+
+  // not configured
+  EXPECT_EQ(-1, generator.generate(TEST_OUTPUT_DIR));
+
+  // generate
+  setup_output_dir();
+  generator.configure(TEST_CONFIG);
+  EXPECT_EQ(0, generator.generate(TEST_OUTPUT_DIR));
+  EXPECT_EQ(6, generator.nb_solved);
+  EXPECT_EQ(0, generator.nb_skipped);
+  EXPECT_GT(generator.throughput(), 0.0);
+
+  // index lists every grid cell once, loadable by the trajectory index
+  csv2mat(TEST_OUTPUT_DIR "/index.csv", true, index_data);
+  ASSERT_EQ(6, index_data.rows());
+  std::vector<int> cells;
+  for (int i = 0; i < index_data.rows(); i++) {
+    const int cell = (int) index_data(i, 0);
+    cells.push_back(cell);
+    EXPECT_FLOAT_EQ(generator.height(cell / 3), index_data(i, 1));
+    EXPECT_FLOAT_EQ(generator.velocity(cell % 3), index_data(i, 2));
+  }
+  std::sort(cells.begin(), cells.end());
+  for (int i = 0; i < 6; i++) {
+    EXPECT_EQ(i, cells[i]);
+  }
+
+  TrajectoryIndex traj_index;
+  Trajectory traj;
+  EXPECT_EQ(0, traj_index.load(TEST_OUTPUT_DIR "/index.csv"));
+  EXPECT_EQ(0, traj_index.find(Vec3{0.0, 0.0, 4.0}, 2.0, traj));
+  EXPECT_EQ(1, traj.index);
+}
+
+TEST(LibraryGenerator, resume) {
+  LibraryGenerator generator;
+  MatX index_data;
+
+  // finished run, nothing left to do
+  setup_output_dir();
+  generator.configure(TEST_CONFIG);
+  generator.generate(TEST_OUTPUT_DIR);
+  EXPECT_EQ(0, generator.generate(TEST_OUTPUT_DIR));
+  EXPECT_EQ(6, generator.nb_skipped);
+  EXPECT_EQ(0, generator.nb_solved);
+
+  // interrupted run, a missing trajectory and a line cut short
+  remove(TEST_OUTPUT_DIR "/4.csv");
+  std::ofstream index(TEST_OUTPUT_DIR "/index.csv", std::ios::app);
+  index << "5,5";
+  index.close();
+  EXPECT_EQ(5, generator.resume(TEST_OUTPUT_DIR));
+  EXPECT_FALSE(generator.done[4]);
+
+  EXPECT_EQ(0, generator.generate(TEST_OUTPUT_DIR));
+  EXPECT_EQ(5, generator.nb_skipped);
+  EXPECT_EQ(1, generator.nb_solved);
+  csv2mat(TEST_OUTPUT_DIR "/index.csv", true, index_data);
+  EXPECT_EQ(6, index_data.rows());
+  EXPECT_TRUE(file_exists(TEST_OUTPUT_DIR "/4.csv"));
+}
+
+} // namespace atl
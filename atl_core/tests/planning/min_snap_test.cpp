@@ -0,0 +1,151 @@
+#include "atl/planning/min_snap.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_CONFIG "tests/configs/planning/min_snap.yaml"
+
+namespace atl {
+
+TEST(PolyBVP, restToRest) {
+  // minimum jerk, 10 tau^3 - 15 tau^4 + 6 tau^5
+  PolyBVP<6> jerk;
+  const double start[3] = {0.0, 0.0, 0.0};
+  const double end[3] = {1.0, 0.0, 0.0};
+  const PolyBVP<6>::Coeffs cj = jerk.solve(start, end, 1.0);
+  PolyBVP<6>::Coeffs cj_expected;
+  cj_expected << 0.0, 0.0, 0.0, 10.0, -15.0, 6.0;
+  EXPECT_TRUE(cj.isApprox(cj_expected, 1e-9));
+
+  // its jerk cost is 720 D^2 / T^5
+  const double D = 2.0;
+  const double T = 3.0;
+  const double end_d[3] = {D, 0.0, 0.0};
+  const PolyBVP<6>::Coeffs cd = jerk.solve(start, end_d, T);
+  EXPECT_NEAR(720.0 * D * D / pow(T, 5), jerk.cost(cd, T), 1e-9);
+
+  // minimum snap, 35 tau^4 - 84 tau^5 + 70 tau^6 - 20 tau^7
+  PolyBVP<8> snap;
+  const double start_s[4] = {0.0, 0.0, 0.0, 0.0};
+  const double end_s[4] = {1.0, 0.0, 0.0, 0.0};
+  const PolyBVP<8>::Coeffs cs = snap.solve(start_s, end_s, 1.0);
+  PolyBVP<8>::Coeffs cs_expected;
+  cs_expected << 0.0, 0.0, 0.0, 0.0, 35.0, -84.0, 70.0, -20.0;
+  EXPECT_TRUE(cs.isApprox(cs_expected, 1e-9));
+}
+
+TEST(PolyBVP, boundaryConditions) {
+  PolyBVP<8> snap;
+  const double start[4] = {1.0, -2.0, 0.5, 3.0};
+  const double end[4] = {-4.0, 1.5, -1.0, 0.25};
+  const double T = 2.7;
+
+  Eigen::Matrix<double, 8, 1> c = snap.solve(start, end, T);
+  for (int k = 0; k < 4; k++) {
+    EXPECT_NEAR(start[k], poly_evaluate(c, T, 0.0, k), 1e-9);
+    EXPECT_NEAR(end[k], poly_evaluate(c, T, T, k), 1e-9);
+  }
+}
+
+TEST(MinSnapGenerator, configure) {
+  MinSnapGenerator generator;
+
+  EXPECT_EQ(0, generator.configure(TEST_CONFIG));
+  EXPECT_TRUE(generator.configured);
+  EXPECT_EQ(4, generator.order);
+  EXPECT_FLOAT_EQ(0.1, generator.dt);
+  EXPECT_FLOAT_EQ(deg2rad(45.0), generator.tilt_max);
+  EXPECT_EQ(-1, generator.configure("/nonexistent.yaml"));
+}
+
+TEST(MinSnapGenerator, solve) {
+  MinSnapGenerator generator;
+  const Vec2 pos{0.0, 7.3};
+  const Vec2 vel{3.7, 0.4};
+  const Vec2 acc{0.5, 0.0};
+  const Vec2 target_pos{2.5, 0.0};
+  const Vec2 target_vel{3.7, 0.0};
+
+  // not configured
+  EXPECT_EQ(-1, generator.solve(pos, vel, acc, target_pos, target_vel));
+
+  for (int order = 3; order <= 4; order++) {
+    generator.configure(TEST_CONFIG);
+    generator.order = order;
+    EXPECT_EQ(0, generator.solve(pos, vel, acc, target_pos, target_vel));
+    EXPECT_GT(generator.duration, generator.duration_min);
+    EXPECT_LT(generator.duration, generator.duration_max);
+    EXPECT_NEAR(0.0, fmod(generator.duration + 1e-9, generator.dt), 1e-6);
+
+    // starts at the start state
+    Vec2 p, v, a;
+    generator.evaluate(0.0, p, v, a);
+    EXPECT_TRUE(p.isApprox(pos, 1e-9));
+    EXPECT_TRUE(v.isApprox(vel, 1e-9));
+    EXPECT_TRUE(a.isApprox(acc, 1e-9));
+
+    // meets the target
+    const double T = generator.duration;
+    generator.evaluate(T, p, v, a);
+    EXPECT_TRUE(p.isApprox(target_pos + target_vel * T, 1e-9));
+    EXPECT_TRUE(v.isApprox(target_vel, 1e-9));
+    EXPECT_NEAR(0.0, a.norm(), 1e-9);
+
+    // within the limits along the way
+    for (int i = 0; i <= 1000; i++) {
+      generator.evaluate(T * i / 1000.0, p, v, a);
+      const double az = a(1) + generator.g;
+      const double thrust = sqrt(a(0) * a(0) + az * az);
+      EXPECT_GT(p(1), -0.05);
+      EXPECT_GT(v(1), generator.vz_min - 0.05);
+      EXPECT_LT(thrust, generator.thrust_max + 0.5);
+      EXPECT_LT(atan2(fabs(a(0)), az), generator.tilt_max + 0.05);
+    }
+  }
+}
+
+TEST(MinSnapGenerator, infeasible) {
+  MinSnapGenerator generator;
+  generator.configure(TEST_CONFIG);
+
+  // target too far away to reach within duration_max
+  const Vec2 pos{0.0, 5.0};
+  const Vec2 vel{0.0, 0.0};
+  const Vec2 acc{0.0, 0.0};
+  const Vec2 target_pos{200.0, 0.0};
+  const Vec2 target_vel{0.0, 0.0};
+  EXPECT_EQ(-2, generator.solve(pos, vel, acc, target_pos, target_vel));
+}
+
+TEST(MinSnapGenerator, generate) {
+  MinSnapGenerator generator;
+  Trajectory traj;
+  const Vec3 p0{1.0, 2.0, 6.2};
+  const Vec2 pos{0.0, 6.2};
+  const Vec2 vel{1.3, 0.0};
+  const Vec2 target_pos{1.0, 0.0};
+  const Vec2 target_vel{1.3, 0.0};
+
+  // trajectory rows every dt, from the start state to the target
+  generator.configure(TEST_CONFIG);
+  EXPECT_EQ(0, generator.generate(pos, vel, target_pos, target_vel, p0, traj));
+  const int nb_rows = (int) round(generator.duration / generator.dt) + 1;
+  EXPECT_TRUE(traj.loaded);
+  EXPECT_EQ(-1, traj.index);
+  EXPECT_EQ(nb_rows, (int) traj.pos.size());
+  EXPECT_TRUE(traj.p0.isApprox(p0));
+  EXPECT_TRUE(traj.pos.front().isApprox(pos, 1e-9));
+  EXPECT_TRUE(traj.vel.front().isApprox(vel, 1e-9));
+  EXPECT_NEAR(0.0, traj.rel_pos.back().norm(), 1e-9);
+  EXPECT_NEAR(0.0, traj.rel_vel.back().norm(), 1e-9);
+
+  // hover thrust and level at the end
+  EXPECT_NEAR(generator.hover_throttle, traj.inputs.back()(0), 1e-9);
+  EXPECT_NEAR(0.0, traj.inputs.back()(1), 1e-9);
+  EXPECT_EQ(0, traj.planFeedForward());
+  EXPECT_FLOAT_EQ(generator.duration, traj.plan.duration());
+
+  // trackable
+  Vec2 wp_pos, wp_vel, wp_inputs;
+  EXPECT_EQ(0, traj.update(p0, wp_pos, wp_vel, wp_inputs));
+}
+
+} // namespace atl
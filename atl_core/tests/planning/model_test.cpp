@@ -150,4 +150,73 @@ TEST(Simulator, configure) {
 //   EXPECT_TRUE(sim.vel_error > 0);
 // }
 
+TEST(BatchSimulator, simulate) {
+  BatchSimulator batch;
+  Simulator sim;
+  Vec4 x_init, x_final;
+  const int N = 16;
+  const int nb_ts = 50;
+
+  // random control sequences around hover
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> az_noise(-2.0, 2.0);
+  std::uniform_real_distribution<float> theta_noise(-0.3, 0.3);
+  Eigen::MatrixXf AZ(N, nb_ts);
+  Eigen::MatrixXf THETA(N, nb_ts);
+  for (int k = 0; k < N; k++) {
+    for (int i = 0; i < nb_ts; i++) {
+      AZ(k, i) = 9.81 + az_noise(rng);
+      THETA(k, i) = theta_noise(rng);
+    }
+  }
+
+  // not configured, inputs do not match
+  x_init << 0.0, 1.0, 5.0, 0.0;
+  x_final << 5.0, 1.0, 0.0, 0.0;
+  EXPECT_EQ(-1, batch.simulate(0.1, 5.0, AZ, THETA));
+  batch.configure(x_init, x_final);
+  EXPECT_EQ(-2, batch.simulate(0.1, 4.0, AZ, THETA));
+  EXPECT_EQ(-2, batch.simulate(0.1, 5.0, AZ, THETA.topRows(8)));
+
+  // same results as simulating each rollout
+  EXPECT_EQ(0, batch.simulate(0.1, 5.0, AZ, THETA));
+  sim.configure(x_init, x_final, 1.0);
+  for (int k = 0; k < N; k++) {
+    MatX U(2, nb_ts), X;
+    U.row(0) = AZ.row(k).cast<double>();
+    U.row(1) = THETA.row(k).cast<double>();
+    EXPECT_EQ(0, sim.simulate(0.1, 5.0, U, X));
+    EXPECT_NEAR(X(0, nb_ts - 1), batch.x(k), 1e-3);
+    EXPECT_NEAR(X(3, nb_ts - 1), batch.vz(k), 1e-3);
+    EXPECT_NEAR(sim.d_az, batch.d_az(k), 1e-2);
+    EXPECT_NEAR(sim.d_theta, batch.d_theta(k), 1e-3);
+    EXPECT_NEAR(sim.az_sum, batch.az_sum(k), 1e-2);
+    EXPECT_NEAR(sim.dist_error, batch.dist_error(k), 1e-2);
+    EXPECT_NEAR(sim.vel_error, batch.vel_error(k), 1e-2);
+    EXPECT_NEAR(std::min(x_init(2), X.row(2).minCoeff()), batch.z_min(k), 1e-3);
+  }
+
+  // pitch beyond +-pi, odd number of rollouts
+  std::uniform_real_distribution<float> angle(-10.0, 10.0);
+  Eigen::MatrixXf AZ_short = AZ.block(0, 0, 11, 10);
+  Eigen::MatrixXf THETA_short(11, 10);
+  for (int k = 0; k < 11; k++) {
+    for (int i = 0; i < 10; i++) {
+      THETA_short(k, i) = angle(rng);
+    }
+  }
+  EXPECT_EQ(0, batch.simulate(0.1, 1.0, AZ_short, THETA_short));
+  ASSERT_EQ(11, batch.x.size());
+  for (int k = 0; k < 11; k++) {
+    MatX U(2, 10), X;
+    U.row(0) = AZ_short.row(k).cast<double>();
+    U.row(1) = THETA_short.row(k).cast<double>();
+    sim.simulate(0.1, 1.0, U, X);
+    EXPECT_NEAR(X(0, 9), batch.x(k), 1e-4);
+    EXPECT_NEAR(X(1, 9), batch.vx(k), 1e-4);
+    EXPECT_NEAR(X(2, 9), batch.z(k), 1e-4);
+    EXPECT_NEAR(X(3, 9), batch.vz(k), 1e-4);
+  }
+}
+
 } // namespace atl
@@ -0,0 +1,217 @@
+#include "atl/control/trajectory_controller.hpp"
+#include "atl/planning/mppi.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_CONFIG "tests/configs/planning/mppi.yaml"
+#define TEST_TRAJ_CONFIG "tests/configs/planning/trajectory_controller.yaml"
+
+namespace atl {
+
+/**
+ * Landing scenario, the quad starts above the target moving with it and
+ * the plant has a horizontal wind the planners do not model
+ */
+struct landing_scenario {
+  double z;
+  double v;
+  double wind;
+};
+
+/**
+ * Fly a landing in closed loop until touchdown
+ *
+ * @param s Scenario
+ * @param controller Inputs (az, theta) from the time, quad and target state
+ * @param touchdown Distance to the target and descent rate at touchdown
+ * @return True if the quad touched down on the target
+ */
+template <typename Controller>
+static bool landing_intercept(const landing_scenario &s,
+                              Controller controller,
+                              Vec2 &touchdown) {
+  const double dt = 0.05;
+  Quad2DModel quad;
+  quad.configure(Vec4{0.0, s.v, s.z, 0.0}, 1.0);
+
+  for (double t = 0.0; t < 15.0; t += dt) {
+    const Vec2 target_pos{s.v * t, 0.0};
+    const Vec2 target_vel{s.v, 0.0};
+    const Vec2 pos{quad.x(0), quad.x(2)};
+    const Vec2 vel{quad.x(1), quad.x(3)};
+
+    // touchdown within the pad at a safe descent rate
+    if (pos(1) <= 0.05) {
+      touchdown << fabs(pos(0) - target_pos(0)), -vel(1);
+      const bool on_target = fabs(pos(0) - target_pos(0)) < 0.3;
+      const bool soft = vel(1) > -1.5 && fabs(vel(0) - s.v) < 0.5;
+      return on_target && soft;
+    }
+
+    const Vec2 u = controller(t, dt, pos, vel, target_pos, target_vel);
+    quad.update(u, dt);
+    quad.x(1) += s.wind * dt;
+  }
+
+  return false;
+}
+
+TEST(MPPIPlanner, configure) {
+  MPPIPlanner planner;
+
+  EXPECT_EQ(0, planner.configure(TEST_CONFIG));
+  EXPECT_TRUE(planner.configured);
+  EXPECT_EQ(256, planner.nb_samples);
+  EXPECT_EQ(2, (int) planner.batches.size());
+  EXPECT_EQ(128, planner.batches[1].cost.size());
+  EXPECT_FLOAT_EQ(deg2rad(5.0), planner.sigma_theta);
+  EXPECT_FLOAT_EQ(deg2rad(45.0), planner.tilt_max);
+  EXPECT_EQ(0, planner.horizon());
+  EXPECT_EQ(-1, planner.configure("/nonexistent.yaml"));
+}
+
+TEST(MPPIPlanner, update) {
+  MPPIPlanner planner;
+  const Vec2 pos{0.0, 5.0};
+  const Vec2 vel{0.0, 0.0};
+  const Vec2 target_pos{1.0, 0.0};
+  const Vec2 target_vel{0.0, 0.0};
+  Vec2 inputs;
+
+  // not configured
+  EXPECT_EQ(-1, planner.update(pos, vel, target_pos, target_vel, 0.0, inputs));
+
+  // the horizon starts at the time to descend and shrinks by whole steps
+  planner.configure(TEST_CONFIG);
+  EXPECT_EQ(0, planner.update(pos, vel, target_pos, target_vel, 0.0, inputs));
+  EXPECT_EQ(50, planner.horizon());
+  EXPECT_EQ(0, planner.update(pos, vel, target_pos, target_vel, 0.05, inputs));
+  EXPECT_EQ(50, planner.horizon());
+  EXPECT_EQ(0, planner.update(pos, vel, target_pos, target_vel, 0.05, inputs));
+  EXPECT_EQ(49, planner.horizon());
+  EXPECT_EQ(0, planner.update(pos, vel, target_pos, target_vel, 10.0, inputs));
+  EXPECT_EQ(planner.min_steps, planner.horizon());
+
+  // inputs within the limits, the cost falls and the plan pitches towards
+  // the target
+  planner.reset();
+  planner.update(pos, vel, target_pos, target_vel, 0.0, inputs);
+  const double cost_init = planner.cost_min;
+  for (int i = 0; i < 20; i++) {
+    planner.update(pos, vel, target_pos, target_vel, 0.0, inputs);
+    EXPECT_GE(inputs(0), planner.thrust_min);
+    EXPECT_LE(inputs(0), planner.thrust_max);
+    EXPECT_LE(fabs(inputs(1)), planner.tilt_max);
+  }
+  EXPECT_LT(planner.cost_min, cost_init);
+
+  Quad2DModel quad;
+  quad.configure(Vec4{pos(0), vel(0), pos(1), vel(1)}, 1.0);
+  for (int k = 0; k < planner.horizon(); k++) {
+    const Vec2 u{planner.nominal_az(k), planner.nominal_theta(k)};
+    quad.update(u, planner.dt);
+  }
+  EXPECT_NEAR(target_pos(0), quad.x(0), 1.0);
+  EXPECT_NEAR(target_pos(1), quad.x(2), 1.0);
+  EXPECT_GT(planner.nb_effective, 1.0);
+  EXPECT_LE(planner.nb_effective, planner.nb_samples);
+}
+
+TEST(MPPIPlanner, benchmark) {
+  MPPIPlanner planner;
+  TrajectoryController tracker;
+  planner.configure(TEST_CONFIG);
+  tracker.configure(TEST_TRAJ_CONFIG);
+
+  std::vector<landing_scenario> scenarios;
+  for (double z : {4.5, 5.0, 5.5}) {
+    for (double v : {0.0, 0.5, 1.0}) {
+      for (double wind : {0.0, 0.3}) {
+        scenarios.push_back({z, v, wind});
+      }
+    }
+  }
+
+  // trajectory controller, tracks the nearest trajectory of an index whose
+  // grid covers the scenarios
+  int nb_lookup = 0;
+  Vec2 lookup_touchdown{0.0, 0.0};
+  double t_lookup = 0.0;
+  int nb_lookup_updates = 0;
+  struct timespec t_start;
+  for (const auto &s : scenarios) {
+    const Vec3 start{0.0, 0.0, s.z};
+    tracker.reset();
+    const Vec3 target_vel{s.v, 0.0, 0.0};
+    ASSERT_EQ(0, tracker.loadTrajectory(start, -start, target_vel, s.v));
+
+    Vec2 touchdown{0.0, 0.0};
+    auto controller = [&](double, double dt, Vec2 pos, Vec2 vel, Vec2 p_t,
+                          Vec2 v_t) {
+      const Vec3 pos_W{pos(0), 0.0, pos(1)};
+      const Vec3 vel_W{vel(0), 0.0, vel(1)};
+      const Vec3 target_pos_B{p_t(0) - pos(0), 0.0, p_t(1) - pos(1)};
+      const Vec3 target_vel_B{v_t(0) - vel(0), 0.0, v_t(1) - vel(1)};
+      const Vec3 rpy{0.0, tracker.outputs(1), 0.0};
+      tic(&t_start);
+      tracker.update(target_pos_B,
+                     target_vel_B,
+                     pos_W,
+                     vel_W,
+                     euler321ToQuat(rpy),
+                     0.0,
+                     dt);
+      t_lookup += toc(&t_start);
+      nb_lookup_updates++;
+
+      // the throttle is relative to the hover throttle
+      const Vec4 &u = tracker.outputs;
+      return Vec2{u(3) * 9.81 / tracker.hover_throttle, u(1)};
+    };
+    if (landing_intercept(s, controller, touchdown)) {
+      nb_lookup++;
+      lookup_touchdown += touchdown;
+    }
+  }
+
+  // mppi, one update per control tick
+  int nb_mppi = 0;
+  Vec2 mppi_touchdown{0.0, 0.0};
+  double t_update = 0.0;
+  int nb_updates = 0;
+  for (const auto &s : scenarios) {
+    planner.reset();
+
+    Vec2 touchdown{0.0, 0.0};
+    auto controller = [&](double, double dt, Vec2 pos, Vec2 vel, Vec2 p_t,
+                          Vec2 v_t) {
+      Vec2 inputs{9.81, 0.0};
+      planner.update(pos, vel, p_t, v_t, dt, inputs);
+      t_update += planner.elapsed;
+      nb_updates++;
+      return inputs;
+    };
+    if (landing_intercept(s, controller, touchdown)) {
+      nb_mppi++;
+      mppi_touchdown += touchdown;
+    }
+  }
+
+  // intercepts, mean touchdown error and descent rate of the intercepts,
+  // and time per update
+  const int nb_scenarios = scenarios.size();
+  lookup_touchdown /= std::max(nb_lookup, 1);
+  mppi_touchdown /= std::max(nb_mppi, 1);
+  std::cout << "intercepted lookup: " << nb_lookup << "/" << nb_scenarios;
+  std::cout << "\tmppi: " << nb_mppi << "/" << nb_scenarios << std::endl;
+  std::cout << "touchdown [m, m/s] lookup: ";
+  std::cout << lookup_touchdown.transpose();
+  std::cout << "\tmppi: " << mppi_touchdown.transpose() << std::endl;
+  std::cout << "update [us] lookup: ";
+  std::cout << t_lookup / nb_lookup_updates * 1e6;
+  std::cout << "\tmppi: " << t_update / nb_updates * 1e6 << std::endl;
+  EXPECT_GE(nb_mppi, nb_lookup);
+  EXPECT_GE(nb_mppi, nb_scenarios * 8 / 10);
+  EXPECT_LT(mppi_touchdown(1), lookup_touchdown(1));
+}
+
+} // namespace atl
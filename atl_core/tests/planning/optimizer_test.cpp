@@ -1,13 +1,87 @@
 #include "atl/planning/optimizer.hpp"
 #include "atl/atl_test.hpp"
 
+#define TEST_OPTIMIZED_OUTPUT_FILE "/tmp/trajectory_optimized.csv"
+
 namespace atl {
 
-TEST(POpt, test) {
+TEST(POpt, solve) {
   POpt popt;
+  struct problem_data p;
+  std::vector<double> x;
+
+  // invalid problem
+  trajectory_setup(&p, 4, 2, 2, std::vector<double>());
+  EXPECT_EQ(-1, popt.solve(p, x));
+
+  // 5 m descent onto a target moving at 1 m/s, warm started from desired
+  trajectory_landing_setup(&p, 5.0, 1.0, 0.1, -1.0);
+  EXPECT_EQ(0, popt.solve(p, x));
+  EXPECT_EQ(trajectory_nb_variables(&p), (int) x.size());
+  EXPECT_LT(popt.violation, popt.feasibility_tol);
+  EXPECT_GT(popt.nb_evaluations, 0);
+
+  // within bounds, starts and ends as asked
+  std::vector<double> lb, ub;
+  trajectory_bounds(&p, lb, ub);
+  for (size_t i = 0; i < x.size(); i++) {
+    EXPECT_TRUE(x[i] >= lb[i] - 1e-9 && x[i] <= ub[i] + 1e-9);
+  }
+  EXPECT_FLOAT_EQ(5.0, x[2]);
+  EXPECT_FLOAT_EQ(0.0, x[x.size() - 4]);
+
+  // re-solving from the solution converges straight away
+  const int nb_evaluations = popt.nb_evaluations;
+  EXPECT_EQ(0, popt.solve(p, x));
+  EXPECT_LE(popt.nb_evaluations, nb_evaluations);
+
+  trajectory_save(TEST_OPTIMIZED_OUTPUT_FILE, &p, x);
+}
+
+TEST(POpt, background) {
+  POpt popt;
+  struct problem_data p;
+  std::vector<double> x;
+
+  // solve on a background thread
+  trajectory_landing_setup(&p, 5.0, 1.0, 0.1, -1.0);
+  EXPECT_EQ(0, popt.start(p));
+  EXPECT_EQ(-1, popt.start(p));
+  while (popt.done() == false) {
+    usleep(1000);
+  }
+  EXPECT_EQ(0, popt.result(x));
+  EXPECT_EQ(trajectory_nb_variables(&p), (int) x.size());
+
+  // stopped
+  popt.start(p);
+  popt.stop();
+  EXPECT_TRUE(popt.done());
+  const int retval = popt.result(x);
+  EXPECT_TRUE(retval == 0 || retval == -3);
+}
+
+TEST(POpt, benchmark) {
+  POpt popt;
+  struct problem_data p;
+  std::vector<double> x;
+
+  // the python planner's problem, 5 m at 1 m/s onto targets at 1 - 10 m/s
+  int nb_solved = 0;
+  struct timespec t_start;
+  tic(&t_start);
+  for (int v = 1; v <= 10; v++) {
+    x.clear();
+    trajectory_landing_setup(&p, 5.0, v, 0.08, -1.0);
+    nb_solved += (popt.solve(p, x) == 0);
+  }
+  const double t_solve = toc(&t_start) / 10.0;
 
-  popt.run();
-  EXPECT_TRUE(true);
+  std::cout << "solved: " << nb_solved << "/10\t";
+  std::cout << "variables: " << trajectory_nb_variables(&p) << "\t";
+  std::cout << "evaluations: " << popt.nb_evaluations << "\t";
+  std::cout << "solve [ms]: " << t_solve * 1e3 << std::endl;
+  EXPECT_EQ(10, nb_solved);
 }
 
 } // namespace atl
@@ -0,0 +1,152 @@
+#include "atl/planning/path_spline.hpp"
+#include "atl/atl_test.hpp"
+
+namespace atl {
+
+static std::vector<Vec3> path_waypoints() {
+  return {Vec3{0.0, 0.0, 10.0},
+          Vec3{6.0, -10.0, 10.0},
+          Vec3{-7.5, -17.3, 12.0},
+          Vec3{-10.6, -9.2, 10.0},
+          Vec3{-4.0, 2.0, 10.0}};
+}
+
+TEST(PathSpline, load) {
+  PathSpline path;
+  const std::vector<Vec3> waypoints = path_waypoints();
+
+  // invalid
+  EXPECT_EQ(-1, path.load({Vec3{0.0, 0.0, 0.0}}));
+  EXPECT_EQ(-1, path.load(waypoints, 0));
+  EXPECT_EQ(-2, path.load({Vec3{1.0, 0.0, 0.0}, Vec3{1.0, 0.0, 0.0}}));
+  EXPECT_FALSE(path.loaded);
+
+  // passes through the waypoints
+  EXPECT_EQ(0, path.load(waypoints));
+  EXPECT_TRUE(path.loaded);
+  EXPECT_EQ(4 * 20 + 1, (int) path.lut_s.size());
+  for (size_t i = 0; i < waypoints.size(); i++) {
+    const double s = path.lut_s[i * path.nb_samples];
+    EXPECT_TRUE(path.point(s).isApprox(waypoints[i], 1e-9));
+  }
+  EXPECT_TRUE(path.point(path.length).isApprox(waypoints.back(), 1e-9));
+
+  // at least as long as the waypoint polyline
+  double chord = 0.0;
+  for (size_t i = 1; i < waypoints.size(); i++) {
+    chord += (waypoints[i] - waypoints[i - 1]).norm();
+  }
+  EXPECT_GT(path.length, chord);
+  EXPECT_LT(path.length, 1.2 * chord);
+
+  // two waypoints are a straight line
+  EXPECT_EQ(0, path.load({Vec3{0.0, 0.0, 0.0}, Vec3{3.0, 4.0, 0.0}}));
+  EXPECT_NEAR(5.0, path.length, 1e-9);
+  EXPECT_TRUE(path.point(2.5).isApprox(Vec3{1.5, 2.0, 0.0}, 1e-9));
+  EXPECT_NEAR(0.0, path.curvature(2.5), 1e-9);
+}
+
+TEST(PathSpline, continuity) {
+  PathSpline path;
+  path.load(path_waypoints());
+
+  // tangent and curvature are continuous at the interior waypoints
+  const double eps = 1e-6;
+  for (size_t i = 1; i + 1 < path.knots.size(); i++) {
+    const double t = path.knots[i];
+    for (int k = 0; k <= 2; k++) {
+      const Vec3 before = path.evaluate(t - eps, k);
+      const Vec3 after = path.evaluate(t + eps, k);
+      EXPECT_NEAR(0.0, (after - before).norm(), 1e-4);
+    }
+    EXPECT_EQ((int) i - 1, path.segment(path.lut_s[i * 20] - 0.01));
+    EXPECT_EQ((int) i, path.segment(path.lut_s[i * 20] + 0.01));
+  }
+
+  // natural end conditions
+  EXPECT_NEAR(0.0, path.curvature(0.0), 1e-9);
+  EXPECT_NEAR(0.0, path.curvature(path.length), 1e-9);
+}
+
+TEST(PathSpline, arcLength) {
+  PathSpline path;
+  path.load(path_waypoints(), 50);
+
+  // equal steps of arc length are equal distances along the path
+  const double ds = 0.1;
+  for (double s = 0.0; s + ds < path.length; s += ds) {
+    EXPECT_NEAR(ds, (path.point(s + ds) - path.point(s)).norm(), 1e-3);
+    EXPECT_NEAR(1.0, path.tangent(s).norm(), 1e-9);
+  }
+
+  // clamped to the path
+  EXPECT_TRUE(path.point(-1.0).isApprox(path.point(0.0)));
+  EXPECT_TRUE(path.point(path.length + 1.0).isApprox(path.point(path.length)));
+}
+
+TEST(PathSpline, closestPoint) {
+  PathSpline path;
+  Vec3 closest;
+
+  // not loaded
+  EXPECT_FLOAT_EQ(-1.0, path.closestPoint(Vec3::Zero(), -1.0, 1.0, closest));
+
+  // off the path along the normal
+  path.load(path_waypoints());
+  for (double s = 1.0; s < path.length - 1.0; s += 1.0) {
+    const Vec3 tangent = path.tangent(s);
+    const Vec3 normal = tangent.cross(Vec3{0.0, 0.0, 1.0}).normalized();
+    const Vec3 position = path.point(s) + 0.2 * normal;
+
+    // whole path and near a previous arc length
+    EXPECT_NEAR(s, path.closestPoint(position, -1.0, 0.0, closest), 0.05);
+    EXPECT_NEAR(0.2, (closest - position).norm(), 0.01);
+    EXPECT_NEAR(s, path.closestPoint(position, s - 0.5, 2.0, closest), 0.05);
+  }
+
+  // the window keeps the closest point near the previous one
+  const double s = path.closestPoint(path.point(5.0), 30.0, 2.0, closest);
+  EXPECT_GT(s, 27.0);
+  EXPECT_LT(s, 32.0);
+}
+
+TEST(PathSpline, benchmark) {
+  PathSpline path;
+  Vec3 closest;
+  const int nb_queries = 10000;
+
+  // long zig-zag path
+  std::vector<Vec3> waypoints;
+  for (int i = 0; i < 500; i++) {
+    waypoints.emplace_back(10.0 * i, (i % 2) ? 5.0 : -5.0, 10.0);
+  }
+  path.load(waypoints);
+
+  // search the whole path
+  struct timespec t_start;
+  const double ds = path.length / nb_queries;
+  tic(&t_start);
+  double error = 0.0;
+  for (int i = 0; i < nb_queries; i++) {
+    const Vec3 position = path.point(i * ds) + Vec3{0.0, 0.0, 0.1};
+    error += fabs(path.closestPoint(position, -1.0, 0.0, closest) - i * ds);
+  }
+  const double t_full = toc(&t_start) / nb_queries;
+
+  // search near the previous arc length
+  tic(&t_start);
+  double s = 0.0;
+  for (int i = 0; i < nb_queries; i++) {
+    const Vec3 position = path.point(i * ds) + Vec3{0.0, 0.0, 0.1};
+    s = path.closestPoint(position, s, 5.0, closest);
+    error += fabs(s - i * ds);
+  }
+  const double t_window = toc(&t_start) / nb_queries;
+
+  std::cout << "samples: " << path.lut_s.size() << "\t";
+  std::cout << "closest point [us] full: " << t_full * 1e6;
+  std::cout << "\twindow: " << t_window * 1e6 << std::endl;
+  EXPECT_LT(error / (2 * nb_queries), 1e-2);
+}
+
+} // namespace atl
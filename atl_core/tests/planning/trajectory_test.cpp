@@ -1,9 +1,8 @@
 #include "atl/planning/trajectory.hpp"
 #include "atl/atl_test.hpp"
-#include <nlopt.hpp>
 
 #define TEST_TRAJECTORY_OUTPUT_FILE "/tmp/trajectory.output"
-#define TEST_OPTIMIZED_OUTPUT_FILE "/tmp/trajectory_optimized.output"
+#define TEST_SAVE_OUTPUT_FILE "/tmp/trajectory_saved.csv"
 #define TEST_PATH_OUTPUT_FILE "/tmp/path.output"
 
 namespace atl {
@@ -131,103 +130,186 @@ TEST(Trajectory, trajectory_calculate_desired_states) {
   path_file.close();
 }
 
-// TEST(Trajectory, trajectory_cost_func) {
-//   struct problem_data p;
-//   std::vector<double> x;
-//   std::vector<double> grad;
-//   std::vector<double> cost_weights;
-//   double cost;
-//
-//   // setup
-//   cost_weights.push_back(1.0);
-//   cost_weights.push_back(1.0);
-//   cost_weights.push_back(1.0);
-//   trajectory_setup(&p, 4, 2, 10, cost_weights);
-//   p.pos_init << -1, 3.5;
-//   p.pos_final << 2.3, 0;
-//   p.vel_init << 1.0, 1.0;
-//   p.vel_final << 0.0, 0.0;
-//   p.thrust_init = 9.81;
-//   p.thrust_final = 9.81;
-//   p.theta_init = 0.2;
-//   p.theta_final = 0.0;
-//
-//   trajectory_calculate_desired(&p);
-//   for (int i = 0; i < 10; i++) {
-//     x.push_back(p.desired(0, i));  // state - x
-//     x.push_back(p.desired(1, i));  // state - vx
-//     x.push_back(p.desired(2, i));  // state - z
-//     x.push_back(p.desired(3, i));  // state - vz
-//     x.push_back(p.desired(4, i));  // input - az
-//     x.push_back(p.desired(5, i));  // input - w
-//   }
-//
-//   // test
-//   cost = trajectory_cost_func(x, grad, &p);
-//   EXPECT_FLOAT_EQ(0.0, cost);
-// }
-//
-// TEST(Trajectory, trajectory_constraint_func) {
-//   struct problem_data p;
-//   nlopt::opt opt;
-//   std::vector<double> x, grad, cost_weights;
-//   double error;
-//
-//   // setup problem
-//   trajectory_setup(&p, 4, 2, 10, cost_weights);
-//   p.pos_init << -1, 3.5;
-//   p.pos_final << 2.3, 0;
-//   p.vel_init << 1.0, 1.0;
-//   p.vel_final << 0.0, 0.0;
-//   p.thrust_init = 9.81;
-//   p.thrust_final = 9.81;
-//   p.theta_init = 0.2;
-//   p.theta_final = 0.0;
-//   trajectory_calculate_desired(&p);
-//   load_matrix(p.desired, x);
-//
-//   error = trajectory_constraint_func(x, grad, &p);
-//   std::cout << error << std::endl;
-// }
-//
-// TEST(Trajectory, optimize) {
-//   double minf;
-//   struct problem_data p;
-//   nlopt::opt opt;
-//   std::vector<double> x;
-//   std::vector<double> cost_weights;
-//   std::ofstream output_file;
-//
-//   // setup cost weights
-//   cost_weights.push_back(1.0);
-//   cost_weights.push_back(1.0);
-//   cost_weights.push_back(0.5);
-//   cost_weights.push_back(1.0);
-//
-//   // setup problem
-//   trajectory_setup(&p, 4, 2, 100, cost_weights);
-//   p.pos_init << -1, 3.5;
-//   p.pos_final << 2.3, 0;
-//   p.vel_init << 1.0, 1.0;
-//   p.vel_final << 0.0, 0.0;
-//   p.thrust_init = 9.81;
-//   p.thrust_final = 9.81;
-//   p.theta_init = 0.2;
-//   p.theta_final = 0.0;
-//   trajectory_calculate_desired(&p);
-//   load_matrix(p.desired, x);
-//
-//   // configure optimizer
-//   opt = nlopt::opt(nlopt::LN_COBYLA, 600);
-//   opt.set_min_objective(trajectory_cost_func, &p);
-//   opt.add_inequality_constraint(trajectory_constraint_func, &p, 1e-8);
-//   opt.set_xtol_rel(1e-4);
-//
-//   // optimize
-//   nlopt::result result = opt.optimize(x, minf);
-//
-//   // record results
-//   trajectory_record_optimization(TEST_OPTIMIZED_OUTPUT_FILE, x, 100);
-// }
+static void perturb(std::vector<double> &x, const int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> noise(-0.3, 0.3);
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] += noise(rng);
+  }
+}
+
+TEST(Trajectory, trajectory_landing_setup) {
+  struct problem_data p;
+
+  // 5 m descent at 1 m/s onto a target moving at 2 m/s
+  EXPECT_EQ(0, trajectory_landing_setup(&p, 5.0, 2.0, 0.1, -1.0));
+  EXPECT_EQ(51, p.nb_steps);
+  EXPECT_EQ(p.nb_steps, p.desired.cols());
+  EXPECT_FLOAT_EQ(10.0, p.pos_final(0));
+  EXPECT_FLOAT_EQ(0.0, p.pos_final(1));
+  EXPECT_FLOAT_EQ(2.0, p.vel_final(0));
+  EXPECT_EQ(306, trajectory_nb_variables(&p));
+  EXPECT_EQ(200, trajectory_nb_constraints(&p));
+
+  // desired velocity along the line
+  EXPECT_FLOAT_EQ(0.2, p.desired(0, 1));
+  EXPECT_FLOAT_EQ(2.0, p.desired(1, 1));
+  EXPECT_FLOAT_EQ(-1.0, p.desired(3, 1));
+
+  EXPECT_EQ(-1, trajectory_landing_setup(&p, 5.0, 2.0, 0.1, 1.0));
+  EXPECT_EQ(-1, trajectory_landing_setup(&p, -1.0, 2.0, 0.1, -1.0));
+}
+
+TEST(Trajectory, trajectory_cost_func) {
+  struct problem_data p;
+  std::vector<double> x, grad, no_grad;
+
+  // zero at the desired trajectory
+  trajectory_landing_setup(&p, 3.0, 1.0, 0.1, -1.0);
+  trajectory_warm_start(&p, x);
+  EXPECT_NEAR(0.0, trajectory_cost_func(x, no_grad, &p), 1e-9);
+
+  // analytic gradient matches finite differences
+  perturb(x, 1);
+  grad.resize(x.size());
+  const double cost = trajectory_cost_func(x, grad, &p);
+  EXPECT_GT(cost, 0.0);
+  for (size_t i = 0; i < x.size(); i++) {
+    std::vector<double> x_fwd = x;
+    std::vector<double> x_bwd = x;
+    x_fwd[i] += 1e-6;
+    x_bwd[i] -= 1e-6;
+    const double c_fwd = trajectory_cost_func(x_fwd, no_grad, &p);
+    const double c_bwd = trajectory_cost_func(x_bwd, no_grad, &p);
+    EXPECT_NEAR((c_fwd - c_bwd) / 2e-6, grad[i], 1e-5);
+  }
+}
+
+TEST(Trajectory, trajectory_constraint_func) {
+  struct problem_data p;
+  std::vector<double> x, grad, no_grad;
+
+  // opposite violations do not cancel
+  trajectory_setup(&p, 4, 2, 3, std::vector<double>());
+  p.g = 0.0;
+  p.desired.setZero();
+  trajectory_warm_start(&p, x);
+  x[6 + 0] = 1.0;
+  x[6 + 2] = -1.0;
+  EXPECT_GT(trajectory_constraint_func(x, no_grad, &p), 1.0);
+
+  // analytic gradient matches finite differences
+  trajectory_landing_setup(&p, 3.0, 1.0, 0.1, -1.0);
+  trajectory_warm_start(&p, x);
+  perturb(x, 2);
+  grad.resize(x.size());
+  trajectory_constraint_func(x, grad, &p);
+  for (size_t i = 0; i < x.size(); i++) {
+    std::vector<double> x_fwd = x;
+    std::vector<double> x_bwd = x;
+    x_fwd[i] += 1e-6;
+    x_bwd[i] -= 1e-6;
+    const double e_fwd = trajectory_constraint_func(x_fwd, no_grad, &p);
+    const double e_bwd = trajectory_constraint_func(x_bwd, no_grad, &p);
+    EXPECT_NEAR((e_fwd - e_bwd) / 2e-6, grad[i], 1e-4);
+  }
+}
+
+TEST(Trajectory, trajectory_constraints_func) {
+  struct problem_data p;
+  std::vector<double> x;
+  std::vector<int> rows, cols;
+
+  // setup
+  trajectory_landing_setup(&p, 3.0, 1.0, 0.1, -1.0);
+  trajectory_warm_start(&p, x);
+  perturb(x, 3);
+  const unsigned m = trajectory_nb_constraints(&p);
+  const unsigned n = trajectory_nb_variables(&p);
+
+  // sparse structure, each defect only depends on the steps it joins
+  trajectory_constraint_structure(&p, rows, cols);
+  ASSERT_EQ(20 * (p.nb_steps - 1), (int) rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    const int step = rows[i] / 4;
+    EXPECT_TRUE(cols[i] >= 6 * step && cols[i] < 6 * (step + 2));
+  }
+
+  // dense jacobian matches finite differences, zero outside the structure
+  std::vector<double> d(m), d_fwd(m), d_bwd(m), J(m * n);
+  trajectory_constraints_func(m, d.data(), n, x.data(), J.data(), &p);
+  for (unsigned j = 0; j < n; j++) {
+    std::vector<double> x_fwd = x;
+    std::vector<double> x_bwd = x;
+    x_fwd[j] += 1e-6;
+    x_bwd[j] -= 1e-6;
+    trajectory_defects(&p, x_fwd.data(), d_fwd.data());
+    trajectory_defects(&p, x_bwd.data(), d_bwd.data());
+    for (unsigned i = 0; i < m; i++) {
+      EXPECT_NEAR((d_fwd[i] - d_bwd[i]) / 2e-6, J[i * n + j], 1e-6);
+    }
+  }
+
+  // a trajectory rolled out with the dynamics has no defects
+  trajectory_setup(&p, 4, 2, 20, std::vector<double>());
+  p.cdx = 0.2;
+  std::vector<double> s = {0.0, 1.0, 5.0, 0.0, 9.81, 0.0};
+  x.clear();
+  for (int k = 0; k < p.nb_steps; k++) {
+    x.insert(x.end(), s.begin(), s.end());
+    s[0] += s[1] * p.dt;
+    s[1] -= p.cdx * s[1] * p.dt;
+  }
+  d.resize(trajectory_nb_constraints(&p));
+  trajectory_defects(&p, x.data(), d.data());
+  for (size_t i = 0; i < d.size(); i++) {
+    EXPECT_NEAR(0.0, d[i], 2e-3);
+  }
+}
+
+TEST(Trajectory, trajectory_bounds) {
+  struct problem_data p;
+  std::vector<double> lb, ub, x;
+
+  // first and last steps fixed, inputs bounded in between
+  trajectory_landing_setup(&p, 3.0, 1.0, 0.1, -1.0);
+  trajectory_bounds(&p, lb, ub);
+  const int n = trajectory_nb_variables(&p);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FLOAT_EQ(lb[i], ub[i]);
+    EXPECT_FLOAT_EQ(lb[n - 6 + i], ub[n - 6 + i]);
+  }
+  EXPECT_FLOAT_EQ(p.thrust_min, lb[6 + 4]);
+  EXPECT_FLOAT_EQ(p.thrust_max, ub[6 + 4]);
+  EXPECT_FLOAT_EQ(p.vz_min, lb[6 + 3]);
+
+  // warm start within the bounds
+  p.desired(5, 1) = 2.0;
+  trajectory_warm_start(&p, x);
+  ASSERT_EQ(n, (int) x.size());
+  EXPECT_FLOAT_EQ(p.theta_max, x[6 + 5]);
+}
+
+TEST(Trajectory, trajectory_save) {
+  struct problem_data p;
+  std::vector<double> x;
+  MatX data;
+
+  // save and load back
+  trajectory_landing_setup(&p, 3.0, 1.0, 0.1, -1.0);
+  trajectory_warm_start(&p, x);
+  EXPECT_EQ(0, trajectory_save(TEST_SAVE_OUTPUT_FILE, &p, x));
+  EXPECT_EQ(-1, trajectory_save("/nonexistent/x.csv", &p, x));
+  csv2mat(TEST_SAVE_OUTPUT_FILE, true, data);
+  ASSERT_EQ(p.nb_steps, data.rows());
+  ASSERT_EQ(10, data.cols());
+
+  // hover thrust normalized, on the target at the end
+  EXPECT_NEAR(p.g / p.thrust_max, data(0, 4), 1e-6);
+  EXPECT_NEAR(-3.0, data(0, 7), 1e-6);
+  for (int j = 6; j < 10; j++) {
+    EXPECT_NEAR(0.0, data(p.nb_steps - 1, j), 1e-6);
+  }
+}
 
 } // namespace atl
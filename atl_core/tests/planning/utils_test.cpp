@@ -15,6 +15,12 @@ TEST(BezierCubicCurve, test) {
   for (size_t i = 1; i < bezier_points.size(); i++) {
     EXPECT_TRUE(bezier_points[i](1) < bezier_points[i - 1](1));
   }
+
+  // 20 points after p0, ending at p3
+  EXPECT_EQ(20, (int) bezier_points.size());
+  EXPECT_TRUE(bezier_points.front().isApprox(
+      0.857375 * p0 + 0.135375 * p1 + 0.007125 * p2 + 0.000125 * p3));
+  EXPECT_TRUE(bezier_points.back().isApprox(p3));
 }
 
 } // namespace atl
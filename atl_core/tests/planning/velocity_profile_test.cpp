@@ -0,0 +1,114 @@
+#include "atl/planning/velocity_profile.hpp"
+#include "atl/atl_test.hpp"
+
+namespace atl {
+
+static PathSpline profile_path() {
+  PathSpline path;
+  path.load({Vec3{0.0, 0.0, 10.0},
+             Vec3{20.0, 0.0, 10.0},
+             Vec3{25.0, 5.0, 10.0},
+             Vec3{25.0, 25.0, 10.0},
+             Vec3{0.0, 30.0, 10.0}});
+  return path;
+}
+
+TEST(VelocityProfile, generate) {
+  VelocityProfile profile;
+  PathSpline path;
+
+  // invalid
+  EXPECT_EQ(-1, profile.generate(path));
+  path = profile_path();
+  profile.a_max = 0.0;
+  EXPECT_EQ(-2, profile.generate(path));
+  EXPECT_FALSE(profile.loaded);
+
+  // straight line, accelerates to the speed limit and brakes to a stop
+  path.load({Vec3{0.0, 0.0, 0.0}, Vec3{50.0, 0.0, 0.0}});
+  profile.v_max = 3.0;
+  profile.a_max = 1.0;
+  profile.j_max = 2.0;
+  EXPECT_EQ(0, profile.generate(path));
+  EXPECT_TRUE(profile.loaded);
+  EXPECT_EQ(501, (int) profile.speeds.size());
+  EXPECT_FLOAT_EQ(0.0, profile.speed(0.0));
+  EXPECT_FLOAT_EQ(3.0, profile.speed(25.0));
+  EXPECT_FLOAT_EQ(0.0, profile.speed(50.0));
+
+  // the configured grid spacing is kept when the path needs another
+  path.load({Vec3{0.0, 0.0, 0.0}, Vec3{50.05, 0.0, 0.0}});
+  EXPECT_EQ(0, profile.generate(path));
+  EXPECT_FLOAT_EQ(0.1, profile.ds);
+  EXPECT_FLOAT_EQ(path.length / 501.0, profile.ds_actual);
+  EXPECT_EQ(0, profile.generate(path));
+  EXPECT_FLOAT_EQ(0.1, profile.ds);
+  EXPECT_FLOAT_EQ(path.length / 501.0, profile.ds_actual);
+  EXPECT_EQ(502, (int) profile.speeds.size());
+  EXPECT_FLOAT_EQ(0.0, profile.speed(50.05));
+
+  // about the constant acceleration duration plus the jerk limit window
+  const double t_trapezoid = 50.0 / 3.0 + 3.0 / 1.0;
+  const double t_window = 2.0 * profile.a_max / profile.j_max;
+  EXPECT_GE(profile.duration(), t_trapezoid - 1e-6);
+  EXPECT_LT(profile.duration(), t_trapezoid + t_window + 0.1);
+
+  // starts and ends at the given speeds
+  profile.v_start = 1.0;
+  profile.v_end = 0.5;
+  EXPECT_EQ(0, profile.generate(path));
+  EXPECT_FLOAT_EQ(1.0, profile.speed(0.0));
+  EXPECT_FLOAT_EQ(0.5, profile.speed(path.length));
+  EXPECT_FLOAT_EQ(1.0, profile.speed(profile.ds_actual));
+}
+
+TEST(VelocityProfile, limits) {
+  VelocityProfile profile;
+  const PathSpline path = profile_path();
+  profile.v_max = 5.0;
+  profile.a_max = 1.0;
+  profile.j_max = 2.0;
+  profile.a_lat_max = 1.5;
+  EXPECT_EQ(0, profile.generate(path));
+
+  // speed, lateral acceleration, acceleration and jerk, the jerk between
+  // two grid segments over the time between their middles
+  double a_prev = NAN;
+  double dt_prev = 0.0;
+  double a_max = 0.0;
+  double j_max = 0.0;
+  for (size_t i = 0; i + 1 < profile.speeds.size(); i++) {
+    const double s = i * profile.ds_actual;
+    const double v0 = profile.speeds[i];
+    const double v1 = profile.speeds[i + 1];
+    EXPECT_LE(v0, profile.v_max + 1e-9);
+    EXPECT_LE(v0 * v0 * path.curvature(s), profile.a_lat_max + 1e-6);
+
+    const double a = (v1 * v1 - v0 * v0) / (2.0 * profile.ds_actual);
+    const double dt = 2.0 * profile.ds_actual / (v0 + v1);
+    a_max = std::max(a_max, fabs(a));
+    if (i > 0) {
+      j_max = std::max(j_max, fabs(a - a_prev) / ((dt_prev + dt) / 2.0));
+    }
+    a_prev = a;
+    dt_prev = dt;
+  }
+  std::cout << "max acceleration: " << a_max << "\t";
+  std::cout << "max jerk: " << j_max << std::endl;
+  EXPECT_LE(a_max, profile.a_max + 1e-9);
+  EXPECT_LE(j_max, profile.j_max);
+
+  // faster than the single speed within the lateral limit everywhere
+  double kappa_max = 0.0;
+  for (double s = 0.0; s < path.length; s += 0.01) {
+    kappa_max = std::max(kappa_max, path.curvature(s));
+  }
+  VelocityProfile constant = profile;
+  constant.v_max = sqrt(profile.a_lat_max / kappa_max);
+  constant.generate(path);
+  std::cout << "duration [s] profile: " << profile.duration();
+  std::cout << "\tsingle speed: " << constant.duration() << std::endl;
+  EXPECT_LT(profile.duration(), constant.duration());
+}
+
+} // namespace atl
@@ -0,0 +1,201 @@
+#include "atl/quadrotor/control_executor.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_CONFIG "tests/configs/quadrotor/executor.yaml"
+#define TEST_CONFIG_PATH "tests/configs/quadrotor"
+
+namespace atl {
+
+TEST(TimingHistogram, addAndPercentile) {
+  TimingHistogram histogram;
+  histogram.bin_width = 1e-3;
+
+  // empty
+  EXPECT_FLOAT_EQ(0.0, histogram.percentile(0.5));
+
+  // 90 samples at 0.5 ms, 10 at 5.5 ms and one way beyond the last bin
+  for (int i = 0; i < 90; i++) {
+    histogram.add(0.5e-3);
+  }
+  for (int i = 0; i < 10; i++) {
+    histogram.add(5.5e-3);
+  }
+  histogram.add(1.0);
+
+  EXPECT_EQ(101u, histogram.nb_samples);
+  EXPECT_EQ(90u, histogram.counts[0]);
+  EXPECT_EQ(10u, histogram.counts[5]);
+  EXPECT_EQ(1u, histogram.counts[EXECUTOR_HISTOGRAM_BINS - 1]);
+  EXPECT_FLOAT_EQ(1e-3, histogram.percentile(0.5));
+  EXPECT_FLOAT_EQ(6e-3, histogram.percentile(0.95));
+  EXPECT_FLOAT_EQ(1.0, histogram.max());
+
+  histogram.reset();
+  EXPECT_EQ(0u, histogram.nb_samples);
+  EXPECT_FLOAT_EQ(0.0, histogram.max());
+}
+
+TEST(ControlExecutor, configure) {
+  ControlExecutor executor;
+
+  EXPECT_EQ(0, executor.configure(TEST_CONFIG));
+  EXPECT_TRUE(executor.configured);
+  EXPECT_FLOAT_EQ(200.0, executor.rate);
+  EXPECT_FALSE(executor.realtime);
+  EXPECT_EQ(80, executor.priority);
+  EXPECT_EQ(-1, executor.cpu);
+  EXPECT_FLOAT_EQ(10e-6, executor.jitter.bin_width);
+}
+
+TEST(ControlExecutor, start) {
+  ControlExecutor executor;
+  Quadrotor quadrotor;
+
+  // not configured
+  EXPECT_EQ(-1, executor.start(quadrotor));
+
+  // quadrotor not configured
+  executor.configure(TEST_CONFIG);
+  EXPECT_EQ(-2, executor.start(quadrotor));
+
+  // already running
+  quadrotor.configure(TEST_CONFIG_PATH);
+  EXPECT_EQ(0, executor.start(quadrotor));
+  EXPECT_EQ(-3, executor.start(quadrotor));
+  executor.stop();
+  EXPECT_FALSE(executor.running);
+}
+
+TEST(ControlExecutor, step) {
+  ControlExecutor executor;
+  Quadrotor quadrotor;
+  AttitudeCommand att_cmd;
+
+  executor.configure(TEST_CONFIG);
+  quadrotor.configure(TEST_CONFIG_PATH);
+  executor.quadrotor = &quadrotor;
+
+  // inputs and commands are applied before stepping
+  executor.state.position.write(Vec3{1.0, 2.0, 3.0});
+  executor.state.velocity.write(Vec3{0.1, 0.2, 0.3});
+  executor.state.target_position.write(Vec3{0.5, 0.5, -3.0});
+  executor.state.target_detected.write(true);
+  EXPECT_EQ(0, executor.setMode(HOVER_MODE));
+
+  EXPECT_EQ(0, executor.step(0.01));
+  EXPECT_TRUE(quadrotor.pose.position.isApprox(Vec3{1.0, 2.0, 3.0}));
+  EXPECT_TRUE(quadrotor.velocity.isApprox(Vec3{0.1, 0.2, 0.3}));
+  const Vec3 target_pos = quadrotor.landing_target.position_B;
+  EXPECT_TRUE(target_pos.isApprox(Vec3{0.5, 0.5, -3.0}));
+  EXPECT_TRUE(quadrotor.landing_target.detected);
+  EXPECT_EQ(HOVER_MODE, quadrotor.current_mode);
+  EXPECT_EQ(0, executor.commands.size());
+
+  // outputs
+  EXPECT_TRUE(executor.att_cmd.read(att_cmd));
+  EXPECT_FLOAT_EQ(quadrotor.att_cmd.throttle, att_cmd.throttle);
+  EXPECT_EQ(HOVER_MODE, executor.mode);
+  EXPECT_EQ(1u, executor.nb_steps);
+
+  // paused, commands still run but the quadrotor is not stepped
+  executor.paused = true;
+  EXPECT_EQ(0, executor.setMode(LANDING_MODE));
+  EXPECT_EQ(0, executor.step(0.01));
+  EXPECT_EQ(LANDING_MODE, executor.mode);
+  EXPECT_EQ(1u, executor.nb_steps);
+  EXPECT_FALSE(executor.att_cmd.read(att_cmd));
+}
+
+TEST(ControlExecutor, commands) {
+  ControlExecutor executor;
+  Quadrotor quadrotor;
+  ControllerGains gains;
+
+  // quadrotor not configured, invalid mode
+  executor.configure(TEST_CONFIG);
+  executor.quadrotor = &quadrotor;
+  EXPECT_EQ(-1, executor.setMode(HOVER_MODE));
+  quadrotor.configure(TEST_CONFIG_PATH);
+  EXPECT_EQ(-2, executor.setMode((enum Mode) 100));
+  EXPECT_EQ(0, executor.commands.size());
+
+  // commands are applied in the order they were posted
+  gains.k_p[0] = 1.0;
+  gains.k_i[1] = 2.0;
+  gains.k_d[2] = 3.0;
+  gains.hover_throttle = 0.5;
+  gains.track_offset[2] = 1.0;
+  executor.paused = true;
+  EXPECT_EQ(0, executor.setMode(HOVER_MODE));
+  EXPECT_EQ(0, executor.setHoverPosition(Vec3{1.0, 2.0, 3.0}));
+  EXPECT_EQ(0, executor.setHoverHeight(4.0));
+  EXPECT_EQ(0, executor.setYaw(0.1));
+  EXPECT_EQ(0, executor.setOffboardSetpoint(Vec3{1.0, 2.0, 3.0},
+                                            Vec3{4.0, 5.0, 6.0},
+                                            Vec3{7.0, 8.0, 9.0}));
+  EXPECT_EQ(0, executor.setPositionGains(gains));
+  EXPECT_EQ(0, executor.setTrackingGains(gains));
+  EXPECT_EQ(7, executor.commands.size());
+  EXPECT_EQ(0, executor.step(0.01));
+  EXPECT_EQ(0, executor.commands.size());
+  EXPECT_EQ(HOVER_MODE, quadrotor.current_mode);
+  EXPECT_TRUE(quadrotor.hover_position.isApprox(Vec3{1.0, 2.0, 4.0}));
+  EXPECT_FLOAT_EQ(0.1, quadrotor.yaw_setpoint);
+  EXPECT_TRUE(quadrotor.offboard_acceleration.isApprox(Vec3{7.0, 8.0, 9.0}));
+  EXPECT_FLOAT_EQ(1.0, quadrotor.position_controller.pid.k_p(0));
+  EXPECT_FLOAT_EQ(2.0, quadrotor.position_controller.pid.k_i(1));
+  EXPECT_FLOAT_EQ(3.0, quadrotor.position_controller.pid.k_d(2));
+  EXPECT_FLOAT_EQ(0.5, quadrotor.position_controller.hover_throttle);
+  EXPECT_FLOAT_EQ(1.0, quadrotor.tracking_controller.track_offset(2));
+
+  // full queue drops the command instead of waiting
+  for (int i = 0; i < EXECUTOR_COMMAND_CAPACITY; i++) {
+    EXPECT_EQ(0, executor.setYaw(0.2));
+  }
+  EXPECT_EQ(-1, executor.setYaw(0.3));
+  EXPECT_EQ(-3, executor.setMode(LANDING_MODE));
+  EXPECT_EQ(0, executor.step(0.01));
+  EXPECT_FLOAT_EQ(0.2, quadrotor.yaw_setpoint);
+  EXPECT_EQ(HOVER_MODE, quadrotor.current_mode);
+}
+
+TEST(ControlExecutor, fixedRate) {
+  ControlExecutor executor;
+  Quadrotor quadrotor;
+  AttitudeCommand att_cmd;
+  struct timespec t_start;
+
+  executor.configure(TEST_CONFIG);
+  quadrotor.configure(TEST_CONFIG_PATH);
+  executor.quadrotor = &quadrotor;
+  executor.setMode(HOVER_MODE);
+
+  // run for half a second at 200 Hz while feeding positions
+  tic(&t_start);
+  executor.start(quadrotor);
+  Vec3 position{0.0, 0.0, 0.0};
+  while (toc(&t_start) < 0.5) {
+    position(2) += 0.001;
+    executor.state.position.write(position);
+    usleep(1000);
+  }
+  executor.stop();
+  const double elapsed = toc(&t_start);
+
+  // rate is set by the deadlines, not by how long a step takes
+  const double nb_expected = elapsed * executor.rate;
+  const double nb_steps = executor.nb_steps + executor.nb_missed;
+  EXPECT_NEAR(nb_expected, nb_steps, 0.05 * nb_expected);
+  EXPECT_EQ(executor.nb_steps, executor.jitter.nb_samples);
+  EXPECT_EQ(HOVER_MODE, executor.mode);
+  EXPECT_TRUE(executor.att_cmd.read(att_cmd));
+  EXPECT_TRUE(executor.execution.percentile(0.5) < 1.0 / executor.rate);
+  executor.printStats();
+
+  // stats reset
+  executor.resetStats();
+  EXPECT_EQ(0u, executor.nb_steps);
+  EXPECT_EQ(0u, executor.jitter.nb_samples);
+}
+
+} // namespace atl
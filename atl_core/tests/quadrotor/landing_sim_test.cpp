@@ -0,0 +1,111 @@
+#include "atl/quadrotor/landing_sim.hpp"
+#include "atl/atl_test.hpp"
+
+#define TEST_CONFIG "tests/configs/landing_sim/landing_sim.yaml"
+#define TEST_REPORT "/tmp/landing_sim_report.txt"
+#define TEST_EPISODES "/tmp/landing_sim_episodes.csv"
+
+namespace atl {
+
+TEST(LandingSim, configure) {
+  LandingSim sim;
+
+  EXPECT_EQ(-1, sim.configure("/nonexistent/landing_sim.yaml"));
+  EXPECT_EQ(0, sim.configure(TEST_CONFIG));
+  EXPECT_TRUE(sim.configured);
+  EXPECT_EQ("tests/configs/landing_sim/quadrotor", sim.quadrotor_config);
+  EXPECT_EQ(20, sim.nb_episodes);
+  EXPECT_FLOAT_EQ(30.0, sim.duration);
+  EXPECT_FLOAT_EQ(deg2rad(90.0), sim.camera_fov);
+  EXPECT_FLOAT_EQ(0.3, sim.target_speed(1));
+
+  // parallel episodes must not write to the same blackbox file
+  Quadrotor quadrotor;
+  EXPECT_EQ(0, quadrotor.configure(sim.quadrotor_config));
+  EXPECT_FALSE(quadrotor.waypoint_controller.blackbox_enable);
+}
+
+TEST(LandingSim, sample) {
+  LandingSim sim;
+  sim.configure(TEST_CONFIG);
+
+  // conditions only depend on the seed and episode index
+  const LandingEpisode a = sim.sample(3);
+  const LandingEpisode b = sim.sample(3);
+  const LandingEpisode c = sim.sample(4);
+  EXPECT_EQ(sim.seed + 3, a.seed);
+  EXPECT_TRUE(a.target_start.isApprox(b.target_start));
+  EXPECT_FLOAT_EQ(a.detection_noise, b.detection_noise);
+  EXPECT_FALSE(a.target_start.isApprox(c.target_start));
+
+  for (int i = 0; i < 100; i++) {
+    const LandingEpisode e = sim.sample(i);
+    EXPECT_LE(e.quad_start.norm(), sim.quad_offset(1));
+    EXPECT_LE(e.target_start.head(2).norm(), sim.target_offset(1));
+    EXPECT_GE(e.target_speed, sim.target_speed(0));
+    EXPECT_LE(e.target_speed, sim.target_speed(1));
+    EXPECT_GE(e.detection_dropout, sim.detection_dropout(0));
+    EXPECT_LE(e.detection_dropout, sim.detection_dropout(1));
+  }
+}
+
+TEST(LandingSim, simulate) {
+  LandingSim sim;
+  sim.configure(TEST_CONFIG);
+
+  // static target below the quadrotor, discover, track, land and disarm
+  LandingEpisode episode;
+  episode.detection_noise = 0.01;
+  EXPECT_EQ(0, sim.simulate(episode));
+  EXPECT_EQ("landed", episode.outcome);
+  EXPECT_TRUE(episode.success);
+  EXPECT_LT(episode.touchdown_error, 0.1);
+  EXPECT_GT(episode.touchdown_time, 4.0);
+  EXPECT_GT(episode.nb_detections, 0);
+  EXPECT_GT(episode.timing[SIM_QUADROTOR], 0.0);
+
+  // target never in view
+  episode = LandingEpisode();
+  episode.target_start << 50.0, 0.0, 0.0;
+  sim.duration = 10.0;
+  EXPECT_EQ(0, sim.simulate(episode));
+  EXPECT_EQ("timeout", episode.outcome);
+  EXPECT_EQ(DISCOVER_MODE, episode.final_mode);
+  EXPECT_EQ(0, episode.nb_detections);
+}
+
+TEST(LandingSim, run) {
+  LandingSim sim;
+  sim.configure(TEST_CONFIG);
+  EXPECT_EQ(0, sim.run());
+  EXPECT_EQ(20u, sim.episodes.size());
+  EXPECT_GT(sim.successRate(), 0.5);
+  EXPECT_LE(sim.touchdownError(0.5), sim.touchdownError(0.9));
+
+  // results do not depend on the number of threads
+  LandingSim single;
+  single.configure(TEST_CONFIG);
+  single.nb_threads = 1;
+  single.run();
+  for (size_t i = 0; i < sim.episodes.size(); i++) {
+    EXPECT_EQ(single.episodes[i].outcome, sim.episodes[i].outcome);
+    EXPECT_EQ(single.episodes[i].touchdown_error,
+              sim.episodes[i].touchdown_error);
+  }
+
+  // real time factor
+  double simulated = 0.0;
+  for (auto &episode : single.episodes) {
+    simulated += episode.nb_steps * single.dt;
+  }
+  std::cout << "simulated " << simulated << "s in " << single.elapsed;
+  std::cout << "s (" << simulated / single.elapsed << "x real time)";
+  std::cout << std::endl;
+
+  EXPECT_EQ(0, sim.saveReport(TEST_REPORT));
+  EXPECT_EQ(0, sim.saveEpisodes(TEST_EPISODES));
+  EXPECT_TRUE(file_exists(TEST_REPORT));
+  EXPECT_TRUE(file_exists(TEST_EPISODES));
+}
+
+} // namespace atl
@@ -65,6 +65,10 @@ TEST(Quadrotor, setMode) {
   // check WAYPOINT_MODE
   quadrotor.setMode(WAYPOINT_MODE);
   EXPECT_EQ(WAYPOINT_MODE, quadrotor.current_mode);
+
+  // check OFFBOARD_MODE
+  quadrotor.setMode(OFFBOARD_MODE);
+  EXPECT_EQ(OFFBOARD_MODE, quadrotor.current_mode);
 }
 
 TEST(Quadrotor, setPose) {
@@ -73,7 +77,7 @@ TEST(Quadrotor, setPose) {
 
   // setup
   pose.position << 1.0, 2.0, 3.0;
-  pose.orientation = Quaternion();
+  pose.orientation = Quaternion::Identity();
 
   // check fail
   EXPECT_EQ(-1, quadrotor.setPose(pose));
@@ -205,4 +209,88 @@ TEST(Quadrotor, conditionsMet) {
   EXPECT_TRUE(quadrotor.conditionsMet(conditions, 3));
 }
 
+TEST(Quadrotor, stepOffboardMode) {
+  Quadrotor quadrotor;
+  Pose pose;
+
+  // check fail
+  EXPECT_EQ(-1, quadrotor.stepOffboardMode(0.01));
+  EXPECT_EQ(-1, quadrotor.setOffboardSetpoint(Vec3::Zero(),
+                                              Vec3::Zero(),
+                                              Vec3::Zero()));
+
+  // offboard mode holds the hover position until a setpoint arrives
+  quadrotor.configure(TEST_CONFIG_PATH);
+  pose.position << 0.0, 0.0, 3.0;
+  quadrotor.setPose(pose);
+  quadrotor.setMode(OFFBOARD_MODE);
+  EXPECT_TRUE(quadrotor.offboard_position.isApprox(Vec3{0.0, 0.0, 3.0}));
+  EXPECT_EQ(0, quadrotor.step(0.01));
+  EXPECT_NEAR(0.0, quadrotor.att_cmd.rpy.norm(), 1e-9);
+  EXPECT_NEAR(0.6, quadrotor.att_cmd.throttle, 1e-9);
+
+  // setpoint in front pitches forward, acceleration upwards adds throttle
+  const Vec3 acc{0.0, 0.0, 1.0};
+  EXPECT_EQ(0, quadrotor.setOffboardSetpoint(Vec3{1.0, 0.0, 3.0},
+                                             Vec3::Zero(),
+                                             acc));
+  EXPECT_EQ(0, quadrotor.step(0.01));
+  EXPECT_GT(quadrotor.att_cmd.rpy(1), 0.0);
+  EXPECT_NEAR(0.0, quadrotor.att_cmd.rpy(0), 1e-9);
+  EXPECT_GT(quadrotor.att_cmd.throttle, 0.6);
+}
+
+TEST(Quadrotor, modeTransitions) {
+  Quadrotor quadrotor;
+  double t = 0.0;
+  const double dt = 0.01;
+
+  // simulated clock, the mission does not run in real time
+  quadrotor.clock = [&t]() { return t; };
+  quadrotor.configure(TEST_CONFIG_PATH);
+  EXPECT_EQ(DISCOVER_MODE, quadrotor.current_mode);
+  EXPECT_TRUE(quadrotor.mode_machine.isIn(FLIGHT_MODES));
+
+  struct timespec t_start;
+  tic(&t_start);
+
+  // discover for min_discover_time with the target in view
+  quadrotor.setTargetPosition(Vec3{1.0, 0.0, -3.0});
+  while (quadrotor.current_mode == DISCOVER_MODE && t < 60.0) {
+    quadrotor.setTargetDetected(true);
+    quadrotor.step(dt);
+    t += dt;
+  }
+  EXPECT_EQ(TRACKING_MODE, quadrotor.current_mode);
+  EXPECT_NEAR(quadrotor.min_discover_time / 1000.0, t, 2 * dt);
+
+  // losing the target for target_lost_threshold drops back to discover
+  const double t_lost = t;
+  while (quadrotor.current_mode == TRACKING_MODE && t < 60.0) {
+    quadrotor.setTargetDetected(false);
+    quadrotor.step(dt);
+    t += dt;
+  }
+  EXPECT_EQ(DISCOVER_MODE, quadrotor.current_mode);
+  EXPECT_NEAR(quadrotor.target_lost_threshold / 1000.0, t - t_lost, 2 * dt);
+  EXPECT_TRUE(quadrotor.landing_target.losted);
+  EXPECT_FLOAT_EQ(quadrotor.recover_height, quadrotor.hover_position(2));
+
+  // discover, track and land
+  const double t_discover = t;
+  while (quadrotor.current_mode != DISARM_MODE && t < 60.0) {
+    const double z = std::max(0.05, 3.0 - 0.5 * (t - t_discover));
+    quadrotor.setTargetPosition(Vec3{0.0, 0.0, -z});
+    quadrotor.setTargetDetected(true);
+    quadrotor.step(dt);
+    t += dt;
+  }
+  EXPECT_EQ(DISARM_MODE, quadrotor.current_mode);
+  EXPECT_FALSE(quadrotor.mode_machine.isIn(FLIGHT_MODES));
+  EXPECT_GT(t - t_discover, 10.0);
+
+  // the simulated mission runs much faster than real time
+  EXPECT_LT(toc(&t_start), 0.1 * t);
+}
+
 } // namespace atl
@@ -0,0 +1,79 @@
+#include <thread>
+
+#include "atl/atl_test.hpp"
+#include "atl/quadrotor/state_store.hpp"
+
+namespace atl {
+
+TEST(StateStore, read) {
+  StateStore store;
+  StateSnapshot snapshot;
+
+  // nothing published yet
+  EXPECT_EQ(0, store.read(snapshot));
+  EXPECT_FALSE(snapshot.pose_updated);
+  EXPECT_FALSE(snapshot.velocity_updated);
+  EXPECT_FALSE(snapshot.target_updated);
+  EXPECT_FALSE(snapshot.radio_updated);
+  EXPECT_FLOAT_EQ(1.0, snapshot.pose.orientation.w());
+
+  // publish
+  RadioState radio;
+  radio.axes[4] = -1.0;
+  radio.nb_axes = 5;
+  const Quaternion q{0.5, 0.5, -0.5, 0.5};
+  store.position.write(Vec3{1.0, 2.0, 3.0});
+  store.orientation.write(q);
+  store.target_detected.write(true);
+  store.radio.write(radio);
+
+  store.read(snapshot);
+  EXPECT_TRUE(snapshot.pose_updated);
+  EXPECT_FALSE(snapshot.velocity_updated);
+  EXPECT_TRUE(snapshot.target_updated);
+  EXPECT_TRUE(snapshot.radio_updated);
+  EXPECT_TRUE(snapshot.pose.position.isApprox(Vec3{1.0, 2.0, 3.0}));
+  EXPECT_TRUE(snapshot.pose.orientation.isApprox(q));
+  EXPECT_TRUE(snapshot.target.detected);
+  EXPECT_FLOAT_EQ(-1.0, snapshot.radio.axes[4]);
+  EXPECT_EQ(5, snapshot.radio.nb_axes);
+
+  // updated flags are relative to the previous snapshot
+  store.read(snapshot);
+  EXPECT_FALSE(snapshot.pose_updated);
+  EXPECT_FALSE(snapshot.target_updated);
+  EXPECT_FALSE(snapshot.radio_updated);
+  EXPECT_TRUE(snapshot.pose.position.isApprox(Vec3{1.0, 2.0, 3.0}));
+}
+
+TEST(StateStore, coherentSnapshot) {
+  StateStore store;
+  const int nb_values = 200000;
+
+  // producer publishes position i and then velocity i, so at any instant
+  // velocity is position or position - 1
+  std::thread producer([&]() {
+    for (int i = 1; i <= nb_values; i++) {
+      store.position.write(Vec3{(double) i, 0.0, 0.0});
+      store.velocity.write(Vec3{(double) i, 0.0, 0.0});
+    }
+  });
+
+  // a snapshot copied while either channel changed would break that
+  StateSnapshot snapshot;
+  int nb_incoherent = 0;
+  int nb_retries = 0;
+  while (snapshot.velocity(0) < nb_values) {
+    nb_retries += store.read(snapshot);
+    const double diff = snapshot.pose.position(0) - snapshot.velocity(0);
+    if (diff != 0.0 && diff != 1.0) {
+      nb_incoherent++;
+    }
+  }
+  producer.join();
+
+  std::cout << "retries: " << nb_retries << std::endl;
+  EXPECT_EQ(0, nb_incoherent);
+}
+
+} // namespace atl
@@ -0,0 +1,218 @@
+#include <unistd.h>
+
+#include "atl/utils/flight_recorder.hpp"
+#include "atl/atl_test.hpp"
+#include "atl/utils/time.hpp"
+
+#define TEST_LOG "/tmp/flight_recorder_test.dat"
+#define TEST_CSV "/tmp/flight_recorder_test.csv"
+#define TEST_NPY "/tmp/flight_recorder_test.npy"
+
+namespace atl {
+
+static const std::vector<std::string> TEST_FIELDS = {"t", "x", "y", "z"};
+
+TEST(Utils_flight_recorder, configure) {
+  FlightRecorder recorder;
+
+  // invalid schema
+  EXPECT_EQ(-1, recorder.configure(TEST_LOG, {}));
+  EXPECT_FALSE(recorder.configured);
+
+  // invalid path
+  EXPECT_EQ(-2, recorder.configure("/nonexistent/log.dat", TEST_FIELDS));
+
+  // capacity rounded up to a power of two
+  EXPECT_EQ(0, recorder.configure(TEST_LOG, TEST_FIELDS, 1000));
+  EXPECT_TRUE(recorder.configured);
+  EXPECT_EQ(1024u, recorder.capacity);
+  EXPECT_EQ(4u, recorder.nb_fields);
+  recorder.close();
+
+  // header only
+  std::vector<std::string> fields;
+  MatX data;
+  EXPECT_EQ(0, flight_log_load(TEST_LOG, fields, data));
+  EXPECT_TRUE(fields == TEST_FIELDS);
+  EXPECT_EQ(0, data.rows());
+}
+
+TEST(Utils_flight_recorder, recordAndLoad) {
+  FlightRecorder recorder;
+  recorder.chunk_size = 64;
+  recorder.flush_period = 0.001;
+  recorder.configure(TEST_LOG, TEST_FIELDS, 128);
+
+  // record while the writer drains, spanning several chunks and wraps
+  const int nb_rows = 1000;
+  for (int i = 0; i < nb_rows; i++) {
+    const double row[4] = {i * 0.01, i * 1.0, i * 2.0, i * 3.0};
+    while (recorder.record(row) != 0) {
+      std::this_thread::yield();
+    }
+  }
+  recorder.close();
+  EXPECT_FALSE(recorder.configured);
+  EXPECT_EQ((uint64_t) nb_rows, recorder.nb_written);
+
+  // load
+  std::vector<std::string> fields;
+  MatX data;
+  EXPECT_EQ(0, flight_log_load(TEST_LOG, fields, data));
+  EXPECT_TRUE(fields == TEST_FIELDS);
+  ASSERT_EQ(nb_rows, data.rows());
+  ASSERT_EQ(4, data.cols());
+  for (int i = 0; i < nb_rows; i++) {
+    EXPECT_DOUBLE_EQ(i * 0.01, data(i, 0));
+    EXPECT_DOUBLE_EQ(i * 3.0, data(i, 3));
+  }
+
+  // invalid files
+  EXPECT_EQ(-1, flight_log_load("/nonexistent/log.dat", fields, data));
+  EXPECT_EQ(-2, flight_log_load("tests/data/utils/matrix.dat", fields, data));
+}
+
+TEST(Utils_flight_recorder, dropWhenFull) {
+  FlightRecorder recorder;
+  recorder.flush_period = 10.0;
+  recorder.configure(TEST_LOG, TEST_FIELDS, 16);
+
+  // writer is asleep, so the ring buffer fills up and rows are dropped
+  const double row[4] = {1.0, 2.0, 3.0, 4.0};
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(0, recorder.record(row));
+  }
+  EXPECT_EQ(-1, recorder.record(row));
+  EXPECT_EQ(1u, recorder.nb_dropped.load());
+
+  // not configured
+  recorder.close();
+  EXPECT_EQ(-1, recorder.record(row));
+  EXPECT_EQ(16u, recorder.nb_written);
+}
+
+TEST(Utils_flight_recorder, truncatedLog) {
+  FlightRecorder recorder;
+  recorder.configure(TEST_LOG, TEST_FIELDS, 16);
+  for (int i = 0; i < 10; i++) {
+    const double row[4] = {(double) i, 0.0, 0.0, 0.0};
+    recorder.record(row);
+  }
+  recorder.close();
+
+  // cut the log in the middle of the last row
+  FILE *file = fopen(TEST_LOG, "r+b");
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fclose(file);
+  EXPECT_EQ(0, truncate(TEST_LOG, size - 8));
+
+  std::vector<std::string> fields;
+  MatX data;
+  EXPECT_EQ(0, flight_log_load(TEST_LOG, fields, data));
+  EXPECT_EQ(9, data.rows());
+  EXPECT_DOUBLE_EQ(8.0, data(8, 0));
+}
+
+TEST(Utils_flight_recorder, flight_log2csv) {
+  FlightRecorder recorder;
+  recorder.configure(TEST_LOG, TEST_FIELDS, 16);
+  const double row[4] = {0.1, 1.0, 2.0, 3.0};
+  recorder.record(row);
+  recorder.record(row);
+  recorder.close();
+
+  EXPECT_EQ(0, flight_log2csv(TEST_LOG, TEST_CSV));
+  EXPECT_EQ(-1, flight_log2csv("/nonexistent/log.dat", TEST_CSV));
+
+  std::ifstream csv(TEST_CSV);
+  std::string line;
+  std::getline(csv, line);
+  EXPECT_EQ("t,x,y,z", line);
+
+  MatX data;
+  EXPECT_EQ(0, csv2mat(TEST_CSV, true, data));
+  EXPECT_EQ(2, data.rows());
+  EXPECT_EQ(4, data.cols());
+  EXPECT_DOUBLE_EQ(0.1, data(1, 0));
+  EXPECT_DOUBLE_EQ(3.0, data(1, 3));
+}
+
+TEST(Utils_flight_recorder, flight_log2npy) {
+  FlightRecorder recorder;
+  recorder.configure(TEST_LOG, TEST_FIELDS, 16);
+  const double row[4] = {0.1, 1.0, 2.0, 3.0};
+  for (int i = 0; i < 3; i++) {
+    recorder.record(row);
+  }
+  recorder.close();
+
+  EXPECT_EQ(0, flight_log2npy(TEST_LOG, TEST_NPY));
+
+  // magic, version and header
+  std::ifstream npy(TEST_NPY, std::ios::binary);
+  char preamble[10];
+  npy.read(preamble, 10);
+  EXPECT_EQ(0, memcmp(preamble, "\x93NUMPY\x01\x00", 8));
+  const int header_len = (uint8_t) preamble[8] | ((uint8_t) preamble[9] << 8);
+  EXPECT_EQ(0, (10 + header_len) % 64);
+
+  std::string header(header_len, '\0');
+  npy.read(&header[0], header_len);
+  EXPECT_NE(std::string::npos, header.find("('x', '<f8')"));
+  EXPECT_NE(std::string::npos, header.find("'shape': (3,)"));
+  EXPECT_EQ('\n', header.back());
+
+  // data
+  double values[12];
+  npy.read((char *) values, sizeof(values));
+  EXPECT_TRUE(npy.good());
+  EXPECT_DOUBLE_EQ(0.1, values[8]);
+  EXPECT_DOUBLE_EQ(3.0, values[11]);
+}
+
+TEST(Utils_flight_recorder, recordBenchmark) {
+  FlightRecorder recorder;
+  recorder.configure(TEST_LOG, TEST_FIELDS, 1024);
+
+  // cost of record() on the control thread while the writer is draining,
+  // the ring buffer is smaller than the run so rows may be dropped
+  const int nb_rows = 50000;
+  std::vector<double> times;
+  times.reserve(nb_rows);
+  uint64_t nb_failed = 0;
+  for (int i = 0; i < nb_rows; i++) {
+    const double row[4] = {(double) i, 1.0, 2.0, 3.0};
+    struct timespec t;
+    tic(&t);
+    nb_failed += (recorder.record(row) != 0);
+    times.push_back(toc(&t));
+  }
+  recorder.close();
+
+  std::sort(times.begin(), times.end());
+  const double p50 = times[nb_rows / 2];
+  const double p99 = times[(size_t) (0.99 * (nb_rows - 1))];
+  std::cout << "record() [us] ";
+  std::cout << "p50: " << p50 * 1e6 << "\t";
+  std::cout << "p99: " << p99 * 1e6 << "\t";
+  std::cout << "max: " << times.back() * 1e6 << "\t";
+  std::cout << "dropped: " << nb_failed << std::endl;
+
+  // every row is either written or reported as dropped, none go missing
+  EXPECT_EQ(nb_failed, recorder.nb_dropped.load());
+  EXPECT_EQ((uint64_t) nb_rows, recorder.nb_written + nb_failed);
+
+  // and the rows that made it are in order
+  std::vector<std::string> fields;
+  MatX data;
+  EXPECT_EQ(0, flight_log_load(TEST_LOG, fields, data));
+  ASSERT_EQ((long) recorder.nb_written, data.rows());
+  int nb_out_of_order = 0;
+  for (long i = 1; i < data.rows(); i++) {
+    nb_out_of_order += (data(i, 0) <= data(i - 1, 0));
+  }
+  EXPECT_EQ(0, nb_out_of_order);
+}
+
+} // namespace atl
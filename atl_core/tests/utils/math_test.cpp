@@ -53,6 +53,12 @@ TEST(Math, wrapTo180) {
 
   retval = wrapTo180(450.0);
   EXPECT_FLOAT_EQ(90.0, retval);
+
+  retval = wrapTo180(-270.0);
+  EXPECT_FLOAT_EQ(90.0, retval);
+
+  retval = wrapTo180(-540.0);
+  EXPECT_FLOAT_EQ(-180.0, retval);
 }
 
 TEST(Math, wrapTo360) {
@@ -0,0 +1,80 @@
+#include <thread>
+
+#include "atl/atl_test.hpp"
+#include "atl/utils/ring_buffer.hpp"
+
+namespace atl {
+
+struct TestValue {
+  int a = 0;
+  int b = 0;
+};
+
+TEST(Utils_ring_buffer, pushAndPop) {
+  RingBuffer<TestValue, 4> buffer;
+  TestValue value;
+
+  // empty
+  EXPECT_EQ(0, buffer.size());
+  EXPECT_FALSE(buffer.pop(value));
+
+  // fill up, the fifth push fails
+  for (int i = 1; i <= 4; i++) {
+    value.a = i;
+    EXPECT_TRUE(buffer.push(value));
+  }
+  EXPECT_EQ(4, buffer.size());
+  value.a = 5;
+  EXPECT_FALSE(buffer.push(value));
+
+  // values come out in the order they went in, across the wrap around
+  EXPECT_TRUE(buffer.pop(value));
+  EXPECT_EQ(1, value.a);
+  value.a = 5;
+  EXPECT_TRUE(buffer.push(value));
+  for (int i = 2; i <= 5; i++) {
+    EXPECT_TRUE(buffer.pop(value));
+    EXPECT_EQ(i, value.a);
+  }
+  EXPECT_FALSE(buffer.pop(value));
+}
+
+TEST(Utils_ring_buffer, producerConsumer) {
+  RingBuffer<TestValue, 64> buffer;
+  const int nb_values = 1000000;
+
+  // producer pushes values whose fields must always agree, retrying while
+  // the buffer is full
+  std::thread producer([&]() {
+    TestValue value;
+    for (int i = 1; i <= nb_values; i++) {
+      value.a = i;
+      value.b = -i;
+      while (buffer.push(value) == false) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  // consumer must see every value once, in order and never torn
+  TestValue value;
+  int last = 0;
+  int nb_torn = 0;
+  int nb_out_of_order = 0;
+  while (last < nb_values) {
+    if (buffer.pop(value) == false) {
+      std::this_thread::yield();
+      continue;
+    }
+    nb_torn += (value.a != -value.b);
+    nb_out_of_order += (value.a != last + 1);
+    last = value.a;
+  }
+  producer.join();
+
+  EXPECT_EQ(0, nb_torn);
+  EXPECT_EQ(0, nb_out_of_order);
+  EXPECT_EQ(0, buffer.size());
+}
+
+} // namespace atl
@@ -0,0 +1,81 @@
+#include <thread>
+
+#include "atl/atl_test.hpp"
+#include "atl/utils/seqlock.hpp"
+
+namespace atl {
+
+struct TestRecord {
+  int64_t a = 0;
+  int64_t b = 0;
+  int64_t c = 0;
+};
+
+TEST(Utils_seqlock, readAndWrite) {
+  Seqlock<TestRecord> seqlock;
+  TestRecord record;
+
+  // initial value
+  EXPECT_EQ(0u, seqlock.read(record));
+  EXPECT_EQ(0, record.a);
+
+  // every write moves the sequence by 2
+  record.a = 1;
+  record.b = 2;
+  record.c = 3;
+  seqlock.write(record);
+  record = TestRecord();
+  EXPECT_EQ(2u, seqlock.read(record));
+  EXPECT_EQ(1, record.a);
+  EXPECT_EQ(2, record.b);
+  EXPECT_EQ(3, record.c);
+
+  // read in progress invalidated by a write
+  const uint32_t seq = seqlock.readBegin();
+  seqlock.readCopy(record);
+  seqlock.write(record);
+  EXPECT_FALSE(seqlock.readValid(seq));
+}
+
+TEST(Utils_seqlock, producerConsumer) {
+  Seqlock<TestRecord> seqlock;
+  const int64_t nb_values = 1000000;
+
+  // producer writes values whose fields must always agree
+  std::thread producer([&]() {
+    TestRecord record;
+    for (int64_t i = 1; i <= nb_values; i++) {
+      record.a = i;
+      record.b = -i;
+      record.c = 2 * i;
+      seqlock.write(record);
+    }
+  });
+
+  // consumers must never see a torn or older value
+  int nb_torn = 0;
+  int nb_older = 0;
+  auto consumer = [&]() {
+    TestRecord record;
+    int64_t last = 0;
+    while (last < nb_values) {
+      seqlock.read(record);
+      if (record.a != -record.b || record.c != 2 * record.a) {
+        nb_torn++;
+      }
+      if (record.a < last) {
+        nb_older++;
+      }
+      last = record.a;
+    }
+  };
+  std::thread consumer2(consumer);
+  consumer();
+  producer.join();
+  consumer2.join();
+
+  EXPECT_EQ(0, nb_torn);
+  EXPECT_EQ(0, nb_older);
+}
+
+} // namespace atl
@@ -0,0 +1,144 @@
+#include "atl/utils/state_machine.hpp"
+#include "atl/atl_test.hpp"
+
+namespace atl {
+
+// A and B are children of P, C is a top level state
+#define STATE_P 0
+#define STATE_A 1
+#define STATE_B 2
+#define STATE_C 3
+
+static void setup(StateMachine &sm,
+                  std::vector<std::string> &trace,
+                  double &t) {
+  auto entry = [&trace](const std::string &s) {
+    return [&trace, s]() { trace.push_back("enter " + s); };
+  };
+  auto exit = [&trace](const std::string &s) {
+    return [&trace, s]() { trace.push_back("exit " + s); };
+  };
+
+  sm.clock = [&t]() { return t; };
+  sm.addState(STATE_P, "P", -1, entry("P"), exit("P"));
+  sm.addState(STATE_A, "A", STATE_P, entry("A"), exit("A"));
+  sm.addState(STATE_B, "B", STATE_P, entry("B"), exit("B"));
+  sm.addState(STATE_C, "C", -1, entry("C"), exit("C"));
+}
+
+TEST(StateMachine, addState) {
+  StateMachine sm;
+  std::vector<std::string> trace;
+  double t = 0.0;
+  setup(sm, trace, t);
+
+  EXPECT_EQ(4u, sm.states.size());
+  EXPECT_EQ(-1, sm.addState(STATE_A, "A"));
+  EXPECT_EQ(-1, sm.addState(-1, "X"));
+  EXPECT_EQ(-2, sm.addState(10, "X", 42));
+  EXPECT_EQ(-1, sm.addTransition(STATE_A, 42, nullptr));
+  EXPECT_EQ(-1, sm.update());
+}
+
+TEST(StateMachine, start) {
+  StateMachine sm;
+  std::vector<std::string> trace;
+  double t = 0.0;
+  setup(sm, trace, t);
+
+  EXPECT_EQ(0, sm.start(STATE_A));
+  EXPECT_EQ(STATE_A, sm.current);
+  EXPECT_EQ("A", sm.currentName());
+  EXPECT_TRUE(sm.isIn(STATE_A));
+  EXPECT_TRUE(sm.isIn(STATE_P));
+  EXPECT_FALSE(sm.isIn(STATE_C));
+
+  const std::vector<std::string> expected = {"enter P", "enter A"};
+  EXPECT_EQ(expected, trace);
+
+  trace.clear();
+  sm.stop();
+  EXPECT_EQ(-1, sm.current);
+  const std::vector<std::string> stopped = {"exit A", "exit P"};
+  EXPECT_EQ(stopped, trace);
+}
+
+TEST(StateMachine, transition) {
+  StateMachine sm;
+  std::vector<std::string> trace;
+  double t = 0.0;
+  setup(sm, trace, t);
+
+  sm.start(STATE_A);
+
+  // between siblings the parent is neither exited nor entered
+  trace.clear();
+  sm.transition(STATE_B, [&trace]() { trace.push_back("action"); });
+  std::vector<std::string> expected = {"exit A", "action", "enter B"};
+  EXPECT_EQ(expected, trace);
+
+  // out of the parent
+  trace.clear();
+  sm.transition(STATE_C);
+  expected = {"exit B", "exit P", "enter C"};
+  EXPECT_EQ(expected, trace);
+
+  // into a child
+  trace.clear();
+  sm.transition(STATE_A);
+  expected = {"exit C", "enter P", "enter A"};
+  EXPECT_EQ(expected, trace);
+
+  // self transition
+  trace.clear();
+  sm.transition(STATE_A);
+  expected = {"exit A", "enter A"};
+  EXPECT_EQ(expected, trace);
+
+  // to the parent
+  trace.clear();
+  sm.transition(STATE_P);
+  expected = {"exit A", "exit P", "enter P"};
+  EXPECT_EQ(expected, trace);
+}
+
+TEST(StateMachine, update) {
+  StateMachine sm;
+  std::vector<std::string> trace;
+  double t = 0.0;
+  setup(sm, trace, t);
+
+  bool go_b = false;
+  bool go_c = false;
+  sm.addTransition(STATE_A, STATE_B, [&go_b]() { return go_b; });
+  sm.addTransition(STATE_P, STATE_C, [&go_c]() { return go_c; });
+  sm.addTransition(STATE_C, STATE_A, [&sm]() {
+    return sm.timeInState() > 2.0;
+  });
+  sm.start(STATE_A);
+
+  // guards do not hold
+  EXPECT_EQ(0, sm.update());
+  EXPECT_EQ(STATE_A, sm.current);
+
+  // the child transition is checked before the parent one
+  go_b = true;
+  go_c = true;
+  EXPECT_EQ(1, sm.update());
+  EXPECT_EQ(STATE_B, sm.current);
+
+  // the parent transition applies to every child
+  EXPECT_EQ(1, sm.update());
+  EXPECT_EQ(STATE_C, sm.current);
+
+  // time in state follows the injected clock
+  t = 2.0;
+  EXPECT_EQ(0, sm.update());
+  t = 2.5;
+  EXPECT_FLOAT_EQ(2.5, sm.timeInState());
+  EXPECT_EQ(1, sm.update());
+  EXPECT_EQ(STATE_A, sm.current);
+  EXPECT_FLOAT_EQ(0.0, sm.timeInState());
+}
+
+} // namespace atl
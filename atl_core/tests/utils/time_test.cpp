@@ -14,4 +14,12 @@ TEST(Utils_time, ticAndtoc) {
   EXPECT_TRUE(mtoc(&start) > 9.0);
 }
 
+TEST(Utils_time, time_monotonic) {
+  const double t0 = time_monotonic();
+  usleep(10 * 1000);
+  const double t1 = time_monotonic();
+  EXPECT_TRUE(t1 - t0 < 0.011);
+  EXPECT_TRUE(t1 - t0 > 0.009);
+}
+
 } // namespace atl
@@ -0,0 +1,65 @@
+#include <thread>
+
+#include "atl/atl_test.hpp"
+#include "atl/utils/triple_buffer.hpp"
+
+namespace atl {
+
+struct TestValue {
+  int a = 0;
+  int b = 0;
+};
+
+TEST(Utils_triple_buffer, readAndWrite) {
+  TripleBuffer<TestValue> buffer;
+  TestValue value;
+
+  // nothing written
+  EXPECT_FALSE(buffer.read(value));
+
+  // latest value wins
+  value.a = 1;
+  buffer.write(value);
+  value.a = 2;
+  buffer.write(value);
+  EXPECT_TRUE(buffer.read(value));
+  EXPECT_EQ(2, value.a);
+
+  // read again without new value
+  value.a = 0;
+  EXPECT_FALSE(buffer.read(value));
+  EXPECT_EQ(2, value.a);
+}
+
+TEST(Utils_triple_buffer, producerConsumer) {
+  TripleBuffer<TestValue> buffer;
+  const int nb_values = 1000000;
+
+  // producer writes values whose fields must always agree
+  std::thread producer([&]() {
+    TestValue value;
+    for (int i = 1; i <= nb_values; i++) {
+      value.a = i;
+      value.b = -i;
+      buffer.write(value);
+    }
+  });
+
+  // consumer must never see a torn or older value
+  TestValue value;
+  int last = 0;
+  int nb_torn = 0;
+  int nb_older = 0;
+  while (last < nb_values) {
+    buffer.read(value);
+    nb_torn += (value.a != -value.b);
+    nb_older += (value.a < last);
+    last = value.a;
+  }
+  producer.join();
+
+  EXPECT_EQ(0, nb_torn);
+  EXPECT_EQ(0, nb_older);
+}
+
+} // namespace atl
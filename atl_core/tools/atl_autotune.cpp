@@ -0,0 +1,33 @@
+#include "atl/control/autotune.hpp"
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    printf("Usage: %s <config.yaml> <output.yaml> [report.txt]\n", argv[0]);
+    return -1;
+  }
+
+  // configure
+  atl::AutoTuner tuner;
+  if (tuner.configure(argv[1]) != 0) {
+    LOG_ERROR("Failed to configure auto-tuner!");
+    return -1;
+  }
+
+  // tune
+  LOG_INFO("Tuning %s controller ...", tuner.controller.c_str());
+  tuner.optimize();
+  LOG_INFO("Cost %f -> %f in %.2fs",
+           tuner.initial_cost,
+           tuner.best_cost,
+           tuner.elapsed);
+
+  // output
+  if (tuner.saveConfig(argv[2]) != 0) {
+    return -1;
+  }
+  if (argc > 3 && tuner.saveReport(argv[3]) != 0) {
+    return -1;
+  }
+
+  return 0;
+}
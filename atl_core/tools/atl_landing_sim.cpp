@@ -0,0 +1,34 @@
+#include "atl/quadrotor/landing_sim.hpp"
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    printf("Usage: %s <config.yaml> [report.txt] [episodes.csv]\n", argv[0]);
+    return -1;
+  }
+
+  // configure
+  atl::LandingSim sim;
+  if (sim.configure(argv[1]) != 0) {
+    LOG_ERROR("Failed to configure landing simulation!");
+    return -1;
+  }
+
+  // simulate
+  LOG_INFO("Simulating %d landing episodes ...", sim.nb_episodes);
+  sim.run();
+  LOG_INFO("Success rate %.3f, median touchdown error %.3fm in %.2fs",
+           sim.successRate(),
+           sim.touchdownError(0.5),
+           sim.elapsed);
+
+  // output
+  const std::string report_file = (argc > 2) ? argv[2] : "/dev/stdout";
+  if (sim.saveReport(report_file) != 0) {
+    return -1;
+  }
+  if (argc > 3 && sim.saveEpisodes(argv[3]) != 0) {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,28 @@
+#include "atl/control/trajectory_library.hpp"
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    printf("Usage: %s <index.csv> <library.bin>\n", argv[0]);
+    return -1;
+  }
+
+  // convert
+  LOG_INFO("Converting trajectory index [%s] ...", argv[1]);
+  if (atl::trajectory_library_create(argv[1], argv[2]) != 0) {
+    LOG_ERROR("Failed to create trajectory library!");
+    return -1;
+  }
+
+  // check
+  atl::TrajectoryLibrary library;
+  if (library.open(argv[2]) != 0) {
+    return -1;
+  }
+  LOG_INFO("Wrote %d trajectories, %lu records (%lu bytes) to [%s]",
+           library.nbTrajectories(),
+           (unsigned long) library.header->nb_rows,
+           (unsigned long) library.size,
+           argv[2]);
+
+  return 0;
+}
@@ -0,0 +1,28 @@
+#include "atl/planning/library_generator.hpp"
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    printf("Usage: %s <config.yaml> <output dir>\n", argv[0]);
+    return -1;
+  }
+
+  // configure
+  atl::LibraryGenerator generator;
+  if (generator.configure(argv[1]) != 0) {
+    LOG_ERROR("Failed to configure library generator!");
+    return -1;
+  }
+
+  // generate, resumes an interrupted run in the same directory
+  const int retval = generator.generate(argv[2]);
+  if (retval == -1 || retval == -2) {
+    return -1;
+  }
+  LOG_INFO("Throughput: %.2f traj/s on %d threads",
+           generator.throughput(),
+           (generator.nb_threads > 0)
+               ? generator.nb_threads
+               : (int) std::thread::hardware_concurrency());
+
+  return (retval == 0) ? 0 : -1;
+}
@@ -22,6 +22,7 @@ static const std::string TARGET_W_YAW_TOPIC = "/atl/apriltag/target/yaw/inertial
 static const std::string TARGET_P_POS_TOPIC = "/atl/apriltag/target/position/body";
 static const std::string TARGET_P_POS_ENCODER_TOPIC = "/atl/apriltag/target/position/body_encoders";
 static const std::string TARGET_P_YAW_TOPIC = "/atl/apriltag/target/yaw/body";
+static const std::string TARGETS_P_POS_TOPIC = "/atl/apriltag/targets/position/body";
 // clang-format on
 
 // SUBSCRIBE TOPICS
@@ -94,6 +95,15 @@ public:
    */
   void publishTargetBodyYawMsg(const TagPose &tag);
 
+  /**
+   * Publish position of every detected tag in body planar frame
+   *
+   * @param tags Detected tags in camera frame
+   * @param gimbal_joint Gimbal joint orientation
+   */
+  void publishTargetsBodyPositionMsg(const std::vector<TagPose> &tags,
+                                     const Quaternion &gimbal_joint);
+
   /**
    * Image callback
    *
@@ -38,6 +38,7 @@ static const std::string TARGET_BODY_VELOCITY_TOPIC = "/atl/estimate/landing_tar
 static const std::string TARGET_DETECTED_TOPIC = "/atl/estimate/landing_target/detected";
 static const std::string HOVER_SET_TOPIC = "/atl/control/hover/set";
 static const std::string HOVER_HEIGHT_SET_TOPIC = "/atl/control/hover/height/set";
+static const std::string OFFBOARD_SET_TOPIC = "/atl/control/offboard/set";
 static const std::string PCTRL_SET_TOPIC = "/atl/control/position_controller/set";
 static const std::string TCTRL_SET_TOPIC = "/atl/control/tracking_controller/set";
 static const std::string LCTRL_SET_TOPIC = "/atl/control/landing_controller/set";
@@ -54,7 +55,11 @@ public:
   bool configured = false;
 
   Quadrotor quadrotor;
+  ControlExecutor executor;
+  StateSnapshot snapshot;
+  AttitudeCommand att_cmd;
   bool armed = false;
+  bool was_armed = false; // armed in the last loop
   int gps_status = -1;
   int gps_service = 0;
   double latitude = 0.0;
@@ -195,6 +200,12 @@ public:
    */
   void hoverHeightSetCallback(const std_msgs::Float64 &msg);
 
+  /**
+   * Offboard setpoint callback, tracked in OFFBOARD_MODE
+   * @param msg ROS message
+   */
+  void offboardSetCallback(const atl_msgs::OffboardSetpoint &msg);
+
   /**
    * Position controller callback
    * @param msg ROS message
@@ -228,6 +239,14 @@ public:
    */
   void publishQuadrotorVelocity();
 
+  /**
+   * Set quadrotor mode, applied by the control executor before its next step
+   *
+   * @param mode Mode
+   * @return Return value of `ControlExecutor::setMode()`
+   */
+  int setMode(const enum Mode mode);
+
   /**
    * ROS node loop function
    *
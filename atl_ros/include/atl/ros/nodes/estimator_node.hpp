@@ -21,14 +21,17 @@ static const std::string LT_VELOCITY_B_TOPIC = "/atl/estimate/landing_target/vel
 static const std::string LT_DETECTED_TOPIC = "/atl/estimate/landing_target/detected";
 static const std::string GIMBAL_SETPOINT_ATTITUDE_TOPIC = "/atl/gimbal/setpoint/attitude";
 static const std::string QUAD_YAW_TOPIC = "/atl/control/yaw/set";
+static const std::string LT_TRACKS_B_TOPIC = "/atl/estimate/landing_targets/position/body";
 
 // SUBSCRIBE TOPICS
 static const std::string QUAD_POSE_TOPIC = "/atl/quadrotor/pose/local";
 static const std::string QUAD_VELOCITY_TOPIC = "/atl/quadrotor/velocity/local";
 static const std::string ESTIMATOR_ON_TOPIC = "/atl/estimator/on";
 static const std::string ESTIMATOR_OFF_TOPIC = "/atl/estimator/off";
+static const std::string TARGET_POSE_TOPIC = "/atl/apriltag/target";
 static const std::string TARGET_POS_B_TOPIC = "/atl/apriltag/target/position/body";
 static const std::string TARGET_YAW_W_TOPIC = "/atl/apriltag/target/yaw/inertial";
+static const std::string TARGETS_POS_B_TOPIC = "/atl/apriltag/targets/position/body";
 // clang-format on
 
 namespace atl {
@@ -41,6 +44,9 @@ public:
 
   KFTracker kf_tracker;
   EKFTracker ekf_tracker;
+  UKFTracker ukf_tracker;
+  TrackerBank tracker_bank;
+  std::vector<TagPose> targets_measured;
 
   Pose quad_pose;
   Vec3 quad_velocity{0.0, 0.0, 0.0};
@@ -55,6 +61,7 @@ public:
   Vec3 target_vel_P{0.0, 0.0, 0.0};
   double target_yaw_W = 0.0;
   Vec3 target_measured{0.0, 0.0, 0.0};
+  TagPose target_tag;
   Vec3 target_last_measured{0.0, 0.0, 0.0};
 
   struct timespec target_last_updated = (struct timespec){0};
@@ -70,6 +77,12 @@ public:
   void onCallback(const std_msgs::Bool &msg);
   void offCallback(const std_msgs::Bool &msg);
 
+  /**
+   * Landing target tag pose (camera frame) callback, keeps the detection
+   * confidence that scales the KF measurement noise
+   */
+  void targetPoseCallback(const atl_msgs::AprilTagPose &msg);
+
   /**
    * Landing target position (body frame) callback
    */
@@ -85,6 +98,11 @@ public:
    */
   void targetInertialYawCallback(const std_msgs::Float64 &msg);
 
+  /**
+   * Landing targets position (body frame) callback, one message per tag
+   */
+  void targetsBodyPosCallback(const atl_msgs::AprilTagPose &msg);
+
   /**
    * Publish landing target position relative to quadrotor (body frame)
    */
@@ -95,6 +113,12 @@ public:
    */
   void publishLTKFBodyVelocityEstimate();
 
+  /**
+   * Publish every tracked landing target relative to quadrotor (body frame),
+   * one message per track id
+   */
+  void publishTrackerBankEstimates();
+
   /**
    * Publish detected landing target
    */
@@ -130,11 +154,21 @@ public:
    */
   int estimateEKF(const double dt);
 
+  /**
+   * Estimate with Unscented Kalman Filter
+   */
+  int estimateUKF(const double dt);
+
   /**
    * Estimate
    */
   int estimate();
 
+  /**
+   * Estimate all landing targets in view with the tracker bank
+   */
+  int estimateTracks();
+
   /**
    * Loop callback
    */
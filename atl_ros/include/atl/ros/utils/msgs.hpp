@@ -20,8 +20,10 @@
 #include <atl/atl_core.hpp>
 
 #include <atl_msgs/AprilTagPose.h>
+#include <atl_msgs/LandingTargetTrack.h>
 #include <atl_msgs/LCtrlSettings.h>
 #include <atl_msgs/ModelPose.h>
+#include <atl_msgs/OffboardSetpoint.h>
 #include <atl_msgs/PCtrlSettings.h>
 #include <atl_msgs/TCtrlSettings.h>
 #include <atl_msgs/VCtrlSettings.h>
@@ -58,6 +60,8 @@ void convertMsg(geometry_msgs::TwistStamped msg, VecX &v);
 void convertMsg(atl_msgs::AprilTagPose msg, TagPose &p);
 void convertMsg(atl_msgs::PCtrlSettings msg, PositionController &pc);
 void convertMsg(atl_msgs::TCtrlSettings msg, TrackingController &tc);
+void convertMsg(atl_msgs::PCtrlSettings msg, ControllerGains &gains);
+void convertMsg(atl_msgs::TCtrlSettings msg, ControllerGains &gains);
 void convertMsg(atl_msgs::LCtrlSettings msg, LandingController &lc);
 
 } // namespace atl
@@ -25,6 +25,7 @@ int AprilTagNode::configure(const int hz) {
   this->addPublisher<geometry_msgs::Vector3>(TARGET_P_POS_TOPIC);
   this->addPublisher<geometry_msgs::Vector3>(TARGET_P_POS_ENCODER_TOPIC);
   this->addPublisher<std_msgs::Float64>(TARGET_P_YAW_TOPIC);
+  this->addPublisher<atl_msgs::AprilTagPose>(TARGETS_P_POS_TOPIC);
   this->addImageSubscriber(CAMERA_IMAGE_TOPIC, &AprilTagNode::imageCallback, this);
   this->addShutdownListener(SHUTDOWN);
   // clang-format on
@@ -94,6 +95,22 @@ void AprilTagNode::publishTargetBodyYawMsg(const TagPose &tag) {
   this->ros_pubs[TARGET_P_YAW_TOPIC].publish(msg);
 }
 
+void AprilTagNode::publishTargetsBodyPositionMsg(
+    const std::vector<TagPose> &tags, const Quaternion &gimbal_joint) {
+  for (size_t i = 0; i < tags.size(); i++) {
+    // transform tag in camera frame to body planar frame
+    TagPose tag_P = tags[i];
+    tag_P.position = Gimbal::getTargetInBPF(this->camera_offset,
+                                            tags[i].position,
+                                            gimbal_joint);
+
+    // build and publish msg
+    atl_msgs::AprilTagPose msg;
+    buildMsg(tag_P, msg);
+    this->ros_pubs[TARGETS_P_POS_TOPIC].publish(msg);
+  }
+}
+
 void AprilTagNode::imageCallback(const sensor_msgs::ImageConstPtr &msg) {
   // parse msg
   const cv_bridge::CvImagePtr image_ptr = cv_bridge::toCvCopy(msg);
@@ -175,6 +192,7 @@ void AprilTagNode::imageCallback(const sensor_msgs::ImageConstPtr &msg) {
   this->publishTargetBodyPositionMsg(target_P);
   this->publishTargetBodyPositionEncoderMsg(target_P_encoder);
   this->publishTargetBodyYawMsg(tags[0]);
+  this->publishTargetsBodyPositionMsg(tags, gimbal_joint);
 }
 
 } // namespace atl
@@ -17,6 +17,22 @@ int ControlNode::configure(const int hz) {
     return -2;
   }
 
+  // Control executor, steps the quadrotor on its own thread if configured
+  // and from the loop callback otherwise
+  this->executor.quadrotor = &this->quadrotor;
+  const std::string executor_file = config_path + "/executor.yaml";
+  if (file_exists(executor_file)) {
+    if (this->executor.configure(executor_file) != 0) {
+      ROS_ERROR("Failed to configure control executor!");
+      return -2;
+    }
+    this->executor.paused = true;
+    if (this->executor.start(this->quadrotor) != 0) {
+      ROS_ERROR("Failed to start control executor!");
+      return -2;
+    }
+  }
+
   // Publishers
   this->addPublisher<atl_msgs::PCtrlSettings>(PCTRL_GET_TOPIC);
   this->addPublisher<geometry_msgs::PoseStamped>(QUADROTOR_POSE_TOPIC);
@@ -40,6 +56,7 @@ int ControlNode::configure(const int hz) {
   this->addSubscriber(TARGET_DETECTED_TOPIC, &ControlNode::targetDetectedCallback, this);
   this->addSubscriber(HOVER_SET_TOPIC, &ControlNode::hoverSetCallback, this);
   this->addSubscriber(HOVER_HEIGHT_SET_TOPIC, &ControlNode::hoverHeightSetCallback, this);
+  this->addSubscriber(OFFBOARD_SET_TOPIC, &ControlNode::offboardSetCallback, this);
   this->addSubscriber(PCTRL_SET_TOPIC, &ControlNode::positionControllerSetCallback, this);
   this->addSubscriber(TCTRL_SET_TOPIC, &ControlNode::trackingControllerSetCallback, this);
   this->addSubscriber(LCTRL_SET_TOPIC, &ControlNode::landingControllerSetCallback, this);
@@ -169,7 +186,9 @@ void ControlNode::globalPositionCallback(const sensor_msgs::NavSatFix &msg) {
     this->home_altitude = msg.altitude;
     this->home_set = true;
 
-    this->quadrotor.setHomePoint(this->home_latitude, this->home_longitude);
+    const double lat = this->home_latitude;
+    const double lon = this->home_longitude;
+    this->executor.setHomePoint(lat, lon);
   }
 
   // Update local position relative to home point
@@ -182,7 +201,7 @@ void ControlNode::globalPositionCallback(const sensor_msgs::NavSatFix &msg) {
               msg.longitude,
               &dist_N,
               &dist_E);
-  this->quadrotor.pose.position << dist_N, -1.0 * dist_E, height;
+  this->executor.state.position.write(Vec3{dist_N, -1.0 * dist_E, height});
 }
 
 void ControlNode::attitudeCallback(
@@ -196,19 +215,27 @@ void ControlNode::attitudeCallback(
   rpy(2) -= M_PI / 2.0;
   quat = euler321ToQuat(rpy);
 
-  this->quadrotor.pose.orientation = quat;
+  this->executor.state.orientation.write(quat);
 }
 
 void ControlNode::velocityCallback(const geometry_msgs::Vector3Stamped &msg) {
   // Transform velocity from ENU to NWU
   Vec3 vel_enu{msg.vector.x, msg.vector.y, msg.vector.z};
   Vec3 vel_nwu = nwu2enu(vel_enu);
-  this->quadrotor.setVelocity(vel_nwu);
+  this->executor.state.velocity.write(vel_nwu);
 }
 
 void ControlNode::radioCallback(const sensor_msgs::Joy &msg) {
   const int mode_switch = msg.axes[4];
 
+  // publish radio state
+  RadioState radio;
+  radio.nb_axes = std::min((int) msg.axes.size(), RADIO_MAX_AXES);
+  for (int i = 0; i < radio.nb_axes; i++) {
+    radio.axes[i] = msg.axes[i];
+  }
+  this->executor.state.radio.write(radio);
+
   // Arm or disarm SDK mode
   if (mode_switch > 0 && this->armed == true) {
     this->armed = false;
@@ -217,7 +244,7 @@ void ControlNode::radioCallback(const sensor_msgs::Joy &msg) {
 
   } else if (mode_switch < 0 && this->armed == false) {
     this->armed = true;
-    this->quadrotor.setMode(DISCOVER_MODE);
+    this->setMode(DISCOVER_MODE);
     this->sdkControlMode(true);
     this->setEstimatorOn();
   }
@@ -230,7 +257,7 @@ void ControlNode::armCallback(const std_msgs::Bool &msg) {
 
     if (this->sim_mode == false) {
       this->sdkControlMode(true);
-      this->quadrotor.setMode(HOVER_MODE);
+      this->setMode(HOVER_MODE);
     }
 
   } else {
@@ -252,62 +279,81 @@ void ControlNode::modeCallback(const std_msgs::String &msg) {
   // parse mode
   if (mode == "DISARM_MODE") {
     this->setEstimatorOff();
-    this->quadrotor.setMode(DISARM_MODE);
+    this->setMode(DISARM_MODE);
   } else if (mode == "HOVER_MODE") {
     this->setEstimatorOff();
-    this->quadrotor.setMode(HOVER_MODE);
+    this->setMode(HOVER_MODE);
   } else if (mode == "DISCOVER_MODE") {
     this->setEstimatorOn();
-    this->quadrotor.setMode(DISCOVER_MODE);
+    this->setMode(DISCOVER_MODE);
   } else if (mode == "TRACKING_MODE") {
     this->setEstimatorOn();
-    this->quadrotor.setMode(TRACKING_MODE);
+    this->setMode(TRACKING_MODE);
   } else if (mode == "LANDING_MODE") {
     this->setEstimatorOn();
-    this->quadrotor.setMode(LANDING_MODE);
+    this->setMode(LANDING_MODE);
   } else if (mode == "WAYPOINT_MODE") {
-    this->quadrotor.setMode(WAYPOINT_MODE);
+    this->setMode(WAYPOINT_MODE);
+  } else if (mode == "OFFBOARD_MODE") {
+    this->setEstimatorOff();
+    this->setMode(OFFBOARD_MODE);
   }
 }
 
 void ControlNode::yawCallback(const std_msgs::Float64 &msg) {
   double yaw;
   convertMsg(msg, yaw);
-  this->quadrotor.setYaw(yaw);
+  this->executor.setYaw(yaw);
 }
 
 void ControlNode::targetPositionCallback(const geometry_msgs::Vector3 &msg) {
   Vec3 position;
   convertMsg(msg, position);
-  this->quadrotor.setTargetPosition(position);
+  this->executor.state.target_position.write(position);
 }
 
 void ControlNode::targetVelocityCallback(const geometry_msgs::Vector3 &msg) {
   Vec3 velocity;
   convertMsg(msg, velocity);
-  this->quadrotor.setTargetVelocity(velocity);
+  this->executor.state.target_velocity.write(velocity);
 }
 
 void ControlNode::targetDetectedCallback(const std_msgs::Bool &msg) {
-  this->quadrotor.setTargetDetected(msg.data);
+  this->executor.state.target_detected.write(msg.data);
 }
 
 void ControlNode::hoverSetCallback(const geometry_msgs::Vector3 &msg) {
-  convertMsg(msg, this->quadrotor.hover_position);
+  Vec3 position;
+  convertMsg(msg, position);
+  this->executor.setHoverPosition(position);
 }
 
 void ControlNode::hoverHeightSetCallback(const std_msgs::Float64 &msg) {
-  convertMsg(msg, this->quadrotor.hover_position(2));
+  double height;
+  convertMsg(msg, height);
+  this->executor.setHoverHeight(height);
+}
+
+void ControlNode::offboardSetCallback(const atl_msgs::OffboardSetpoint &msg) {
+  Vec3 position, velocity, acceleration;
+  convertMsg(msg.position, position);
+  convertMsg(msg.velocity, velocity);
+  convertMsg(msg.acceleration, acceleration);
+  this->executor.setOffboardSetpoint(position, velocity, acceleration);
 }
 
 void ControlNode::positionControllerSetCallback(
     const atl_msgs::PCtrlSettings &msg) {
-  convertMsg(msg, this->quadrotor.position_controller);
+  ControllerGains gains;
+  convertMsg(msg, gains);
+  this->executor.setPositionGains(gains);
 }
 
 void ControlNode::trackingControllerSetCallback(
     const atl_msgs::TCtrlSettings &msg) {
-  convertMsg(msg, this->quadrotor.tracking_controller);
+  ControllerGains gains;
+  convertMsg(msg, gains);
+  this->executor.setTrackingGains(gains);
 }
 
 void ControlNode::landingControllerSetCallback(
@@ -347,10 +393,11 @@ void ControlNode::publishAttitudeSetpoint() {
   const int control_byte = 0x22;
 
   // Control signal in roll, pitch and yaw (radians) in ENU frame
-  const Vec3 rpy = this->quadrotor.att_cmd.toEuler("ENU");
+  this->executor.att_cmd.read(this->att_cmd);
+  const Vec3 rpy = this->att_cmd.toEuler("ENU");
 
   // Throttle (0 - 100)
-  const double throttle = this->quadrotor.att_cmd.throttle * 100.0;
+  const double throttle = this->att_cmd.throttle * 100.0;
 
   // Setup and publish control message
   sensor_msgs::Joy msg;
@@ -364,40 +411,57 @@ void ControlNode::publishAttitudeSetpoint() {
 
 void ControlNode::publishQuadrotorPose() {
   geometry_msgs::PoseStamped msg;
-  buildMsg(this->ros_seq, ros::Time::now(), this->quadrotor.pose, msg);
+  buildMsg(this->ros_seq, ros::Time::now(), this->snapshot.pose, msg);
   this->ros_pubs[QUADROTOR_POSE_TOPIC].publish(msg);
 }
 
 void ControlNode::publishQuadrotorVelocity() {
   geometry_msgs::TwistStamped msg;
 
-  msg.twist.linear.x = this->quadrotor.velocity(0);
-  msg.twist.linear.y = this->quadrotor.velocity(1);
-  msg.twist.linear.z = this->quadrotor.velocity(2);
+  msg.twist.linear.x = this->snapshot.velocity(0);
+  msg.twist.linear.y = this->snapshot.velocity(1);
+  msg.twist.linear.z = this->snapshot.velocity(2);
 
   this->ros_pubs[QUADROTOR_VELOCITY_TOPIC].publish(msg);
 }
 
+int ControlNode::setMode(const enum Mode mode) {
+  return this->executor.setMode(mode);
+}
+
 int ControlNode::loopCallback() {
   // publish pose and velocity
+  this->executor.state.read(this->snapshot);
   this->publishQuadrotorPose();
   this->publishQuadrotorVelocity();
 
-  // pre-check
+  // setup
+  const double dt = (ros::Time::now() - this->ros_last_updated).toSec();
+  const bool threaded = this->executor.running;
+
+  // pre-check, reset the quadrotor once when it gets disarmed
   if (this->armed == false) {
-    this->quadrotor.reset();
+    if (this->was_armed) {
+      this->executor.reset();
+      this->was_armed = false;
+    }
+    this->executor.paused = true;
+    if (threaded == false) {
+      this->executor.step(dt);
+    }
     this->setEstimatorOff();
     return 0;
   }
+  this->was_armed = true;
+  this->executor.paused = false;
   this->setEstimatorOn();
 
-  // setup
-  const double dt = (ros::Time::now() - this->ros_last_updated).toSec();
-
-  // step
-  if (this->quadrotor.step(dt) != 0) {
+  // step, the executor thread steps on its own when running
+  const int retval = threaded ? this->executor.step_retval.load()
+                              : this->executor.step(dt);
+  if (retval != 0) {
     return -1;
-  } else if (this->quadrotor.current_mode == DISARM_MODE) {
+  } else if (this->executor.mode == DISARM_MODE) {
     this->setEstimatorOff();
   }
 
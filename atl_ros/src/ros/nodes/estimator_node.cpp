@@ -4,6 +4,7 @@ namespace atl {
 
 int EstimatorNode::configure(const int hz) {
   std::string config_file;
+  std::string bank_config_file;
 
   // ros node
   if (ROSNode::configure(hz) != 0) {
@@ -27,11 +28,28 @@ int EstimatorNode::configure(const int hz) {
       return -2;
     }
 
+  } else if (this->estimator_type == "UKF") {
+    LOG_INFO("Estimator running in UKF_MODE!");
+    if (this->ukf_tracker.configure(config_file) != 0) {
+      LOG_ERROR("Failed to configure UnscentedKalmanFilterTracker!");
+      return -2;
+    }
+
   } else {
     LOG_ERROR("Invalid Estimator Mode!");
     return -2;
   }
 
+  // tracker bank (optional)
+  if (this->ros_nh->getParam(this->node_name + "/bank_config",
+                             bank_config_file)) {
+    LOG_INFO("Estimator tracking multiple targets!");
+    if (this->tracker_bank.configure(bank_config_file) != 0) {
+      LOG_ERROR("Failed to configure TrackerBank!");
+      return -2;
+    }
+  }
+
   // publishers and subscribers
   // clang-format off
   this->addPublisher<geometry_msgs::Vector3>(LT_POSITION_B_TOPIC);
@@ -39,12 +57,15 @@ int EstimatorNode::configure(const int hz) {
   this->addPublisher<std_msgs::Bool>(LT_DETECTED_TOPIC);
   this->addPublisher<geometry_msgs::Vector3>(GIMBAL_SETPOINT_ATTITUDE_TOPIC);
   this->addPublisher<std_msgs::Float64>(QUAD_YAW_TOPIC);
+  this->addPublisher<atl_msgs::LandingTargetTrack>(LT_TRACKS_B_TOPIC, 64);
   this->addSubscriber(ESTIMATOR_ON_TOPIC, &EstimatorNode::onCallback, this);
   this->addSubscriber(ESTIMATOR_OFF_TOPIC, &EstimatorNode::offCallback, this);
   this->addSubscriber(QUAD_POSE_TOPIC, &EstimatorNode::quadPoseCallback, this);
   this->addSubscriber(QUAD_VELOCITY_TOPIC, &EstimatorNode::quadVelocityCallback, this);
+  this->addSubscriber(TARGET_POSE_TOPIC, &EstimatorNode::targetPoseCallback, this);
   this->addSubscriber(TARGET_POS_B_TOPIC, &EstimatorNode::targetBodyPosCallback, this);
   this->addSubscriber(TARGET_YAW_W_TOPIC, &EstimatorNode::targetInertialYawCallback, this);
+  this->addSubscriber(TARGETS_POS_B_TOPIC, &EstimatorNode::targetsBodyPosCallback, this, 64);
   this->addLoopCallback(std::bind(&EstimatorNode::loopCallback, this));
   // clang-format on
 
@@ -88,6 +109,20 @@ void EstimatorNode::initLTKF(const Vec3 &x0) {
       LOG_ERROR("Failed to intialize ExtendedKalmanFilterTracker!");
       exit(-1); // dangerous but necessary
     }
+
+  } else if (this->estimator_type == "UKF") {
+    // clang-format off
+    mu = VecX(9);
+    mu << x0(0), x0(1), x0(2),
+          0, 0, 0,
+          0, 0, 0;
+    // clang-format on
+
+    LOG_INFO("Intializing UKF!");
+    if (this->ukf_tracker.initialize(mu) != 0) {
+      LOG_ERROR("Failed to intialize UnscentedKalmanFilterTracker!");
+      exit(-1); // dangerous but necessary
+    }
   }
 
   LOG_INFO("Estimator intialized!");
@@ -133,6 +168,10 @@ void EstimatorNode::offCallback(const std_msgs::Bool &msg) {
   }
 }
 
+void EstimatorNode::targetPoseCallback(const atl_msgs::AprilTagPose &msg) {
+  convertMsg(msg, this->target_tag);
+}
+
 void EstimatorNode::targetBodyPosCallback(const geometry_msgs::Vector3 &msg) {
   // pre-check
   if (this->running == false) {
@@ -174,6 +213,18 @@ void EstimatorNode::targetInertialYawCallback(const std_msgs::Float64 &msg) {
   convertMsg(msg, this->target_yaw_W);
 }
 
+void EstimatorNode::targetsBodyPosCallback(const atl_msgs::AprilTagPose &msg) {
+  // pre-check
+  if (this->running == false || this->tracker_bank.configured == false) {
+    return;
+  }
+
+  // buffer detection until next loop
+  TagPose tag;
+  convertMsg(msg, tag);
+  this->targets_measured.push_back(tag);
+}
+
 void EstimatorNode::publishLTKFBodyPositionEstimate() {
   Vec3 est_pos;
 
@@ -185,6 +236,10 @@ void EstimatorNode::publishLTKFBodyPositionEstimate() {
     est_pos(0) = this->ekf_tracker.mu(0);
     est_pos(1) = this->ekf_tracker.mu(1);
     est_pos(2) = this->ekf_tracker.mu(2);
+  } else if (this->estimator_type == "UKF") {
+    est_pos(0) = this->ukf_tracker.mu(0);
+    est_pos(1) = this->ukf_tracker.mu(1);
+    est_pos(2) = this->ukf_tracker.mu(2);
   }
 
   // estimate in body planar frame
@@ -209,6 +264,10 @@ void EstimatorNode::publishLTKFBodyVelocityEstimate() {
     est_vel(0) = this->ekf_tracker.mu(4) * cos(this->ekf_tracker.mu(3));
     est_vel(1) = this->ekf_tracker.mu(4) * sin(this->ekf_tracker.mu(3));
     est_vel(2) = this->ekf_tracker.mu(5);
+  } else if (this->estimator_type == "UKF") {
+    est_vel(0) = this->ukf_tracker.mu(4) * cos(this->ukf_tracker.mu(3));
+    est_vel(1) = this->ukf_tracker.mu(4) * sin(this->ukf_tracker.mu(3));
+    est_vel(2) = this->ukf_tracker.mu(5);
   }
 
   // estimate in body planar frame
@@ -222,6 +281,17 @@ void EstimatorNode::publishLTKFBodyVelocityEstimate() {
   this->ros_pubs[LT_VELOCITY_B_TOPIC].publish(msg);
 }
 
+void EstimatorNode::publishTrackerBankEstimates() {
+  for (int i = 0; i < this->tracker_bank.nb_tracks; i++) {
+    atl_msgs::LandingTargetTrack msg;
+    msg.track_id = this->tracker_bank.track_id[i];
+    msg.tag_id = this->tracker_bank.tag_id[i];
+    buildMsg(this->tracker_bank.getPosition(i), msg.position);
+    buildMsg(this->tracker_bank.getVelocity(i), msg.velocity);
+    this->ros_pubs[LT_TRACKS_B_TOPIC].publish(msg);
+  }
+}
+
 void EstimatorNode::publishLTDetected() {
   std_msgs::Bool msg;
 
@@ -274,6 +344,7 @@ void EstimatorNode::reset() {
   this->target_losted = true;
   this->target_detected = false;
   this->target_measured << 0.0, 0.0, 0.0;
+  this->target_tag = TagPose();
 
   // reset gimbal
   setpoints << 0, 0, 0;
@@ -282,36 +353,36 @@ void EstimatorNode::reset() {
 
 int EstimatorNode::estimateKF(const double dt) {
   MatX A(9, 9), C(3, 9);
-  Vec3 y, prev_pos, curr_pos;
+  Vec3 prev_pos, curr_pos;
+  TagPose tag;
 
   // setup
   prev_pos = this->target_last_measured;
   MATRIX_A_CONSTANT_ACCELERATION_XYZ(A);
 
-  // check measurement
-  if (this->target_detected) {
-    // clang-format off
-    C << 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
-         0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
-         0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0;
-    y << this->target_measured(0),
-         this->target_measured(1),
-         this->target_measured(2);
-    this->target_last_measured = this->target_measured;
-    // clang-format on
+  // clang-format off
+  C << 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+       0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+       0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0;
+  // clang-format on
 
-  } else {
-    // clang-format off
-    C << 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
-         0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
-         0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0;
-    // clang-format on
-    y << 0.0, 0.0, 0.0; // to prevent uninitialized values from entering kf
+  // body frame position with the detection confidence of the tag, a tag
+  // that was not detected only predicts
+  if (this->target_detected) {
+    tag = this->target_tag;
+    tag.detected = true;
+    tag.position = this->target_measured;
   }
 
-  // estimate
+  // estimate, a measurement rejected by the innovation gate is not used
+  // for the sanity check either
   this->kf_tracker.C = C;
-  this->kf_tracker.estimate(A, y);
+  const int retval = this->kf_tracker.estimate(A, tag);
+  if (retval == -4) {
+    return -1;
+  } else if (retval == 0 && this->target_detected) {
+    this->target_last_measured = this->target_measured;
+  }
 
   // sanity check estimates
   curr_pos = this->kf_tracker.mu.block(0, 0, 3, 1);
@@ -353,6 +424,32 @@ int EstimatorNode::estimateEKF(const double dt) {
   return 0;
 }
 
+int EstimatorNode::estimateUKF(const double dt) {
+  VecX y(4);
+
+  // setup
+  y(0) = this->target_measured(0);
+  y(1) = this->target_measured(1);
+  y(2) = this->target_measured(2);
+  y(3) = wrapToPi(this->target_yaw_W);
+
+  // prediction update
+  if (this->ukf_tracker.predictionUpdate(dt) != 0) {
+    return -1;
+  }
+
+  // measurement update
+  if (this->target_detected) {
+    this->ukf_tracker.measurementUpdate(y);
+
+  } else {
+    this->ukf_tracker.mu = this->ukf_tracker.mu_p;
+    this->ukf_tracker.S = this->ukf_tracker.S_p;
+  }
+
+  return 0;
+}
+
 int EstimatorNode::estimate() {
   int retval;
 
@@ -376,6 +473,8 @@ int EstimatorNode::estimate() {
     retval = this->estimateKF(dt);
   } else if (this->estimator_type == "EKF") {
     retval = this->estimateEKF(dt);
+  } else if (this->estimator_type == "UKF") {
+    retval = this->estimateUKF(dt);
   }
 
   // sanity check target estimates
@@ -388,7 +487,30 @@ int EstimatorNode::estimate() {
   return 0;
 }
 
+int EstimatorNode::estimateTracks() {
+  // pre-check
+  if (this->running == false || this->tracker_bank.configured == false) {
+    return 0;
+  }
+
+  // setup
+  const ros::Time now = ros::Time::now();
+  const double dt = (now - this->ros_last_updated).toSec();
+
+  // estimate
+  this->tracker_bank.predict(dt);
+  this->tracker_bank.update(this->targets_measured, now.toSec());
+  this->targets_measured.clear();
+
+  return 0;
+}
+
 int EstimatorNode::loopCallback() {
+  // track every landing target in view
+  if (this->estimateTracks() == 0 && this->tracker_bank.nb_tracks) {
+    this->publishTrackerBankEstimates();
+  }
+
   // pre-check
   if (this->initialized == false) {
     return 0;
@@ -57,6 +57,9 @@ void buildMsg(TagPose tag, atl_msgs::AprilTagPose &msg) {
   msg.orientation.x = tag.orientation.x();
   msg.orientation.y = tag.orientation.y();
   msg.orientation.z = tag.orientation.z();
+
+  msg.decision_margin = tag.decision_margin;
+  msg.area = tag.area;
 }
 
 void buildMsg(TagPose tag, geometry_msgs::Vector3 &msg) {
@@ -68,34 +71,34 @@ void buildMsg(TagPose tag, geometry_msgs::Vector3 &msg) {
 void buildMsg(PositionController pc, atl_msgs::PCtrlSettings &msg) {
   msg.roll_controller.min = pc.roll_limit[0];
   msg.roll_controller.max = pc.roll_limit[1];
-  msg.roll_controller.k_p = pc.x_controller.k_p;
-  msg.roll_controller.k_i = pc.x_controller.k_i;
-  msg.roll_controller.k_d = pc.x_controller.k_d;
+  msg.roll_controller.k_p = pc.pid.k_p(1);
+  msg.roll_controller.k_i = pc.pid.k_i(1);
+  msg.roll_controller.k_d = pc.pid.k_d(1);
 
   msg.pitch_controller.min = pc.pitch_limit[0];
   msg.pitch_controller.max = pc.pitch_limit[1];
-  msg.pitch_controller.k_p = pc.y_controller.k_p;
-  msg.pitch_controller.k_i = pc.y_controller.k_i;
-  msg.pitch_controller.k_d = pc.y_controller.k_d;
+  msg.pitch_controller.k_p = pc.pid.k_p(0);
+  msg.pitch_controller.k_i = pc.pid.k_i(0);
+  msg.pitch_controller.k_d = pc.pid.k_d(0);
 
-  msg.throttle_controller.k_p = pc.z_controller.k_p;
-  msg.throttle_controller.k_i = pc.z_controller.k_i;
-  msg.throttle_controller.k_d = pc.z_controller.k_d;
+  msg.throttle_controller.k_p = pc.pid.k_p(2);
+  msg.throttle_controller.k_i = pc.pid.k_i(2);
+  msg.throttle_controller.k_d = pc.pid.k_d(2);
   msg.hover_throttle = pc.hover_throttle;
 }
 
 void buildMsg(TrackingController tc, atl_msgs::TCtrlSettings &msg) {
-  msg.roll_controller.k_p = tc.x_controller.k_p;
-  msg.roll_controller.k_i = tc.x_controller.k_i;
-  msg.roll_controller.k_d = tc.x_controller.k_d;
+  msg.roll_controller.k_p = tc.pid.k_p(1);
+  msg.roll_controller.k_i = tc.pid.k_i(1);
+  msg.roll_controller.k_d = tc.pid.k_d(1);
 
-  msg.pitch_controller.k_p = tc.y_controller.k_p;
-  msg.pitch_controller.k_i = tc.y_controller.k_i;
-  msg.pitch_controller.k_d = tc.y_controller.k_d;
+  msg.pitch_controller.k_p = tc.pid.k_p(0);
+  msg.pitch_controller.k_i = tc.pid.k_i(0);
+  msg.pitch_controller.k_d = tc.pid.k_d(0);
 
-  msg.throttle_controller.k_p = tc.z_controller.k_p;
-  msg.throttle_controller.k_i = tc.z_controller.k_i;
-  msg.throttle_controller.k_d = tc.z_controller.k_d;
+  msg.throttle_controller.k_p = tc.pid.k_p(2);
+  msg.throttle_controller.k_i = tc.pid.k_i(2);
+  msg.throttle_controller.k_d = tc.pid.k_d(2);
   msg.hover_throttle = tc.hover_throttle;
 
   msg.roll_controller.min = tc.roll_limit[0];
@@ -184,39 +187,41 @@ void convertMsg(atl_msgs::AprilTagPose msg, TagPose &tag) {
   tag.detected = msg.detected;
   convertMsg(msg.position, tag.position);
   convertMsg(msg.orientation, tag.orientation);
+  tag.decision_margin = msg.decision_margin;
+  tag.area = msg.area;
 }
 
 void convertMsg(atl_msgs::PCtrlSettings msg, PositionController &pc) {
   pc.pitch_limit[0] = deg2rad(msg.pitch_controller.min);
   pc.pitch_limit[1] = deg2rad(msg.pitch_controller.max);
-  pc.x_controller.k_p = msg.pitch_controller.k_p;
-  pc.x_controller.k_i = msg.pitch_controller.k_i;
-  pc.x_controller.k_d = msg.pitch_controller.k_d;
+  pc.pid.k_p(0) = msg.pitch_controller.k_p;
+  pc.pid.k_i(0) = msg.pitch_controller.k_i;
+  pc.pid.k_d(0) = msg.pitch_controller.k_d;
 
   pc.roll_limit[0] = deg2rad(msg.roll_controller.min);
   pc.roll_limit[1] = deg2rad(msg.roll_controller.max);
-  pc.y_controller.k_p = msg.roll_controller.k_p;
-  pc.y_controller.k_i = msg.roll_controller.k_i;
-  pc.y_controller.k_d = msg.roll_controller.k_d;
+  pc.pid.k_p(1) = msg.roll_controller.k_p;
+  pc.pid.k_i(1) = msg.roll_controller.k_i;
+  pc.pid.k_d(1) = msg.roll_controller.k_d;
 
-  pc.z_controller.k_p = msg.throttle_controller.k_p;
-  pc.z_controller.k_i = msg.throttle_controller.k_i;
-  pc.z_controller.k_d = msg.throttle_controller.k_d;
+  pc.pid.k_p(2) = msg.throttle_controller.k_p;
+  pc.pid.k_i(2) = msg.throttle_controller.k_i;
+  pc.pid.k_d(2) = msg.throttle_controller.k_d;
   pc.hover_throttle = msg.hover_throttle;
 }
 
 void convertMsg(atl_msgs::TCtrlSettings msg, TrackingController &tc) {
-  tc.y_controller.k_p = msg.roll_controller.k_p;
-  tc.y_controller.k_i = msg.roll_controller.k_i;
-  tc.y_controller.k_d = msg.roll_controller.k_d;
+  tc.pid.k_p(1) = msg.roll_controller.k_p;
+  tc.pid.k_i(1) = msg.roll_controller.k_i;
+  tc.pid.k_d(1) = msg.roll_controller.k_d;
 
-  tc.x_controller.k_p = msg.pitch_controller.k_p;
-  tc.x_controller.k_i = msg.pitch_controller.k_i;
-  tc.x_controller.k_d = msg.pitch_controller.k_d;
+  tc.pid.k_p(0) = msg.pitch_controller.k_p;
+  tc.pid.k_i(0) = msg.pitch_controller.k_i;
+  tc.pid.k_d(0) = msg.pitch_controller.k_d;
 
-  tc.z_controller.k_p = msg.throttle_controller.k_p;
-  tc.z_controller.k_i = msg.throttle_controller.k_i;
-  tc.z_controller.k_d = msg.throttle_controller.k_d;
+  tc.pid.k_p(2) = msg.throttle_controller.k_p;
+  tc.pid.k_i(2) = msg.throttle_controller.k_i;
+  tc.pid.k_d(2) = msg.throttle_controller.k_d;
   tc.hover_throttle = msg.hover_throttle;
 
   tc.roll_limit[0] = deg2rad(msg.roll_controller.min);
@@ -232,6 +237,48 @@ void convertMsg(atl_msgs::TCtrlSettings msg, TrackingController &tc) {
   // clang-format on
 }
 
+void convertMsg(atl_msgs::PCtrlSettings msg, ControllerGains &gains) {
+  gains.pitch_limit[0] = deg2rad(msg.pitch_controller.min);
+  gains.pitch_limit[1] = deg2rad(msg.pitch_controller.max);
+  gains.k_p[0] = msg.pitch_controller.k_p;
+  gains.k_i[0] = msg.pitch_controller.k_i;
+  gains.k_d[0] = msg.pitch_controller.k_d;
+
+  gains.roll_limit[0] = deg2rad(msg.roll_controller.min);
+  gains.roll_limit[1] = deg2rad(msg.roll_controller.max);
+  gains.k_p[1] = msg.roll_controller.k_p;
+  gains.k_i[1] = msg.roll_controller.k_i;
+  gains.k_d[1] = msg.roll_controller.k_d;
+
+  gains.k_p[2] = msg.throttle_controller.k_p;
+  gains.k_i[2] = msg.throttle_controller.k_i;
+  gains.k_d[2] = msg.throttle_controller.k_d;
+  gains.hover_throttle = msg.hover_throttle;
+}
+
+void convertMsg(atl_msgs::TCtrlSettings msg, ControllerGains &gains) {
+  gains.pitch_limit[0] = deg2rad(msg.pitch_controller.min);
+  gains.pitch_limit[1] = deg2rad(msg.pitch_controller.max);
+  gains.k_p[0] = msg.pitch_controller.k_p;
+  gains.k_i[0] = msg.pitch_controller.k_i;
+  gains.k_d[0] = msg.pitch_controller.k_d;
+
+  gains.roll_limit[0] = deg2rad(msg.roll_controller.min);
+  gains.roll_limit[1] = deg2rad(msg.roll_controller.max);
+  gains.k_p[1] = msg.roll_controller.k_p;
+  gains.k_i[1] = msg.roll_controller.k_i;
+  gains.k_d[1] = msg.roll_controller.k_d;
+
+  gains.k_p[2] = msg.throttle_controller.k_p;
+  gains.k_i[2] = msg.throttle_controller.k_i;
+  gains.k_d[2] = msg.throttle_controller.k_d;
+  gains.hover_throttle = msg.hover_throttle;
+
+  gains.track_offset[0] = msg.track_offset.x;
+  gains.track_offset[1] = msg.track_offset.y;
+  gains.track_offset[2] = msg.track_offset.z;
+}
+
 // void convertMsg(atl_msgs::LCtrlSettings msg, LandingController &lc) {
 //   lc.vx_controller.k_p = msg.vx_controller.k_p;
 //   lc.vx_controller.k_i = msg.vx_controller.k_i;
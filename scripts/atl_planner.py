@@ -1,5 +1,6 @@
 #!/usr/bin/env python2
 import itertools
+import time
 
 from math import cos
 from math import sin
@@ -301,12 +302,15 @@ def optimize(p0_z, pf_z, v, dt, save_plot=False, plot_name="", vz_max=-1.2):
         {"type": "eq", "fun": ine_constraints, "args": (T, dt, n, m)}
     ]
 
-    # optimize
+    # optimize, timed against the c++ optimizer (POpt.benchmark test)
+    t_start = time.time()
     results = scipy.optimize.minimize(cost_func,
                                       x0,
                                       args=args,
                                       constraints=constraints,
                                       bounds=bounds)
+    print("variables: {0}\tsolve [ms]: {1}".format(
+        T * (n + m), (time.time() - t_start) * 1e3))
 
     # plot optimization results
     plot_optimization_results(traj, results.x, T, n, m, save_plot, plot_name)